@@ -46,7 +46,7 @@ TEST(TestBenchmark, TestMultipleSequenceOperationMostlyGPU)
 
     std::shared_ptr<kp::TensorT<float>> tensorInA = mgr.tensor(std::vector<float>(numElems, elemValue));
     std::shared_ptr<kp::TensorT<uint32_t>> tensorInB = mgr.tensorT<uint32_t>(std::vector<uint32_t>(numElems, elemValue));
-    std::shared_ptr<kp::TensorT<float>> tensorOut = mgr.tensor(std::vector<float>(numElems, 0));
+    std::shared_ptr<kp::TensorT<float>> tensorOut = mgr.tensorFilled(numElems, 0, kp::Memory::MemoryTypes::eDevice);
 
     std::vector<std::shared_ptr<kp::Memory>> params = { tensorInA, tensorInB, tensorOut };
 
@@ -92,3 +92,123 @@ TEST(TestBenchmark, TestMultipleSequenceOperationMostlyGPU)
     EXPECT_LT(totalTime, 50000000);
 }
 
+
+TEST(TestBenchmark, TestReduceSumThroughput)
+{
+    uint32_t numIter = 100;
+    uint32_t numElems = 1 << 24;
+
+    std::vector<float> data(numElems, 1);
+
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorIn = mgr.tensor(data);
+    std::shared_ptr<kp::TensorT<float>> tensorOut = mgr.tensor({ 0 });
+
+    mgr.sequence()->eval<kp::OpSyncDevice>({ tensorIn });
+
+    // Opt: Record the passes once and only resubmit them
+    std::shared_ptr<kp::Sequence> sq = mgr.sequence();
+    sq->record<kp::OpReduce>({ tensorIn, tensorOut }, mgr);
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    for (uint32_t i = 0; i < numIter; i++) {
+        sq->eval();
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto gpuTime =
+      std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime)
+        .count();
+
+    mgr.sequence()->eval<kp::OpSyncLocal>({ tensorOut });
+
+    startTime = std::chrono::high_resolution_clock::now();
+
+    float cpuSum = 0;
+    for (uint32_t i = 0; i < numIter; i++) {
+        cpuSum = 0;
+        for (float value : data) {
+            cpuSum += value;
+        }
+    }
+
+    endTime = std::chrono::high_resolution_clock::now();
+    auto cpuTime =
+      std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime)
+        .count();
+
+    KP_LOG_INFO("Reduce sum of {} floats: GPU {:.2f} GB/s, CPU {:.2f} GB/s",
+                numElems,
+                numElems * sizeof(float) * numIter / (gpuTime * 1e3),
+                numElems * sizeof(float) * numIter / (cpuTime * 1e3));
+
+    EXPECT_EQ(tensorOut->vector(), std::vector<float>({ float(numElems) }));
+    EXPECT_EQ(cpuSum, float(numElems));
+
+    // Validating significant divergences of performance
+    // Currently configured for github actions performance
+    EXPECT_LT(gpuTime, 50000000);
+}
+
+TEST(TestBenchmark, TestMatMulGflops)
+{
+    uint32_t numIter = 10;
+
+    // Cooperative matrices are used for fp16 inputs when supported
+    kp::Manager mgr(0,
+                    {},
+                    { "VK_KHR_cooperative_matrix",
+                      "VK_KHR_vulkan_memory_model",
+                      "VK_KHR_shader_float16_int8",
+                      "VK_KHR_16bit_storage" });
+
+    for (uint32_t size : { 256, 512, 1024, 2048 }) {
+        uint32_t numElems = size * size;
+
+        std::shared_ptr<kp::TensorT<float>> tensorA =
+          mgr.tensor(std::vector<float>(numElems, 1));
+        std::shared_ptr<kp::TensorT<float>> tensorB =
+          mgr.tensor(std::vector<float>(numElems, 1));
+        std::shared_ptr<kp::TensorT<kp::Half>> tensorHalfA =
+          mgr.tensorT(std::vector<kp::Half>(numElems, 1.0f));
+        std::shared_ptr<kp::TensorT<kp::Half>> tensorHalfB =
+          mgr.tensorT(std::vector<kp::Half>(numElems, 1.0f));
+        std::shared_ptr<kp::TensorT<float>> tensorC =
+          mgr.tensorT<float>(numElems);
+
+        mgr.sequence()->eval<kp::OpSyncDevice>(
+          { tensorA, tensorB, tensorHalfA, tensorHalfB });
+
+        std::shared_ptr<kp::OpMatMul> opFloat{ new kp::OpMatMul(
+          { tensorA, tensorB, tensorC }, mgr, size, size, size) };
+        std::shared_ptr<kp::OpMatMul> opHalf{ new kp::OpMatMul(
+          { tensorHalfA, tensorHalfB, tensorC }, mgr, size, size, size) };
+
+        for (const std::shared_ptr<kp::OpMatMul>& op : { opFloat, opHalf }) {
+            // Opt: Record the multiplication once and only resubmit it
+            std::shared_ptr<kp::Sequence> sq = mgr.sequence()->record(op);
+            sq->eval();
+
+            auto startTime = std::chrono::high_resolution_clock::now();
+
+            for (uint32_t i = 0; i < numIter; i++) {
+                sq->eval();
+            }
+
+            auto endTime = std::chrono::high_resolution_clock::now();
+            auto totalTime = std::chrono::duration_cast<
+                               std::chrono::microseconds>(endTime - startTime)
+                               .count();
+
+            KP_LOG_INFO("{}: {:.2f} GFLOP/s",
+                        op->name(),
+                        2.0 * size * size * size * numIter / (totalTime * 1e3));
+
+            mgr.sequence()->eval<kp::OpSyncLocal>({ tensorC });
+            EXPECT_EQ(tensorC->vector(),
+                      std::vector<float>(numElems, float(size)));
+        }
+    }
+}
@@ -9,15 +9,26 @@ function(vulkan_compile_shader)
           return()
      endif()
 
-     cmake_parse_arguments(SHADER_COMPILE "" "INFILE;OUTFILE;NAMESPACE" "" ${ARGN})
+     cmake_parse_arguments(SHADER_COMPILE "" "INFILE;OUTFILE;NAMESPACE;TARGET_ENV" "" ${ARGN})
      set(SHADER_COMPILE_INFILE_FULL "${CMAKE_CURRENT_SOURCE_DIR}/${SHADER_COMPILE_INFILE}")
      set(SHADER_COMPILE_SPV_FILE_FULL "${CMAKE_CURRENT_BINARY_DIR}/${SHADER_COMPILE_INFILE}.spv")
-     set(SHADER_COMPILE_HEADER_FILE_FULL "${CMAKE_CURRENT_SOURCE_DIR}/${SHADER_COMPILE_OUTFILE}")
+     if(IS_ABSOLUTE "${SHADER_COMPILE_OUTFILE}")
+          set(SHADER_COMPILE_HEADER_FILE_FULL "${SHADER_COMPILE_OUTFILE}")
+     else()
+          set(SHADER_COMPILE_HEADER_FILE_FULL "${CMAKE_CURRENT_SOURCE_DIR}/${SHADER_COMPILE_OUTFILE}")
+     endif()
+
+     # Shaders using newer SPIR-V features (ie. subgroup operations) need a newer target environment
+     set(SHADER_COMPILE_TARGET_ENV_ARGS "")
+     if(SHADER_COMPILE_TARGET_ENV)
+          set(SHADER_COMPILE_TARGET_ENV_ARGS "--target-env" "${SHADER_COMPILE_TARGET_ENV}")
+     endif()
 
      # .comp -> .spv
      add_custom_command(OUTPUT "${SHADER_COMPILE_SPV_FILE_FULL}"
                         COMMAND "${GLS_LANG_VALIDATOR_PATH}"
                         ARGS "-V"
+                             ${SHADER_COMPILE_TARGET_ENV_ARGS}
                              "${SHADER_COMPILE_INFILE_FULL}"
                              "-o"
                              "${SHADER_COMPILE_SPV_FILE_FULL}"
@@ -818,6 +818,8 @@ static const char *__doc_kp_Memory_DataTypes = R"doc()doc";
 
 static const char *__doc_kp_Memory_DataTypes_eBool = R"doc()doc";
 
+static const char *__doc_kp_Memory_DataTypes_eBFloat16 = R"doc(kp::BFloat16, upper 16 bits of a float)doc";
+
 static const char *__doc_kp_Memory_DataTypes_eChar = R"doc()doc";
 
 static const char *__doc_kp_Memory_DataTypes_eCustom = R"doc()doc";
@@ -826,8 +828,12 @@ static const char *__doc_kp_Memory_DataTypes_eDouble = R"doc()doc";
 
 static const char *__doc_kp_Memory_DataTypes_eFloat = R"doc()doc";
 
+static const char *__doc_kp_Memory_DataTypes_eHalf = R"doc(kp::Half, IEEE 754 half precision float)doc";
+
 static const char *__doc_kp_Memory_DataTypes_eInt = R"doc()doc";
 
+static const char *__doc_kp_Memory_DataTypes_eQInt8 = R"doc(kp::QInt8, int8 with a scale and zero point)doc";
+
 static const char *__doc_kp_Memory_DataTypes_eShort = R"doc()doc";
 
 static const char *__doc_kp_Memory_DataTypes_eUnsignedChar = R"doc()doc";
@@ -911,6 +917,13 @@ Returns:
 
 static const char *__doc_kp_Memory_destroy = R"doc(Destroys and frees the GPU resources which includes the memory.)doc";
 
+static const char *__doc_kp_Memory_floatVector =
+R"doc(Gets the data converted to floats, which is the reverse of
+setFloatData and is supported for eFloat, eHalf, eBFloat16 and eQInt8.
+
+Returns:
+    Vector with one float per element)doc";
+
 static const char *__doc_kp_Memory_getDescriptorType = R"doc()doc";
 
 static const char *__doc_kp_Memory_getPrimaryMemoryPropertyFlags = R"doc()doc";
@@ -1074,6 +1087,26 @@ static const char *__doc_kp_Memory_setData_2 =
 R"doc(Sets / resets the data of the tensor/image which is directly done on
 the GPU host visible memory available by the tensor/image.)doc";
 
+static const char *__doc_kp_Memory_setFloatData =
+R"doc(Sets the data from floats, which are converted to the data type of the
+memory object: rounded for eHalf and eBFloat16, and quantized with the
+scale and zero point for eQInt8. This is mainly used to upload data in a
+reduced precision so shaders read less memory.
+
+Parameter ``data``:
+    The values, one per element of the memory object)doc";
+
+static const char *__doc_kp_Memory_setQuantization =
+R"doc(Sets the affine mapping of quantized values to floats, where value =
+scale * (quantized - zeroPoint), which is used to convert the data of
+kp::Memory::DataTypes::eQInt8 memory objects.
+
+Parameter ``scale``:
+    The step between consecutive quantized values
+
+Parameter ``zeroPoint``:
+    The quantized value representing zero)doc";
+
 static const char *__doc_kp_Memory_size =
 R"doc(Returns the size/magnitude of the Tensor/Image, which will be the
 total number of elements across all dimensions
@@ -93,6 +93,15 @@ PYBIND11_MODULE(kp, m)
       .value("uchar",
              kp::Memory::DataTypes::eUnsignedChar,
              DOC(kp, Memory, DataTypes, eUnsignedChar))
+      .value("half",
+             kp::Memory::DataTypes::eHalf,
+             DOC(kp, Memory, DataTypes, eHalf))
+      .value("bfloat16",
+             kp::Memory::DataTypes::eBFloat16,
+             DOC(kp, Memory, DataTypes, eBFloat16))
+      .value("qint8",
+             kp::Memory::DataTypes::eQInt8,
+             DOC(kp, Memory, DataTypes, eQInt8))
       .export_values();
 
     py::enum_<kp::Memory::MemoryTypes>(m, "MemoryTypes")
@@ -209,6 +218,18 @@ PYBIND11_MODULE(kp, m)
            static_cast<kp::Memory::DataTypes (kp::Memory::*)()>(
              &kp::Memory::dataType),
            DOC(kp, Memory, dataType))
+      .def("float_data",
+           &kp::Memory::floatVector,
+           DOC(kp, Memory, floatVector))
+      .def("set_float_data",
+           &kp::Memory::setFloatData,
+           DOC(kp, Memory, setFloatData),
+           py::arg("data"))
+      .def("set_quantization",
+           &kp::Memory::setQuantization,
+           DOC(kp, Memory, setQuantization),
+           py::arg("scale"),
+           py::arg("zero_point"))
       .def("is_init", &kp::Tensor::isInit, DOC(kp, Tensor, isInit))
       .def("destroy", &kp::Tensor::destroy, DOC(kp, Tensor, destroy));
     py::class_<kp::Image, std::shared_ptr<kp::Image>, kp::Memory>(
@@ -339,7 +360,8 @@ PYBIND11_MODULE(kp, m)
            &kp::Manager::sequence,
            DOC(kp, Manager, sequence),
            py::arg("queue_index") = 0,
-           py::arg("total_timestamps") = 0)
+           py::arg("total_timestamps") = 0,
+           py::arg("total_pipeline_statistics") = 0)
       .def(
         "tensor",
         [np](kp::Manager& self,
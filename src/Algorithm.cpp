@@ -1,5 +1,6 @@
 // SPDX-License-Identifier: Apache-2.0
 #include <fstream>
+#include <map>
 
 #include "kompute/Algorithm.hpp"
 #include "kompute/Image.hpp"
@@ -21,6 +22,22 @@ Algorithm::isInit()
            this->mDescriptorSetLayout && this->mShaderModule;
 }
 
+bool
+Algorithm::isPipelineReady() const
+{
+    return !this->mPipelineReady.valid() ||
+           this->mPipelineReady.wait_for(std::chrono::seconds(0)) ==
+             std::future_status::ready;
+}
+
+void
+Algorithm::waitForPipeline()
+{
+    if (this->mPipelineReady.valid()) {
+        this->mPipelineReady.get();
+    }
+}
+
 void
 Algorithm::destroy()
 {
@@ -38,6 +55,13 @@ Algorithm::destroy()
         return;
     }
 
+    // The resources of a pipeline still compiling can't be destroyed until
+    // it finishes, its errors are not relevant anymore at this point
+    if (this->mPipelineReady.valid()) {
+        this->mPipelineReady.wait();
+        this->mPipelineReady = std::shared_future<void>();
+    }
+
     if (this->mFreePipeline && this->mPipeline) {
         KP_LOG_DEBUG("Kompute Algorithm Destroying pipeline");
         if (!this->mPipeline) {
@@ -128,35 +152,22 @@ Algorithm::destroy()
 void
 Algorithm::createParameters()
 {
-    uint32_t numImages = 0;
-    uint32_t numTensors = 0;
-
     KP_LOG_DEBUG("Kompute Algorithm createParameters started");
 
+    // The pool provides as many descriptors of each type as are bound, as
+    // images can be storage images, sampled images or combined samplers
+    std::map<vk::DescriptorType, uint32_t> descriptorCounts;
     for (const std::shared_ptr<Memory>& mem : this->mMemObjects) {
-        if (mem->type() == Memory::Type::eImage) {
-            numImages++;
-        } else {
-            numTensors++;
-        }
+        descriptorCounts[mem->getDescriptorType()]++;
     }
 
     std::vector<vk::DescriptorPoolSize> descriptorPoolSizes;
-
-    if (numTensors > 0) {
-        descriptorPoolSizes.push_back(vk::DescriptorPoolSize(
-          vk::DescriptorType::eStorageBuffer,
-          static_cast<uint32_t>(numTensors) // Descriptor count
-          ));
+    for (const std::pair<const vk::DescriptorType, uint32_t>& count :
+         descriptorCounts) {
+        descriptorPoolSizes.push_back(
+          vk::DescriptorPoolSize(count.first, count.second));
     }
 
-    if (numImages > 0) {
-        descriptorPoolSizes.push_back(vk::DescriptorPoolSize(
-          vk::DescriptorType::eStorageImage,
-          static_cast<uint32_t>(numImages) // Descriptor count
-          ));
-    };
-
     vk::DescriptorPoolCreateInfo descriptorPoolInfo(
       vk::DescriptorPoolCreateFlags(),
       1, // Max sets
@@ -201,7 +212,49 @@ Algorithm::createParameters()
                                           this->mDescriptorSet.get());
     this->mFreeDescriptorSet = true;
 
+    // Descriptors can only be written for buffers with memory, which
+    // transient tensors only get once their sequence is planned and evicted
+    // tensors once they are used again
+    this->mDescriptorSetsPending = false;
+    for (const std::shared_ptr<Memory>& mem : this->mMemObjects) {
+        if (mem->type() == Memory::Type::eTensor &&
+            !std::static_pointer_cast<Tensor>(mem)->isMemoryBound()) {
+            this->mDescriptorSetsPending = true;
+        }
+    }
+
+    if (this->mDescriptorSetsPending) {
+        KP_LOG_DEBUG("Kompute Algorithm deferring descriptor set updates");
+    } else {
+        this->updateDescriptorSets();
+    }
+
+    KP_LOG_DEBUG("Kompute Algorithm successfully run init");
+}
+
+void
+Algorithm::updateDescriptorSets()
+{
     KP_LOG_DEBUG("Kompute Algorithm updating descriptor sets");
+
+    for (size_t i = 0; i < this->mMemObjects.size(); i++) {
+        const std::shared_ptr<Memory>& mem = this->mMemObjects[i];
+        if (mem->type() == Memory::Type::eTensor &&
+            !std::static_pointer_cast<Tensor>(mem)->isMemoryBound()) {
+            throw std::runtime_error("Kompute Algorithm tensor at binding " +
+                                     std::to_string(i) +
+                                     " is used without memory bound");
+        }
+    }
+
+    this->mDescriptorVersions.clear();
+    for (const std::shared_ptr<Memory>& mem : this->mMemObjects) {
+        this->mDescriptorVersions.push_back(
+          mem->type() == Memory::Type::eTensor
+            ? std::static_pointer_cast<Tensor>(mem)->getPrimaryBufferVersion()
+            : 0);
+    }
+
     for (size_t i = 0; i < this->mMemObjects.size(); i++) {
         std::vector<vk::WriteDescriptorSet> computeWriteDescriptorSets;
 
@@ -215,7 +268,7 @@ Algorithm::createParameters()
                                             nullptr);
     }
 
-    KP_LOG_DEBUG("Kompute Algorithm successfully run init");
+    this->mDescriptorSetsPending = false;
 }
 
 void
@@ -265,23 +318,11 @@ Algorithm::createPipeline()
       &pipelineLayoutInfo, nullptr, this->mPipelineLayout.get());
     this->mFreePipelineLayout = true;
 
-    std::vector<vk::SpecializationMapEntry> specializationEntries;
-
-    for (uint32_t i = 0; i < this->mSpecializationConstantsSize; i++) {
-        vk::SpecializationMapEntry specializationEntry(
-          static_cast<uint32_t>(i),
-          static_cast<uint32_t>(
-            this->mSpecializationConstantsDataTypeMemorySize * i),
-          this->mSpecializationConstantsDataTypeMemorySize);
-
-        specializationEntries.push_back(specializationEntry);
-    }
-
-    // This passes ownership of the memory so we remove ownership from
-    // specialization container by using "transferDataOwnership"
+    // The map entries are built in rebuild from the constants layout, with
+    // one entry per constant id
     vk::SpecializationInfo specializationInfo(
-      static_cast<uint32_t>(specializationEntries.size()),
-      specializationEntries.data(),
+      static_cast<uint32_t>(this->mSpecializationEntries.size()),
+      this->mSpecializationEntries.data(),
       this->mSpecializationConstantsDataTypeMemorySize *
         this->mSpecializationConstantsSize,
       this->mSpecializationConstantsData);
@@ -338,6 +379,22 @@ Algorithm::createPipeline()
 void
 Algorithm::recordBindCore(const vk::CommandBuffer& commandBuffer)
 {
+    this->waitForPipeline();
+
+    // Tensors restored after an eviction have a new buffer
+    for (size_t i = 0; i < this->mDescriptorVersions.size(); i++) {
+        const std::shared_ptr<Memory>& mem = this->mMemObjects[i];
+        if (mem->type() == Memory::Type::eTensor &&
+            std::static_pointer_cast<Tensor>(mem)->getPrimaryBufferVersion() !=
+              this->mDescriptorVersions[i]) {
+            this->mDescriptorSetsPending = true;
+        }
+    }
+
+    if (this->mDescriptorSetsPending) {
+        this->updateDescriptorSets();
+    }
+
     KP_LOG_DEBUG("Kompute Algorithm binding pipeline");
 
     commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute,
@@ -356,6 +413,8 @@ Algorithm::recordBindCore(const vk::CommandBuffer& commandBuffer)
 void
 Algorithm::recordBindPush(const vk::CommandBuffer& commandBuffer)
 {
+    this->waitForPipeline();
+
     if (this->mPushConstantsSize) {
         KP_LOG_DEBUG("Kompute Algorithm binding push constants memory size: {}",
                      this->mPushConstantsSize *
@@ -379,6 +438,17 @@ Algorithm::recordDispatch(const vk::CommandBuffer& commandBuffer)
       this->mWorkgroup[0], this->mWorkgroup[1], this->mWorkgroup[2]);
 }
 
+void
+Algorithm::recordDispatchIndirect(const vk::CommandBuffer& commandBuffer,
+                                  const vk::Buffer& buffer,
+                                  vk::DeviceSize offset)
+{
+    KP_LOG_DEBUG("Kompute Algorithm recording indirect dispatch at offset {}",
+                 offset);
+
+    commandBuffer.dispatchIndirect(buffer, offset);
+}
+
 void
 Algorithm::setWorkgroup(const Workgroup& workgroup, uint32_t minSize)
 {
@@ -415,4 +485,108 @@ Algorithm::getMemObjects()
     return this->mMemObjects;
 }
 
+uint64_t
+Algorithm::getSpirvHash() const
+{
+    return Algorithm::hashSpirv(this->mSpirv);
+}
+
+uint64_t
+Algorithm::hashSpirv(const std::vector<uint32_t>& spirv)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint32_t word : spirv) {
+        for (uint32_t i = 0; i < 4; i++) {
+            hash ^= (word >> (i * 8)) & 0xFF;
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+std::shared_ptr<ShaderReflection>
+Algorithm::getReflection()
+{
+    return this->mReflection;
+}
+
+std::shared_ptr<ShaderReflection>
+Algorithm::reflectSpirv(const std::vector<uint32_t>& spirv,
+                        const std::vector<std::shared_ptr<Memory>>& memObjects,
+                        uint32_t pushConstantsSize) const
+{
+    std::shared_ptr<ShaderReflection> reflection =
+      std::make_shared<ShaderReflection>(spirv);
+
+    for (const ShaderReflection::Binding& binding :
+         reflection->getBindings()) {
+        if (binding.set != 0) {
+            throw std::runtime_error(fmt::format(
+              "Kompute Algorithm shader binding {} ({}) uses descriptor set "
+              "{} but only set 0 is supported",
+              binding.binding,
+              binding.name,
+              binding.set));
+        }
+        if (binding.binding >= memObjects.size()) {
+            throw std::runtime_error(fmt::format(
+              "Kompute Algorithm shader expects binding {} ({}) but only {} "
+              "memory objects were provided",
+              binding.binding,
+              binding.name,
+              memObjects.size()));
+        }
+        vk::DescriptorType descriptorType =
+          memObjects[binding.binding]->getDescriptorType();
+        if (binding.descriptorType != descriptorType) {
+            throw std::runtime_error(fmt::format(
+              "Kompute Algorithm shader binding {} ({}) expects descriptor "
+              "type {} but the memory object provided is of type {}",
+              binding.binding,
+              binding.name,
+              vk::to_string(binding.descriptorType),
+              vk::to_string(descriptorType)));
+        }
+    }
+
+    // The range of the pipeline layout has to cover the whole block
+    if (pushConstantsSize < reflection->getPushConstantsSize()) {
+        throw std::runtime_error(fmt::format(
+          "Kompute Algorithm shader push constant block is {} bytes but only "
+          "{} bytes were provided",
+          reflection->getPushConstantsSize(),
+          pushConstantsSize));
+    }
+
+    return reflection;
+}
+
+uint32_t
+Algorithm::defaultWorkgroupSize()
+{
+    uint32_t totalSize =
+      this->mMemObjects.size() ? this->mMemObjects[0]->size() : 1;
+
+    // The local size can be set through 32 bit specialization constants
+    std::map<uint32_t, uint32_t> specializationConstants;
+    for (const vk::SpecializationMapEntry& entry :
+         this->mSpecializationEntries) {
+        if (entry.size == sizeof(uint32_t)) {
+            uint32_t value;
+            memcpy(&value,
+                   (uint8_t*)this->mSpecializationConstantsData + entry.offset,
+                   sizeof(uint32_t));
+            specializationConstants[entry.constantID] = value;
+        }
+    }
+
+    uint32_t localSizeX =
+      this->mReflection->getLocalSize(specializationConstants)[0];
+    if (!localSizeX) {
+        localSizeX = 1;
+    }
+
+    return (totalSize + localSizeX - 1) / localSizeX;
+}
+
 }
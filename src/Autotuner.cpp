@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/Autotuner.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace kp {
+
+Autotuner::Autotuner(Manager& manager,
+                     const std::string& cachePath,
+                     const std::vector<uint32_t>& candidates,
+                     uint32_t iterations)
+  : mManager(manager)
+{
+    KP_LOG_DEBUG("Kompute Autotuner constructor with cache path: {}",
+                 cachePath);
+
+    this->mCachePath = cachePath;
+    this->mCandidates = candidates;
+    this->mIterations = iterations > 0 ? iterations : 1;
+
+    this->loadCache();
+}
+
+void
+Autotuner::clearCache()
+{
+    this->mCache.clear();
+    this->saveCache();
+}
+
+std::vector<uint32_t>
+Autotuner::validCandidates()
+{
+    vk::PhysicalDeviceLimits limits =
+      this->mManager.getDeviceProperties().limits;
+
+    std::vector<uint32_t> candidates;
+    for (uint32_t localSize : this->mCandidates) {
+        if (localSize > 0 && localSize <= limits.maxComputeWorkGroupSize[0] &&
+            localSize <= limits.maxComputeWorkGroupInvocations) {
+            candidates.push_back(localSize);
+        } else {
+            KP_LOG_DEBUG("Kompute Autotuner skipping local size {} as it "
+                         "exceeds the device limits",
+                         localSize);
+        }
+    }
+    return candidates;
+}
+
+std::string
+Autotuner::cacheKey(uint64_t spirvHash)
+{
+    std::ostringstream key;
+    key << std::hex << std::setfill('0');
+    for (uint8_t byte : this->mManager.getDeviceUUID()) {
+        key << std::setw(2) << (uint32_t)byte;
+    }
+    key << ":" << std::setw(16) << spirvHash;
+    return key.str();
+}
+
+double
+Autotuner::timeDispatch(std::shared_ptr<Algorithm> algorithm)
+{
+    vk::PhysicalDeviceLimits limits =
+      this->mManager.getDeviceProperties().limits;
+    bool useTimestamps = limits.timestampComputeAndGraphics;
+
+    // Falls back to host timings on devices without compute timestamps
+    std::shared_ptr<Sequence> sq =
+      this->mManager.sequence(0, useTimestamps ? 1 : 0);
+    sq->record<OpAlgoDispatch>(algorithm);
+
+    // Warm up run so the first dispatch overheads are not measured
+    sq->eval();
+
+    double bestUs = std::numeric_limits<double>::max();
+    for (uint32_t i = 0; i < this->mIterations; i++) {
+        std::chrono::steady_clock::time_point start =
+          std::chrono::steady_clock::now();
+        sq->eval();
+        std::chrono::steady_clock::time_point end =
+          std::chrono::steady_clock::now();
+
+        double timeUs = 0;
+        if (useTimestamps) {
+            std::vector<uint64_t> timestamps = sq->getTimestamps();
+            timeUs = (timestamps[1] - timestamps[0]) * limits.timestampPeriod /
+                     1000.0;
+        } else {
+            timeUs =
+              std::chrono::duration<double, std::micro>(end - start).count();
+        }
+        bestUs = std::min(bestUs, timeUs);
+    }
+
+    sq->destroy();
+
+    return bestUs;
+}
+
+void
+Autotuner::loadCache()
+{
+    if (this->mCachePath.empty()) {
+        return;
+    }
+
+    std::ifstream file(this->mCachePath);
+    if (!file.is_open()) {
+        KP_LOG_DEBUG("Kompute Autotuner no cache found at {}",
+                     this->mCachePath);
+        return;
+    }
+
+    std::string key;
+    uint32_t localSize;
+    while (file >> key >> localSize) {
+        this->mCache[key] = localSize;
+    }
+
+    KP_LOG_DEBUG("Kompute Autotuner loaded {} cached results from {}",
+                 this->mCache.size(),
+                 this->mCachePath);
+}
+
+void
+Autotuner::saveCache()
+{
+    if (this->mCachePath.empty()) {
+        return;
+    }
+
+    std::ofstream file(this->mCachePath, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        KP_LOG_WARN("Kompute Autotuner could not write cache to {}",
+                    this->mCachePath);
+        return;
+    }
+
+    for (const auto& entry : this->mCache) {
+        file << entry.first << " " << entry.second << "\n";
+    }
+}
+
+Workgroup
+Autotuner::workgroupFor(uint32_t totalInvocations, uint32_t localSize)
+{
+    return { (totalInvocations + localSize - 1) / localSize, 1, 1 };
+}
+
+std::vector<uint32_t>
+Autotuner::withLocalSize(const std::vector<uint32_t>& specializationConstants,
+                         uint32_t localSizeSpecId,
+                         uint32_t localSize)
+{
+    std::vector<uint32_t> constants = specializationConstants;
+    if (constants.size() <= localSizeSpecId) {
+        constants.resize(localSizeSpecId + 1, 0);
+    }
+    constants[localSizeSpecId] = localSize;
+    return constants;
+}
+
+}
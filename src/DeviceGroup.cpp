@@ -0,0 +1,284 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/DeviceGroup.hpp"
+#include "kompute/DeviceSelector.hpp"
+
+#include <algorithm>
+
+namespace kp {
+
+// Devices that are not GPUs, such as software rasterisers
+static bool
+isCpuDevice(const vk::PhysicalDevice& physicalDevice)
+{
+    vk::PhysicalDeviceType type = physicalDevice.getProperties().deviceType;
+    return type == vk::PhysicalDeviceType::eCpu ||
+           type == vk::PhysicalDeviceType::eOther;
+}
+
+DeviceGroup::DeviceGroup(uint32_t maxDevices,
+                         const std::vector<std::string>& desiredExtensions)
+{
+    KP_LOG_DEBUG("Kompute DeviceGroup constructor with max devices {}",
+                 maxDevices);
+
+    // The manager of the first device lists the others, and is kept if the
+    // first device is used
+    std::shared_ptr<Manager> firstManager = std::make_shared<Manager>(
+      0, std::vector<uint32_t>(), desiredExtensions);
+    std::vector<vk::PhysicalDevice> physicalDevices =
+      firstManager->listDevices();
+
+    std::vector<int64_t> scores;
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i < physicalDevices.size(); i++) {
+        scores.push_back(
+          DeviceSelector::scoreDevice(physicalDevices[i], DevicePolicy()));
+        if (scores[i] >= 0) {
+            indices.push_back(i);
+        }
+    }
+    std::stable_sort(
+      indices.begin(), indices.end(), [&](uint32_t a, uint32_t b) {
+          return scores[a] > scores[b];
+      });
+
+    if (indices.empty()) {
+        throw std::runtime_error(
+          "Kompute DeviceGroup found no device with a compute queue");
+    }
+
+    if (!isCpuDevice(physicalDevices[indices[0]])) {
+        indices.erase(std::remove_if(indices.begin(),
+                                     indices.end(),
+                                     [&](uint32_t index) {
+                                         return isCpuDevice(
+                                           physicalDevices[index]);
+                                     }),
+                      indices.end());
+    }
+    if (maxDevices > 0 && indices.size() > maxDevices) {
+        indices.resize(maxDevices);
+    }
+
+    this->createManagers(indices, desiredExtensions, firstManager);
+}
+
+DeviceGroup::DeviceGroup(const std::vector<uint32_t>& physicalDeviceIndices,
+                         const std::vector<std::string>& desiredExtensions)
+{
+    KP_LOG_DEBUG("Kompute DeviceGroup constructor with {} devices",
+                 physicalDeviceIndices.size());
+
+    if (physicalDeviceIndices.empty()) {
+        throw std::runtime_error(
+          "Kompute DeviceGroup requires at least one device");
+    }
+
+    this->createManagers(physicalDeviceIndices, desiredExtensions);
+}
+
+uint32_t
+DeviceGroup::size() const
+{
+    return this->mManagers.size();
+}
+
+std::shared_ptr<Manager>
+DeviceGroup::getManager(uint32_t index) const
+{
+    return this->mManagers.at(index);
+}
+
+std::vector<std::shared_ptr<Algorithm>>
+DeviceGroup::algorithm(
+  const std::vector<std::shared_ptr<ShardedTensor>>& tensors,
+  const std::vector<uint32_t>& spirv,
+  const std::vector<Workgroup>& workgroups,
+  const std::vector<float>& specializationConstants,
+  const std::vector<float>& pushConstants)
+{
+    if (tensors.empty()) {
+        throw std::runtime_error(
+          "Kompute DeviceGroup algorithm requires at least one tensor");
+    }
+
+    // The default workgroup is derived from the size of the first tensor,
+    // which would be the whole tensor on every device if it was replicated
+    if (tensors[0]->isReplicated()) {
+        throw std::runtime_error(
+          "Kompute DeviceGroup algorithm first tensor cannot be replicated");
+    }
+
+    // The sharded tensors set the number of shards, and replicated tensors
+    // are available on every device
+    uint32_t shardCount = this->mManagers.size();
+    std::shared_ptr<ShardedTensor> sharded = nullptr;
+    for (const std::shared_ptr<ShardedTensor>& tensor : tensors) {
+        if (tensor->isReplicated()) {
+            continue;
+        }
+        if (!sharded) {
+            sharded = tensor;
+            shardCount = tensor->shardCount();
+        } else if (tensor->getRows() != sharded->getRows()) {
+            throw std::runtime_error(fmt::format(
+              "Kompute DeviceGroup sharded tensors have {} and {} rows, so "
+              "their shards do not match",
+              sharded->getRows(),
+              tensor->getRows()));
+        }
+    }
+
+    if (!workgroups.empty() && workgroups.size() != shardCount) {
+        throw std::runtime_error(fmt::format(
+          "Kompute DeviceGroup algorithm given {} workgroups for {} shards",
+          workgroups.size(),
+          shardCount));
+    }
+
+    std::vector<std::shared_ptr<Algorithm>> algorithms;
+    for (uint32_t i = 0; i < shardCount; i++) {
+        algorithms.push_back(this->mManagers[i]->algorithmAsync(
+          DeviceGroup::getShards(tensors, i),
+          spirv,
+          workgroups.empty() ? Workgroup() : workgroups[i],
+          specializationConstants,
+          pushConstants));
+    }
+    return algorithms;
+}
+
+void
+DeviceGroup::syncDevice(
+  const std::vector<std::shared_ptr<ShardedTensor>>& tensors)
+{
+    std::vector<bool> recorded(this->mManagers.size(), false);
+    for (uint32_t i = 0; i < this->mManagers.size(); i++) {
+        std::vector<std::shared_ptr<Memory>> shards =
+          DeviceGroup::getShards(tensors, i);
+        if (shards.empty()) {
+            continue;
+        }
+        this->mSequences[i]->clear();
+        this->mSequences[i]->record<OpSyncDevice>(shards);
+        recorded[i] = true;
+    }
+    this->evalSequences(recorded);
+}
+
+void
+DeviceGroup::syncLocal(
+  const std::vector<std::shared_ptr<ShardedTensor>>& tensors)
+{
+    std::vector<bool> recorded(this->mManagers.size(), false);
+    for (uint32_t i = 0; i < this->mManagers.size(); i++) {
+        std::vector<std::shared_ptr<Memory>> shards =
+          DeviceGroup::getShards(tensors, i);
+        if (shards.empty()) {
+            continue;
+        }
+        this->mSequences[i]->clear();
+        this->mSequences[i]->record<OpSyncLocal>(shards);
+        recorded[i] = true;
+    }
+    this->evalSequences(recorded);
+}
+
+void
+DeviceGroup::eval(const std::vector<std::shared_ptr<Algorithm>>& algorithms)
+{
+    if (algorithms.size() > this->mManagers.size()) {
+        throw std::runtime_error(
+          "Kompute DeviceGroup eval called with more algorithms than devices");
+    }
+
+    std::vector<bool> recorded(this->mManagers.size(), false);
+    for (uint32_t i = 0; i < algorithms.size(); i++) {
+        if (!algorithms[i]) {
+            continue;
+        }
+        this->mSequences[i]->clear();
+        this->mSequences[i]->record<OpAlgoDispatch>(algorithms[i]);
+        recorded[i] = true;
+    }
+    this->evalSequences(recorded);
+}
+
+std::vector<uint32_t>
+DeviceGroup::splitRows(uint32_t rows) const
+{
+    if (rows == 0) {
+        throw std::runtime_error(
+          "Kompute DeviceGroup cannot shard a tensor without rows");
+    }
+
+    // The first shards take one more row when they do not divide evenly
+    uint32_t shardCount =
+      std::min(rows, static_cast<uint32_t>(this->mManagers.size()));
+    uint32_t shardRows = rows / shardCount;
+    uint32_t remainder = rows % shardCount;
+
+    std::vector<uint32_t> firstRows;
+    uint32_t firstRow = 0;
+    for (uint32_t i = 0; i < shardCount; i++) {
+        firstRows.push_back(firstRow);
+        firstRow += shardRows + (i < remainder ? 1 : 0);
+    }
+    return firstRows;
+}
+
+void
+DeviceGroup::evalSequences(const std::vector<bool>& recorded)
+{
+    for (uint32_t i = 0; i < recorded.size(); i++) {
+        if (recorded[i]) {
+            this->mSequences[i]->evalAsync();
+        }
+    }
+    for (uint32_t i = 0; i < recorded.size(); i++) {
+        if (recorded[i]) {
+            this->mSequences[i]->evalAwait();
+        }
+    }
+}
+
+std::vector<std::shared_ptr<Memory>>
+DeviceGroup::getShards(
+  const std::vector<std::shared_ptr<ShardedTensor>>& tensors,
+  uint32_t index)
+{
+    std::vector<std::shared_ptr<Memory>> shards;
+    for (const std::shared_ptr<ShardedTensor>& tensor : tensors) {
+        if (index < tensor->shardCount()) {
+            shards.push_back(tensor->getShard(index));
+        }
+    }
+    return shards;
+}
+
+void
+DeviceGroup::createManagers(const std::vector<uint32_t>& physicalDeviceIndices,
+                            const std::vector<std::string>& desiredExtensions,
+                            std::shared_ptr<Manager> firstManager)
+{
+    for (uint32_t index : physicalDeviceIndices) {
+        std::shared_ptr<Manager> manager = nullptr;
+        if (index == 0 && firstManager) {
+            manager = firstManager;
+            firstManager = nullptr;
+        } else {
+            manager = std::make_shared<Manager>(
+              index, std::vector<uint32_t>(), desiredExtensions);
+        }
+
+        KP_LOG_INFO("Kompute DeviceGroup using device {}: {}",
+                    index,
+                    manager->getDeviceProperties().deviceName.data());
+
+        this->mSequences.push_back(manager->sequence());
+        this->mManagers.push_back(manager);
+    }
+}
+
+}
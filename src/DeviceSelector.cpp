@@ -0,0 +1,223 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/DeviceSelector.hpp"
+#include "kompute/logger/Logger.hpp"
+
+#include <algorithm>
+#include <set>
+
+namespace kp {
+
+// Rank of the type of a device, with the preferred type above all others
+static int64_t
+rankDeviceType(vk::PhysicalDeviceType type, vk::PhysicalDeviceType preferred)
+{
+    if (type == preferred) {
+        return 5;
+    }
+    switch (type) {
+        case vk::PhysicalDeviceType::eDiscreteGpu:
+            return 4;
+        case vk::PhysicalDeviceType::eIntegratedGpu:
+            return 3;
+        case vk::PhysicalDeviceType::eVirtualGpu:
+            return 2;
+        case vk::PhysicalDeviceType::eCpu:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// Whether the policy allows and prefers a family without graphics
+static bool
+prefersAsyncCompute(const DevicePolicy& policy)
+{
+    return policy.preferAsyncCompute &&
+           !(policy.requiredQueueFlags & vk::QueueFlagBits::eGraphics);
+}
+
+int64_t
+DeviceSelector::scoreDevice(const vk::PhysicalDevice& physicalDevice,
+                            const DevicePolicy& policy)
+{
+    vk::PhysicalDeviceProperties properties = physicalDevice.getProperties();
+
+    if (!DeviceSelector::supportsFeatures(physicalDevice.getFeatures(),
+                                          policy.requiredFeatures)) {
+        KP_LOG_DEBUG("Kompute DeviceSelector device {} misses features",
+                     properties.deviceName.data());
+        return -1;
+    }
+
+    std::set<std::string> extensionNames;
+    for (const vk::ExtensionProperties& extension :
+         physicalDevice.enumerateDeviceExtensionProperties()) {
+        extensionNames.insert(extension.extensionName.data());
+    }
+    for (const std::string& extension : policy.requiredExtensions) {
+        if (!extensionNames.count(extension)) {
+            KP_LOG_DEBUG("Kompute DeviceSelector device {} misses {}",
+                         properties.deviceName.data(),
+                         extension);
+            return -1;
+        }
+    }
+
+    if (DeviceSelector::getDeviceMemorySize(physicalDevice) <
+        policy.minDeviceMemory) {
+        KP_LOG_DEBUG("Kompute DeviceSelector device {} has not enough memory",
+                     properties.deviceName.data());
+        return -1;
+    }
+
+    bool queueFamilySupported = false;
+    bool asyncComputeFamily = false;
+    for (const vk::QueueFamilyProperties& family :
+         physicalDevice.getQueueFamilyProperties()) {
+        if ((family.queueFlags & policy.requiredQueueFlags) ==
+            policy.requiredQueueFlags) {
+            queueFamilySupported = true;
+            if (!(family.queueFlags & vk::QueueFlagBits::eGraphics)) {
+                asyncComputeFamily = true;
+            }
+        }
+    }
+    if (!queueFamilySupported) {
+        KP_LOG_DEBUG("Kompute DeviceSelector device {} has no queue family "
+                     "with the required flags",
+                     properties.deviceName.data());
+        return -1;
+    }
+
+    int64_t score =
+      rankDeviceType(properties.deviceType, policy.preferredType) * 4;
+    if (asyncComputeFamily && prefersAsyncCompute(policy)) {
+        score += 2;
+    }
+    if (DeviceSelector::findTransferQueueFamily(physicalDevice) >= 0) {
+        score += 1;
+    }
+    return score;
+}
+
+uint32_t
+DeviceSelector::selectDevice(
+  const std::vector<vk::PhysicalDevice>& physicalDevices,
+  const DevicePolicy& policy)
+{
+    int64_t bestScore = -1;
+    vk::DeviceSize bestMemorySize = 0;
+    uint32_t bestIndex = 0;
+
+    for (uint32_t i = 0; i < physicalDevices.size(); i++) {
+        int64_t score =
+          DeviceSelector::scoreDevice(physicalDevices[i], policy);
+        vk::DeviceSize memorySize =
+          DeviceSelector::getDeviceMemorySize(physicalDevices[i]);
+
+        KP_LOG_DEBUG("Kompute DeviceSelector device index {} {} score {}",
+                     i,
+                     physicalDevices[i].getProperties().deviceName.data(),
+                     score);
+
+        if (score > bestScore ||
+            (score == bestScore && score >= 0 && memorySize > bestMemorySize)) {
+            bestScore = score;
+            bestMemorySize = memorySize;
+            bestIndex = i;
+        }
+    }
+
+    if (bestScore < 0) {
+        throw std::runtime_error(
+          "Kompute DeviceSelector found no device meeting the policy");
+    }
+
+    return bestIndex;
+}
+
+uint32_t
+DeviceSelector::selectQueueFamily(const vk::PhysicalDevice& physicalDevice,
+                                  const DevicePolicy& policy)
+{
+    std::vector<vk::QueueFamilyProperties> families =
+      physicalDevice.getQueueFamilyProperties();
+
+    int64_t selected = -1;
+    for (uint32_t i = 0; i < families.size(); i++) {
+        if ((families[i].queueFlags & policy.requiredQueueFlags) !=
+            policy.requiredQueueFlags) {
+            continue;
+        }
+        if (selected < 0) {
+            selected = i;
+        }
+        if (prefersAsyncCompute(policy) &&
+            !(families[i].queueFlags & vk::QueueFlagBits::eGraphics)) {
+            selected = i;
+            break;
+        }
+    }
+
+    if (selected < 0) {
+        throw std::runtime_error("Compute queue is not supported");
+    }
+
+    return selected;
+}
+
+int64_t
+DeviceSelector::findTransferQueueFamily(
+  const vk::PhysicalDevice& physicalDevice)
+{
+    std::vector<vk::QueueFamilyProperties> families =
+      physicalDevice.getQueueFamilyProperties();
+
+    for (uint32_t i = 0; i < families.size(); i++) {
+        vk::QueueFlags flags = families[i].queueFlags;
+        if ((flags & vk::QueueFlagBits::eTransfer) &&
+            !(flags & vk::QueueFlagBits::eCompute) &&
+            !(flags & vk::QueueFlagBits::eGraphics)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+vk::DeviceSize
+DeviceSelector::getDeviceMemorySize(const vk::PhysicalDevice& physicalDevice)
+{
+    vk::PhysicalDeviceMemoryProperties memoryProperties =
+      physicalDevice.getMemoryProperties();
+
+    vk::DeviceSize memorySize = 0;
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++) {
+        const vk::MemoryHeap& heap = memoryProperties.memoryHeaps[i];
+        if (heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal) {
+            memorySize = std::max(memorySize, heap.size);
+        }
+    }
+    return memorySize;
+}
+
+bool
+DeviceSelector::supportsFeatures(const vk::PhysicalDeviceFeatures& supported,
+                                 const vk::PhysicalDeviceFeatures& required)
+{
+    // The features structure only holds booleans, so it is compared as such
+    const vk::Bool32* supportedFlags =
+      reinterpret_cast<const vk::Bool32*>(&supported);
+    const vk::Bool32* requiredFlags =
+      reinterpret_cast<const vk::Bool32*>(&required);
+    size_t count = sizeof(vk::PhysicalDeviceFeatures) / sizeof(vk::Bool32);
+
+    for (size_t i = 0; i < count; i++) {
+        if (requiredFlags[i] && !supportedFlags[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
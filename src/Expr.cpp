@@ -0,0 +1,402 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/Expr.hpp"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#if KOMPUTE_OPT_USE_SHADERC
+#include "kompute/ShaderCompiler.hpp"
+#endif
+
+namespace kp {
+namespace expr {
+
+// Clamped to the device limits, as only 128 invocations are guaranteed
+static const uint32_t DEFAULT_LOCAL_SIZE = 256;
+
+// The cache is keyed by the generated source, which only depends on the
+// structure of the expression
+static std::mutex cacheMutex;
+static std::unordered_map<std::string, std::vector<uint32_t>> cache;
+
+Expr::Expr(const std::shared_ptr<Tensor>& tensor)
+{
+    if (!tensor || tensor->dataType() != Memory::DataTypes::eFloat) {
+        throw std::runtime_error(
+          "Kompute expr only supports float tensors in expressions");
+    }
+    std::shared_ptr<Node> node = std::make_shared<Node>();
+    node->operation = Operation::eTensor;
+    node->tensor = tensor;
+    this->mNode = node;
+}
+
+Expr::Expr(float value)
+{
+    std::shared_ptr<Node> node = std::make_shared<Node>();
+    node->operation = Operation::eConstant;
+    node->value = value;
+    this->mNode = node;
+}
+
+Expr::Expr(Operation operation, const std::vector<Expr>& operands)
+{
+    if (operation == Operation::eTensor ||
+        operation == Operation::eConstant) {
+        throw std::runtime_error(
+          "Kompute expr tensors and constants have their own constructors");
+    }
+    std::shared_ptr<Node> node = std::make_shared<Node>();
+    node->operation = operation;
+    for (const Expr& operand : operands) {
+        node->operands.push_back(operand.node());
+    }
+    this->mNode = node;
+}
+
+const std::shared_ptr<const Expr::Node>&
+Expr::node() const
+{
+    return this->mNode;
+}
+
+Expr
+operator+(const Expr& a, const Expr& b)
+{
+    return Expr(Expr::Operation::eAdd, { a, b });
+}
+
+Expr
+operator-(const Expr& a, const Expr& b)
+{
+    return Expr(Expr::Operation::eSub, { a, b });
+}
+
+Expr
+operator*(const Expr& a, const Expr& b)
+{
+    return Expr(Expr::Operation::eMul, { a, b });
+}
+
+Expr
+operator/(const Expr& a, const Expr& b)
+{
+    return Expr(Expr::Operation::eDiv, { a, b });
+}
+
+Expr
+operator-(const Expr& a)
+{
+    return Expr(Expr::Operation::eNeg, { a });
+}
+
+Expr
+min(const Expr& a, const Expr& b)
+{
+    return Expr(Expr::Operation::eMin, { a, b });
+}
+
+Expr
+max(const Expr& a, const Expr& b)
+{
+    return Expr(Expr::Operation::eMax, { a, b });
+}
+
+Expr
+abs(const Expr& a)
+{
+    return Expr(Expr::Operation::eAbs, { a });
+}
+
+Expr
+exp(const Expr& a)
+{
+    return Expr(Expr::Operation::eExp, { a });
+}
+
+Expr
+log(const Expr& a)
+{
+    return Expr(Expr::Operation::eLog, { a });
+}
+
+Expr
+sqrt(const Expr& a)
+{
+    return Expr(Expr::Operation::eSqrt, { a });
+}
+
+Expr
+tanh(const Expr& a)
+{
+    return Expr(Expr::Operation::eTanh, { a });
+}
+
+Expr
+relu(const Expr& a)
+{
+    return Expr(Expr::Operation::eRelu, { a });
+}
+
+Expr
+sigmoid(const Expr& a)
+{
+    return Expr(Expr::Operation::eSigmoid, { a });
+}
+
+/**
+ * Walks the DAG of an expression once, assigning a binding to each distinct
+ * tensor, a push constant to each constant and a variable to each shared
+ * node, so the generated code only depends on the structure of the DAG.
+ */
+class Generator
+{
+  public:
+    std::vector<std::shared_ptr<Tensor>> tensors;
+    std::vector<float> constants;
+    std::string body;
+
+    std::string visit(const std::shared_ptr<const Expr::Node>& node)
+    {
+        auto visited = this->mVariables.find(node.get());
+        if (visited != this->mVariables.end()) {
+            return visited->second;
+        }
+
+        std::string value;
+        switch (node->operation) {
+            case Expr::Operation::eTensor:
+                value = fmt::format("t{}[index]", this->binding(node->tensor));
+                break;
+            case Expr::Operation::eConstant:
+                // Constants are not shared as they are not computed
+                this->constants.push_back(node->value);
+                return fmt::format("pc.constants[{}]",
+                                   this->constants.size() - 1);
+            default:
+                value = this->operation(node);
+                break;
+        }
+
+        std::string variable = fmt::format("v{}", this->mVariables.size());
+        this->body +=
+          fmt::format("        float {} = {};\n", variable, value);
+        this->mVariables[node.get()] = variable;
+        return variable;
+    }
+
+    uint32_t binding(const std::shared_ptr<Tensor>& tensor)
+    {
+        for (uint32_t i = 0; i < this->tensors.size(); i++) {
+            if (this->tensors[i] == tensor) {
+                return i;
+            }
+        }
+        this->tensors.push_back(tensor);
+        return this->tensors.size() - 1;
+    }
+
+  private:
+    std::map<const Expr::Node*, std::string> mVariables;
+
+    std::string operation(const std::shared_ptr<const Expr::Node>& node)
+    {
+        std::vector<std::string> operands;
+        for (const std::shared_ptr<const Expr::Node>& operand :
+             node->operands) {
+            operands.push_back(this->visit(operand));
+        }
+
+        bool binary = node->operation == Expr::Operation::eAdd ||
+                      node->operation == Expr::Operation::eSub ||
+                      node->operation == Expr::Operation::eMul ||
+                      node->operation == Expr::Operation::eDiv ||
+                      node->operation == Expr::Operation::eMin ||
+                      node->operation == Expr::Operation::eMax;
+        if (operands.size() != (binary ? 2u : 1u)) {
+            throw std::runtime_error(
+              "Kompute expr operation " +
+              std::to_string(static_cast<uint32_t>(node->operation)) +
+              " has " + std::to_string(operands.size()) + " operands");
+        }
+
+        const std::string& a = operands[0];
+        const std::string& b = binary ? operands[1] : operands[0];
+
+        switch (node->operation) {
+            case Expr::Operation::eAdd:
+                return a + " + " + b;
+            case Expr::Operation::eSub:
+                return a + " - " + b;
+            case Expr::Operation::eMul:
+                return a + " * " + b;
+            case Expr::Operation::eDiv:
+                return a + " / " + b;
+            case Expr::Operation::eNeg:
+                return "-" + a;
+            case Expr::Operation::eMin:
+                return "min(" + a + ", " + b + ")";
+            case Expr::Operation::eMax:
+                return "max(" + a + ", " + b + ")";
+            case Expr::Operation::eAbs:
+                return "abs(" + a + ")";
+            case Expr::Operation::eExp:
+                return "exp(" + a + ")";
+            case Expr::Operation::eLog:
+                return "log(" + a + ")";
+            case Expr::Operation::eSqrt:
+                return "sqrt(" + a + ")";
+            case Expr::Operation::eTanh:
+                return "tanh(" + a + ")";
+            case Expr::Operation::eRelu:
+                return "max(" + a + ", 0.0)";
+            case Expr::Operation::eSigmoid:
+                return "1.0 / (1.0 + exp(-" + a + "))";
+            default:
+                throw std::runtime_error("Kompute expr unknown operation");
+        }
+    }
+};
+
+static std::string
+generate(const std::shared_ptr<Tensor>& output,
+         const Expr& expression,
+         Generator& generator)
+{
+    if (!output || output->dataType() != Memory::DataTypes::eFloat) {
+        throw std::runtime_error(
+          "Kompute expr only supports float output tensors");
+    }
+
+    std::string result = generator.visit(expression.node());
+    uint32_t outputBinding = generator.binding(output);
+
+    for (const std::shared_ptr<Tensor>& tensor : generator.tensors) {
+        if (tensor->size() != output->size()) {
+            throw std::runtime_error(
+              "Kompute expr tensors must have the size of the output, got " +
+              std::to_string(tensor->size()) + " and " +
+              std::to_string(output->size()));
+        }
+    }
+
+    std::string source = "#version 450\n"
+                         "\n"
+                         "layout (local_size_x_id = 0) in;\n"
+                         "layout (constant_id = 1) const uint COUNT = 0;\n"
+                         "\n";
+    for (uint32_t i = 0; i < generator.tensors.size(); i++) {
+        source += fmt::format(
+          "layout(set = 0, binding = {0}) {1}buffer tensor{0} {{ float t{0}[]; "
+          "}};\n",
+          i,
+          i == outputBinding ? "" : "readonly ");
+    }
+    if (!generator.constants.empty()) {
+        source += fmt::format("\nlayout(push_constant) uniform PushConstants "
+                              "{{ float constants[{}]; }} pc;\n",
+                              generator.constants.size());
+    }
+    source += "\n"
+              "void main()\n"
+              "{\n"
+              "    uint stride = gl_NumWorkGroups.x * gl_WorkGroupSize.x;\n"
+              "    for (uint index = gl_GlobalInvocationID.x; index < COUNT;\n"
+              "         index += stride) {\n";
+    source += generator.body;
+    source += fmt::format("        t{}[index] = {};\n", outputBinding, result);
+    source += "    }\n"
+              "}\n";
+    return source;
+}
+
+std::string
+source(const std::shared_ptr<Tensor>& output, const Expr& expression)
+{
+    Generator generator;
+    return generate(output, expression, generator);
+}
+
+std::shared_ptr<Algorithm>
+algorithm(Manager& manager,
+          const std::shared_ptr<Tensor>& output,
+          const Expr& expression,
+          const Compiler& compiler)
+{
+    Generator generator;
+    std::string shaderSource = generate(output, expression, generator);
+
+    const vk::PhysicalDeviceLimits limits =
+      manager.getDeviceProperties().limits;
+
+    if (generator.constants.size() * sizeof(float) >
+        limits.maxPushConstantsSize) {
+        throw std::runtime_error(
+          "Kompute expr has " + std::to_string(generator.constants.size()) +
+          " constants which exceeds the push constant size of the device");
+    }
+
+    std::vector<uint32_t> spirv;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto cached = cache.find(shaderSource);
+        if (cached != cache.end()) {
+            spirv = cached->second;
+        }
+    }
+
+    if (spirv.empty()) {
+        if (compiler) {
+            spirv = compiler(shaderSource);
+        } else {
+#if KOMPUTE_OPT_USE_SHADERC
+            static ShaderCompiler shaderCompiler;
+            spirv = shaderCompiler.compile(shaderSource);
+#else
+            throw std::runtime_error(
+              "Kompute expr requires a compiler when Kompute is built without "
+              "KOMPUTE_OPT_USE_SHADERC");
+#endif
+        }
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        cache[shaderSource] = spirv;
+    }
+
+    KP_LOG_DEBUG("Kompute expr created kernel with {} tensors and {} "
+                 "constants",
+                 generator.tensors.size(),
+                 generator.constants.size());
+
+    uint32_t localSize = std::min({ DEFAULT_LOCAL_SIZE,
+                                    limits.maxComputeWorkGroupSize[0],
+                                    limits.maxComputeWorkGroupInvocations });
+
+    // The shader loops over the elements when the workgroups are capped
+    uint32_t workgroups = std::min<uint32_t>(
+      (output->size() + localSize - 1) / localSize,
+      limits.maxComputeWorkGroupCount[0]);
+    workgroups = std::max<uint32_t>(workgroups, 1);
+
+    std::vector<std::shared_ptr<Memory>> memObjects(
+      generator.tensors.begin(), generator.tensors.end());
+
+    return manager.algorithm<uint32_t, float>(memObjects,
+                                              spirv,
+                                              { workgroups, 1, 1 },
+                                              { localSize, output->size() },
+                                              generator.constants);
+}
+
+void
+clearCache()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cache.clear();
+}
+
+} // End namespace expr
+} // End namespace kp
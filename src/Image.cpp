@@ -1,6 +1,9 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "kompute/Image.hpp"
+#include "kompute/ImageLayoutTracker.hpp"
+
+#include <algorithm>
 
 namespace kp {
 
@@ -8,21 +11,60 @@ void
 Image::init(void* data,
             size_t dataSize,
             uint32_t numChannels,
-            vk::ImageTiling tiling)
+            vk::ImageTiling tiling,
+            const Dimensions& dimensions)
 {
-    KP_LOG_DEBUG(
-      "Kompute Image constructor data width: {}, height: {}, and type: {}",
-      this->getX(),
-      this->getY(),
-      Memory::toString(this->memoryType()));
+    KP_LOG_DEBUG("Kompute Image constructor data width: {}, height: {}, "
+                 "depth: {}, layers: {}, and type: {}",
+                 this->getX(),
+                 this->getY(),
+                 dimensions.depth,
+                 dimensions.layers,
+                 Memory::toString(this->memoryType()));
 
     if (numChannels == 0) {
         throw std::runtime_error(
           "Kompute Image attempted to create an image with no channels");
     }
 
-    if (data != nullptr &&
-        dataSize < this->getX() * this->getY() * numChannels) {
+    if (dimensions.depth == 0 || dimensions.layers == 0) {
+        throw std::runtime_error(
+          "Kompute Image attempted to create an image with no depth or layers");
+    }
+
+    if (dimensions.depth > 1 && dimensions.layers > 1) {
+        throw std::runtime_error(
+          "Kompute Image arrays of 3D images are not supported by Vulkan");
+    }
+
+    // Linear images are only guaranteed to support a single 2D level
+    if (tiling != vk::ImageTiling::eOptimal &&
+        (dimensions.depth > 1 || dimensions.layers > 1 ||
+         dimensions.mipLevels != 1)) {
+        throw std::runtime_error("Kompute Image 3D images, image arrays and "
+                                 "mip levels require optimal tiling");
+    }
+
+    uint32_t maxMipLevels = 1;
+    for (uint32_t size =
+           std::max({ this->getX(), this->getY(), dimensions.depth });
+         size > 1;
+         size /= 2) {
+        maxMipLevels++;
+    }
+
+    if (dimensions.mipLevels > maxMipLevels) {
+        throw std::runtime_error(
+          fmt::format("Kompute Image requested {} mip levels but the image "
+                      "only has {}",
+                      dimensions.mipLevels,
+                      maxMipLevels));
+    }
+
+    size_t size = static_cast<size_t>(this->getX()) * this->getY() *
+                  dimensions.depth * dimensions.layers * numChannels;
+
+    if (data != nullptr && dataSize < size) {
         throw std::runtime_error(
           "Kompute Image data is smaller than the requested image size");
     }
@@ -45,7 +87,12 @@ Image::init(void* data,
     this->mNumChannels = numChannels;
     this->mDescriptorType = vk::DescriptorType::eStorageImage;
     this->mTiling = tiling;
-    this->mSize = this->getX() * this->getY() * this->mNumChannels;
+    this->mDepth = dimensions.depth;
+    this->mLayers = dimensions.layers;
+    this->mMipLevels =
+      dimensions.mipLevels == 0 ? maxMipLevels : dimensions.mipLevels;
+    // Only the first mip level is synced with the host
+    this->mSize = size;
 
     this->reserve();
     this->updateRawData(data);
@@ -88,20 +135,23 @@ void
 Image::recordCopyFrom(const vk::CommandBuffer& commandBuffer,
                       std::shared_ptr<Image> copyFromImage)
 {
-    vk::ImageSubresourceLayers layer = {};
-    layer.aspectMask = vk::ImageAspectFlagBits::eColor;
-    layer.layerCount = 1;
     vk::Offset3D offset = { 0, 0, 0 };
 
     if (this->getX() != copyFromImage->getX() ||
-        this->getY() != copyFromImage->getY()) {
+        this->getY() != copyFromImage->getY() ||
+        this->mDepth != copyFromImage->mDepth ||
+        this->mLayers != copyFromImage->mLayers) {
         throw std::runtime_error(
           "Kompute Image recordCopyFrom image sizes do not match");
     }
 
-    vk::Extent3D size = { this->getX(), this->getY(), 1 };
+    vk::Extent3D size = this->getExtent();
 
-    vk::ImageCopy copyRegion(layer, offset, layer, offset, size);
+    vk::ImageCopy copyRegion(copyFromImage->getSubresourceLayers(),
+                             offset,
+                             this->getSubresourceLayers(),
+                             offset,
+                             size);
 
     KP_LOG_DEBUG(
       "Kompute Image recordCopyFrom size {},{}.", size.width, size.height);
@@ -133,14 +183,12 @@ void
 Image::recordCopyFrom(const vk::CommandBuffer& commandBuffer,
                       std::shared_ptr<Tensor> copyFromTensor)
 {
-    vk::ImageSubresourceLayers layer = {};
-    layer.aspectMask = vk::ImageAspectFlagBits::eColor;
-    layer.layerCount = 1;
     vk::Offset3D offset = { 0, 0, 0 };
 
-    vk::Extent3D size = { this->getX(), this->getY(), 1 };
+    vk::Extent3D size = this->getExtent();
 
-    vk::BufferImageCopy copyRegion(0, 0, 0, layer, offset, size);
+    vk::BufferImageCopy copyRegion(
+      0, 0, 0, this->getSubresourceLayers(), offset, size);
 
     KP_LOG_DEBUG(
       "Kompute Image recordCopyFrom size {},{}.", size.width, size.height);
@@ -162,16 +210,35 @@ Image::recordCopyFrom(const vk::CommandBuffer& commandBuffer,
 void
 Image::recordCopyFromStagingToDevice(const vk::CommandBuffer& commandBuffer)
 {
-    vk::ImageSubresourceLayers layer = {};
-    layer.aspectMask = vk::ImageAspectFlagBits::eColor;
-    layer.layerCount = 1;
+    vk::ImageSubresourceLayers layer = this->getSubresourceLayers();
     vk::Offset3D offset = { 0, 0, 0 };
 
-    vk::Extent3D size = { this->getX(), this->getY(), 1 };
+    vk::Extent3D size = this->getExtent();
 
-    vk::ImageCopy copyRegion(layer, offset, layer, offset, size);
+    KP_LOG_DEBUG("Kompute Image copying size {},{},{}.",
+                 size.width,
+                 size.height,
+                 size.depth);
+
+    if (this->usesStagingBuffer()) {
+        vk::BufferImageCopy copyRegion(0, 0, 0, layer, offset, size);
 
-    KP_LOG_DEBUG("Kompute Image copying size {},{}.", size.width, size.height);
+        this->recordPrimaryImageBarrier(commandBuffer,
+                                        vk::AccessFlagBits::eMemoryRead,
+                                        vk::AccessFlagBits::eMemoryWrite,
+                                        vk::PipelineStageFlagBits::eTransfer,
+                                        vk::PipelineStageFlagBits::eTransfer,
+                                        vk::ImageLayout::eTransferDstOptimal);
+
+        this->recordCopyImageFromTensor(commandBuffer,
+                                        this->mStagingBuffer,
+                                        this->mPrimaryImage,
+                                        this->mPrimaryImageLayout,
+                                        copyRegion);
+        return;
+    }
+
+    vk::ImageCopy copyRegion(layer, offset, layer, offset, size);
 
     this->recordStagingImageBarrier(commandBuffer,
                                     vk::AccessFlagBits::eMemoryRead,
@@ -198,17 +265,43 @@ Image::recordCopyFromStagingToDevice(const vk::CommandBuffer& commandBuffer)
 void
 Image::recordCopyFromDeviceToStaging(const vk::CommandBuffer& commandBuffer)
 {
-    vk::ImageSubresourceLayers layer;
-    layer.aspectMask = vk::ImageAspectFlagBits::eColor;
-    layer.layerCount = 1;
+    vk::ImageSubresourceLayers layer = this->getSubresourceLayers();
     vk::Offset3D offset = { 0, 0, 0 };
 
-    vk::Extent3D size = { this->getX(), this->getY(), 1 };
+    vk::Extent3D size = this->getExtent();
+
+    KP_LOG_DEBUG("Kompute Image copying size {},{},{}.",
+                 size.width,
+                 size.height,
+                 size.depth);
+
+    if (this->usesStagingBuffer()) {
+        vk::BufferImageCopy copyRegion(0, 0, 0, layer, offset, size);
+
+        this->recordPrimaryImageBarrier(commandBuffer,
+                                        vk::AccessFlagBits::eMemoryRead,
+                                        vk::AccessFlagBits::eMemoryWrite,
+                                        vk::PipelineStageFlagBits::eTransfer,
+                                        vk::PipelineStageFlagBits::eTransfer,
+                                        vk::ImageLayout::eTransferSrcOptimal);
+
+        vk::Image primaryImage = *this->mPrimaryImage;
+        vk::ImageLayout primaryImageLayout = this->mPrimaryImageLayout;
+        vk::Buffer stagingBuffer = *this->mStagingBuffer;
+        ImageLayoutTracker::recordCommand(
+          commandBuffer,
+          [=](const vk::CommandBuffer& deferredCommandBuffer) {
+              deferredCommandBuffer.copyImageToBuffer(primaryImage,
+                                                      primaryImageLayout,
+                                                      stagingBuffer,
+                                                      1,
+                                                      &copyRegion);
+          });
+        return;
+    }
 
     vk::ImageCopy copyRegion(layer, offset, layer, offset, size);
 
-    KP_LOG_DEBUG("Kompute Image copying size {},{}.", size.width, size.height);
-
     this->recordPrimaryImageBarrier(commandBuffer,
                                     vk::AccessFlagBits::eMemoryRead,
                                     vk::AccessFlagBits::eMemoryWrite,
@@ -239,8 +332,11 @@ Image::recordCopyImage(const vk::CommandBuffer& commandBuffer,
                        vk::ImageLayout dstLayout,
                        vk::ImageCopy copyRegion)
 {
-    commandBuffer.copyImage(
-      *srcImage, srcLayout, *dstImage, dstLayout, 1, &copyRegion);
+    ImageLayoutTracker::recordCommand(
+      commandBuffer, [=](const vk::CommandBuffer& deferredCommandBuffer) {
+          deferredCommandBuffer.copyImage(
+            *srcImage, srcLayout, *dstImage, dstLayout, 1, &copyRegion);
+      });
 }
 
 void
@@ -250,8 +346,11 @@ Image::recordCopyImageFromTensor(const vk::CommandBuffer& commandBuffer,
                                  vk::ImageLayout dstLayout,
                                  vk::BufferImageCopy copyRegion)
 {
-    commandBuffer.copyBufferToImage(
-      *srcBuffer, *dstImage, dstLayout, 1, &copyRegion);
+    ImageLayoutTracker::recordCommand(
+      commandBuffer, [=](const vk::CommandBuffer& deferredCommandBuffer) {
+          deferredCommandBuffer.copyBufferToImage(
+            *srcBuffer, *dstImage, dstLayout, 1, &copyRegion);
+      });
 }
 
 void
@@ -287,6 +386,26 @@ Image::recordStagingMemoryBarrier(const vk::CommandBuffer& commandBuffer,
                                   vk::PipelineStageFlagBits srcStageMask,
                                   vk::PipelineStageFlagBits dstStageMask)
 {
+    if (this->usesStagingBuffer()) {
+        KP_LOG_DEBUG("Kompute Image recording STAGING buffer memory barrier");
+
+        vk::BufferMemoryBarrier bufferMemoryBarrier;
+        bufferMemoryBarrier.buffer = *this->mStagingBuffer;
+        bufferMemoryBarrier.size = this->memorySize();
+        bufferMemoryBarrier.srcAccessMask = srcAccessMask;
+        bufferMemoryBarrier.dstAccessMask = dstAccessMask;
+        bufferMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+        commandBuffer.pipelineBarrier(srcStageMask,
+                                      dstStageMask,
+                                      vk::DependencyFlags(),
+                                      nullptr,
+                                      bufferMemoryBarrier,
+                                      nullptr);
+        return;
+    }
+
     vk::ImageLayout dstImageLayout;
 
     // Ideally the image would be set to eGeneral as soon as it was created
@@ -316,6 +435,21 @@ Image::recordPrimaryImageBarrier(const vk::CommandBuffer& commandBuffer,
 {
     KP_LOG_DEBUG("Kompute Image recording PRIMARY image memory barrier");
 
+    ImageLayoutTracker* tracker = ImageLayoutTracker::find(commandBuffer);
+    if (tracker) {
+        tracker->transition(*this,
+                            dstLayout,
+                            srcAccessMask,
+                            dstAccessMask,
+                            srcStageMask,
+                            dstStageMask);
+        // Batched operations flush the transitions of all their images at once
+        if (!tracker->isBatching()) {
+            tracker->flush(commandBuffer);
+        }
+        return;
+    }
+
     this->recordImageMemoryBarrier(commandBuffer,
                                    *this->mPrimaryImage,
                                    srcAccessMask,
@@ -323,9 +457,14 @@ Image::recordPrimaryImageBarrier(const vk::CommandBuffer& commandBuffer,
                                    srcStageMask,
                                    dstStageMask,
                                    this->mPrimaryImageLayout,
-                                   dstLayout);
+                                   dstLayout,
+                                   this->getSubresourceRange(
+                                     0, this->mMipLevels));
 
+    // Without a tracker the commands are assumed to execute in the order
+    // they are recorded
     this->mPrimaryImageLayout = dstLayout;
+    this->mSubmittedPrimaryImageLayout = dstLayout;
 }
 
 void
@@ -345,7 +484,8 @@ Image::recordStagingImageBarrier(const vk::CommandBuffer& commandBuffer,
                                    srcStageMask,
                                    dstStageMask,
                                    this->mStagingImageLayout,
-                                   dstLayout);
+                                   dstLayout,
+                                   this->getSubresourceRange());
 
     this->mStagingImageLayout = dstLayout;
 }
@@ -353,24 +493,19 @@ Image::recordStagingImageBarrier(const vk::CommandBuffer& commandBuffer,
 void
 Image::recordImageMemoryBarrier(const vk::CommandBuffer& commandBuffer,
                                 const vk::Image& image,
-                                vk::AccessFlagBits srcAccessMask,
-                                vk::AccessFlagBits dstAccessMask,
-                                vk::PipelineStageFlagBits srcStageMask,
-                                vk::PipelineStageFlagBits dstStageMask,
+                                vk::AccessFlags srcAccessMask,
+                                vk::AccessFlags dstAccessMask,
+                                vk::PipelineStageFlags srcStageMask,
+                                vk::PipelineStageFlags dstStageMask,
                                 vk::ImageLayout srcLayout,
-                                vk::ImageLayout dstLayout)
+                                vk::ImageLayout dstLayout,
+                                vk::ImageSubresourceRange subresourceRange)
 {
     KP_LOG_DEBUG("Kompute Image recording image memory barrier");
 
     vk::ImageMemoryBarrier imageMemoryBarrier;
     imageMemoryBarrier.image = image;
-
-    imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
-    imageMemoryBarrier.subresourceRange.levelCount = 1;
-    imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
-    imageMemoryBarrier.subresourceRange.layerCount = 1;
-    imageMemoryBarrier.subresourceRange.aspectMask =
-      vk::ImageAspectFlagBits::eColor;
+    imageMemoryBarrier.subresourceRange = subresourceRange;
 
     imageMemoryBarrier.srcAccessMask = srcAccessMask;
     imageMemoryBarrier.dstAccessMask = dstAccessMask;
@@ -388,6 +523,133 @@ Image::recordImageMemoryBarrier(const vk::CommandBuffer& commandBuffer,
                                   imageMemoryBarrier);
 }
 
+void
+Image::recordGenerateMipmaps(const vk::CommandBuffer& commandBuffer)
+{
+    KP_LOG_DEBUG("Kompute Image generating {} mip levels", this->mMipLevels);
+
+    if (this->mMipLevels < 2) {
+        throw std::runtime_error(
+          "Kompute Image generating mip levels requires more than one level");
+    }
+
+    vk::FormatFeatureFlags features = this->getFormatFeatures();
+    if (!(features & vk::FormatFeatureFlagBits::eBlitSrc) ||
+        !(features & vk::FormatFeatureFlagBits::eBlitDst)) {
+        throw std::runtime_error(
+          "Kompute Image format " + vk::to_string(this->getFormat()) +
+          " does not support the blits used to generate mip levels");
+    }
+
+    // Integer formats never support linear filtering
+    vk::Filter filter =
+      features & vk::FormatFeatureFlagBits::eSampledImageFilterLinear
+        ? vk::Filter::eLinear
+        : vk::Filter::eNearest;
+
+    this->recordPrimaryImageBarrier(commandBuffer,
+                                    vk::AccessFlagBits::eMemoryWrite,
+                                    vk::AccessFlagBits::eTransferWrite,
+                                    vk::PipelineStageFlagBits::eAllCommands,
+                                    vk::PipelineStageFlagBits::eTransfer,
+                                    vk::ImageLayout::eTransferDstOptimal);
+
+    for (uint32_t level = 1; level < this->mMipLevels; level++) {
+        this->recordImageMemoryBarrier(
+          commandBuffer,
+          *this->mPrimaryImage,
+          vk::AccessFlagBits::eTransferWrite,
+          vk::AccessFlagBits::eTransferRead,
+          vk::PipelineStageFlagBits::eTransfer,
+          vk::PipelineStageFlagBits::eTransfer,
+          vk::ImageLayout::eTransferDstOptimal,
+          vk::ImageLayout::eTransferSrcOptimal,
+          this->getSubresourceRange(level - 1));
+
+        vk::Extent3D srcExtent = this->getExtent(level - 1);
+        vk::Extent3D dstExtent = this->getExtent(level);
+
+        vk::ImageBlit blit;
+        blit.srcSubresource = this->getSubresourceLayers(level - 1);
+        blit.srcOffsets[1] = vk::Offset3D(srcExtent.width,
+                                          srcExtent.height,
+                                          srcExtent.depth);
+        blit.dstSubresource = this->getSubresourceLayers(level);
+        blit.dstOffsets[1] = vk::Offset3D(dstExtent.width,
+                                          dstExtent.height,
+                                          dstExtent.depth);
+
+        commandBuffer.blitImage(*this->mPrimaryImage,
+                                vk::ImageLayout::eTransferSrcOptimal,
+                                *this->mPrimaryImage,
+                                vk::ImageLayout::eTransferDstOptimal,
+                                blit,
+                                filter);
+    }
+
+    // All the levels but the last one were read from by the blits
+    this->recordImageMemoryBarrier(
+      commandBuffer,
+      *this->mPrimaryImage,
+      vk::AccessFlagBits::eTransferRead,
+      vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+      vk::PipelineStageFlagBits::eTransfer,
+      vk::PipelineStageFlagBits::eAllCommands,
+      vk::ImageLayout::eTransferSrcOptimal,
+      vk::ImageLayout::eGeneral,
+      this->getSubresourceRange(0, this->mMipLevels - 1));
+
+    this->recordImageMemoryBarrier(
+      commandBuffer,
+      *this->mPrimaryImage,
+      vk::AccessFlagBits::eTransferWrite,
+      vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+      vk::PipelineStageFlagBits::eTransfer,
+      vk::PipelineStageFlagBits::eAllCommands,
+      vk::ImageLayout::eTransferDstOptimal,
+      vk::ImageLayout::eGeneral,
+      this->getSubresourceRange(this->mMipLevels - 1));
+
+    ImageLayoutTracker* tracker = ImageLayoutTracker::find(commandBuffer);
+    if (tracker) {
+        tracker->track(*this, vk::ImageLayout::eGeneral);
+    } else {
+        this->mPrimaryImageLayout = vk::ImageLayout::eGeneral;
+        this->mSubmittedPrimaryImageLayout = vk::ImageLayout::eGeneral;
+    }
+}
+
+vk::ImageSubresourceLayers
+Image::getSubresourceLayers(uint32_t mipLevel)
+{
+    return vk::ImageSubresourceLayers(
+      vk::ImageAspectFlagBits::eColor, mipLevel, 0, this->mLayers);
+}
+
+vk::ImageSubresourceRange
+Image::getSubresourceRange(uint32_t baseMipLevel, uint32_t levelCount)
+{
+    return vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor,
+                                     baseMipLevel,
+                                     levelCount,
+                                     0,
+                                     this->mLayers);
+}
+
+vk::Extent3D
+Image::getExtent(uint32_t mipLevel)
+{
+    return vk::Extent3D(std::max(this->getX() >> mipLevel, 1u),
+                        std::max(this->getY() >> mipLevel, 1u),
+                        std::max(this->mDepth >> mipLevel, 1u));
+}
+
+bool
+Image::usesStagingBuffer()
+{
+    return this->mDepth > 1 || this->mLayers > 1;
+}
+
 vk::DescriptorImageInfo
 Image::constructDescriptorImageInfo()
 {
@@ -398,23 +660,34 @@ Image::constructDescriptorImageInfo()
     viewInfo.image = *this->mPrimaryImage;
     viewInfo.format = this->getFormat();
     viewInfo.flags = vk::ImageViewCreateFlags();
-    viewInfo.viewType = vk::ImageViewType::e2D;
+    if (this->mDepth > 1) {
+        viewInfo.viewType = vk::ImageViewType::e3D;
+    } else if (this->mLayers > 1) {
+        viewInfo.viewType = vk::ImageViewType::e2DArray;
+    } else {
+        viewInfo.viewType = vk::ImageViewType::e2D;
+    }
 
-    viewInfo.subresourceRange.baseMipLevel = 0;
-    viewInfo.subresourceRange.levelCount = 1;
-    viewInfo.subresourceRange.baseArrayLayer = 0;
-    viewInfo.subresourceRange.layerCount = 1;
-    viewInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    // Storage images can only view a single mip level, whereas sampled
+    // images view the whole chain so shaders can select the level of detail
+    bool storage = this->mDescriptorType == vk::DescriptorType::eStorageImage;
+    std::shared_ptr<vk::ImageView>& imageView =
+      storage ? this->mImageView : this->mSampledImageView;
+    viewInfo.subresourceRange =
+      this->getSubresourceRange(0, storage ? 1 : this->mMipLevels);
 
     // This image object owns the image view
-    if (!this->mImageView) {
-        mImageView = std::make_shared<vk::ImageView>(
+    if (!imageView) {
+        imageView = std::make_shared<vk::ImageView>(
           this->mDevice->createImageView(viewInfo));
     }
 
     vk::DescriptorImageInfo descriptorInfo;
 
-    descriptorInfo.imageView = *(mImageView.get());
+    if (this->mSampler) {
+        descriptorInfo.sampler = *this->mSampler->getSampler();
+    }
+    descriptorInfo.imageView = *imageView;
     descriptorInfo.imageLayout = this->mPrimaryImageLayout;
     return descriptorInfo;
 }
@@ -431,32 +704,97 @@ Image::constructDescriptorSet(vk::DescriptorSet descriptorSet, uint32_t binding)
                                   binding, // Destination binding
                                   0,       // Destination array element
                                   1,       // Descriptor count
-                                  vk::DescriptorType::eStorageImage,
+                                  this->mDescriptorType,
                                   &mDescriptorImageInfo,
                                   nullptr); // Descriptor buffer info
 }
 
+void
+Image::setDescriptorType(vk::DescriptorType descriptorType,
+                         std::shared_ptr<Sampler> sampler)
+{
+    if (descriptorType != vk::DescriptorType::eStorageImage &&
+        descriptorType != vk::DescriptorType::eSampledImage &&
+        descriptorType != vk::DescriptorType::eCombinedImageSampler) {
+        throw std::runtime_error(
+          "Kompute Image unsupported descriptor type " +
+          vk::to_string(descriptorType));
+    }
+    if ((descriptorType == vk::DescriptorType::eCombinedImageSampler) !=
+        (sampler != nullptr)) {
+        throw std::runtime_error("Kompute Image requires a sampler for, and "
+                                 "only for, combined image samplers");
+    }
+
+    vk::FormatFeatureFlags features = this->getFormatFeatures();
+    if (descriptorType != vk::DescriptorType::eStorageImage &&
+        !(features & vk::FormatFeatureFlagBits::eSampledImage)) {
+        throw std::runtime_error(
+          "Kompute Image format " + vk::to_string(this->getFormat()) +
+          " does not support sampling with " +
+          vk::to_string(this->mTiling) + " tiling");
+    }
+    if (sampler && sampler->getFilter() == vk::Filter::eLinear &&
+        !(features & vk::FormatFeatureFlagBits::eSampledImageFilterLinear)) {
+        throw std::runtime_error(
+          "Kompute Image format " + vk::to_string(this->getFormat()) +
+          " does not support linear filtering");
+    }
+
+    KP_LOG_DEBUG("Kompute Image setting descriptor type {}",
+                 vk::to_string(descriptorType));
+
+    this->mDescriptorType = descriptorType;
+    this->mSampler = sampler;
+}
+
+std::shared_ptr<Sampler>
+Image::getSampler()
+{
+    return this->mSampler;
+}
+
+vk::FormatFeatureFlags
+Image::getFormatFeatures()
+{
+    vk::FormatProperties properties =
+      this->mPhysicalDevice->getFormatProperties(this->getFormat());
+
+    return this->mTiling == vk::ImageTiling::eOptimal
+             ? properties.optimalTilingFeatures
+             : properties.linearTilingFeatures;
+}
+
 vk::ImageUsageFlags
 Image::getPrimaryImageUsageFlags()
 {
+    vk::ImageUsageFlags usageFlags;
+
     switch (this->mMemoryType) {
         case MemoryTypes::eDevice:
         case MemoryTypes::eHost:
         case MemoryTypes::eDeviceAndHost:
-            return vk::ImageUsageFlagBits::eStorage |
-                   vk::ImageUsageFlagBits::eTransferSrc |
-                   vk::ImageUsageFlagBits::eTransferDst;
+            usageFlags = vk::ImageUsageFlagBits::eStorage |
+                         vk::ImageUsageFlagBits::eTransferSrc |
+                         vk::ImageUsageFlagBits::eTransferDst;
             break;
         case MemoryTypes::eStorage:
-            return vk::ImageUsageFlagBits::eStorage |
-                   // You can still copy images to/from storage memory
-                   // so set the transfer usage flags here.
-                   vk::ImageUsageFlagBits::eTransferSrc |
-                   vk::ImageUsageFlagBits::eTransferDst;
+            usageFlags = vk::ImageUsageFlagBits::eStorage |
+                         // You can still copy images to/from storage memory
+                         // so set the transfer usage flags here.
+                         vk::ImageUsageFlagBits::eTransferSrc |
+                         vk::ImageUsageFlagBits::eTransferDst;
             break;
         default:
             throw std::runtime_error("Kompute Image invalid image type");
     }
+
+    // Allows the image to be bound as a sampled image later on
+    if (this->getFormatFeatures() & vk::FormatFeatureFlagBits::eSampledImage) {
+        usageFlags |= vk::ImageUsageFlagBits::eSampled;
+    }
+
+    return usageFlags;
 }
 
 vk::ImageUsageFlags
@@ -490,6 +828,24 @@ Image::getNumChannels()
     return this->mNumChannels;
 }
 
+uint32_t
+Image::getDepth()
+{
+    return this->mDepth;
+}
+
+uint32_t
+Image::getLayers()
+{
+    return this->mLayers;
+}
+
+uint32_t
+Image::getMipLevels()
+{
+    return this->mMipLevels;
+}
+
 void
 Image::allocateMemoryCreateGPUResources()
 {
@@ -505,8 +861,10 @@ Image::allocateMemoryCreateGPUResources()
     KP_LOG_DEBUG("Kompute Image creating primary image and memory");
 
     this->mPrimaryImage = std::make_shared<vk::Image>();
-    this->createImage(
-      this->mPrimaryImage, this->getPrimaryImageUsageFlags(), this->mTiling);
+    this->createImage(this->mPrimaryImage,
+                      this->getPrimaryImageUsageFlags(),
+                      this->mTiling,
+                      this->mMipLevels);
     this->mFreePrimaryImage = true;
     this->mPrimaryMemory = std::make_shared<vk::DeviceMemory>();
     this->allocateBindMemory(this->mPrimaryImage,
@@ -514,13 +872,19 @@ Image::allocateMemoryCreateGPUResources()
                              this->getPrimaryMemoryPropertyFlags());
     this->mFreePrimaryMemory = true;
 
-    if (this->mMemoryType == MemoryTypes::eDevice) {
+    if (this->mMemoryType == MemoryTypes::eDevice &&
+        this->usesStagingBuffer()) {
+        KP_LOG_DEBUG("Kompute Image creating staging buffer and memory");
+
+        this->createStagingBuffer();
+    } else if (this->mMemoryType == MemoryTypes::eDevice) {
         KP_LOG_DEBUG("Kompute Image creating staging image and memory");
 
         this->mStagingImage = std::make_shared<vk::Image>();
         this->createImage(this->mStagingImage,
                           this->getStagingImageUsageFlags(),
-                          vk::ImageTiling::eLinear);
+                          vk::ImageTiling::eLinear,
+                          1);
         this->mFreeStagingImage = true;
         this->mStagingMemory = std::make_shared<vk::DeviceMemory>();
         this->allocateBindMemory(this->mStagingImage,
@@ -535,7 +899,8 @@ Image::allocateMemoryCreateGPUResources()
 void
 Image::createImage(std::shared_ptr<vk::Image> image,
                    vk::ImageUsageFlags imageUsageFlags,
-                   vk::ImageTiling imageTiling)
+                   vk::ImageTiling imageTiling,
+                   uint32_t mipLevels)
 {
     vk::DeviceSize imageSize = this->memorySize();
 
@@ -553,18 +918,47 @@ Image::createImage(std::shared_ptr<vk::Image> image,
     vk::ImageCreateInfo imageInfo;
 
     imageInfo.flags = vk::ImageCreateFlags();
-    imageInfo.imageType = vk::ImageType::e2D;
+    imageInfo.imageType =
+      this->mDepth > 1 ? vk::ImageType::e3D : vk::ImageType::e2D;
     imageInfo.format = this->getFormat();
-    imageInfo.extent = vk::Extent3D(this->getX(), this->getY(), 1);
+    imageInfo.extent = this->getExtent();
     imageInfo.usage = imageUsageFlags;
-    imageInfo.mipLevels = 1;
-    imageInfo.arrayLayers = 1;
+    imageInfo.mipLevels = mipLevels;
+    imageInfo.arrayLayers = this->mLayers;
     imageInfo.initialLayout = vk::ImageLayout::eUndefined;
     imageInfo.tiling = imageTiling;
 
     this->mDevice->createImage(&imageInfo, nullptr, image.get());
 }
 
+void
+Image::createStagingBuffer()
+{
+    KP_LOG_DEBUG("Kompute Image creating staging buffer with memory size: {}",
+                 this->memorySize());
+
+    vk::BufferCreateInfo bufferInfo(vk::BufferCreateFlags(),
+                                    this->memorySize(),
+                                    vk::BufferUsageFlagBits::eTransferSrc |
+                                      vk::BufferUsageFlagBits::eTransferDst,
+                                    vk::SharingMode::eExclusive);
+
+    this->mStagingBuffer = std::make_shared<vk::Buffer>();
+    this->mDevice->createBuffer(
+      &bufferInfo, nullptr, this->mStagingBuffer.get());
+    this->mFreeStagingBuffer = true;
+
+    this->mStagingMemory = std::make_shared<vk::DeviceMemory>();
+    this->allocateMemory(
+      this->mDevice->getBufferMemoryRequirements(*this->mStagingBuffer),
+      this->mStagingMemory,
+      this->getStagingMemoryPropertyFlags());
+    this->mFreeStagingMemory = true;
+
+    this->mDevice->bindBufferMemory(
+      *this->mStagingBuffer, *this->mStagingMemory, 0);
+}
+
 void
 Image::allocateBindMemory(std::shared_ptr<vk::Image> image,
                           std::shared_ptr<vk::DeviceMemory> memory,
@@ -573,12 +967,21 @@ Image::allocateBindMemory(std::shared_ptr<vk::Image> image,
 
     KP_LOG_DEBUG("Kompute Image allocating and binding memory");
 
+    this->allocateMemory(this->mDevice->getImageMemoryRequirements(*image),
+                         memory,
+                         memoryPropertyFlags);
+
+    this->mDevice->bindImageMemory(*image, *memory, 0);
+}
+
+void
+Image::allocateMemory(vk::MemoryRequirements memoryRequirements,
+                      std::shared_ptr<vk::DeviceMemory> memory,
+                      vk::MemoryPropertyFlags memoryPropertyFlags)
+{
     vk::PhysicalDeviceMemoryProperties memoryProperties =
       this->mPhysicalDevice->getMemoryProperties();
 
-    vk::MemoryRequirements memoryRequirements =
-      this->mDevice->getImageMemoryRequirements(*image);
-
     uint32_t memoryTypeIndex = -1;
     bool memoryTypeIndexFound = false;
     for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
@@ -606,8 +1009,6 @@ Image::allocateBindMemory(std::shared_ptr<vk::Image> image,
                                               memoryTypeIndex);
 
     this->mDevice->allocateMemory(&memoryAllocateInfo, nullptr, memory.get());
-
-    this->mDevice->bindImageMemory(*image, *memory, 0);
 }
 
 void
@@ -649,12 +1050,37 @@ Image::destroy()
         }
     }
 
+    if (this->mFreeStagingBuffer) {
+        if (!this->mStagingBuffer) {
+            KP_LOG_WARN("Kompose Image expected to destroy staging buffer "
+                        "but got null buffer");
+        } else {
+            KP_LOG_DEBUG("Kompose Image destroying staging buffer");
+            this->mDevice->destroy(
+              *this->mStagingBuffer,
+              (vk::Optional<const vk::AllocationCallbacks>)nullptr);
+            this->mStagingBuffer = nullptr;
+            this->mFreeStagingBuffer = false;
+        }
+    }
+
     if (this->mImageView) {
         KP_LOG_DEBUG("Kompose Image freeing image view");
         this->mDevice->destroyImageView(*this->mImageView);
         this->mImageView = nullptr;
     }
 
+    if (this->mSampledImageView) {
+        KP_LOG_DEBUG("Kompose Image freeing sampled image view");
+        this->mDevice->destroyImageView(*this->mSampledImageView);
+        this->mSampledImageView = nullptr;
+    }
+
+    // Images created again by reserve() start without a layout
+    this->mPrimaryImageLayout = vk::ImageLayout::eUndefined;
+    this->mStagingImageLayout = vk::ImageLayout::eUndefined;
+    this->mSubmittedPrimaryImageLayout = vk::ImageLayout::eUndefined;
+
     Memory::destroy();
 
     KP_LOG_DEBUG("Kompute Image successful destroy()");
@@ -748,6 +1174,31 @@ Image::getFormat()
                     return vk::Format::eUndefined;
             }
         }
+        case Memory::DataTypes::eHalf: {
+            switch (this->mNumChannels) {
+                case 1:
+                    return vk::Format::eR16Sfloat;
+                case 2:
+                    return vk::Format::eR16G16Sfloat;
+                case 4:
+                    return vk::Format::eR16G16B16A16Sfloat;
+                default:
+                    return vk::Format::eUndefined;
+            }
+        }
+        // The quantized values are read as ints and dequantized by the shader
+        case Memory::DataTypes::eQInt8: {
+            switch (this->mNumChannels) {
+                case 1:
+                    return vk::Format::eR8Sint;
+                case 2:
+                    return vk::Format::eR8G8Sint;
+                case 4:
+                    return vk::Format::eR8G8B8A8Sint;
+                default:
+                    return vk::Format::eUndefined;
+            }
+        }
         default:
             return vk::Format::eUndefined;
     }
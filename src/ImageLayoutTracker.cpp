@@ -0,0 +1,278 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/ImageLayoutTracker.hpp"
+
+#include <mutex>
+
+namespace kp {
+
+// Trackers are looked up by the images through the command buffer they record
+// into, so the operations do not need to be aware of them
+static std::map<VkCommandBuffer, ImageLayoutTracker*>&
+trackerRegistry()
+{
+    static std::map<VkCommandBuffer, ImageLayoutTracker*> registry;
+    return registry;
+}
+
+static std::mutex trackerRegistryMutex;
+
+ImageLayoutTracker::ImageLayoutTracker(const vk::CommandBuffer& commandBuffer,
+                                       vk::QueueFlags queueFlags)
+  : mCommandBuffer(commandBuffer)
+  , mQueueFlags(queueFlags)
+{
+    KP_LOG_DEBUG("Kompute ImageLayoutTracker constructor");
+
+    std::lock_guard<std::mutex> lock(trackerRegistryMutex);
+    trackerRegistry()[static_cast<VkCommandBuffer>(commandBuffer)] = this;
+}
+
+ImageLayoutTracker::~ImageLayoutTracker()
+{
+    KP_LOG_DEBUG("Kompute ImageLayoutTracker destructor");
+
+    std::lock_guard<std::mutex> lock(trackerRegistryMutex);
+    trackerRegistry().erase(static_cast<VkCommandBuffer>(this->mCommandBuffer));
+}
+
+ImageLayoutTracker*
+ImageLayoutTracker::find(const vk::CommandBuffer& commandBuffer)
+{
+    std::lock_guard<std::mutex> lock(trackerRegistryMutex);
+
+    std::map<VkCommandBuffer, ImageLayoutTracker*>& registry =
+      trackerRegistry();
+    auto it = registry.find(static_cast<VkCommandBuffer>(commandBuffer));
+    return it == registry.end() ? nullptr : it->second;
+}
+
+ImageLayoutTracker::ImageState&
+ImageLayoutTracker::getState(Image& image)
+{
+    auto it = this->mImages.find(&image);
+    if (it == this->mImages.end()) {
+        it = this->mImages
+               .emplace(&image,
+                        ImageState{ image.mPrimaryImageLayout,
+                                    image.mPrimaryImageLayout })
+               .first;
+    }
+    return it->second;
+}
+
+void
+ImageLayoutTracker::transition(Image& image,
+                               vk::ImageLayout dstLayout,
+                               vk::AccessFlags srcAccessMask,
+                               vk::AccessFlags dstAccessMask,
+                               vk::PipelineStageFlags srcStageMask,
+                               vk::PipelineStageFlags dstStageMask)
+{
+    ImageState& state = this->getState(image);
+
+    this->mPendingSrcStageMask |= srcStageMask;
+    this->mPendingDstStageMask |= dstStageMask;
+
+    // Barriers within a pipeline barrier are not ordered, so a second
+    // transition of an image before the flush is merged into the first one
+    for (auto it = this->mPendingImageBarriers.begin();
+         it != this->mPendingImageBarriers.end();
+         it++) {
+        if (it->image != *image.mPrimaryImage) {
+            continue;
+        }
+
+        it->srcAccessMask |= srcAccessMask;
+        it->dstAccessMask |= dstAccessMask;
+        it->newLayout = dstLayout;
+        state.layout = dstLayout;
+        image.mPrimaryImageLayout = dstLayout;
+
+        if (it->oldLayout == it->newLayout) {
+            this->mPendingSrcAccessMask |= it->srcAccessMask;
+            this->mPendingDstAccessMask |= it->dstAccessMask;
+            this->mPendingImageBarriers.erase(it);
+            this->mTransitionCount--;
+            this->mSkippedTransitionCount++;
+        }
+        return;
+    }
+
+    if (state.layout == dstLayout) {
+        KP_LOG_DEBUG("Kompute ImageLayoutTracker skipping transition to {}",
+                     vk::to_string(dstLayout));
+
+        this->mPendingSrcAccessMask |= srcAccessMask;
+        this->mPendingDstAccessMask |= dstAccessMask;
+        this->mSkippedTransitionCount++;
+        return;
+    }
+
+    vk::ImageMemoryBarrier imageMemoryBarrier;
+    imageMemoryBarrier.image = *image.mPrimaryImage;
+    imageMemoryBarrier.subresourceRange =
+      image.getSubresourceRange(0, image.mMipLevels);
+    imageMemoryBarrier.srcAccessMask = srcAccessMask;
+    imageMemoryBarrier.dstAccessMask = dstAccessMask;
+    imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageMemoryBarrier.oldLayout = state.layout;
+    imageMemoryBarrier.newLayout = dstLayout;
+
+    this->mPendingImageBarriers.push_back(imageMemoryBarrier);
+    this->mTransitionCount++;
+
+    state.layout = dstLayout;
+    image.mPrimaryImageLayout = dstLayout;
+}
+
+void
+ImageLayoutTracker::flush(const vk::CommandBuffer& commandBuffer)
+{
+    if (this->mPendingImageBarriers.empty() && !this->mPendingSrcAccessMask &&
+        !this->mPendingDstAccessMask) {
+        this->mPendingSrcStageMask = vk::PipelineStageFlags();
+        this->mPendingDstStageMask = vk::PipelineStageFlags();
+        return;
+    }
+
+    KP_LOG_DEBUG("Kompute ImageLayoutTracker recording {} image barriers",
+                 this->mPendingImageBarriers.size());
+
+    std::vector<vk::MemoryBarrier> memoryBarriers;
+    if (this->mPendingSrcAccessMask || this->mPendingDstAccessMask) {
+        memoryBarriers.push_back(vk::MemoryBarrier(
+          this->mPendingSrcAccessMask, this->mPendingDstAccessMask));
+    }
+
+    commandBuffer.pipelineBarrier(this->mPendingSrcStageMask,
+                                  this->mPendingDstStageMask,
+                                  vk::DependencyFlags(),
+                                  memoryBarriers,
+                                  nullptr,
+                                  this->mPendingImageBarriers);
+    this->mBarrierCount++;
+
+    this->mPendingImageBarriers.clear();
+    this->mPendingSrcAccessMask = vk::AccessFlags();
+    this->mPendingDstAccessMask = vk::AccessFlags();
+    this->mPendingSrcStageMask = vk::PipelineStageFlags();
+    this->mPendingDstStageMask = vk::PipelineStageFlags();
+}
+
+void
+ImageLayoutTracker::beginBatch()
+{
+    this->mBatching = true;
+}
+
+void
+ImageLayoutTracker::endBatch(const vk::CommandBuffer& commandBuffer)
+{
+    this->mBatching = false;
+    this->flush(commandBuffer);
+
+    for (const std::function<void(const vk::CommandBuffer&)>& command :
+         this->mDeferredCommands) {
+        command(commandBuffer);
+    }
+    this->mDeferredCommands.clear();
+}
+
+bool
+ImageLayoutTracker::isBatching()
+{
+    return this->mBatching;
+}
+
+void
+ImageLayoutTracker::recordCommand(
+  const vk::CommandBuffer& commandBuffer,
+  const std::function<void(const vk::CommandBuffer&)>& command)
+{
+    ImageLayoutTracker* tracker = ImageLayoutTracker::find(commandBuffer);
+    if (tracker && tracker->mBatching) {
+        tracker->mDeferredCommands.push_back(command);
+        return;
+    }
+    command(commandBuffer);
+}
+
+void
+ImageLayoutTracker::track(Image& image, vk::ImageLayout layout)
+{
+    this->getState(image).layout = layout;
+    image.mPrimaryImageLayout = layout;
+}
+
+bool
+ImageLayoutTracker::isStale()
+{
+    for (const auto& entry : this->mImages) {
+        if (entry.first->mSubmittedPrimaryImageLayout !=
+            entry.second.initialLayout) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+ImageLayoutTracker::restoreLayouts()
+{
+    for (const auto& entry : this->mImages) {
+        entry.first->mPrimaryImageLayout =
+          entry.first->mSubmittedPrimaryImageLayout;
+    }
+}
+
+void
+ImageLayoutTracker::submit()
+{
+    for (const auto& entry : this->mImages) {
+        entry.first->mSubmittedPrimaryImageLayout = entry.second.layout;
+    }
+}
+
+void
+ImageLayoutTracker::reset()
+{
+    this->mImages.clear();
+    this->mPendingImageBarriers.clear();
+    this->mPendingSrcAccessMask = vk::AccessFlags();
+    this->mPendingDstAccessMask = vk::AccessFlags();
+    this->mPendingSrcStageMask = vk::PipelineStageFlags();
+    this->mPendingDstStageMask = vk::PipelineStageFlags();
+    this->mBatching = false;
+    this->mDeferredCommands.clear();
+    this->mTransitionCount = 0;
+    this->mSkippedTransitionCount = 0;
+    this->mBarrierCount = 0;
+}
+
+uint32_t
+ImageLayoutTracker::getTransitionCount()
+{
+    return this->mTransitionCount;
+}
+
+uint32_t
+ImageLayoutTracker::getSkippedTransitionCount()
+{
+    return this->mSkippedTransitionCount;
+}
+
+uint32_t
+ImageLayoutTracker::getBarrierCount()
+{
+    return this->mBarrierCount;
+}
+
+vk::QueueFlags
+ImageLayoutTracker::getQueueFlags()
+{
+    return this->mQueueFlags;
+}
+
+}
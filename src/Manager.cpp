@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "kompute/Manager.hpp"
+#include "kompute/operations/OpFill.hpp"
 #include "kompute/logger/Logger.hpp"
 #if KOMPUTE_OPT_USE_SPDLOG
 #include <spdlog/fmt/fmt.h>
@@ -9,6 +10,7 @@
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 #endif
+#include <algorithm>
 #include <iterator>
 #include <set>
 #include <sstream>
@@ -45,10 +47,37 @@ debugMessageCallback(VkDebugReportFlagsEXT /*flags*/,
 #endif
 
 Manager::Manager()
-  : Manager(0)
+  : Manager(DevicePolicy())
 {
 }
 
+Manager::Manager(const DevicePolicy& policy,
+                 const std::vector<std::string>& desiredExtensions)
+{
+    this->mManageResources = true;
+
+// Make sure the logger is setup
+#if !KOMPUTE_OPT_LOG_LEVEL_DISABLED
+    logger::setupLogger();
+#endif
+
+    this->createInstance();
+
+    uint32_t physicalDeviceIndex = DeviceSelector::selectDevice(
+      this->mInstance->enumeratePhysicalDevices(), policy);
+
+    std::vector<std::string> extensions = desiredExtensions;
+    for (const std::string& extension : policy.requiredExtensions) {
+        if (std::find(extensions.begin(), extensions.end(), extension) ==
+            extensions.end()) {
+            extensions.push_back(extension);
+        }
+    }
+
+    this->createDevice({}, physicalDeviceIndex, extensions, policy);
+    this->createMemoryBudget();
+}
+
 Manager::Manager(uint32_t physicalDeviceIndex,
                  const std::vector<uint32_t>& familyQueueIndices,
                  const std::vector<std::string>& desiredExtensions)
@@ -61,8 +90,15 @@ Manager::Manager(uint32_t physicalDeviceIndex,
 #endif
 
     this->createInstance();
+
+    // This constructor keeps using the first compute queue family, which
+    // usually supports graphics too, rather than an async compute family
+    DevicePolicy policy;
+    policy.preferAsyncCompute = false;
+
     this->createDevice(
-      familyQueueIndices, physicalDeviceIndex, desiredExtensions);
+      familyQueueIndices, physicalDeviceIndex, desiredExtensions, policy);
+    this->createMemoryBudget();
 }
 
 Manager::Manager(std::shared_ptr<vk::Instance> instance,
@@ -79,6 +115,8 @@ Manager::Manager(std::shared_ptr<vk::Instance> instance,
 #if !KOMPUTE_OPT_LOG_LEVEL_DISABLED
     logger::setupLogger();
 #endif
+
+    this->createMemoryBudget();
 }
 
 Manager::~Manager()
@@ -110,6 +148,8 @@ Manager::destroy()
         this->mManagedSequences.clear();
     }
 
+    this->mMemoryBudget = nullptr;
+
     if (this->mManageResources && this->mManagedAlgorithms.size()) {
         KP_LOG_DEBUG("Kompute Manager explicitly freeing algorithms");
         for (const std::weak_ptr<Algorithm>& weakAlgorithm :
@@ -121,6 +161,17 @@ Manager::destroy()
         this->mManagedAlgorithms.clear();
     }
 
+    if (this->mManageResources && this->mManagedSamplers.size()) {
+        KP_LOG_DEBUG("Kompute Manager explicitly freeing samplers");
+        for (const std::weak_ptr<Sampler>& weakSampler :
+             this->mManagedSamplers) {
+            if (std::shared_ptr<Sampler> sampler = weakSampler.lock()) {
+                sampler->destroy();
+            }
+        }
+        this->mManagedSamplers.clear();
+    }
+
     if (this->mManageResources && this->mManagedMemObjects.size()) {
         KP_LOG_DEBUG("Kompute Manager explicitly freeing memory objects");
         for (const std::weak_ptr<Memory>& weakMemory :
@@ -317,6 +368,11 @@ Manager::clear()
             end(this->mManagedAlgorithms),
             [](std::weak_ptr<Algorithm> t) { return t.expired(); }),
           end(this->mManagedAlgorithms));
+        this->mManagedSamplers.erase(
+          std::remove_if(begin(this->mManagedSamplers),
+                         end(this->mManagedSamplers),
+                         [](std::weak_ptr<Sampler> t) { return t.expired(); }),
+          end(this->mManagedSamplers));
         this->mManagedSequences.erase(
           std::remove_if(begin(this->mManagedSequences),
                          end(this->mManagedSequences),
@@ -328,7 +384,8 @@ Manager::clear()
 void
 Manager::createDevice(const std::vector<uint32_t>& familyQueueIndices,
                       uint32_t physicalDeviceIndex,
-                      const std::vector<std::string>& desiredExtensions)
+                      const std::vector<std::string>& desiredExtensions,
+                      const DevicePolicy& policy)
 {
 
     KP_LOG_DEBUG("Kompute Manager creating Device");
@@ -374,27 +431,12 @@ Manager::createDevice(const std::vector<uint32_t>& familyQueueIndices,
                 physicalDeviceProperties.deviceName.data());
 
     if (familyQueueIndices.empty()) {
-        // Find compute queue
-        std::vector<vk::QueueFamilyProperties> allQueueFamilyProperties =
-          physicalDevice.getQueueFamilyProperties();
+        // Async compute families are preferred over the graphics family
+        uint32_t computeQueueFamilyIndex =
+          DeviceSelector::selectQueueFamily(physicalDevice, policy);
 
-        uint32_t computeQueueFamilyIndex = 0;
-        bool computeQueueSupported = false;
-        for (uint32_t i = 0; i < allQueueFamilyProperties.size(); i++) {
-            vk::QueueFamilyProperties queueFamilyProperties =
-              allQueueFamilyProperties[i];
-
-            if (queueFamilyProperties.queueFlags &
-                vk::QueueFlagBits::eCompute) {
-                computeQueueFamilyIndex = i;
-                computeQueueSupported = true;
-                break;
-            }
-        }
-
-        if (!computeQueueSupported) {
-            throw std::runtime_error("Compute queue is not supported");
-        }
+        KP_LOG_INFO("Using compute queue family index {}",
+                    computeQueueFamilyIndex);
 
         this->mComputeQueueFamilyIndices.push_back(computeQueueFamilyIndex);
     } else {
@@ -462,13 +504,99 @@ Manager::createDevice(const std::vector<uint32_t>& familyQueueIndices,
                      fmt::join(validExtensions, ", "));
     }
 
+    // The memory budget is enabled when supported so the usage of the heaps
+    // can be tracked against the share of the device left by other processes
+    this->mMemoryBudgetEnabled =
+      uniqueExtensionNames.count(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) != 0;
+    if (this->mMemoryBudgetEnabled &&
+        std::find(desiredExtensions.begin(),
+                  desiredExtensions.end(),
+                  VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) ==
+          desiredExtensions.end()) {
+        validExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
+    // Optional features are enabled when supported so they can be used by
+    // the components that depend on them, such as pipeline statistics
+    vk::PhysicalDeviceFeatures supportedFeatures = physicalDevice.getFeatures();
+    if (!DeviceSelector::supportsFeatures(supportedFeatures,
+                                          policy.requiredFeatures)) {
+        throw std::runtime_error(
+          "Kompute Manager device does not support the required features");
+    }
+    vk::PhysicalDeviceFeatures enabledFeatures = policy.requiredFeatures;
+    enabledFeatures.pipelineStatisticsQuery =
+      supportedFeatures.pipelineStatisticsQuery;
+
     vk::DeviceCreateInfo deviceCreateInfo(vk::DeviceCreateFlags(),
                                           deviceQueueCreateInfos.size(),
                                           deviceQueueCreateInfos.data(),
                                           {},
                                           {},
                                           validExtensions.size(),
-                                          validExtensions.data());
+                                          validExtensions.data(),
+                                          &enabledFeatures);
+
+    // The features of the type and memory model extensions requested are
+    // chained to the device creation with everything they support, so shaders
+    // can use 16-bit and 8-bit types as well as cooperative matrices
+    vk::PhysicalDeviceFeatures2 features2;
+    vk::PhysicalDevice16BitStorageFeatures storage16BitFeatures;
+    vk::PhysicalDevice8BitStorageFeatures storage8BitFeatures;
+    vk::PhysicalDeviceShaderFloat16Int8Features float16Int8Features;
+    vk::PhysicalDeviceVulkanMemoryModelFeatures memoryModelFeatures;
+#ifdef VK_KHR_cooperative_matrix
+    vk::PhysicalDeviceCooperativeMatrixFeaturesKHR cooperativeMatrixFeatures;
+#endif // VK_KHR_cooperative_matrix
+
+    std::set<std::string> enabledExtensionNames(validExtensions.begin(),
+                                                validExtensions.end());
+    void** next = &features2.pNext;
+    auto chainFeatures = [&](const char* extension, auto& features) {
+        if (enabledExtensionNames.count(extension)) {
+            *next = &features;
+            next = &features.pNext;
+        }
+    };
+    chainFeatures(VK_KHR_16BIT_STORAGE_EXTENSION_NAME, storage16BitFeatures);
+    chainFeatures(VK_KHR_8BIT_STORAGE_EXTENSION_NAME, storage8BitFeatures);
+    chainFeatures(VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME,
+                  float16Int8Features);
+    chainFeatures(VK_KHR_VULKAN_MEMORY_MODEL_EXTENSION_NAME,
+                  memoryModelFeatures);
+#ifdef VK_KHR_cooperative_matrix
+    chainFeatures(VK_KHR_COOPERATIVE_MATRIX_EXTENSION_NAME,
+                  cooperativeMatrixFeatures);
+#endif // VK_KHR_cooperative_matrix
+
+    if (features2.pNext) {
+        physicalDevice.getFeatures2(&features2);
+
+        // The core features are provided through the chain instead
+        features2.features = enabledFeatures;
+        deviceCreateInfo.pEnabledFeatures = nullptr;
+        deviceCreateInfo.pNext = &features2;
+    }
+
+    // Structures that were not chained are left with all features disabled
+    this->mShaderTypeFeatures.shaderFloat16 =
+      float16Int8Features.shaderFloat16;
+    this->mShaderTypeFeatures.shaderInt8 = float16Int8Features.shaderInt8;
+    this->mShaderTypeFeatures.storageBuffer16BitAccess =
+      storage16BitFeatures.storageBuffer16BitAccess;
+    this->mShaderTypeFeatures.storageBuffer8BitAccess =
+      storage8BitFeatures.storageBuffer8BitAccess;
+
+#ifdef VK_KHR_cooperative_matrix
+    // The shaders of kp::OpMatMul also need the memory model and fp16 types
+    this->mCooperativeMatrixEnabled =
+      cooperativeMatrixFeatures.cooperativeMatrix &&
+      memoryModelFeatures.vulkanMemoryModel &&
+      this->mShaderTypeFeatures.shaderFloat16 &&
+      this->mShaderTypeFeatures.storageBuffer16BitAccess;
+    KP_LOG_DEBUG("Kompute Manager cooperative matrices enabled: {}",
+                 this->mCooperativeMatrixEnabled);
+#endif // VK_KHR_cooperative_matrix
 
     this->mDevice = std::make_shared<vk::Device>();
     physicalDevice.createDevice(
@@ -490,8 +618,65 @@ Manager::createDevice(const std::vector<uint32_t>& familyQueueIndices,
     KP_LOG_DEBUG("Kompute Manager compute queue obtained");
 }
 
+ThreadPool&
+Manager::getThreadPool()
+{
+    if (!this->mThreadPool) {
+        this->mThreadPool = std::unique_ptr<ThreadPool>(new ThreadPool());
+    }
+    return *this->mThreadPool;
+}
+
+void
+Manager::createMemoryBudget()
+{
+    KP_LOG_DEBUG("Kompute Manager creating memory budget, extension enabled: "
+                 "{}",
+                 this->mMemoryBudgetEnabled);
+
+    // The sequence copying the data of evicted tensors is not attached to
+    // the budget, and managers of external devices have no queues for it
+    std::shared_ptr<Sequence> sequence = nullptr;
+    if (!this->mComputeQueues.empty()) {
+        sequence = this->sequence();
+    }
+
+    this->mMemoryBudget =
+      std::make_shared<MemoryBudget>(this->mPhysicalDevice,
+                                     this->mDevice,
+                                     this->mMemoryBudgetEnabled,
+                                     sequence);
+}
+
+void
+Manager::manageMemory(std::shared_ptr<Memory> memory)
+{
+    if (this->mManageResources) {
+        this->mManagedMemObjects.push_back(memory);
+    }
+
+    this->mMemoryBudget->track(memory);
+    this->mMemoryBudget->enforce({ memory });
+}
+
+std::shared_ptr<MemoryBudget>
+Manager::getMemoryBudget() const
+{
+    return this->mMemoryBudget;
+}
+
+void
+Manager::fill(std::shared_ptr<Memory> memory, double value)
+{
+    KP_LOG_DEBUG("Kompute Manager filling memory object with {}", value);
+
+    this->sequence()->eval<OpFill>({ memory }, value);
+}
+
 std::shared_ptr<Sequence>
-Manager::sequence(uint32_t queueIndex, uint32_t totalTimestamps)
+Manager::sequence(uint32_t queueIndex,
+                  uint32_t totalTimestamps,
+                  uint32_t totalPipelineStatistics)
 {
     KP_LOG_DEBUG("Kompute Manager sequence() with queueIndex: {}", queueIndex);
 
@@ -500,12 +685,17 @@ Manager::sequence(uint32_t queueIndex, uint32_t totalTimestamps)
       this->mDevice,
       this->mComputeQueues[queueIndex],
       this->mComputeQueueFamilyIndices[queueIndex],
-      totalTimestamps) };
+      totalTimestamps,
+      totalPipelineStatistics) };
 
     if (this->mManageResources) {
         this->mManagedSequences.push_back(sq);
     }
 
+    if (this->mMemoryBudget) {
+        sq->setMemoryBudget(this->mMemoryBudget);
+    }
+
     return sq;
 }
 
@@ -515,6 +705,71 @@ Manager::getDeviceProperties() const
     return this->mPhysicalDevice->getProperties();
 }
 
+std::array<uint8_t, VK_UUID_SIZE>
+Manager::getDeviceUUID() const
+{
+    vk::StructureChain<vk::PhysicalDeviceProperties2,
+                       vk::PhysicalDeviceIDProperties>
+      properties = this->mPhysicalDevice->getProperties2<
+        vk::PhysicalDeviceProperties2,
+        vk::PhysicalDeviceIDProperties>();
+
+    const vk::PhysicalDeviceIDProperties& idProperties =
+      properties.get<vk::PhysicalDeviceIDProperties>();
+
+    std::array<uint8_t, VK_UUID_SIZE> uuid;
+    std::copy(idProperties.deviceUUID.begin(),
+              idProperties.deviceUUID.end(),
+              uuid.begin());
+    return uuid;
+}
+
+Manager::ShaderTypeFeatures
+Manager::getShaderTypeFeatures() const
+{
+    return this->mShaderTypeFeatures;
+}
+
+vk::PhysicalDeviceSubgroupProperties
+Manager::getSubgroupProperties() const
+{
+    vk::StructureChain<vk::PhysicalDeviceProperties2,
+                       vk::PhysicalDeviceSubgroupProperties>
+      properties = this->mPhysicalDevice->getProperties2<
+        vk::PhysicalDeviceProperties2,
+        vk::PhysicalDeviceSubgroupProperties>();
+
+    return properties.get<vk::PhysicalDeviceSubgroupProperties>();
+}
+
+#ifdef VK_KHR_cooperative_matrix
+std::vector<vk::CooperativeMatrixPropertiesKHR>
+Manager::getCooperativeMatrixProperties() const
+{
+    if (!this->mCooperativeMatrixEnabled) {
+        return {};
+    }
+
+#if VK_USE_PLATFORM_ANDROID_KHR
+    PFN_vkGetInstanceProcAddr getInstanceProcAddr =
+      VULKAN_HPP_DEFAULT_DISPATCHER.vkGetInstanceProcAddr;
+#else
+    PFN_vkGetInstanceProcAddr getInstanceProcAddr = &vkGetInstanceProcAddr;
+#endif // VK_USE_PLATFORM_ANDROID_KHR
+
+#ifdef VK_VERSION_1_4
+    vk::detail::DispatchLoaderDynamic dispatcher(*this->mInstance,
+                                                 getInstanceProcAddr);
+#else
+    vk::DispatchLoaderDynamic dispatcher(*this->mInstance,
+                                         getInstanceProcAddr);
+#endif // VK_VERSION_1_4
+
+    return this->mPhysicalDevice->getCooperativeMatrixPropertiesKHR(
+      dispatcher);
+}
+#endif // VK_KHR_cooperative_matrix
+
 std::vector<vk::PhysicalDevice>
 Manager::listDevices() const
 {
@@ -527,4 +782,46 @@ Manager::getVkInstance() const
     return this->mInstance;
 }
 
+std::pair<std::vector<vk::PerformanceCounterKHR>,
+          std::vector<vk::PerformanceCounterDescriptionKHR>>
+Manager::listPerformanceCounters(uint32_t queueIndex) const
+{
+    std::vector<vk::ExtensionProperties> deviceExtensions =
+      this->mPhysicalDevice->enumerateDeviceExtensionProperties();
+
+    bool performanceQuerySupported = false;
+    for (const vk::ExtensionProperties& ext : deviceExtensions) {
+        if (std::string(ext.extensionName.data()) ==
+            VK_KHR_PERFORMANCE_QUERY_EXTENSION_NAME) {
+            performanceQuerySupported = true;
+            break;
+        }
+    }
+
+    if (!performanceQuerySupported) {
+        KP_LOG_WARN("Kompute Manager device does not support {}",
+                    VK_KHR_PERFORMANCE_QUERY_EXTENSION_NAME);
+        return {};
+    }
+
+#if VK_USE_PLATFORM_ANDROID_KHR
+    PFN_vkGetInstanceProcAddr getInstanceProcAddr =
+      VULKAN_HPP_DEFAULT_DISPATCHER.vkGetInstanceProcAddr;
+#else
+    PFN_vkGetInstanceProcAddr getInstanceProcAddr = &vkGetInstanceProcAddr;
+#endif // VK_USE_PLATFORM_ANDROID_KHR
+
+#ifdef VK_VERSION_1_4
+    vk::detail::DispatchLoaderDynamic dispatcher(*this->mInstance,
+                                                 getInstanceProcAddr);
+#else
+    vk::DispatchLoaderDynamic dispatcher(*this->mInstance,
+                                         getInstanceProcAddr);
+#endif // VK_VERSION_1_4
+
+    return this->mPhysicalDevice
+      ->enumerateQueueFamilyPerformanceQueryCountersKHR(
+        this->mComputeQueueFamilyIndices[queueIndex], dispatcher);
+}
+
 }
@@ -8,6 +8,7 @@
 #else
 #include <fmt/core.h>
 #endif
+#include <algorithm>
 
 namespace kp {
 
@@ -69,6 +70,12 @@ Memory::toString(Memory::DataTypes dt)
             return "eFloat";
         case DataTypes::eDouble:
             return "eDouble";
+        case DataTypes::eHalf:
+            return "eHalf";
+        case DataTypes::eBFloat16:
+            return "eBFloat16";
+        case DataTypes::eQInt8:
+            return "eQInt8";
         default:
             return "unknown";
     }
@@ -114,6 +121,12 @@ Memory::dataTypeMemorySize(DataTypes dt)
             return sizeof(float);
         case DataTypes::eDouble:
             return sizeof(double);
+        case DataTypes::eHalf:
+            return sizeof(Half);
+        case DataTypes::eBFloat16:
+            return sizeof(BFloat16);
+        case DataTypes::eQInt8:
+            return sizeof(QInt8);
         default:
             return 0;
     }
@@ -134,6 +147,10 @@ Memory::memorySize()
 void*
 Memory::rawData()
 {
+    // The data can be modified through the pointer
+    this->resolveHostDataDependents();
+    this->resolveHostData();
+
     if (!this->mRawData) {
         this->mapRawData();
     }
@@ -148,10 +165,212 @@ Memory::setData(const void* data, size_t size)
           "Kompute Memory Cannot set data of different sizes");
     }
 
+    this->resolveHostDataDependents();
+    this->discardDeferredHostData();
+
     if (!this->mRawData) {
         this->mapRawData();
     }
     memcpy(this->mRawData, data, this->memorySize());
+
+    // The data set from the host replaces the one on the device
+    this->mDeviceDataNewer = false;
+}
+
+void
+Memory::deferHostDataCopy(std::shared_ptr<Memory> source)
+{
+    if (!source || source.get() == this) {
+        throw std::runtime_error(
+          "Kompute Memory cannot defer a host data copy from itself");
+    }
+    if (source->memorySize() != this->memorySize()) {
+        throw std::runtime_error(fmt::format(
+          "Kompute Memory cannot defer a host data copy of {} bytes into {}",
+          source->memorySize(),
+          this->memorySize()));
+    }
+
+    // The dependents expect the host data this memory object has now
+    this->resolveHostDataDependents();
+    this->discardDeferredHostData();
+
+    source->mHostDataDependents.push_back(this);
+    this->mHostDataSource = source;
+}
+
+bool
+Memory::hasDeferredHostData()
+{
+    return this->mHostDataSource != nullptr;
+}
+
+void
+Memory::resolveHostData()
+{
+    if (!this->mHostDataSource) {
+        return;
+    }
+
+    std::shared_ptr<Memory> source = this->mHostDataSource;
+    this->discardDeferredHostData();
+
+    if (!source->hasHostVisibleMemory() || !this->hasHostVisibleMemory()) {
+        KP_LOG_WARN("Kompute Memory dropping deferred host data copy of "
+                    "destroyed memory");
+        return;
+    }
+
+    KP_LOG_DEBUG("Kompute Memory resolving deferred host data copy of {} "
+                 "bytes",
+                 this->memorySize());
+
+    // The source may itself be waiting for its host data
+    source->resolveHostData();
+
+    if (!source->mRawData) {
+        source->mapRawData();
+    }
+    if (!this->mRawData) {
+        this->mapRawData();
+    }
+    memcpy(this->mRawData, source->mRawData, this->memorySize());
+}
+
+void
+Memory::resolveHostDataDependents()
+{
+    // Resolving removes the dependent from the list
+    while (!this->mHostDataDependents.empty()) {
+        this->mHostDataDependents.back()->resolveHostData();
+    }
+}
+
+void
+Memory::discardDeferredHostData()
+{
+    if (!this->mHostDataSource) {
+        return;
+    }
+
+    std::vector<Memory*>& dependents =
+      this->mHostDataSource->mHostDataDependents;
+    dependents.erase(std::remove(dependents.begin(), dependents.end(), this),
+                     dependents.end());
+    this->mHostDataSource = nullptr;
+}
+
+bool
+Memory::isDeviceDataNewer()
+{
+    return this->mDeviceDataNewer;
+}
+
+void
+Memory::setDeviceDataNewer(bool newer)
+{
+    this->mDeviceDataNewer = newer;
+}
+
+void
+Memory::setQuantization(float scale, int32_t zeroPoint)
+{
+    if (!(scale > 0)) {
+        throw std::runtime_error(
+          "Kompute Memory quantization scale must be positive");
+    }
+    this->mQuantizationScale = scale;
+    this->mQuantizationZeroPoint = zeroPoint;
+}
+
+float
+Memory::quantizationScale()
+{
+    return this->mQuantizationScale;
+}
+
+int32_t
+Memory::quantizationZeroPoint()
+{
+    return this->mQuantizationZeroPoint;
+}
+
+void
+Memory::setFloatData(const std::vector<float>& data)
+{
+    if (data.size() != this->size()) {
+        throw std::runtime_error(
+          "Kompute Memory Cannot set data of different sizes");
+    }
+
+    switch (this->mDataType) {
+        case DataTypes::eFloat:
+            this->setData(data);
+            break;
+        case DataTypes::eHalf:
+            this->setData(std::vector<Half>(data.begin(), data.end()));
+            break;
+        case DataTypes::eBFloat16:
+            this->setData(std::vector<BFloat16>(data.begin(), data.end()));
+            break;
+        case DataTypes::eQInt8: {
+            std::vector<QInt8> quantized(data.size());
+            for (size_t i = 0; i < data.size(); i++) {
+                quantized[i].value = quantizeInt8(data[i],
+                                                  this->mQuantizationScale,
+                                                  this->mQuantizationZeroPoint);
+            }
+            this->setData(quantized);
+            break;
+        }
+        default:
+            throw std::runtime_error(
+              "Kompute Memory cannot convert floats to data type " +
+              Memory::toString(this->mDataType));
+    }
+}
+
+std::vector<float>
+Memory::floatVector()
+{
+    switch (this->mDataType) {
+        case DataTypes::eFloat:
+            return this->vector<float>();
+        case DataTypes::eHalf: {
+            std::vector<Half> halves = this->vector<Half>();
+            return std::vector<float>(halves.begin(), halves.end());
+        }
+        case DataTypes::eBFloat16: {
+            std::vector<BFloat16> values = this->vector<BFloat16>();
+            return std::vector<float>(values.begin(), values.end());
+        }
+        case DataTypes::eQInt8: {
+            std::vector<QInt8> quantized = this->vector<QInt8>();
+            std::vector<float> values(quantized.size());
+            for (size_t i = 0; i < quantized.size(); i++) {
+                values[i] = dequantizeInt8(quantized[i].value,
+                                           this->mQuantizationScale,
+                                           this->mQuantizationZeroPoint);
+            }
+            return values;
+        }
+        default:
+            throw std::runtime_error(
+              "Kompute Memory cannot convert data type " +
+              Memory::toString(this->mDataType) + " to floats");
+    }
+}
+
+bool
+Memory::hasHostVisibleMemory()
+{
+    if (this->mMemoryType == MemoryTypes::eHost ||
+        this->mMemoryType == MemoryTypes::eDeviceAndHost) {
+        return this->mPrimaryMemory != nullptr;
+    } else if (this->mMemoryType == MemoryTypes::eDevice) {
+        return this->mStagingMemory != nullptr;
+    }
+    return false;
 }
 
 void
@@ -216,6 +435,8 @@ Memory::updateRawData(void* data)
 {
     if (this->memoryType() != Memory::MemoryTypes::eStorage &&
         data != nullptr) {
+        this->resolveHostDataDependents();
+        this->discardDeferredHostData();
         this->mapRawData();
         memcpy(this->mRawData, data, this->memorySize());
     }
@@ -289,6 +510,10 @@ Memory::recordCopyFrom(const vk::CommandBuffer& commandBuffer,
 void
 Memory::destroy(void)
 {
+    // The deferred copies from this memory object need its host data
+    this->resolveHostDataDependents();
+    this->discardDeferredHostData();
+
     // Setting raw data to null regardless whether device is available to
     // invalidate Memory
     this->mRawData = nullptr;
@@ -0,0 +1,291 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/MemoryBudget.hpp"
+#include "kompute/operations/OpSyncDevice.hpp"
+#include "kompute/operations/OpSyncLocal.hpp"
+
+#include <algorithm>
+
+namespace kp {
+
+// Device memory allocated by a memory object, which excludes the memory of
+// transient tensors shared through their sequence and of evicted tensors
+static vk::DeviceSize
+deviceMemorySize(const std::shared_ptr<Memory>& memory)
+{
+    if (memory->memoryType() == Memory::MemoryTypes::eHost) {
+        return 0;
+    }
+    if (memory->type() == Memory::Type::eTensor) {
+        std::shared_ptr<Tensor> tensor =
+          std::static_pointer_cast<Tensor>(memory);
+        if (tensor->isTransient() || !tensor->isMemoryBound()) {
+            return 0;
+        }
+    }
+    return memory->memorySize();
+}
+
+MemoryBudget::MemoryBudget(std::shared_ptr<vk::PhysicalDevice> physicalDevice,
+                           std::shared_ptr<vk::Device> device,
+                           bool extensionEnabled,
+                           std::shared_ptr<Sequence> sequence)
+{
+    this->mPhysicalDevice = physicalDevice;
+    this->mDevice = device;
+    this->mExtensionEnabled = extensionEnabled;
+    this->mSequence = sequence;
+}
+
+std::vector<MemoryBudget::Heap>
+MemoryBudget::getHeaps() const
+{
+    vk::PhysicalDeviceMemoryProperties2 properties2;
+    vk::PhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties;
+    if (this->mExtensionEnabled) {
+        properties2.pNext = &budgetProperties;
+    }
+    this->mPhysicalDevice->getMemoryProperties2(&properties2);
+
+    const vk::PhysicalDeviceMemoryProperties& properties =
+      properties2.memoryProperties;
+
+    // Without the extension the tracked memory is accounted to the largest
+    // device local heap, which is where the device memory is allocated
+    uint32_t deviceHeapIndex = 0;
+    vk::DeviceSize deviceHeapSize = 0;
+    for (uint32_t i = 0; i < properties.memoryHeapCount; i++) {
+        const vk::MemoryHeap& memoryHeap = properties.memoryHeaps[i];
+        if ((memoryHeap.flags & vk::MemoryHeapFlagBits::eDeviceLocal) &&
+            memoryHeap.size > deviceHeapSize) {
+            deviceHeapIndex = i;
+            deviceHeapSize = memoryHeap.size;
+        }
+    }
+
+    std::vector<Heap> heaps;
+    for (uint32_t i = 0; i < properties.memoryHeapCount; i++) {
+        Heap heap;
+        heap.index = i;
+        heap.flags = properties.memoryHeaps[i].flags;
+        heap.size = properties.memoryHeaps[i].size;
+        if (this->mExtensionEnabled) {
+            heap.budget = budgetProperties.heapBudget[i];
+            heap.usage = budgetProperties.heapUsage[i];
+        } else {
+            heap.budget = heap.size;
+            heap.usage = i == deviceHeapIndex ? this->getAllocatedSize() : 0;
+        }
+        heaps.push_back(heap);
+    }
+
+    return heaps;
+}
+
+bool
+MemoryBudget::isExtensionEnabled() const
+{
+    return this->mExtensionEnabled;
+}
+
+void
+MemoryBudget::setSoftLimit(double fraction, const Callback& callback)
+{
+    if (fraction < 0) {
+        throw std::runtime_error(
+          "Kompute MemoryBudget soft limit cannot be negative");
+    }
+
+    this->mSoftLimit = fraction;
+    this->mCallback = callback;
+}
+
+void
+MemoryBudget::setEvictionEnabled(bool enabled)
+{
+    if (enabled && !this->mSequence) {
+        throw std::runtime_error(
+          "Kompute MemoryBudget eviction requires a sequence to copy the "
+          "data of the evicted tensors");
+    }
+
+    this->mEvictionEnabled = enabled;
+}
+
+void
+MemoryBudget::track(std::shared_ptr<Memory> memory)
+{
+    Entry entry;
+    entry.memory = memory;
+    entry.lastUse = ++this->mTick;
+    this->mEntries[memory.get()] = entry;
+}
+
+void
+MemoryBudget::use(const std::vector<std::shared_ptr<Memory>>& memObjects)
+{
+    uint64_t tick = ++this->mTick;
+
+    for (const std::shared_ptr<Memory>& memory : memObjects) {
+        std::map<const Memory*, Entry>::iterator it =
+          this->mEntries.find(memory.get());
+        if (it == this->mEntries.end() || it->second.memory.expired()) {
+            continue;
+        }
+        it->second.lastUse = tick;
+
+        if (memory->type() != Memory::Type::eTensor) {
+            continue;
+        }
+        std::shared_ptr<Tensor> tensor =
+          std::static_pointer_cast<Tensor>(memory);
+        if (!tensor->isEvicted()) {
+            continue;
+        }
+
+        KP_LOG_DEBUG("Kompute MemoryBudget restoring evicted tensor of {} "
+                     "bytes",
+                     tensor->memorySize());
+
+        tensor->restore();
+        this->mSequence->eval<OpSyncDevice>({ tensor });
+        this->mRestoreCount++;
+    }
+}
+
+void
+MemoryBudget::enforce(const std::vector<std::shared_ptr<Memory>>& memObjects)
+{
+    bool overLimit = false;
+    for (const Heap& heap : this->getHeaps()) {
+        if ((heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal) &&
+            heap.usage > heap.budget * this->mSoftLimit) {
+            KP_LOG_DEBUG("Kompute MemoryBudget heap {} usage {} over soft "
+                         "limit of budget {}",
+                         heap.index,
+                         heap.usage,
+                         heap.budget);
+            overLimit = true;
+            if (this->mCallback) {
+                this->mCallback(heap);
+            }
+        }
+    }
+
+    if (!overLimit || !this->mEvictionEnabled) {
+        return;
+    }
+
+    // The usage is queried again after each eviction as the budget reported
+    // by the driver can change with the allocations of other processes
+    while (overLimit) {
+        if (!this->evictLeastRecentlyUsed(memObjects)) {
+            KP_LOG_WARN("Kompute MemoryBudget over soft limit without "
+                        "tensors left to evict");
+            return;
+        }
+
+        overLimit = false;
+        for (const Heap& heap : this->getHeaps()) {
+            if ((heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal) &&
+                heap.usage > heap.budget * this->mSoftLimit) {
+                overLimit = true;
+            }
+        }
+    }
+}
+
+bool
+MemoryBudget::evictLeastRecentlyUsed(
+  const std::vector<std::shared_ptr<Memory>>& memObjects)
+{
+    std::shared_ptr<Tensor> leastRecentlyUsed = nullptr;
+    uint64_t lastUse = 0;
+
+    for (std::map<const Memory*, Entry>::iterator it = this->mEntries.begin();
+         it != this->mEntries.end();) {
+        std::shared_ptr<Memory> memory = it->second.memory.lock();
+        if (!memory) {
+            it = this->mEntries.erase(it);
+            continue;
+        }
+        uint64_t entryLastUse = it->second.lastUse;
+        it++;
+
+        if (memory->type() != Memory::Type::eTensor ||
+            memory->memoryType() != Memory::MemoryTypes::eDevice ||
+            !memory->isInit()) {
+            continue;
+        }
+        std::shared_ptr<Tensor> tensor =
+          std::static_pointer_cast<Tensor>(memory);
+        if (tensor->isEvicted() ||
+            std::find(memObjects.begin(), memObjects.end(), memory) !=
+              memObjects.end()) {
+            continue;
+        }
+        if (!leastRecentlyUsed || entryLastUse < lastUse) {
+            leastRecentlyUsed = tensor;
+            lastUse = entryLastUse;
+        }
+    }
+
+    if (!leastRecentlyUsed) {
+        return false;
+    }
+
+    KP_LOG_INFO("Kompute MemoryBudget evicting tensor of {} bytes",
+                leastRecentlyUsed->memorySize());
+
+    // The tensor could still be used by a sequence running asynchronously
+    this->mDevice->waitIdle();
+
+    // The staging memory already holds the data of tensors that were not
+    // written on the device since they were last synced or set from the host
+    if (leastRecentlyUsed->isDeviceDataNewer()) {
+        this->mSequence->eval<OpSyncLocal>({ leastRecentlyUsed });
+    }
+    leastRecentlyUsed->evict();
+    this->mEvictionCount++;
+
+    return true;
+}
+
+vk::DeviceSize
+MemoryBudget::getAllocatedSize() const
+{
+    vk::DeviceSize allocatedSize = 0;
+    for (const auto& entry : this->mEntries) {
+        if (std::shared_ptr<Memory> memory = entry.second.memory.lock()) {
+            allocatedSize += deviceMemorySize(memory);
+        }
+    }
+    return allocatedSize;
+}
+
+uint64_t
+MemoryBudget::getEvictionCount() const
+{
+    return this->mEvictionCount;
+}
+
+uint64_t
+MemoryBudget::getRestoreCount() const
+{
+    return this->mRestoreCount;
+}
+
+bool
+MemoryBudget::hasEvictedTensors() const
+{
+    for (const auto& entry : this->mEntries) {
+        std::shared_ptr<Memory> memory = entry.second.memory.lock();
+        if (memory && memory->type() == Memory::Type::eTensor &&
+            std::static_pointer_cast<Tensor>(memory)->isEvicted()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
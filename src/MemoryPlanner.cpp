@@ -0,0 +1,320 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/MemoryPlanner.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace kp {
+
+// Transient tensors used by an operation that do not have memory yet
+static std::vector<std::shared_ptr<Tensor>>
+unboundTransientTensors(const OpBase& op)
+{
+    std::vector<std::shared_ptr<Tensor>> tensors;
+    for (const std::shared_ptr<Memory>& mem : op.getMemObjects()) {
+        if (!mem || mem->type() != Memory::Type::eTensor) {
+            continue;
+        }
+        std::shared_ptr<Tensor> tensor = std::static_pointer_cast<Tensor>(mem);
+        if (tensor->isTransient() && !tensor->isMemoryBound()) {
+            tensors.push_back(tensor);
+        }
+    }
+    return tensors;
+}
+
+// The lifetimes cannot be computed if an operation does not report the
+// memory objects it accesses
+static void
+checkReportsMemObjects(const OpBase& op)
+{
+    if (!op.reportsMemObjects()) {
+        throw std::runtime_error(
+          "Kompute MemoryPlanner operation " + op.name() +
+          " does not override getMemObjects() so it cannot be recorded in a "
+          "sequence with transient tensors");
+    }
+}
+
+static vk::DeviceSize
+alignUp(vk::DeviceSize value, vk::DeviceSize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+MemoryPlanner::MemoryPlanner(std::shared_ptr<vk::PhysicalDevice> physicalDevice,
+                             std::shared_ptr<vk::Device> device)
+{
+    this->mPhysicalDevice = physicalDevice;
+    this->mDevice = device;
+}
+
+MemoryPlanner::~MemoryPlanner()
+{
+    this->destroy();
+}
+
+bool
+MemoryPlanner::needsPlan(const OpBase& op)
+{
+    return !unboundTransientTensors(op).empty();
+}
+
+void
+MemoryPlanner::plan(const std::vector<std::shared_ptr<OpBase>>& operations)
+{
+    struct Lifetime
+    {
+        std::shared_ptr<Tensor> tensor;
+        uint32_t first;
+        uint32_t last;
+        vk::MemoryRequirements requirements;
+        vk::DeviceSize offset;
+    };
+
+    std::vector<Lifetime> lifetimes;
+    std::map<const Tensor*, size_t> indices;
+
+    for (uint32_t i = 0; i < operations.size(); i++) {
+        for (const std::shared_ptr<Tensor>& tensor :
+             unboundTransientTensors(*operations[i])) {
+            std::map<const Tensor*, size_t>::iterator it =
+              indices.find(tensor.get());
+            if (it != indices.end()) {
+                lifetimes[it->second].last = i;
+                continue;
+            }
+            indices[tensor.get()] = lifetimes.size();
+            lifetimes.push_back(
+              { tensor, i, i, tensor->getPrimaryMemoryRequirements(), 0 });
+        }
+    }
+
+    if (lifetimes.empty()) {
+        return;
+    }
+
+    for (const std::shared_ptr<OpBase>& op : operations) {
+        checkReportsMemObjects(*op);
+    }
+
+    // The largest tensors are placed first so the smaller ones fill the gaps
+    std::vector<size_t> order(lifetimes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return lifetimes[a].requirements.size > lifetimes[b].requirements.size;
+    });
+
+    std::vector<const Lifetime*> placed;
+    vk::DeviceSize blockSize = 0;
+    vk::DeviceSize tensorsSize = 0;
+    uint32_t memoryTypeBits = ~0u;
+
+    for (size_t index : order) {
+        Lifetime& lifetime = lifetimes[index];
+        const vk::MemoryRequirements& requirements = lifetime.requirements;
+
+        // Only the tensors used at the same time cannot share memory
+        std::vector<const Lifetime*> conflicts;
+        for (const Lifetime* other : placed) {
+            if (other->first <= lifetime.last &&
+                lifetime.first <= other->last) {
+                conflicts.push_back(other);
+            }
+        }
+        std::sort(conflicts.begin(),
+                  conflicts.end(),
+                  [](const Lifetime* a, const Lifetime* b) {
+                      return a->offset < b->offset;
+                  });
+
+        // First fit after the conflicting tensors sorted by offset
+        vk::DeviceSize offset = 0;
+        for (const Lifetime* conflict : conflicts) {
+            vk::DeviceSize conflictEnd =
+              conflict->offset + conflict->requirements.size;
+            if (offset < conflictEnd &&
+                conflict->offset < offset + requirements.size) {
+                offset = alignUp(conflictEnd, requirements.alignment);
+            }
+        }
+
+        lifetime.offset = offset;
+        placed.push_back(&lifetime);
+        blockSize = std::max(blockSize, offset + requirements.size);
+        tensorsSize += requirements.size;
+        memoryTypeBits &= requirements.memoryTypeBits;
+    }
+
+    std::shared_ptr<vk::DeviceMemory> memory =
+      this->allocateMemory(blockSize, memoryTypeBits);
+    this->mMemoryBlocks.push_back(memory);
+
+    for (const Lifetime& lifetime : lifetimes) {
+        lifetime.tensor->bindTransientMemory(memory, lifetime.offset);
+        const vk::MemoryRequirements& requirements = lifetime.requirements;
+        this->mPlacements[lifetime.tensor.get()] = {
+            lifetime.tensor, *memory, lifetime.offset, requirements.size
+        };
+    }
+
+    this->mMemorySize += blockSize;
+    this->mTensorsMemorySize += tensorsSize;
+
+    KP_LOG_INFO("Kompute MemoryPlanner placed {} transient tensors of {} "
+                "bytes in {} bytes",
+                lifetimes.size(),
+                tensorsSize,
+                blockSize);
+}
+
+void
+MemoryPlanner::recordAliasBarrier(const vk::CommandBuffer& commandBuffer,
+                                  const OpBase& op)
+{
+    if (!this->mPlacements.empty()) {
+        checkReportsMemObjects(op);
+    }
+
+    bool aliased = false;
+
+    for (const std::shared_ptr<Memory>& mem : op.getMemObjects()) {
+        if (!mem || mem->type() != Memory::Type::eTensor) {
+            continue;
+        }
+        const Tensor* tensor = static_cast<const Tensor*>(mem.get());
+
+        std::map<const Tensor*, Placement>::iterator it =
+          this->mPlacements.find(tensor);
+        if (it == this->mPlacements.end() || it->second.tensor.expired()) {
+            continue;
+        }
+        if (std::find(this->mLiveTensors.begin(),
+                      this->mLiveTensors.end(),
+                      tensor) != this->mLiveTensors.end()) {
+            continue;
+        }
+
+        // The contents of the tensors this one overlaps are no longer used
+        const Placement& placement = it->second;
+        std::vector<const Tensor*>::iterator liveIt =
+          this->mLiveTensors.begin();
+        while (liveIt != this->mLiveTensors.end()) {
+            const Placement& other = this->mPlacements[*liveIt];
+            if (other.memory == placement.memory &&
+                other.offset < placement.offset + placement.size &&
+                placement.offset < other.offset + other.size) {
+                aliased = true;
+                liveIt = this->mLiveTensors.erase(liveIt);
+            } else {
+                liveIt++;
+            }
+        }
+
+        this->mLiveTensors.push_back(tensor);
+    }
+
+    if (!aliased) {
+        return;
+    }
+
+    KP_LOG_DEBUG("Kompute MemoryPlanner recording aliasing memory barrier");
+
+    vk::AccessFlags access =
+      vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite |
+      vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite;
+    vk::PipelineStageFlags stages = vk::PipelineStageFlagBits::eComputeShader |
+                                    vk::PipelineStageFlagBits::eTransfer;
+    vk::MemoryBarrier memoryBarrier(access, access);
+
+    commandBuffer.pipelineBarrier(stages,
+                                  stages,
+                                  vk::DependencyFlags(),
+                                  memoryBarrier,
+                                  nullptr,
+                                  nullptr);
+}
+
+void
+MemoryPlanner::reset()
+{
+    this->mLiveTensors.clear();
+}
+
+vk::DeviceSize
+MemoryPlanner::getMemorySize() const
+{
+    return this->mMemorySize;
+}
+
+vk::DeviceSize
+MemoryPlanner::getTensorsMemorySize() const
+{
+    return this->mTensorsMemorySize;
+}
+
+uint32_t
+MemoryPlanner::getTensorCount() const
+{
+    return this->mPlacements.size();
+}
+
+std::shared_ptr<vk::DeviceMemory>
+MemoryPlanner::allocateMemory(vk::DeviceSize size, uint32_t memoryTypeBits)
+{
+    vk::PhysicalDeviceMemoryProperties memoryProperties =
+      this->mPhysicalDevice->getMemoryProperties();
+
+    uint32_t memoryTypeIndex = -1;
+    bool memoryTypeIndexFound = false;
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+        if ((memoryTypeBits & (1 << i)) &&
+            (memoryProperties.memoryTypes[i].propertyFlags &
+             vk::MemoryPropertyFlagBits::eDeviceLocal)) {
+            memoryTypeIndex = i;
+            memoryTypeIndexFound = true;
+            break;
+        }
+    }
+    if (!memoryTypeIndexFound) {
+        throw std::runtime_error(
+          "Kompute MemoryPlanner memory type for transient tensors not found");
+    }
+
+    KP_LOG_DEBUG("Kompute MemoryPlanner allocating memory index: {}, size {}",
+                 memoryTypeIndex,
+                 size);
+
+    vk::MemoryAllocateInfo memoryAllocateInfo(size, memoryTypeIndex);
+
+    std::shared_ptr<vk::DeviceMemory> memory =
+      std::make_shared<vk::DeviceMemory>();
+    this->mDevice->allocateMemory(&memoryAllocateInfo, nullptr, memory.get());
+
+    return memory;
+}
+
+void
+MemoryPlanner::destroy()
+{
+    KP_LOG_DEBUG("Kompute MemoryPlanner destroy started");
+
+    if (!this->mDevice) {
+        return;
+    }
+
+    for (const std::shared_ptr<vk::DeviceMemory>& memory :
+         this->mMemoryBlocks) {
+        this->mDevice->freeMemory(
+          *memory, (vk::Optional<const vk::AllocationCallbacks>)nullptr);
+    }
+
+    this->mMemoryBlocks.clear();
+    this->mPlacements.clear();
+    this->mLiveTensors.clear();
+    this->mMemorySize = 0;
+    this->mTensorsMemorySize = 0;
+}
+
+}
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "kompute/operations/OpAlgoDispatch.hpp"
+#include "kompute/ImageLayoutTracker.hpp"
 
 namespace kp {
 
@@ -19,6 +20,23 @@ OpAlgoDispatch::record(const vk::CommandBuffer& commandBuffer)
 {
     KP_LOG_DEBUG("Kompute OpAlgoDispatch record called");
 
+    // The constants are copied on every submit so the values set in preEval
+    // are picked up without re-recording. A previous dispatch of the same
+    // command buffer may still be reading them when the copy starts.
+    if (this->mConstantsTensor &&
+        this->mConstantsTensor->memoryType() == Memory::MemoryTypes::eDevice) {
+        this->mConstantsTensor->recordPrimaryMemoryBarrier(
+          commandBuffer,
+          vk::AccessFlagBits::eShaderRead,
+          vk::AccessFlagBits::eTransferWrite,
+          vk::PipelineStageFlagBits::eComputeShader,
+          vk::PipelineStageFlagBits::eTransfer);
+        this->mConstantsTensor->recordCopyFromStagingToDevice(commandBuffer);
+    }
+
+    // The image transitions of the sequence are batched into one barrier
+    ImageLayoutTracker* tracker = ImageLayoutTracker::find(commandBuffer);
+
     // Barrier to ensure the data is finished writing to buffer memory
     for (const std::shared_ptr<Memory>& mem :
          this->mAlgorithm->getMemObjects()) {
@@ -28,6 +46,22 @@ OpAlgoDispatch::record(const vk::CommandBuffer& commandBuffer)
         if (mem->type() == Memory::Type::eImage) {
             std::shared_ptr<Image> image = std::static_pointer_cast<Image>(mem);
 
+            // Skipped transitions keep a memory dependency, which also
+            // orders the accesses of consecutive dispatches to the image
+            if (tracker) {
+                tracker->transition(
+                  *image,
+                  vk::ImageLayout::eGeneral,
+                  vk::AccessFlagBits::eTransferWrite |
+                    vk::AccessFlagBits::eShaderWrite,
+                  vk::AccessFlagBits::eShaderRead |
+                    vk::AccessFlagBits::eShaderWrite,
+                  vk::PipelineStageFlagBits::eTransfer |
+                    vk::PipelineStageFlagBits::eComputeShader,
+                  vk::PipelineStageFlagBits::eComputeShader);
+                continue;
+            }
+
             image->recordPrimaryImageBarrier(
               commandBuffer,
               vk::AccessFlagBits::eTransferWrite,
@@ -45,6 +79,10 @@ OpAlgoDispatch::record(const vk::CommandBuffer& commandBuffer)
         }
     }
 
+    if (tracker) {
+        tracker->flush(commandBuffer);
+    }
+
     if (this->mPushConstantsSize) {
         this->mAlgorithm->setPushConstants(
           this->mPushConstantsData,
@@ -54,6 +92,12 @@ OpAlgoDispatch::record(const vk::CommandBuffer& commandBuffer)
 
     this->mAlgorithm->recordBindCore(commandBuffer);
     this->mAlgorithm->recordBindPush(commandBuffer);
+    this->recordDispatch(commandBuffer);
+}
+
+void
+OpAlgoDispatch::recordDispatch(const vk::CommandBuffer& commandBuffer)
+{
     this->mAlgorithm->recordDispatch(commandBuffer);
 }
 
@@ -61,6 +105,12 @@ void
 OpAlgoDispatch::preEval(const vk::CommandBuffer& /*commandBuffer*/)
 {
     KP_LOG_DEBUG("Kompute OpAlgoDispatch preEval called");
+
+    if (this->mConstantsTensor && this->mPendingConstants.size()) {
+        this->mConstantsTensor->setData(this->mPendingConstants.data(),
+                                        this->mPendingConstants.size());
+        this->mPendingConstants.clear();
+    }
 }
 
 void
@@ -69,4 +119,21 @@ OpAlgoDispatch::postEval(const vk::CommandBuffer& /*commandBuffer*/)
     KP_LOG_DEBUG("Kompute OpAlgoDispatch postSubmit called");
 }
 
+std::vector<std::shared_ptr<Memory>>
+OpAlgoDispatch::getMemObjects() const
+{
+    return this->mAlgorithm->getMemObjects();
+}
+
+std::string
+OpAlgoDispatch::name() const
+{
+    const Workgroup& workgroup = this->mAlgorithm->getWorkgroup();
+    return fmt::format("OpAlgoDispatch (spirv {:016x}, workgroup {}x{}x{})",
+                       this->mAlgorithm->getSpirvHash(),
+                       workgroup[0],
+                       workgroup[1],
+                       workgroup[2]);
+}
+
 }
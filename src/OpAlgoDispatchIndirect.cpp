@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/operations/OpAlgoDispatchIndirect.hpp"
+
+namespace kp {
+
+OpAlgoDispatchIndirect::~OpAlgoDispatchIndirect() noexcept
+{
+    KP_LOG_DEBUG("Kompute OpAlgoDispatchIndirect destructor started");
+}
+
+void
+OpAlgoDispatchIndirect::record(const vk::CommandBuffer& commandBuffer)
+{
+    KP_LOG_DEBUG("Kompute OpAlgoDispatchIndirect record called");
+
+    // The dispatch parameters can be written by a previous shader or copied
+    // from the staging buffer, both need to be visible to the indirect read
+    this->mIndirectTensor->recordPrimaryMemoryBarrier(
+      commandBuffer,
+      vk::AccessFlagBits::eShaderWrite,
+      vk::AccessFlagBits::eIndirectCommandRead,
+      vk::PipelineStageFlagBits::eComputeShader,
+      vk::PipelineStageFlagBits::eDrawIndirect);
+    this->mIndirectTensor->recordPrimaryMemoryBarrier(
+      commandBuffer,
+      vk::AccessFlagBits::eTransferWrite,
+      vk::AccessFlagBits::eIndirectCommandRead,
+      vk::PipelineStageFlagBits::eTransfer,
+      vk::PipelineStageFlagBits::eDrawIndirect);
+
+    OpAlgoDispatch::record(commandBuffer);
+}
+
+void
+OpAlgoDispatchIndirect::recordDispatch(const vk::CommandBuffer& commandBuffer)
+{
+    this->mAlgorithm->recordDispatchIndirect(
+      commandBuffer, *this->mIndirectTensor->getPrimaryBuffer(), this->mOffset);
+}
+
+std::vector<std::shared_ptr<Memory>>
+OpAlgoDispatchIndirect::getMemObjects() const
+{
+    std::vector<std::shared_ptr<Memory>> memObjects =
+      OpAlgoDispatch::getMemObjects();
+    memObjects.push_back(this->mIndirectTensor);
+    return memObjects;
+}
+
+std::string
+OpAlgoDispatchIndirect::name() const
+{
+    return fmt::format("OpAlgoDispatchIndirect (spirv {:016x})",
+                       this->mAlgorithm->getSpirvHash());
+}
+
+}
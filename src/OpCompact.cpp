@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/operations/OpCompact.hpp"
+
+#include <algorithm>
+
+namespace kp {
+
+static const uint32_t DEFAULT_LOCAL_SIZE = 256;
+
+static bool
+is32BitType(Memory::DataTypes dataType)
+{
+    return dataType == Memory::DataTypes::eInt ||
+           dataType == Memory::DataTypes::eUnsignedInt ||
+           dataType == Memory::DataTypes::eFloat;
+}
+
+OpCompact::OpCompact(std::vector<std::shared_ptr<Memory>> memObjects,
+                     Manager& manager,
+                     uint32_t localSize)
+{
+    KP_LOG_DEBUG("Kompute OpCompact constructor with params");
+
+    if (memObjects.size() != 4) {
+        throw std::runtime_error(
+          "Kompute OpCompact expected 4 mem objects but got " +
+          std::to_string(memObjects.size()));
+    }
+    for (const std::shared_ptr<Memory>& mem : memObjects) {
+        if (!mem || mem->type() != Memory::Type::eTensor) {
+            throw std::runtime_error(
+              "Kompute OpCompact only supports tensor mem objects");
+        }
+    }
+
+    const std::shared_ptr<Memory>& values = memObjects[0];
+    const std::shared_ptr<Memory>& predicates = memObjects[1];
+    const std::shared_ptr<Memory>& output = memObjects[2];
+    const std::shared_ptr<Memory>& count = memObjects[3];
+
+    if (!is32BitType(values->dataType()) ||
+        output->dataType() != values->dataType()) {
+        throw std::runtime_error(
+          "Kompute OpCompact expected int, uint or float values and output "
+          "of the same type but got " +
+          Memory::toString(values->dataType()) + " and " +
+          Memory::toString(output->dataType()));
+    }
+    if (predicates->dataType() != Memory::DataTypes::eUnsignedInt ||
+        count->dataType() != Memory::DataTypes::eUnsignedInt) {
+        throw std::runtime_error(
+          "Kompute OpCompact expected uint predicates and count");
+    }
+    if (!values->size() || predicates->size() != values->size() ||
+        output->size() < values->size() || !count->size()) {
+        throw std::runtime_error(
+          "Kompute OpCompact expected a predicate per value and an output "
+          "at least as large as the values");
+    }
+
+    this->mMemObjects = memObjects;
+
+    const vk::PhysicalDeviceLimits limits =
+      manager.getDeviceProperties().limits;
+
+    if (!localSize) {
+        localSize = DEFAULT_LOCAL_SIZE;
+    }
+    localSize = std::min({ localSize,
+                           limits.maxComputeWorkGroupSize[0],
+                           limits.maxComputeWorkGroupInvocations });
+    // The scan of the predicates requires a power of two
+    while (localSize & (localSize - 1)) {
+        localSize &= localSize - 1;
+    }
+
+    uint32_t workgroups = (values->size() + localSize - 1) / localSize;
+    if (workgroups > limits.maxComputeWorkGroupCount[0]) {
+        throw std::runtime_error(
+          "Kompute OpCompact input of " + std::to_string(values->size()) +
+          " values requires more workgroups than supported by the device");
+    }
+
+    this->mPositions = manager.tensor(values->size(),
+                                      sizeof(uint32_t),
+                                      Memory::DataTypes::eUnsignedInt,
+                                      Memory::MemoryTypes::eStorage);
+
+    this->mScan = std::unique_ptr<OpScan>(new OpScan(
+      { predicates, this->mPositions }, manager, true, true, localSize));
+
+    const std::vector<uint32_t> spirv = std::vector<uint32_t>(
+      SHADEROPCOMPACT_COMP_SPV.begin(), SHADEROPCOMPACT_COMP_SPV.end());
+    if (spirv.empty()) {
+        throw std::runtime_error(
+          "Kompute OpCompact shader is not available as Kompute was built "
+          "without glslangValidator or a precompiled shader header");
+    }
+
+    this->mAlgorithm = manager.algorithm<uint32_t, uint32_t>(
+      { values, predicates, this->mPositions, output, count },
+      spirv,
+      { workgroups, 1, 1 },
+      { localSize },
+      { values->size() });
+}
+
+OpCompact::~OpCompact() noexcept
+{
+    KP_LOG_DEBUG("Kompute OpCompact destructor started");
+}
+
+void
+OpCompact::record(const vk::CommandBuffer& commandBuffer)
+{
+    KP_LOG_DEBUG("Kompute OpCompact record called");
+
+    this->mScan->record(commandBuffer);
+
+    // Barrier to ensure the data is finished writing to buffer memory
+    for (const std::shared_ptr<Memory>& mem : this->mMemObjects) {
+        mem->recordPrimaryMemoryBarrier(
+          commandBuffer,
+          vk::AccessFlagBits::eTransferWrite,
+          vk::AccessFlagBits::eShaderRead,
+          vk::PipelineStageFlagBits::eTransfer,
+          vk::PipelineStageFlagBits::eComputeShader);
+    }
+
+    // The positions written by the scan
+    this->mPositions->recordPrimaryMemoryBarrier(
+      commandBuffer,
+      vk::AccessFlagBits::eShaderWrite,
+      vk::AccessFlagBits::eShaderRead,
+      vk::PipelineStageFlagBits::eComputeShader,
+      vk::PipelineStageFlagBits::eComputeShader);
+
+    this->mAlgorithm->recordBindCore(commandBuffer);
+    this->mAlgorithm->recordBindPush(commandBuffer);
+    this->mAlgorithm->recordDispatch(commandBuffer);
+}
+
+void
+OpCompact::preEval(const vk::CommandBuffer& /*commandBuffer*/)
+{
+    KP_LOG_DEBUG("Kompute OpCompact preEval called");
+}
+
+void
+OpCompact::postEval(const vk::CommandBuffer& /*commandBuffer*/)
+{
+    KP_LOG_DEBUG("Kompute OpCompact postEval called");
+}
+
+}
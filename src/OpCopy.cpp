@@ -2,6 +2,7 @@
 
 #include "kompute/operations/OpCopy.hpp"
 #include "kompute/Image.hpp"
+#include "kompute/ImageLayoutTracker.hpp"
 #include "kompute/Tensor.hpp"
 
 namespace kp {
@@ -28,11 +29,21 @@ OpCopy::record(const vk::CommandBuffer& commandBuffer)
 {
     KP_LOG_DEBUG("Kompute OpCopy record called");
 
+    // The image transitions of all the copies are batched into one barrier
+    ImageLayoutTracker* tracker = ImageLayoutTracker::find(commandBuffer);
+    if (tracker) {
+        tracker->beginBatch();
+    }
+
     // We iterate from the second memory object onwards and record a copy to all
     for (size_t i = 1; i < this->mMemObjects.size(); i++) {
         this->mMemObjects[i]->recordCopyFrom(commandBuffer,
                                              this->mMemObjects[0]);
     }
+
+    if (tracker) {
+        tracker->endBatch(commandBuffer);
+    }
 }
 
 void
@@ -54,16 +65,38 @@ OpCopy::postEval(const vk::CommandBuffer& /*commandBuffer*/)
         return;
     }
 
-    // Copy the data from the first memory object into all the memory objects
+    const std::shared_ptr<Memory>& source = this->mMemObjects[0];
+    bool sourceHostVisible =
+      source->memoryType() != kp::Memory::MemoryTypes::eDevice;
+
+    // The host data of the destinations is copied from the source when they
+    // are accessed, rather than for every destination after each copy
     for (size_t i = 1; i < this->mMemObjects.size(); i++) {
-        if (this->mMemObjects[i]->memoryType() ==
-            kp::Memory::MemoryTypes::eStorage) {
+        const std::shared_ptr<Memory>& mem = this->mMemObjects[i];
+
+        if (mem->memoryType() == kp::Memory::MemoryTypes::eStorage) {
             KP_LOG_DEBUG("Kompute OpCopy not copying to tensor dest "
                          "given it's of eStorage type");
             continue;
         }
-        this->mMemObjects[i]->setData(this->mMemObjects[0]->rawData(),
-                                      this->mMemObjects[0]->memorySize());
+
+        bool hostVisible =
+          mem->memoryType() != kp::Memory::MemoryTypes::eDevice;
+
+        if (hostVisible && sourceHostVisible) {
+            // The GPU copy already wrote the host visible memory
+            mem->discardDeferredHostData();
+            continue;
+        }
+        if (hostVisible || sourceHostVisible) {
+            // The host visible memory is written by later GPU operations
+            // without notice, which a deferred copy would then overwrite with
+            // stale data, so it is copied now
+            mem->setData(source->rawData(), source->memorySize());
+            continue;
+        }
+
+        mem->deferHostDataCopy(source);
     }
 }
 
@@ -0,0 +1,353 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/operations/OpCopyRegions.hpp"
+#include "kompute/ImageLayoutTracker.hpp"
+
+namespace kp {
+
+OpCopyRegions::OpCopyRegions(
+  const std::vector<std::shared_ptr<Memory>>& memObjects,
+  const std::vector<Region>& regions)
+{
+    KP_LOG_DEBUG("Kompute OpCopyRegions constructor with {} regions",
+                 regions.size());
+
+    if (memObjects.size() != 2) {
+        throw std::runtime_error(
+          "Kompute OpCopyRegions expected 2 memory objects but got " +
+          std::to_string(memObjects.size()));
+    }
+    if (!memObjects[0] || !memObjects[1]) {
+        throw std::runtime_error(
+          "Kompute OpCopyRegions called with a null memory object");
+    }
+    if (memObjects[0] == memObjects[1]) {
+        throw std::runtime_error(
+          "Kompute OpCopyRegions source and destination must be different");
+    }
+    if (memObjects[0]->dataType() != memObjects[1]->dataType()) {
+        throw std::runtime_error(fmt::format(
+          "Kompute OpCopyRegions attempting to copy memory of different "
+          "types from {} to {}",
+          Memory::toString(memObjects[0]->dataType()),
+          Memory::toString(memObjects[1]->dataType())));
+    }
+    if (regions.empty()) {
+        throw std::runtime_error(
+          "Kompute OpCopyRegions called with no regions");
+    }
+
+    this->mSource = memObjects[0];
+    this->mDestination = memObjects[1];
+    this->mRegions = regions;
+
+    bool srcImage = this->mSource->type() == Memory::Type::eImage;
+    bool dstImage = this->mDestination->type() == Memory::Type::eImage;
+
+    // Copies between images need formats with texels of the same size
+    if (srcImage && dstImage) {
+        std::shared_ptr<Image> srcImg =
+          std::static_pointer_cast<Image>(this->mSource);
+        std::shared_ptr<Image> dstImg =
+          std::static_pointer_cast<Image>(this->mDestination);
+        uint32_t srcTexelSize =
+          srcImg->getNumChannels() * srcImg->dataTypeMemorySize();
+        uint32_t dstTexelSize =
+          dstImg->getNumChannels() * dstImg->dataTypeMemorySize();
+        if (srcTexelSize != dstTexelSize) {
+            throw std::runtime_error(fmt::format(
+              "Kompute OpCopyRegions attempting to copy between images with "
+              "texels of {} and {} bytes",
+              srcTexelSize,
+              dstTexelSize));
+        }
+    }
+
+    for (const Region& region : this->mRegions) {
+        if (srcImage) {
+            this->validateImageBox(this->mSource,
+                                   region.srcImageOffset,
+                                   region.imageExtent,
+                                   region.srcMipLevel,
+                                   region.srcBaseLayer,
+                                   region.layerCount);
+        }
+        if (dstImage) {
+            this->validateImageBox(this->mDestination,
+                                   region.dstImageOffset,
+                                   region.imageExtent,
+                                   region.dstMipLevel,
+                                   region.dstBaseLayer,
+                                   region.layerCount);
+        }
+
+        if (!srcImage && !dstImage) {
+            if (region.size == 0) {
+                throw std::runtime_error(
+                  "Kompute OpCopyRegions tensor region has no elements");
+            }
+            this->validateTensorRange(
+              this->mSource, region.srcOffset, region.size);
+            this->validateTensorRange(
+              this->mDestination, region.dstOffset, region.size);
+        } else if (!srcImage) {
+            this->validateTensorRange(
+              this->mSource,
+              region.srcOffset,
+              this->getTensorRangeSize(this->mDestination, region));
+        } else if (!dstImage) {
+            this->validateTensorRange(
+              this->mDestination,
+              region.dstOffset,
+              this->getTensorRangeSize(this->mSource, region));
+        }
+    }
+}
+
+OpCopyRegions::~OpCopyRegions() noexcept
+{
+    KP_LOG_DEBUG("Kompute OpCopyRegions destructor started");
+}
+
+void
+OpCopyRegions::validateTensorRange(const std::shared_ptr<Memory>& mem,
+                                   uint64_t offset,
+                                   uint64_t size)
+{
+    if (offset + size > mem->size()) {
+        throw std::runtime_error(
+          fmt::format("Kompute OpCopyRegions range of {} elements at {} is "
+                      "outside of the tensor of size {}",
+                      size,
+                      offset,
+                      mem->size()));
+    }
+}
+
+void
+OpCopyRegions::validateImageBox(const std::shared_ptr<Memory>& mem,
+                                const vk::Offset3D& offset,
+                                const vk::Extent3D& extent,
+                                uint32_t mipLevel,
+                                uint32_t baseLayer,
+                                uint32_t layerCount)
+{
+    std::shared_ptr<Image> image = std::static_pointer_cast<Image>(mem);
+
+    if (mipLevel >= image->getMipLevels()) {
+        throw std::runtime_error(
+          fmt::format("Kompute OpCopyRegions mip level {} is outside of the "
+                      "image with {} levels",
+                      mipLevel,
+                      image->getMipLevels()));
+    }
+    if (layerCount == 0 || baseLayer + layerCount > image->getLayers()) {
+        throw std::runtime_error(
+          fmt::format("Kompute OpCopyRegions layers {} to {} are outside of "
+                      "the image with {} layers",
+                      baseLayer,
+                      baseLayer + layerCount,
+                      image->getLayers()));
+    }
+
+    vk::Extent3D levelExtent = image->getExtent(mipLevel);
+    if (extent.width == 0 || extent.height == 0 || extent.depth == 0 ||
+        offset.x < 0 || offset.y < 0 || offset.z < 0 ||
+        offset.x + extent.width > levelExtent.width ||
+        offset.y + extent.height > levelExtent.height ||
+        offset.z + extent.depth > levelExtent.depth) {
+        throw std::runtime_error(fmt::format(
+          "Kompute OpCopyRegions box of {}x{}x{} texels at ({}, {}, {}) is "
+          "empty or outside of the image level of {}x{}x{} texels",
+          extent.width,
+          extent.height,
+          extent.depth,
+          offset.x,
+          offset.y,
+          offset.z,
+          levelExtent.width,
+          levelExtent.height,
+          levelExtent.depth));
+    }
+}
+
+uint64_t
+OpCopyRegions::getTensorRangeSize(const std::shared_ptr<Memory>& mem,
+                                  const Region& region)
+{
+    std::shared_ptr<Image> image = std::static_pointer_cast<Image>(mem);
+
+    if (region.rowLength != 0 &&
+        region.rowLength < region.imageExtent.width) {
+        throw std::runtime_error(
+          "Kompute OpCopyRegions row length is smaller than the image extent");
+    }
+
+    // Vulkan requires buffer offsets aligned to 4 bytes and to the texels
+    uint64_t offset =
+      this->mSource->type() == Memory::Type::eImage ? region.dstOffset
+                                                      : region.srcOffset;
+    uint64_t texelSize = image->getNumChannels() * image->dataTypeMemorySize();
+    uint64_t byteOffset = offset * image->dataTypeMemorySize();
+    if (byteOffset % 4 != 0 || byteOffset % texelSize != 0) {
+        throw std::runtime_error(fmt::format(
+          "Kompute OpCopyRegions tensor offset of {} bytes is not aligned to "
+          "4 bytes and to the texel size of {} bytes",
+          byteOffset,
+          texelSize));
+    }
+
+    uint64_t rowTexels =
+      region.rowLength ? region.rowLength : region.imageExtent.width;
+    uint64_t rows = static_cast<uint64_t>(region.imageExtent.height) *
+                    region.imageExtent.depth * region.layerCount;
+
+    return ((rows - 1) * rowTexels + region.imageExtent.width) *
+           image->getNumChannels();
+}
+
+vk::ImageSubresourceLayers
+OpCopyRegions::getSubresourceLayers(uint32_t mipLevel,
+                                    uint32_t baseLayer,
+                                    uint32_t layerCount)
+{
+    return vk::ImageSubresourceLayers(
+      vk::ImageAspectFlagBits::eColor, mipLevel, baseLayer, layerCount);
+}
+
+void
+OpCopyRegions::record(const vk::CommandBuffer& commandBuffer)
+{
+    KP_LOG_DEBUG("Kompute OpCopyRegions record called");
+
+    bool srcImage = this->mSource->type() == Memory::Type::eImage;
+    bool dstImage = this->mDestination->type() == Memory::Type::eImage;
+    uint64_t elementSize = this->mSource->dataTypeMemorySize();
+
+    if (!srcImage && !dstImage) {
+        std::vector<vk::BufferCopy> copyRegions;
+        for (const Region& region : this->mRegions) {
+            copyRegions.push_back(vk::BufferCopy(region.srcOffset * elementSize,
+                                                 region.dstOffset * elementSize,
+                                                 region.size * elementSize));
+        }
+
+        commandBuffer.copyBuffer(
+          *std::static_pointer_cast<Tensor>(this->mSource)->getPrimaryBuffer(),
+          *std::static_pointer_cast<Tensor>(this->mDestination)
+             ->getPrimaryBuffer(),
+          copyRegions);
+        return;
+    }
+
+    std::shared_ptr<Image> sourceImage;
+    std::shared_ptr<Image> destinationImage;
+
+    // The transitions of the source and destination images share a barrier
+    ImageLayoutTracker* tracker = ImageLayoutTracker::find(commandBuffer);
+    if (tracker) {
+        tracker->beginBatch();
+    }
+
+    if (srcImage) {
+        sourceImage = std::static_pointer_cast<Image>(this->mSource);
+        sourceImage->recordPrimaryImageBarrier(
+          commandBuffer,
+          vk::AccessFlagBits::eMemoryRead,
+          vk::AccessFlagBits::eMemoryWrite,
+          vk::PipelineStageFlagBits::eTransfer,
+          vk::PipelineStageFlagBits::eTransfer,
+          vk::ImageLayout::eTransferSrcOptimal);
+    }
+    if (dstImage) {
+        destinationImage = std::static_pointer_cast<Image>(this->mDestination);
+        destinationImage->recordPrimaryImageBarrier(
+          commandBuffer,
+          vk::AccessFlagBits::eMemoryRead,
+          vk::AccessFlagBits::eMemoryWrite,
+          vk::PipelineStageFlagBits::eTransfer,
+          vk::PipelineStageFlagBits::eTransfer,
+          vk::ImageLayout::eTransferDstOptimal);
+    }
+
+    if (tracker) {
+        tracker->endBatch(commandBuffer);
+    }
+
+    if (srcImage && dstImage) {
+        std::vector<vk::ImageCopy> copyRegions;
+        for (const Region& region : this->mRegions) {
+            copyRegions.push_back(
+              vk::ImageCopy(this->getSubresourceLayers(region.srcMipLevel,
+                                                       region.srcBaseLayer,
+                                                       region.layerCount),
+                            region.srcImageOffset,
+                            this->getSubresourceLayers(region.dstMipLevel,
+                                                       region.dstBaseLayer,
+                                                       region.layerCount),
+                            region.dstImageOffset,
+                            region.imageExtent));
+        }
+
+        commandBuffer.copyImage(*sourceImage->getPrimaryImage(),
+                                sourceImage->getPrimaryImageLayout(),
+                                *destinationImage->getPrimaryImage(),
+                                destinationImage->getPrimaryImageLayout(),
+                                copyRegions);
+    } else if (dstImage) {
+        std::vector<vk::BufferImageCopy> copyRegions;
+        for (const Region& region : this->mRegions) {
+            copyRegions.push_back(
+              vk::BufferImageCopy(region.srcOffset * elementSize,
+                                  region.rowLength,
+                                  0,
+                                  this->getSubresourceLayers(
+                                    region.dstMipLevel,
+                                    region.dstBaseLayer,
+                                    region.layerCount),
+                                  region.dstImageOffset,
+                                  region.imageExtent));
+        }
+
+        commandBuffer.copyBufferToImage(
+          *std::static_pointer_cast<Tensor>(this->mSource)->getPrimaryBuffer(),
+          *destinationImage->getPrimaryImage(),
+          destinationImage->getPrimaryImageLayout(),
+          copyRegions);
+    } else {
+        std::vector<vk::BufferImageCopy> copyRegions;
+        for (const Region& region : this->mRegions) {
+            copyRegions.push_back(
+              vk::BufferImageCopy(region.dstOffset * elementSize,
+                                  region.rowLength,
+                                  0,
+                                  this->getSubresourceLayers(
+                                    region.srcMipLevel,
+                                    region.srcBaseLayer,
+                                    region.layerCount),
+                                  region.srcImageOffset,
+                                  region.imageExtent));
+        }
+
+        commandBuffer.copyImageToBuffer(
+          *sourceImage->getPrimaryImage(),
+          sourceImage->getPrimaryImageLayout(),
+          *std::static_pointer_cast<Tensor>(this->mDestination)
+             ->getPrimaryBuffer(),
+          copyRegions);
+    }
+}
+
+void
+OpCopyRegions::preEval(const vk::CommandBuffer& /*commandBuffer*/)
+{
+    KP_LOG_DEBUG("Kompute OpCopyRegions preEval called");
+}
+
+void
+OpCopyRegions::postEval(const vk::CommandBuffer& /*commandBuffer*/)
+{
+    KP_LOG_DEBUG("Kompute OpCopyRegions postEval called");
+}
+
+}
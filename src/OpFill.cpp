@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/operations/OpFill.hpp"
+
+#include <cstring>
+
+namespace kp {
+
+// Repeats the bytes of a 1 or 2 byte element into the 32-bit fill pattern
+static uint32_t
+repeatPattern(uint32_t bits, uint32_t elementSize)
+{
+    if (elementSize == 1) {
+        bits &= 0xFF;
+        bits |= bits << 8;
+    }
+    if (elementSize <= 2) {
+        bits &= 0xFFFF;
+        bits |= bits << 16;
+    }
+    return bits;
+}
+
+OpFill::OpFill(const std::vector<std::shared_ptr<Memory>>& memObjects,
+               double value)
+{
+    KP_LOG_DEBUG("Kompute OpFill constructor with value {}", value);
+
+    if (memObjects.size() < 1) {
+        throw std::runtime_error(
+          "Kompute OpFill called with less than 1 memory object");
+    }
+
+    this->mMemObjects = memObjects;
+    this->mValue = value;
+
+    // The values are converted here so unsupported types fail early
+    for (const std::shared_ptr<Memory>& mem : this->mMemObjects) {
+        if (!mem) {
+            throw std::runtime_error(
+              "Kompute OpFill called with a null memory object");
+        }
+        if (mem->type() == Memory::Type::eImage) {
+            this->getClearColor(mem);
+            continue;
+        }
+        if (mem->memorySize() % 4 != 0) {
+            throw std::runtime_error(
+              fmt::format("Kompute OpFill tensor size of {} bytes is not a "
+                          "multiple of 4 bytes",
+                          mem->memorySize()));
+        }
+        this->getFillPattern(mem);
+    }
+}
+
+OpFill::~OpFill() noexcept
+{
+    KP_LOG_DEBUG("Kompute OpFill destructor started");
+}
+
+uint32_t
+OpFill::getFillPattern(const std::shared_ptr<Memory>& mem)
+{
+    uint32_t elementSize = mem->dataTypeMemorySize();
+    // Conversions to unsigned types wrap negative values
+    uint32_t integer =
+      static_cast<uint32_t>(static_cast<int64_t>(this->mValue));
+    float value = static_cast<float>(this->mValue);
+
+    switch (mem->dataType()) {
+        case Memory::DataTypes::eBool:
+            return repeatPattern(this->mValue != 0, elementSize);
+        case Memory::DataTypes::eChar:
+        case Memory::DataTypes::eUnsignedChar:
+        case Memory::DataTypes::eShort:
+        case Memory::DataTypes::eUnsignedShort:
+        case Memory::DataTypes::eInt:
+        case Memory::DataTypes::eUnsignedInt:
+            return repeatPattern(integer, elementSize);
+        case Memory::DataTypes::eQInt8:
+            return repeatPattern(
+              static_cast<uint8_t>(quantizeInt8(value,
+                                                mem->quantizationScale(),
+                                                mem->quantizationZeroPoint())),
+              elementSize);
+        case Memory::DataTypes::eHalf:
+            return repeatPattern(floatToHalf(value), elementSize);
+        case Memory::DataTypes::eBFloat16:
+            return repeatPattern(floatToBFloat16(value), elementSize);
+        case Memory::DataTypes::eFloat: {
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+        default:
+            // The halves of 8-byte values differ for anything but zero
+            if (this->mValue != 0) {
+                throw std::runtime_error(
+                  "Kompute OpFill can only fill tensors of type " +
+                  Memory::toString(mem->dataType()) + " with zeros");
+            }
+            return 0;
+    }
+}
+
+vk::ClearColorValue
+OpFill::getClearColor(const std::shared_ptr<Memory>& mem)
+{
+    float value = static_cast<float>(this->mValue);
+    int32_t integer = static_cast<int32_t>(static_cast<int64_t>(this->mValue));
+
+    switch (mem->dataType()) {
+        case Memory::DataTypes::eFloat:
+        case Memory::DataTypes::eHalf:
+            return vk::ClearColorValue(
+              std::array<float, 4>{ value, value, value, value });
+        case Memory::DataTypes::eChar:
+        case Memory::DataTypes::eShort:
+        case Memory::DataTypes::eInt:
+            return vk::ClearColorValue(
+              std::array<int32_t, 4>{ integer, integer, integer, integer });
+        case Memory::DataTypes::eQInt8: {
+            int32_t quantized = quantizeInt8(value,
+                                             mem->quantizationScale(),
+                                             mem->quantizationZeroPoint());
+            return vk::ClearColorValue(std::array<int32_t, 4>{
+              quantized, quantized, quantized, quantized });
+        }
+        case Memory::DataTypes::eUnsignedChar:
+        case Memory::DataTypes::eUnsignedShort:
+        case Memory::DataTypes::eUnsignedInt: {
+            uint32_t bits = static_cast<uint32_t>(integer);
+            return vk::ClearColorValue(
+              std::array<uint32_t, 4>{ bits, bits, bits, bits });
+        }
+        default:
+            throw std::runtime_error(
+              "Kompute OpFill does not support images of type " +
+              Memory::toString(mem->dataType()));
+    }
+}
+
+void
+OpFill::record(const vk::CommandBuffer& commandBuffer)
+{
+    KP_LOG_DEBUG("Kompute OpFill record called");
+
+    for (const std::shared_ptr<Memory>& mem : this->mMemObjects) {
+        if (mem->type() == Memory::Type::eImage) {
+            std::shared_ptr<Image> image = std::static_pointer_cast<Image>(mem);
+
+            image->recordPrimaryImageBarrier(
+              commandBuffer,
+              vk::AccessFlagBits::eMemoryRead,
+              vk::AccessFlagBits::eMemoryWrite,
+              vk::PipelineStageFlagBits::eTransfer,
+              vk::PipelineStageFlagBits::eTransfer,
+              vk::ImageLayout::eTransferDstOptimal);
+
+            vk::ImageSubresourceRange range(vk::ImageAspectFlagBits::eColor,
+                                            0,
+                                            image->getMipLevels(),
+                                            0,
+                                            image->getLayers());
+
+            commandBuffer.clearColorImage(*image->getPrimaryImage(),
+                                          image->getPrimaryImageLayout(),
+                                          this->getClearColor(mem),
+                                          range);
+        } else {
+            std::shared_ptr<Tensor> tensor =
+              std::static_pointer_cast<Tensor>(mem);
+
+            // Previous shader and transfer writes are ordered before the fill
+            vk::BufferMemoryBarrier bufferMemoryBarrier;
+            bufferMemoryBarrier.buffer = *tensor->getPrimaryBuffer();
+            bufferMemoryBarrier.size = tensor->memorySize();
+            bufferMemoryBarrier.srcAccessMask =
+              vk::AccessFlagBits::eShaderWrite |
+              vk::AccessFlagBits::eTransferWrite;
+            bufferMemoryBarrier.dstAccessMask =
+              vk::AccessFlagBits::eTransferWrite;
+            bufferMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            bufferMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+            commandBuffer.pipelineBarrier(
+              vk::PipelineStageFlagBits::eComputeShader |
+                vk::PipelineStageFlagBits::eTransfer,
+              vk::PipelineStageFlagBits::eTransfer,
+              vk::DependencyFlags(),
+              nullptr,
+              bufferMemoryBarrier,
+              nullptr);
+
+            commandBuffer.fillBuffer(*tensor->getPrimaryBuffer(),
+                                     0,
+                                     tensor->memorySize(),
+                                     this->getFillPattern(mem));
+        }
+    }
+}
+
+void
+OpFill::preEval(const vk::CommandBuffer& /*commandBuffer*/)
+{
+    KP_LOG_DEBUG("Kompute OpFill preEval called");
+}
+
+void
+OpFill::postEval(const vk::CommandBuffer& /*commandBuffer*/)
+{
+    KP_LOG_DEBUG("Kompute OpFill postEval called");
+}
+
+}
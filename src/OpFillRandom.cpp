@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/operations/OpFillRandom.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace kp {
+
+// Values generated by each invocation, matches ShaderOpFillRandom.comp
+static const uint32_t VALUES_PER_INVOCATION = 4;
+
+static const uint32_t DEFAULT_LOCAL_SIZE = 256;
+
+static uint32_t
+floatBits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+OpFillRandom::OpFillRandom(std::vector<std::shared_ptr<Memory>> memObjects,
+                           Manager& manager,
+                           uint64_t seed,
+                           Distribution distribution,
+                           float a,
+                           float b,
+                           uint64_t stream,
+                           uint32_t localSize)
+{
+    KP_LOG_DEBUG("Kompute OpFillRandom constructor with seed {}", seed);
+
+    if (memObjects.size() != 1) {
+        throw std::runtime_error(
+          "Kompute OpFillRandom expected 1 mem object but got " +
+          std::to_string(memObjects.size()));
+    }
+    if (!memObjects[0] || memObjects[0]->type() != Memory::Type::eTensor) {
+        throw std::runtime_error(
+          "Kompute OpFillRandom only supports tensor mem objects");
+    }
+
+    this->mOutput = std::static_pointer_cast<Tensor>(memObjects[0]);
+    this->mDistribution = distribution;
+
+    Memory::DataTypes dataType = this->mOutput->dataType();
+    if (distribution == Distribution::eBits) {
+        if (dataType != Memory::DataTypes::eInt &&
+            dataType != Memory::DataTypes::eUnsignedInt) {
+            throw std::runtime_error("Kompute OpFillRandom only supports int "
+                                     "and uint tensors for random bits but "
+                                     "got " +
+                                     Memory::toString(dataType));
+        }
+    } else if (dataType != Memory::DataTypes::eFloat) {
+        throw std::runtime_error("Kompute OpFillRandom only supports float "
+                                 "tensors for uniform and normal values but "
+                                 "got " +
+                                 Memory::toString(dataType));
+    }
+
+    const vk::PhysicalDeviceLimits limits =
+      manager.getDeviceProperties().limits;
+
+    if (!localSize) {
+        localSize = DEFAULT_LOCAL_SIZE;
+    }
+    localSize = std::min({ localSize,
+                           limits.maxComputeWorkGroupSize[0],
+                           limits.maxComputeWorkGroupInvocations });
+
+    uint32_t count = this->mOutput->size();
+    uint32_t invocations =
+      (count + VALUES_PER_INVOCATION - 1) / VALUES_PER_INVOCATION;
+    uint32_t workgroups = (invocations + localSize - 1) / localSize;
+
+    if (workgroups > limits.maxComputeWorkGroupCount[0]) {
+        throw std::runtime_error(
+          "Kompute OpFillRandom tensor of " + std::to_string(count) +
+          " values requires more workgroups than supported by the device");
+    }
+
+    const std::vector<uint32_t> spirv = std::vector<uint32_t>(
+      SHADEROPFILLRANDOM_COMP_SPV.begin(), SHADEROPFILLRANDOM_COMP_SPV.end());
+    if (spirv.empty()) {
+        throw std::runtime_error(
+          "Kompute OpFillRandom shader is not available as Kompute was built "
+          "without glslangValidator or a precompiled shader header");
+    }
+
+    this->mAlgorithm = manager.algorithm<uint32_t, uint32_t>(
+      { this->mOutput },
+      spirv,
+      { workgroups, 1, 1 },
+      { localSize, static_cast<uint32_t>(distribution) },
+      { count,
+        static_cast<uint32_t>(seed),
+        static_cast<uint32_t>(seed >> 32),
+        static_cast<uint32_t>(stream),
+        static_cast<uint32_t>(stream >> 32),
+        floatBits(a),
+        floatBits(b) });
+}
+
+OpFillRandom::~OpFillRandom() noexcept
+{
+    KP_LOG_DEBUG("Kompute OpFillRandom destructor started");
+}
+
+void
+OpFillRandom::record(const vk::CommandBuffer& commandBuffer)
+{
+    KP_LOG_DEBUG("Kompute OpFillRandom record called");
+
+    // Barrier to ensure previous transfers are finished writing the tensor
+    this->mOutput->recordPrimaryMemoryBarrier(
+      commandBuffer,
+      vk::AccessFlagBits::eTransferWrite,
+      vk::AccessFlagBits::eShaderWrite,
+      vk::PipelineStageFlagBits::eTransfer,
+      vk::PipelineStageFlagBits::eComputeShader);
+
+    this->mAlgorithm->recordBindCore(commandBuffer);
+    this->mAlgorithm->recordBindPush(commandBuffer);
+    this->mAlgorithm->recordDispatch(commandBuffer);
+}
+
+void
+OpFillRandom::preEval(const vk::CommandBuffer& /*commandBuffer*/)
+{
+    KP_LOG_DEBUG("Kompute OpFillRandom preEval called");
+}
+
+void
+OpFillRandom::postEval(const vk::CommandBuffer& /*commandBuffer*/)
+{
+    KP_LOG_DEBUG("Kompute OpFillRandom postEval called");
+}
+
+std::string
+OpFillRandom::name() const
+{
+    switch (this->mDistribution) {
+        case Distribution::eUniform:
+            return "OpFillRandom (uniform)";
+        case Distribution::eNormal:
+            return "OpFillRandom (normal)";
+        default:
+            return "OpFillRandom (bits)";
+    }
+}
+
+}
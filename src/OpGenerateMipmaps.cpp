@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/operations/OpGenerateMipmaps.hpp"
+#include "kompute/ImageLayoutTracker.hpp"
+
+namespace kp {
+
+OpGenerateMipmaps::OpGenerateMipmaps(
+  const std::vector<std::shared_ptr<Memory>>& memObjects)
+{
+    KP_LOG_DEBUG("Kompute OpGenerateMipmaps constructor");
+
+    if (memObjects.empty()) {
+        throw std::runtime_error(
+          "Kompute OpGenerateMipmaps called with no images");
+    }
+
+    for (const std::shared_ptr<Memory>& mem : memObjects) {
+        if (!mem || mem->type() != Memory::Type::eImage) {
+            throw std::runtime_error(
+              "Kompute OpGenerateMipmaps only supports image mem objects");
+        }
+
+        std::shared_ptr<Image> image = std::static_pointer_cast<Image>(mem);
+        if (image->getMipLevels() < 2) {
+            throw std::runtime_error(
+              "Kompute OpGenerateMipmaps called with an image without mip "
+              "levels");
+        }
+        this->mImages.push_back(image);
+    }
+}
+
+OpGenerateMipmaps::~OpGenerateMipmaps() noexcept
+{
+    KP_LOG_DEBUG("Kompute OpGenerateMipmaps destructor started");
+}
+
+void
+OpGenerateMipmaps::record(const vk::CommandBuffer& commandBuffer)
+{
+    KP_LOG_DEBUG("Kompute OpGenerateMipmaps record called");
+
+    // The blits between the levels need a queue family with graphics
+    ImageLayoutTracker* tracker = ImageLayoutTracker::find(commandBuffer);
+    if (tracker &&
+        !(tracker->getQueueFlags() & vk::QueueFlagBits::eGraphics)) {
+        throw std::runtime_error(
+          "Kompute OpGenerateMipmaps requires a queue family with graphics "
+          "capabilities, which can be selected by adding eGraphics to "
+          "kp::DevicePolicy::requiredQueueFlags");
+    }
+
+    for (const std::shared_ptr<Image>& image : this->mImages) {
+        image->recordGenerateMipmaps(commandBuffer);
+    }
+}
+
+void
+OpGenerateMipmaps::preEval(const vk::CommandBuffer& /*commandBuffer*/)
+{
+    KP_LOG_DEBUG("Kompute OpGenerateMipmaps preEval called");
+}
+
+void
+OpGenerateMipmaps::postEval(const vk::CommandBuffer& /*commandBuffer*/)
+{
+    KP_LOG_DEBUG("Kompute OpGenerateMipmaps postEval called");
+}
+
+}
@@ -0,0 +1,260 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/operations/OpMatMul.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace kp {
+
+// Values accumulated by each invocation, matches ShaderOpMatMul.comp
+static const uint32_t WORK_M = 4;
+static const uint32_t WORK_N = 4;
+
+static const uint32_t DEFAULT_LOCAL_SIZE = 16;
+static const uint32_t DEFAULT_TILE_K = 16;
+
+// Grid of cooperative matrix tiles of each workgroup, matches
+// ShaderOpMatMulCoopMat.comp
+static const uint32_t SUBGROUPS_X = 2;
+static const uint32_t SUBGROUPS_Y = 2;
+
+static uint32_t
+floatBits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+OpMatMul::OpMatMul(std::vector<std::shared_ptr<Memory>> memObjects,
+                   Manager& manager,
+                   uint32_t m,
+                   uint32_t n,
+                   uint32_t k,
+                   uint32_t batch,
+                   bool transposeA,
+                   bool transposeB,
+                   float alpha,
+                   float beta)
+{
+    KP_LOG_DEBUG("Kompute OpMatMul constructor with m {} n {} k {} batch {}",
+                 m,
+                 n,
+                 k,
+                 batch);
+
+    if (memObjects.size() != 3) {
+        throw std::runtime_error(
+          "Kompute OpMatMul expected 3 mem objects but got " +
+          std::to_string(memObjects.size()));
+    }
+    for (const std::shared_ptr<Memory>& mem : memObjects) {
+        if (!mem || mem->type() != Memory::Type::eTensor) {
+            throw std::runtime_error(
+              "Kompute OpMatMul only supports tensor mem objects");
+        }
+    }
+    if (!m || !n || !batch) {
+        throw std::runtime_error(
+          "Kompute OpMatMul matrix sizes and batch must not be zero");
+    }
+
+    const std::shared_ptr<Memory>& a = memObjects[0];
+    const std::shared_ptr<Memory>& b = memObjects[1];
+    const std::shared_ptr<Memory>& c = memObjects[2];
+
+    // Halves are read in pairs from 32-bit words
+    bool halfInputs = a->dataType() == Memory::DataTypes::eHalf &&
+                      b->dataType() == Memory::DataTypes::eHalf &&
+                      a->size() % 2 == 0 && b->size() % 2 == 0;
+    bool floatInputs = a->dataType() == Memory::DataTypes::eFloat &&
+                       b->dataType() == Memory::DataTypes::eFloat;
+    if (!halfInputs && !floatInputs) {
+        throw std::runtime_error(
+          "Kompute OpMatMul expected float inputs or half inputs with an even "
+          "number of elements");
+    }
+    if (c->dataType() != Memory::DataTypes::eFloat) {
+        throw std::runtime_error("Kompute OpMatMul expected a float output "
+                                 "tensor but got " +
+                                 Memory::toString(c->dataType()));
+    }
+    if (a->size() < uint64_t(batch) * m * k ||
+        b->size() < uint64_t(batch) * k * n ||
+        c->size() < uint64_t(batch) * m * n) {
+        throw std::runtime_error(
+          "Kompute OpMatMul tensors are smaller than the batch of matrices");
+    }
+
+    this->mMemObjects = memObjects;
+    this->mM = m;
+    this->mN = n;
+    this->mK = k;
+    this->mBatch = batch;
+
+    const vk::PhysicalDeviceLimits limits =
+      manager.getDeviceProperties().limits;
+    const std::vector<uint32_t> pushConstants = {
+        m, n, k, floatBits(alpha), floatBits(beta)
+    };
+
+#ifdef VK_KHR_cooperative_matrix
+    // The tiles are distributed over the subgroups of each workgroup, which
+    // is sized for 2 x 2 subgroups of the default size
+    uint32_t coopMatLocalSize = manager.getSubgroupProperties().subgroupSize *
+                                SUBGROUPS_X * SUBGROUPS_Y;
+    if (halfInputs && !SHADEROPMATMULCOOPMAT_COMP_SPV.empty() &&
+        coopMatLocalSize <= limits.maxComputeWorkGroupInvocations &&
+        coopMatLocalSize <= limits.maxComputeWorkGroupSize[0]) {
+
+        for (const vk::CooperativeMatrixPropertiesKHR& properties :
+             manager.getCooperativeMatrixProperties()) {
+            if (properties.AType != vk::ComponentTypeKHR::eFloat16 ||
+                properties.BType != vk::ComponentTypeKHR::eFloat16 ||
+                properties.CType != vk::ComponentTypeKHR::eFloat32 ||
+                properties.ResultType != vk::ComponentTypeKHR::eFloat32 ||
+                properties.scope != vk::ScopeKHR::eSubgroup ||
+                m % properties.MSize || n % properties.NSize ||
+                k % properties.KSize) {
+                continue;
+            }
+
+            uint32_t tileM = properties.MSize * SUBGROUPS_Y;
+            uint32_t tileN = properties.NSize * SUBGROUPS_X;
+            uint32_t workgroupsX = (n + tileN - 1) / tileN;
+            uint32_t workgroupsY = (m + tileM - 1) / tileM;
+            if (workgroupsX > limits.maxComputeWorkGroupCount[0] ||
+                workgroupsY > limits.maxComputeWorkGroupCount[1] ||
+                batch > limits.maxComputeWorkGroupCount[2]) {
+                continue;
+            }
+
+            const std::vector<uint32_t> spirv =
+              std::vector<uint32_t>(SHADEROPMATMULCOOPMAT_COMP_SPV.begin(),
+                                    SHADEROPMATMULCOOPMAT_COMP_SPV.end());
+
+            this->mAlgorithm = manager.algorithm<uint32_t, uint32_t>(
+              memObjects,
+              spirv,
+              { workgroupsX, workgroupsY, batch },
+              { coopMatLocalSize,
+                properties.MSize,
+                properties.NSize,
+                properties.KSize,
+                transposeA,
+                transposeB },
+              pushConstants);
+            this->mUseCooperativeMatrix = true;
+
+            KP_LOG_DEBUG("Kompute OpMatMul using cooperative matrices of "
+                         "{}x{}x{}",
+                         properties.MSize,
+                         properties.NSize,
+                         properties.KSize);
+            return;
+        }
+    }
+#endif // VK_KHR_cooperative_matrix
+
+    uint32_t localX = DEFAULT_LOCAL_SIZE;
+    uint32_t localY = DEFAULT_LOCAL_SIZE;
+    while (localX * localY > limits.maxComputeWorkGroupInvocations ||
+           localX > limits.maxComputeWorkGroupSize[0] ||
+           localY > limits.maxComputeWorkGroupSize[1]) {
+        if (localX >= localY) {
+            localX /= 2;
+        } else {
+            localY /= 2;
+        }
+    }
+
+    uint32_t tileM = localY * WORK_M;
+    uint32_t tileN = localX * WORK_N;
+    uint32_t workgroupsX = (n + tileN - 1) / tileN;
+    uint32_t workgroupsY = (m + tileM - 1) / tileM;
+    if (workgroupsX > limits.maxComputeWorkGroupCount[0] ||
+        workgroupsY > limits.maxComputeWorkGroupCount[1] ||
+        batch > limits.maxComputeWorkGroupCount[2]) {
+        throw std::runtime_error(
+          "Kompute OpMatMul matrices require more workgroups than supported "
+          "by the device");
+    }
+
+    const std::vector<uint32_t> spirv = std::vector<uint32_t>(
+      SHADEROPMATMUL_COMP_SPV.begin(), SHADEROPMATMUL_COMP_SPV.end());
+    if (spirv.empty()) {
+        throw std::runtime_error(
+          "Kompute OpMatMul shader is not available as Kompute was built "
+          "without glslangValidator or a precompiled shader header");
+    }
+
+    this->mAlgorithm = manager.algorithm<uint32_t, uint32_t>(
+      memObjects,
+      spirv,
+      { workgroupsX, workgroupsY, batch },
+      { localX, localY, DEFAULT_TILE_K, halfInputs, transposeA, transposeB },
+      pushConstants);
+
+    KP_LOG_DEBUG("Kompute OpMatMul using tiles of {}x{}x{}",
+                 tileM,
+                 tileN,
+                 DEFAULT_TILE_K);
+}
+
+OpMatMul::~OpMatMul() noexcept
+{
+    KP_LOG_DEBUG("Kompute OpMatMul destructor started");
+}
+
+void
+OpMatMul::record(const vk::CommandBuffer& commandBuffer)
+{
+    KP_LOG_DEBUG("Kompute OpMatMul record called");
+
+    // Barrier to ensure the data is finished writing to buffer memory
+    for (const std::shared_ptr<Memory>& mem : this->mMemObjects) {
+        mem->recordPrimaryMemoryBarrier(
+          commandBuffer,
+          vk::AccessFlagBits::eTransferWrite,
+          vk::AccessFlagBits::eShaderRead,
+          vk::PipelineStageFlagBits::eTransfer,
+          vk::PipelineStageFlagBits::eComputeShader);
+    }
+
+    this->mAlgorithm->recordBindCore(commandBuffer);
+    this->mAlgorithm->recordBindPush(commandBuffer);
+    this->mAlgorithm->recordDispatch(commandBuffer);
+}
+
+void
+OpMatMul::preEval(const vk::CommandBuffer& /*commandBuffer*/)
+{
+    KP_LOG_DEBUG("Kompute OpMatMul preEval called");
+}
+
+void
+OpMatMul::postEval(const vk::CommandBuffer& /*commandBuffer*/)
+{
+    KP_LOG_DEBUG("Kompute OpMatMul postEval called");
+}
+
+std::string
+OpMatMul::name() const
+{
+    return fmt::format("OpMatMul ({}x{}x{}, batch {}, {})",
+                       this->mM,
+                       this->mN,
+                       this->mK,
+                       this->mBatch,
+                       this->mUseCooperativeMatrix ? "cooperative matrix"
+                                                   : "tiled");
+}
+
+bool
+OpMatMul::usesCooperativeMatrix() const
+{
+    return this->mUseCooperativeMatrix;
+}
+
+}
@@ -0,0 +1,268 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/operations/OpReduce.hpp"
+
+#include <algorithm>
+
+namespace kp {
+
+// Values reduced by each invocation before the workgroup reduction
+static const uint32_t VALUES_PER_INVOCATION = 4;
+
+static const uint32_t DEFAULT_LOCAL_SIZE = 256;
+
+static std::string
+toString(OpReduce::Operation operation)
+{
+    switch (operation) {
+        case OpReduce::Operation::eSum:
+            return "sum";
+        case OpReduce::Operation::eMin:
+            return "min";
+        case OpReduce::Operation::eMax:
+            return "max";
+        case OpReduce::Operation::eArgMax:
+            return "argmax";
+        default:
+            return "unknown";
+    }
+}
+
+OpReduce::OpReduce(std::vector<std::shared_ptr<Memory>> memObjects,
+                   Manager& manager,
+                   Operation operation,
+                   uint32_t localSize)
+{
+    KP_LOG_DEBUG("Kompute OpReduce constructor with operation {}",
+                 toString(operation));
+
+    if (memObjects.size() != 2) {
+        throw std::runtime_error(
+          "Kompute OpReduce expected 2 mem objects but got " +
+          std::to_string(memObjects.size()));
+    }
+    for (const std::shared_ptr<Memory>& mem : memObjects) {
+        if (!mem || mem->type() != Memory::Type::eTensor) {
+            throw std::runtime_error(
+              "Kompute OpReduce only supports tensor mem objects");
+        }
+    }
+
+    this->mInput = std::static_pointer_cast<Tensor>(memObjects[0]);
+    this->mOutput = std::static_pointer_cast<Tensor>(memObjects[1]);
+    this->mOperation = operation;
+
+    Memory::DataTypes dataType = this->mInput->dataType();
+    if (dataType != Memory::DataTypes::eInt &&
+        dataType != Memory::DataTypes::eUnsignedInt &&
+        dataType != Memory::DataTypes::eFloat) {
+        throw std::runtime_error("Kompute OpReduce only supports int, uint "
+                                 "and float tensors but got " +
+                                 Memory::toString(dataType));
+    }
+
+    Memory::DataTypes outputType = operation == Operation::eArgMax
+                                     ? Memory::DataTypes::eUnsignedInt
+                                     : dataType;
+    if (this->mOutput->dataType() != outputType) {
+        throw std::runtime_error(
+          "Kompute OpReduce expected output tensor of type " +
+          Memory::toString(outputType) + " but got " +
+          Memory::toString(this->mOutput->dataType()));
+    }
+
+    if (!this->mInput->size() || !this->mOutput->size()) {
+        throw std::runtime_error(
+          "Kompute OpReduce input and output tensors must not be empty");
+    }
+
+    vk::PhysicalDeviceProperties properties = manager.getDeviceProperties();
+    const vk::PhysicalDeviceLimits& limits = properties.limits;
+
+    if (!localSize) {
+        localSize = DEFAULT_LOCAL_SIZE;
+    }
+    localSize = std::min({ localSize,
+                           limits.maxComputeWorkGroupSize[0],
+                           limits.maxComputeWorkGroupInvocations });
+    // The shared memory reduction halves the active invocations at each step
+    while (localSize & (localSize - 1)) {
+        localSize &= localSize - 1;
+    }
+
+    // Subgroup arithmetic requires SPIR-V 1.3 which comes with Vulkan 1.1
+    vk::PhysicalDeviceSubgroupProperties subgroupProperties =
+      manager.getSubgroupProperties();
+    this->mUseSubgroups =
+      KOMPUTE_VK_API_VERSION >= VK_MAKE_VERSION(1, 1, 0) &&
+      properties.apiVersion >= VK_MAKE_VERSION(1, 1, 0) &&
+      (subgroupProperties.supportedStages &
+       vk::ShaderStageFlagBits::eCompute) &&
+      (subgroupProperties.supportedOperations &
+       vk::SubgroupFeatureFlagBits::eArithmetic);
+
+    std::vector<uint32_t> spirv;
+    if (this->mUseSubgroups) {
+        spirv = std::vector<uint32_t>(
+          SHADEROPREDUCESUBGROUP_COMP_SPV.begin(),
+          SHADEROPREDUCESUBGROUP_COMP_SPV.end());
+    } else {
+        spirv = std::vector<uint32_t>(SHADEROPREDUCE_COMP_SPV.begin(),
+                                      SHADEROPREDUCE_COMP_SPV.end());
+    }
+    if (spirv.empty()) {
+        throw std::runtime_error(
+          "Kompute OpReduce shader is not available as Kompute was built "
+          "without glslangValidator or a precompiled shader header");
+    }
+
+    const std::vector<uint32_t> specializationConstants = {
+        localSize,
+        static_cast<uint32_t>(operation),
+        static_cast<uint32_t>(dataType)
+    };
+
+    // Bound to the index bindings that are not used by a pass
+    std::shared_ptr<Tensor> unusedIndices =
+      manager.tensor(1,
+                     sizeof(uint32_t),
+                     Memory::DataTypes::eUnsignedInt,
+                     Memory::MemoryTypes::eStorage);
+    this->mScratchTensors.push_back(unusedIndices);
+
+    uint32_t valuesPerWorkgroup = localSize * VALUES_PER_INVOCATION;
+
+    std::shared_ptr<Tensor> inValues = this->mInput;
+    std::shared_ptr<Tensor> inIndices = unusedIndices;
+    uint32_t count = this->mInput->size();
+    bool firstPass = true;
+
+    while (true) {
+        // Larger inputs are covered by each invocation looping over the values
+        uint32_t workgroups =
+          std::min((count + valuesPerWorkgroup - 1) / valuesPerWorkgroup,
+                   limits.maxComputeWorkGroupCount[0]);
+        bool lastPass = workgroups == 1;
+
+        std::shared_ptr<Tensor> outValues;
+        if (lastPass && operation != Operation::eArgMax) {
+            outValues = this->mOutput;
+        } else {
+            outValues = manager.tensor(workgroups,
+                                       sizeof(uint32_t),
+                                       dataType,
+                                       Memory::MemoryTypes::eStorage);
+            this->mScratchTensors.push_back(outValues);
+        }
+
+        std::shared_ptr<Tensor> outIndices = unusedIndices;
+        if (operation == Operation::eArgMax) {
+            if (lastPass) {
+                outIndices = this->mOutput;
+            } else {
+                outIndices =
+                  manager.tensor(workgroups,
+                                 sizeof(uint32_t),
+                                 Memory::DataTypes::eUnsignedInt,
+                                 Memory::MemoryTypes::eStorage);
+                this->mScratchTensors.push_back(outIndices);
+            }
+        }
+
+        this->mAlgorithms.push_back(manager.algorithm<uint32_t, uint32_t>(
+          { inValues, inIndices, outValues, outIndices },
+          spirv,
+          { workgroups, 1, 1 },
+          specializationConstants,
+          { count, firstPass ? 1u : 0u }));
+
+        if (lastPass) {
+            break;
+        }
+
+        inValues = outValues;
+        inIndices = outIndices;
+        count = workgroups;
+        firstPass = false;
+    }
+
+    KP_LOG_DEBUG("Kompute OpReduce created {} passes with local size {}",
+                 this->mAlgorithms.size(),
+                 localSize);
+}
+
+OpReduce::~OpReduce() noexcept
+{
+    KP_LOG_DEBUG("Kompute OpReduce destructor started");
+}
+
+void
+OpReduce::record(const vk::CommandBuffer& commandBuffer)
+{
+    KP_LOG_DEBUG("Kompute OpReduce record called");
+
+    // Barrier to ensure the data is finished writing to buffer memory
+    for (const std::shared_ptr<Tensor>& tensor :
+         { this->mInput, this->mOutput }) {
+        tensor->recordPrimaryMemoryBarrier(
+          commandBuffer,
+          vk::AccessFlagBits::eTransferWrite,
+          vk::AccessFlagBits::eShaderRead,
+          vk::PipelineStageFlagBits::eTransfer,
+          vk::PipelineStageFlagBits::eComputeShader);
+    }
+
+    for (size_t i = 0; i < this->mAlgorithms.size(); i++) {
+        const std::shared_ptr<Algorithm>& algorithm = this->mAlgorithms[i];
+
+        // The partial values and indices written by the previous pass
+        if (i > 0) {
+            for (size_t j = 0; j < 2; j++) {
+                algorithm->getMemObjects()[j]->recordPrimaryMemoryBarrier(
+                  commandBuffer,
+                  vk::AccessFlagBits::eShaderWrite,
+                  vk::AccessFlagBits::eShaderRead,
+                  vk::PipelineStageFlagBits::eComputeShader,
+                  vk::PipelineStageFlagBits::eComputeShader);
+            }
+        }
+
+        algorithm->recordBindCore(commandBuffer);
+        algorithm->recordBindPush(commandBuffer);
+        algorithm->recordDispatch(commandBuffer);
+    }
+}
+
+void
+OpReduce::preEval(const vk::CommandBuffer& /*commandBuffer*/)
+{
+    KP_LOG_DEBUG("Kompute OpReduce preEval called");
+}
+
+void
+OpReduce::postEval(const vk::CommandBuffer& /*commandBuffer*/)
+{
+    KP_LOG_DEBUG("Kompute OpReduce postEval called");
+}
+
+std::string
+OpReduce::name() const
+{
+    return fmt::format("OpReduce ({}, {} passes)",
+                       toString(this->mOperation),
+                       this->mAlgorithms.size());
+}
+
+uint32_t
+OpReduce::passes() const
+{
+    return this->mAlgorithms.size();
+}
+
+bool
+OpReduce::usesSubgroups() const
+{
+    return this->mUseSubgroups;
+}
+
+}
@@ -0,0 +1,247 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/operations/OpScan.hpp"
+
+#include <algorithm>
+
+namespace kp {
+
+// Values scanned by each invocation, matches ShaderOpScan.comp
+static const uint32_t VALUES_PER_INVOCATION = 4;
+
+static const uint32_t DEFAULT_LOCAL_SIZE = 256;
+
+// Matches the modes of ShaderOpScan.comp
+static const uint32_t MODE_REDUCE = 0;
+static const uint32_t MODE_SCAN = 1;
+
+OpScan::OpScan(std::vector<std::shared_ptr<Memory>> memObjects,
+               Manager& manager,
+               bool exclusive,
+               bool countNonZero,
+               uint32_t localSize)
+{
+    KP_LOG_DEBUG("Kompute OpScan constructor with exclusive {}", exclusive);
+
+    if (memObjects.size() != 2) {
+        throw std::runtime_error(
+          "Kompute OpScan expected 2 mem objects but got " +
+          std::to_string(memObjects.size()));
+    }
+    for (const std::shared_ptr<Memory>& mem : memObjects) {
+        if (!mem || mem->type() != Memory::Type::eTensor) {
+            throw std::runtime_error(
+              "Kompute OpScan only supports tensor mem objects");
+        }
+    }
+
+    this->mInput = std::static_pointer_cast<Tensor>(memObjects[0]);
+    this->mOutput = std::static_pointer_cast<Tensor>(memObjects[1]);
+    this->mExclusive = exclusive;
+
+    Memory::DataTypes dataType = this->mInput->dataType();
+    if (dataType != Memory::DataTypes::eInt &&
+        dataType != Memory::DataTypes::eUnsignedInt &&
+        dataType != Memory::DataTypes::eFloat) {
+        throw std::runtime_error("Kompute OpScan only supports int, uint and "
+                                 "float tensors but got " +
+                                 Memory::toString(dataType));
+    }
+
+    Memory::DataTypes outputType =
+      countNonZero ? Memory::DataTypes::eUnsignedInt : dataType;
+    if (this->mOutput->dataType() != outputType) {
+        throw std::runtime_error(
+          "Kompute OpScan expected output tensor of type " +
+          Memory::toString(outputType) + " but got " +
+          Memory::toString(this->mOutput->dataType()));
+    }
+
+    if (!this->mInput->size() ||
+        this->mOutput->size() < this->mInput->size()) {
+        throw std::runtime_error("Kompute OpScan input tensor must not be "
+                                 "empty and output tensor must be at least as "
+                                 "large as the input");
+    }
+
+    const vk::PhysicalDeviceLimits limits =
+      manager.getDeviceProperties().limits;
+
+    if (!localSize) {
+        localSize = DEFAULT_LOCAL_SIZE;
+    }
+    localSize = std::min({ localSize,
+                           limits.maxComputeWorkGroupSize[0],
+                           limits.maxComputeWorkGroupInvocations });
+    // The shared memory reduction halves the active invocations at each step
+    while (localSize & (localSize - 1)) {
+        localSize &= localSize - 1;
+    }
+
+    const std::vector<uint32_t> spirv = std::vector<uint32_t>(
+      SHADEROPSCAN_COMP_SPV.begin(), SHADEROPSCAN_COMP_SPV.end());
+    if (spirv.empty()) {
+        throw std::runtime_error(
+          "Kompute OpScan shader is not available as Kompute was built "
+          "without glslangValidator or a precompiled shader header");
+    }
+
+    this->createPasses(manager,
+                       spirv,
+                       this->mInput,
+                       this->mOutput,
+                       this->mInput->size(),
+                       localSize,
+                       limits.maxComputeWorkGroupCount[0],
+                       outputType,
+                       exclusive,
+                       countNonZero);
+
+    KP_LOG_DEBUG("Kompute OpScan created {} passes with local size {}",
+                 this->mAlgorithms.size(),
+                 localSize);
+}
+
+OpScan::~OpScan() noexcept
+{
+    KP_LOG_DEBUG("Kompute OpScan destructor started");
+}
+
+void
+OpScan::createPasses(Manager& manager,
+                     const std::vector<uint32_t>& spirv,
+                     const std::shared_ptr<Tensor>& input,
+                     const std::shared_ptr<Tensor>& output,
+                     uint32_t count,
+                     uint32_t localSize,
+                     uint32_t maxWorkgroups,
+                     Memory::DataTypes dataType,
+                     bool exclusive,
+                     bool countNonZero)
+{
+    uint32_t valuesPerWorkgroup = localSize * VALUES_PER_INVOCATION;
+    uint32_t workgroups = (count + valuesPerWorkgroup - 1) / valuesPerWorkgroup;
+
+    if (workgroups > maxWorkgroups) {
+        throw std::runtime_error(
+          "Kompute OpScan input of " + std::to_string(count) +
+          " values requires more workgroups than supported by the device");
+    }
+
+    // The input is bound in place of the offsets when there is a single
+    // block, the shader does not read them in that case
+    std::shared_ptr<Tensor> offsets = input;
+
+    if (workgroups > 1) {
+        std::shared_ptr<Tensor> sums =
+          manager.tensor(workgroups,
+                         sizeof(uint32_t),
+                         dataType,
+                         Memory::MemoryTypes::eStorage);
+        offsets = manager.tensor(workgroups,
+                                 sizeof(uint32_t),
+                                 dataType,
+                                 Memory::MemoryTypes::eStorage);
+        this->mScratchTensors.push_back(sums);
+        this->mScratchTensors.push_back(offsets);
+
+        this->mAlgorithms.push_back(manager.algorithm<uint32_t, uint32_t>(
+          { input, sums, output },
+          spirv,
+          { workgroups, 1, 1 },
+          { localSize,
+            MODE_REDUCE,
+            static_cast<uint32_t>(dataType),
+            exclusive,
+            countNonZero },
+          { count, 0 }));
+
+        // The offset of each block is the exclusive scan of the block sums
+        this->createPasses(manager,
+                           spirv,
+                           sums,
+                           offsets,
+                           workgroups,
+                           localSize,
+                           maxWorkgroups,
+                           dataType,
+                           true,
+                           false);
+    }
+
+    this->mAlgorithms.push_back(manager.algorithm<uint32_t, uint32_t>(
+      { input, offsets, output },
+      spirv,
+      { workgroups, 1, 1 },
+      { localSize,
+        MODE_SCAN,
+        static_cast<uint32_t>(dataType),
+        exclusive,
+        countNonZero },
+      { count, workgroups > 1 }));
+}
+
+void
+OpScan::record(const vk::CommandBuffer& commandBuffer)
+{
+    KP_LOG_DEBUG("Kompute OpScan record called");
+
+    // Barrier to ensure the data is finished writing to buffer memory
+    for (const std::shared_ptr<Tensor>& tensor :
+         { this->mInput, this->mOutput }) {
+        tensor->recordPrimaryMemoryBarrier(
+          commandBuffer,
+          vk::AccessFlagBits::eTransferWrite,
+          vk::AccessFlagBits::eShaderRead,
+          vk::PipelineStageFlagBits::eTransfer,
+          vk::PipelineStageFlagBits::eComputeShader);
+    }
+
+    for (size_t i = 0; i < this->mAlgorithms.size(); i++) {
+        const std::shared_ptr<Algorithm>& algorithm = this->mAlgorithms[i];
+
+        // The values and block offsets written by the previous passes
+        if (i > 0) {
+            for (size_t j = 0; j < 2; j++) {
+                algorithm->getMemObjects()[j]->recordPrimaryMemoryBarrier(
+                  commandBuffer,
+                  vk::AccessFlagBits::eShaderWrite,
+                  vk::AccessFlagBits::eShaderRead,
+                  vk::PipelineStageFlagBits::eComputeShader,
+                  vk::PipelineStageFlagBits::eComputeShader);
+            }
+        }
+
+        algorithm->recordBindCore(commandBuffer);
+        algorithm->recordBindPush(commandBuffer);
+        algorithm->recordDispatch(commandBuffer);
+    }
+}
+
+void
+OpScan::preEval(const vk::CommandBuffer& /*commandBuffer*/)
+{
+    KP_LOG_DEBUG("Kompute OpScan preEval called");
+}
+
+void
+OpScan::postEval(const vk::CommandBuffer& /*commandBuffer*/)
+{
+    KP_LOG_DEBUG("Kompute OpScan postEval called");
+}
+
+std::string
+OpScan::name() const
+{
+    return fmt::format("OpScan ({}, {} passes)",
+                       this->mExclusive ? "exclusive" : "inclusive",
+                       this->mAlgorithms.size());
+}
+
+uint32_t
+OpScan::passes() const
+{
+    return this->mAlgorithms.size();
+}
+
+}
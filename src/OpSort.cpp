@@ -0,0 +1,274 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/operations/OpSort.hpp"
+
+#include <algorithm>
+
+namespace kp {
+
+// Matches ShaderOpSort.comp
+static const uint32_t VALUES_PER_INVOCATION = 4;
+static const uint32_t RADIX_BITS = 4;
+static const uint32_t RADIX = 1 << RADIX_BITS;
+
+// An even number of passes leaves the sorted keys in the user tensors
+static const uint32_t PASSES = 32 / RADIX_BITS;
+
+static const uint32_t DEFAULT_LOCAL_SIZE = 128;
+
+// Matches the modes of ShaderOpSort.comp
+static const uint32_t MODE_HISTOGRAM = 0;
+static const uint32_t MODE_SCATTER = 1;
+
+OpSort::OpSort(std::vector<std::shared_ptr<Memory>> memObjects,
+               Manager& manager,
+               bool descending,
+               uint32_t localSize)
+{
+    KP_LOG_DEBUG("Kompute OpSort constructor with descending {}", descending);
+
+    if (memObjects.size() != 1 && memObjects.size() != 2) {
+        throw std::runtime_error(
+          "Kompute OpSort expected 1 or 2 mem objects but got " +
+          std::to_string(memObjects.size()));
+    }
+    for (const std::shared_ptr<Memory>& mem : memObjects) {
+        if (!mem || mem->type() != Memory::Type::eTensor) {
+            throw std::runtime_error(
+              "Kompute OpSort only supports tensor mem objects");
+        }
+    }
+
+    const std::shared_ptr<Memory>& keys = memObjects[0];
+    bool hasValues = memObjects.size() == 2;
+
+    Memory::DataTypes keyType = keys->dataType();
+    if (keyType != Memory::DataTypes::eInt &&
+        keyType != Memory::DataTypes::eUnsignedInt &&
+        keyType != Memory::DataTypes::eFloat) {
+        throw std::runtime_error(
+          "Kompute OpSort only supports int, uint and float keys but got " +
+          Memory::toString(keyType));
+    }
+    if (!keys->size()) {
+        throw std::runtime_error(
+          "Kompute OpSort keys tensor must not be empty");
+    }
+    if (hasValues &&
+        (memObjects[1]->size() != keys->size() ||
+         memObjects[1]->dataTypeMemorySize() != sizeof(uint32_t))) {
+        throw std::runtime_error(
+          "Kompute OpSort expected 32-bit values of the same size as the keys");
+    }
+
+    this->mMemObjects = memObjects;
+    this->mCount = keys->size();
+    this->mDescending = descending;
+
+    const vk::PhysicalDeviceLimits limits =
+      manager.getDeviceProperties().limits;
+
+    if (!localSize) {
+        localSize = DEFAULT_LOCAL_SIZE;
+    }
+    // Each invocation holds the counts of every digit in shared memory
+    localSize =
+      std::min({ localSize,
+                 limits.maxComputeWorkGroupSize[0],
+                 limits.maxComputeWorkGroupInvocations,
+                 limits.maxComputeSharedMemorySize /
+                   static_cast<uint32_t>(RADIX * sizeof(uint32_t)) });
+    // The shared memory reduction halves the active invocations at each step
+    while (localSize & (localSize - 1)) {
+        localSize &= localSize - 1;
+    }
+
+    uint32_t valuesPerWorkgroup = localSize * VALUES_PER_INVOCATION;
+    uint32_t workgroups =
+      (this->mCount + valuesPerWorkgroup - 1) / valuesPerWorkgroup;
+    if (workgroups > limits.maxComputeWorkGroupCount[0]) {
+        throw std::runtime_error(
+          "Kompute OpSort input of " + std::to_string(this->mCount) +
+          " keys requires more workgroups than supported by the device");
+    }
+
+    std::shared_ptr<Tensor> scratchKeys =
+      manager.tensor(this->mCount,
+                     sizeof(uint32_t),
+                     keyType,
+                     Memory::MemoryTypes::eStorage);
+    this->mScratchTensors.push_back(scratchKeys);
+
+    // The keys are bound in place of the values when there are none, the
+    // shader does not access them in that case
+    std::shared_ptr<Memory> values = keys;
+    std::shared_ptr<Memory> scratchValues = scratchKeys;
+    if (hasValues) {
+        values = memObjects[1];
+        std::shared_ptr<Tensor> tensor =
+          manager.tensor(this->mCount,
+                         sizeof(uint32_t),
+                         values->dataType(),
+                         Memory::MemoryTypes::eStorage);
+        this->mScratchTensors.push_back(tensor);
+        scratchValues = tensor;
+    }
+
+    this->mHistograms = manager.tensor(RADIX * workgroups,
+                                       sizeof(uint32_t),
+                                       Memory::DataTypes::eUnsignedInt,
+                                       Memory::MemoryTypes::eStorage);
+    this->mOffsets = manager.tensor(RADIX * workgroups,
+                                    sizeof(uint32_t),
+                                    Memory::DataTypes::eUnsignedInt,
+                                    Memory::MemoryTypes::eStorage);
+
+    this->mScan = std::unique_ptr<OpScan>(new OpScan(
+      { this->mHistograms, this->mOffsets }, manager, true, false));
+
+    const std::vector<uint32_t> spirv = std::vector<uint32_t>(
+      SHADEROPSORT_COMP_SPV.begin(), SHADEROPSORT_COMP_SPV.end());
+    if (spirv.empty()) {
+        throw std::runtime_error(
+          "Kompute OpSort shader is not available as Kompute was built "
+          "without glslangValidator or a precompiled shader header");
+    }
+
+    const std::vector<std::vector<std::shared_ptr<Memory>>> directions = {
+        { keys, values, scratchKeys, scratchValues },
+        { scratchKeys, scratchValues, keys, values }
+    };
+
+    for (const std::vector<std::shared_ptr<Memory>>& direction : directions) {
+        this->mHistogramAlgorithms.push_back(
+          manager.algorithm<uint32_t, uint32_t>(
+            { direction[0],
+              direction[1],
+              this->mHistograms,
+              direction[2],
+              direction[3] },
+            spirv,
+            { workgroups, 1, 1 },
+            { localSize,
+              MODE_HISTOGRAM,
+              static_cast<uint32_t>(keyType),
+              hasValues,
+              descending },
+            { this->mCount, 0 }));
+
+        this->mScatterAlgorithms.push_back(
+          manager.algorithm<uint32_t, uint32_t>(
+            { direction[0],
+              direction[1],
+              this->mOffsets,
+              direction[2],
+              direction[3] },
+            spirv,
+            { workgroups, 1, 1 },
+            { localSize,
+              MODE_SCATTER,
+              static_cast<uint32_t>(keyType),
+              hasValues,
+              descending },
+            { this->mCount, 0 }));
+    }
+
+    KP_LOG_DEBUG("Kompute OpSort created {} workgroups with local size {}",
+                 workgroups,
+                 localSize);
+}
+
+OpSort::~OpSort() noexcept
+{
+    KP_LOG_DEBUG("Kompute OpSort destructor started");
+}
+
+void
+OpSort::record(const vk::CommandBuffer& commandBuffer)
+{
+    KP_LOG_DEBUG("Kompute OpSort record called");
+
+    // Barrier to ensure the data is finished writing to buffer memory
+    for (const std::shared_ptr<Memory>& mem : this->mMemObjects) {
+        mem->recordPrimaryMemoryBarrier(
+          commandBuffer,
+          vk::AccessFlagBits::eTransferWrite,
+          vk::AccessFlagBits::eShaderRead,
+          vk::PipelineStageFlagBits::eTransfer,
+          vk::PipelineStageFlagBits::eComputeShader);
+    }
+
+    for (uint32_t pass = 0; pass < PASSES; pass++) {
+        const std::shared_ptr<Algorithm>& histogram =
+          this->mHistogramAlgorithms[pass % 2];
+        const std::shared_ptr<Algorithm>& scatter =
+          this->mScatterAlgorithms[pass % 2];
+        const uint32_t pushConstants[2] = { this->mCount, pass * RADIX_BITS };
+
+        // The keys and values written by the previous scatter
+        if (pass > 0) {
+            for (size_t j = 0; j < 2; j++) {
+                histogram->getMemObjects()[j]->recordPrimaryMemoryBarrier(
+                  commandBuffer,
+                  vk::AccessFlagBits::eShaderWrite,
+                  vk::AccessFlagBits::eShaderRead,
+                  vk::PipelineStageFlagBits::eComputeShader,
+                  vk::PipelineStageFlagBits::eComputeShader);
+            }
+        }
+
+        histogram->setPushConstants(pushConstants, 2, sizeof(uint32_t));
+        histogram->recordBindCore(commandBuffer);
+        histogram->recordBindPush(commandBuffer);
+        histogram->recordDispatch(commandBuffer);
+
+        this->mHistograms->recordPrimaryMemoryBarrier(
+          commandBuffer,
+          vk::AccessFlagBits::eShaderWrite,
+          vk::AccessFlagBits::eShaderRead,
+          vk::PipelineStageFlagBits::eComputeShader,
+          vk::PipelineStageFlagBits::eComputeShader);
+
+        this->mScan->record(commandBuffer);
+
+        this->mOffsets->recordPrimaryMemoryBarrier(
+          commandBuffer,
+          vk::AccessFlagBits::eShaderWrite,
+          vk::AccessFlagBits::eShaderRead,
+          vk::PipelineStageFlagBits::eComputeShader,
+          vk::PipelineStageFlagBits::eComputeShader);
+
+        scatter->setPushConstants(pushConstants, 2, sizeof(uint32_t));
+        scatter->recordBindCore(commandBuffer);
+        scatter->recordBindPush(commandBuffer);
+        scatter->recordDispatch(commandBuffer);
+    }
+}
+
+void
+OpSort::preEval(const vk::CommandBuffer& /*commandBuffer*/)
+{
+    KP_LOG_DEBUG("Kompute OpSort preEval called");
+}
+
+void
+OpSort::postEval(const vk::CommandBuffer& /*commandBuffer*/)
+{
+    KP_LOG_DEBUG("Kompute OpSort postEval called");
+}
+
+std::string
+OpSort::name() const
+{
+    return fmt::format("OpSort ({}, {} passes)",
+                       this->mDescending ? "descending" : "ascending",
+                       PASSES);
+}
+
+uint32_t
+OpSort::passes() const
+{
+    return PASSES;
+}
+
+}
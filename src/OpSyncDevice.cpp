@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "kompute/operations/OpSyncDevice.hpp"
+#include "kompute/ImageLayoutTracker.hpp"
 
 namespace kp {
 
@@ -29,24 +30,48 @@ OpSyncDevice::record(const vk::CommandBuffer& commandBuffer)
 {
     KP_LOG_DEBUG("Kompute OpSyncDevice record called");
 
+    // The image transitions of all the copies are batched into one barrier
+    ImageLayoutTracker* tracker = ImageLayoutTracker::find(commandBuffer);
+    if (tracker) {
+        tracker->beginBatch();
+    }
+
     for (size_t i = 0; i < this->mMemObjects.size(); i++) {
         if (this->mMemObjects[i]->memoryType() ==
             Tensor::MemoryTypes::eDevice) {
             this->mMemObjects[i]->recordCopyFromStagingToDevice(commandBuffer);
         }
     }
+
+    if (tracker) {
+        tracker->endBatch(commandBuffer);
+    }
 }
 
 void
 OpSyncDevice::preEval(const vk::CommandBuffer& /*commandBuffer*/)
 {
     KP_LOG_DEBUG("Kompute OpSyncDevice preEval called");
+
+    // The staging memory is uploaded, so it must hold any deferred host data
+    for (const std::shared_ptr<Memory>& mem : this->mMemObjects) {
+        if (mem->memoryType() == Memory::MemoryTypes::eDevice) {
+            mem->resolveHostData();
+        }
+    }
 }
 
 void
 OpSyncDevice::postEval(const vk::CommandBuffer& /*commandBuffer*/)
 {
     KP_LOG_DEBUG("Kompute OpSyncDevice postEval called");
+
+    for (size_t i = 0; i < this->mMemObjects.size(); i++) {
+        if (this->mMemObjects[i]->memoryType() ==
+            Memory::MemoryTypes::eDevice) {
+            this->mMemObjects[i]->setDeviceDataNewer(false);
+        }
+    }
 }
 
 }
@@ -1,5 +1,6 @@
 // SPDX-License-Identifier: Apache-2.0
 
+#include "kompute/ImageLayoutTracker.hpp"
 #include "kompute/Tensor.hpp"
 
 #include "kompute/operations/OpSyncLocal.hpp"
@@ -28,6 +29,13 @@ OpSyncLocal::record(const vk::CommandBuffer& commandBuffer)
 {
     KP_LOG_DEBUG("Kompute OpSyncLocal record called");
 
+    // The image transitions before the copies and the barriers after them
+    // are each batched into one barrier
+    ImageLayoutTracker* tracker = ImageLayoutTracker::find(commandBuffer);
+    if (tracker) {
+        tracker->beginBatch();
+    }
+
     for (size_t i = 0; i < this->mMemObjects.size(); i++) {
         if (this->mMemObjects[i]->memoryType() ==
             Memory::MemoryTypes::eDevice) {
@@ -40,7 +48,17 @@ OpSyncLocal::record(const vk::CommandBuffer& commandBuffer)
               vk::PipelineStageFlagBits::eTransfer);
 
             this->mMemObjects[i]->recordCopyFromDeviceToStaging(commandBuffer);
+        }
+    }
 
+    if (tracker) {
+        tracker->endBatch(commandBuffer);
+        tracker->beginBatch();
+    }
+
+    for (size_t i = 0; i < this->mMemObjects.size(); i++) {
+        if (this->mMemObjects[i]->memoryType() ==
+            Memory::MemoryTypes::eDevice) {
             this->mMemObjects[i]->recordPrimaryMemoryBarrier(
               commandBuffer,
               vk::AccessFlagBits::eTransferWrite,
@@ -55,6 +73,15 @@ void
 OpSyncLocal::preEval(const vk::CommandBuffer& /*commandBuffer*/)
 {
     KP_LOG_DEBUG("Kompute OpSyncLocal preEval called");
+
+    // The staging memory is overwritten by the device data when submitted, so
+    // the deferred copies from it are done first and those into it dropped
+    for (const std::shared_ptr<Memory>& mem : this->mMemObjects) {
+        if (mem->memoryType() == Memory::MemoryTypes::eDevice) {
+            mem->resolveHostDataDependents();
+            mem->discardDeferredHostData();
+        }
+    }
 }
 
 void
@@ -63,6 +90,13 @@ OpSyncLocal::postEval(const vk::CommandBuffer& /*commandBuffer*/)
     KP_LOG_DEBUG("Kompute OpSyncLocal postEval called");
 
     KP_LOG_DEBUG("Kompute OpSyncLocal mapping data into tensor local");
+
+    for (size_t i = 0; i < this->mMemObjects.size(); i++) {
+        if (this->mMemObjects[i]->memoryType() ==
+            Memory::MemoryTypes::eDevice) {
+            this->mMemObjects[i]->setDeviceDataNewer(false);
+        }
+    }
 }
 
 }
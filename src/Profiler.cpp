@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/Profiler.hpp"
+#include "kompute/logger/Logger.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace kp {
+
+static std::string
+jsonEscape(const std::string& value)
+{
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        switch (c) {
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    escaped += ' ';
+                } else {
+                    escaped += c;
+                }
+        }
+    }
+    return escaped;
+}
+
+Profiler::Profiler()
+{
+    this->mStart = Clock::now();
+}
+
+void
+Profiler::addCpuSpan(const std::string& track,
+                     const std::string& name,
+                     Clock::time_point begin,
+                     Clock::time_point end)
+{
+    double startUs = this->toUs(begin);
+    this->addEvent({ name, track, false, startUs, this->toUs(end) - startUs });
+}
+
+void
+Profiler::addGpuTimestamps(const std::string& track,
+                           const std::vector<std::string>& opNames,
+                           const std::vector<uint64_t>& timestamps,
+                           float timestampPeriod,
+                           uint32_t timestampValidBits,
+                           Clock::time_point submitTime)
+{
+    if (timestamps.size() < 2) {
+        return;
+    }
+
+    uint64_t mask = timestampValidBits >= 64
+                      ? UINT64_MAX
+                      : ((uint64_t)1 << timestampValidBits) - 1;
+    double usPerTick = timestampPeriod / 1000.0;
+    double offsetUs = this->toUs(submitTime);
+
+    size_t total = std::min(opNames.size(), timestamps.size() - 1);
+    for (size_t i = 0; i < total; i++) {
+        // Masking handles the wrap around of counters with fewer valid bits
+        uint64_t startTicks = (timestamps[i] - timestamps[0]) & mask;
+        uint64_t durationTicks = (timestamps[i + 1] - timestamps[i]) & mask;
+
+        this->addEvent({ opNames[i],
+                         track,
+                         true,
+                         offsetUs + startTicks * usPerTick,
+                         durationTicks * usPerTick });
+    }
+}
+
+std::vector<Profiler::Event>
+Profiler::getEvents() const
+{
+    std::lock_guard<std::mutex> lock(this->mMutex);
+    return this->mEvents;
+}
+
+std::map<std::string, Profiler::Stats>
+Profiler::getStats(bool gpu) const
+{
+    std::lock_guard<std::mutex> lock(this->mMutex);
+    return gpu ? this->mGpuStats : this->mCpuStats;
+}
+
+std::string
+Profiler::toChromeTrace() const
+{
+    std::lock_guard<std::mutex> lock(this->mMutex);
+
+    // Each track is mapped to a thread id, shared between CPU and GPU
+    std::map<std::string, uint32_t> trackIds;
+    for (const Event& event : this->mEvents) {
+        trackIds.emplace(event.track, (uint32_t)trackIds.size());
+    }
+
+    std::ostringstream json;
+    json.precision(3);
+    json << std::fixed;
+    json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    json << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,"
+            "\"args\":{\"name\":\"CPU\"}},";
+    json << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+            "\"args\":{\"name\":\"GPU\"}}";
+
+    for (const auto& track : trackIds) {
+        for (uint32_t pid = 0; pid < 2; pid++) {
+            json << ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+                 << ",\"tid\":" << track.second << ",\"args\":{\"name\":\""
+                 << jsonEscape(track.first) << "\"}}";
+        }
+    }
+
+    for (const Event& event : this->mEvents) {
+        json << ",{\"name\":\"" << jsonEscape(event.name) << "\",\"cat\":\""
+             << (event.gpu ? "gpu" : "cpu")
+             << "\",\"ph\":\"X\",\"pid\":" << (event.gpu ? 1 : 0)
+             << ",\"tid\":" << trackIds[event.track]
+             << ",\"ts\":" << event.startUs << ",\"dur\":" << event.durationUs
+             << "}";
+    }
+
+    json << "]}";
+    return json.str();
+}
+
+void
+Profiler::writeChromeTrace(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Kompute Profiler could not open file " +
+                                 path + " to write the trace");
+    }
+    file << this->toChromeTrace();
+
+    KP_LOG_INFO("Kompute Profiler wrote chrome trace to {}", path);
+}
+
+void
+Profiler::clear()
+{
+    std::lock_guard<std::mutex> lock(this->mMutex);
+    this->mEvents.clear();
+    this->mCpuStats.clear();
+    this->mGpuStats.clear();
+}
+
+void
+Profiler::addEvent(Event event)
+{
+    std::lock_guard<std::mutex> lock(this->mMutex);
+
+    Stats& stats = event.gpu ? this->mGpuStats[event.name]
+                             : this->mCpuStats[event.name];
+    if (!stats.count || event.durationUs < stats.minUs) {
+        stats.minUs = event.durationUs;
+    }
+    if (!stats.count || event.durationUs > stats.maxUs) {
+        stats.maxUs = event.durationUs;
+    }
+    stats.count++;
+    stats.totalUs += event.durationUs;
+
+    this->mEvents.push_back(std::move(event));
+}
+
+double
+Profiler::toUs(Clock::time_point timePoint) const
+{
+    return std::chrono::duration<double, std::micro>(timePoint - this->mStart)
+      .count();
+}
+
+}
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/Sampler.hpp"
+
+namespace kp {
+
+Sampler::Sampler(std::shared_ptr<vk::Device> device,
+                 vk::Filter filter,
+                 vk::SamplerAddressMode addressMode,
+                 bool normalizedCoordinates,
+                 vk::BorderColor borderColor)
+{
+    KP_LOG_DEBUG("Kompute Sampler constructor with filter {} and address "
+                 "mode {}",
+                 vk::to_string(filter),
+                 vk::to_string(addressMode));
+
+    if (!device) {
+        throw std::runtime_error("Kompute Sampler device is null");
+    }
+
+    // Restrictions of unnormalizedCoordinates in the Vulkan specification
+    if (!normalizedCoordinates &&
+        addressMode != vk::SamplerAddressMode::eClampToEdge &&
+        addressMode != vk::SamplerAddressMode::eClampToBorder) {
+        throw std::runtime_error(
+          "Kompute Sampler with unnormalized coordinates requires the "
+          "eClampToEdge or eClampToBorder address mode but got " +
+          vk::to_string(addressMode));
+    }
+
+    this->mDevice = device;
+    this->mFilter = filter;
+    this->mAddressMode = addressMode;
+    this->mNormalizedCoordinates = normalizedCoordinates;
+
+    vk::SamplerCreateInfo samplerInfo;
+    samplerInfo.magFilter = filter;
+    samplerInfo.minFilter = filter;
+    // Unnormalized coordinates can only sample the first mip level
+    samplerInfo.mipmapMode =
+      normalizedCoordinates && filter == vk::Filter::eLinear
+        ? vk::SamplerMipmapMode::eLinear
+        : vk::SamplerMipmapMode::eNearest;
+    samplerInfo.addressModeU = addressMode;
+    samplerInfo.addressModeV = addressMode;
+    samplerInfo.addressModeW = addressMode;
+    samplerInfo.mipLodBias = 0.0f;
+    samplerInfo.anisotropyEnable = false;
+    samplerInfo.compareEnable = false;
+    samplerInfo.minLod = 0.0f;
+    samplerInfo.maxLod = normalizedCoordinates ? VK_LOD_CLAMP_NONE : 0.0f;
+    samplerInfo.borderColor = borderColor;
+    samplerInfo.unnormalizedCoordinates = !normalizedCoordinates;
+
+    this->mSampler = std::make_shared<vk::Sampler>();
+    this->mDevice->createSampler(&samplerInfo, nullptr, this->mSampler.get());
+}
+
+Sampler::~Sampler()
+{
+    KP_LOG_DEBUG("Kompute Sampler destructor started");
+
+    if (this->mDevice) {
+        this->destroy();
+    }
+}
+
+void
+Sampler::destroy()
+{
+    KP_LOG_DEBUG("Kompute Sampler started destroy()");
+
+    if (!this->mDevice) {
+        KP_LOG_WARN(
+          "Kompute Sampler destructor reached with null Device pointer");
+        return;
+    }
+
+    if (this->mSampler) {
+        this->mDevice->destroy(
+          *this->mSampler,
+          (vk::Optional<const vk::AllocationCallbacks>)nullptr);
+        this->mSampler = nullptr;
+    }
+
+    this->mDevice = nullptr;
+}
+
+bool
+Sampler::isInit()
+{
+    return this->mDevice && this->mSampler;
+}
+
+std::shared_ptr<vk::Sampler>
+Sampler::getSampler()
+{
+    return this->mSampler;
+}
+
+vk::Filter
+Sampler::getFilter()
+{
+    return this->mFilter;
+}
+
+vk::SamplerAddressMode
+Sampler::getAddressMode()
+{
+    return this->mAddressMode;
+}
+
+bool
+Sampler::getNormalizedCoordinates()
+{
+    return this->mNormalizedCoordinates;
+}
+
+}
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "kompute/Sequence.hpp"
+#include "kompute/MemoryBudget.hpp"
 
 namespace kp {
 
@@ -8,7 +9,8 @@ Sequence::Sequence(std::shared_ptr<vk::PhysicalDevice> physicalDevice,
                    std::shared_ptr<vk::Device> device,
                    std::shared_ptr<vk::Queue> computeQueue,
                    uint32_t queueIndex,
-                   uint32_t totalTimestamps) noexcept
+                   uint32_t totalTimestamps,
+                   uint32_t totalPipelineStatistics) noexcept
 {
     KP_LOG_DEBUG("Kompute Sequence Constructor with existing device & queue");
 
@@ -20,9 +22,17 @@ Sequence::Sequence(std::shared_ptr<vk::PhysicalDevice> physicalDevice,
 
     this->createCommandPool();
     this->createCommandBuffer();
+    this->mImageLayoutTracker = std::make_shared<ImageLayoutTracker>(
+      *this->mCommandBuffer,
+      this->mPhysicalDevice->getQueueFamilyProperties()[this->mQueueIndex]
+        .queueFlags);
+    this->mMemoryPlanner =
+      std::make_shared<MemoryPlanner>(this->mPhysicalDevice, this->mDevice);
     if (totalTimestamps > 0)
         this->createTimestampQueryPool(totalTimestamps +
                                        1); //+1 for the first one
+    if (totalPipelineStatistics > 0)
+        this->createPipelineStatisticsQueryPool(totalPipelineStatistics);
 }
 
 Sequence::~Sequence() noexcept
@@ -52,13 +62,29 @@ Sequence::begin()
     KP_LOG_INFO("Kompute Sequence command now started recording");
     this->mCommandBuffer->begin(vk::CommandBufferBeginInfo());
     this->mRecording = true;
+    this->mImageLayoutTracker->reset();
+    this->mMemoryPlanner->reset();
+    if (this->mMemoryBudget) {
+        this->mRecordedEvictionCount = this->mMemoryBudget->getEvictionCount();
+    }
 
-    // latch the first timestamp before any commands are submitted
-    if (this->timestampQueryPool)
+    // latch the first timestamp before any commands are submitted, the
+    // queries need to be reset as a query cannot be written twice
+    if (this->timestampQueryPool) {
+        this->mCommandBuffer->resetQueryPool(
+          *this->timestampQueryPool, 0, this->mTotalTimestamps);
         this->mCommandBuffer->writeTimestamp(
           vk::PipelineStageFlagBits::eAllCommands,
           *this->timestampQueryPool,
           0);
+    }
+
+    if (this->mPipelineStatisticsQueryPool) {
+        this->mCommandBuffer->resetQueryPool(
+          *this->mPipelineStatisticsQueryPool,
+          0,
+          this->mTotalPipelineStatistics);
+    }
 }
 
 void
@@ -86,6 +112,10 @@ Sequence::clear()
 {
     KP_LOG_DEBUG("Kompute Sequence calling clear");
     this->mOperations.clear();
+    this->mPlanPending = false;
+    if (this->mImageLayoutTracker) {
+        this->mImageLayoutTracker->reset();
+    }
     if (this->isRecording()) {
         this->end();
     }
@@ -119,8 +149,52 @@ Sequence::evalAsync()
           "called without successful wait");
     }
 
+    // Evicted tensors are restored and the tensors of other sequences evicted
+    // when over the soft limit, so the buffers recorded may have been freed
+    if (this->mMemoryBudget) {
+        std::vector<std::shared_ptr<Memory>> memObjects;
+        for (const std::shared_ptr<OpBase>& op : this->mOperations) {
+            std::vector<std::shared_ptr<Memory>> opMemObjects =
+              op->getMemObjects();
+            memObjects.insert(
+              memObjects.end(), opMemObjects.begin(), opMemObjects.end());
+        }
+        this->mMemoryBudget->use(memObjects);
+        this->mMemoryBudget->enforce(memObjects);
+
+        if (!this->mPlanPending && this->mMemoryBudget->getEvictionCount() !=
+                                     this->mRecordedEvictionCount) {
+            KP_LOG_DEBUG("Kompute Sequence re-recording for evicted tensors");
+            this->mImageLayoutTracker->restoreLayouts();
+            this->rerecord();
+            this->end();
+        }
+    }
+
+    // The transient tensors can only be placed once all the operations that
+    // use them are known, so their operations are recorded at the first eval
+    if (this->mPlanPending) {
+        KP_LOG_DEBUG("Kompute Sequence planning memory of transient tensors");
+        this->mPlanPending = false;
+        this->mMemoryPlanner->plan(this->mOperations);
+        this->mImageLayoutTracker->restoreLayouts();
+        this->rerecord();
+        this->end();
+    }
+
+    // The barriers were recorded for the layouts the images had at the time,
+    // which differ when replaying or after submitting other recordings
+    if (this->mImageLayoutTracker->isStale()) {
+        KP_LOG_DEBUG("Kompute Sequence re-recording for new image layouts");
+        this->mImageLayoutTracker->restoreLayouts();
+        this->rerecord();
+        this->end();
+    }
+
     this->mIsRunning = true;
 
+    Profiler::Clock::time_point submitStart = Profiler::Clock::now();
+
     for (size_t i = 0; i < this->mOperations.size(); i++) {
         this->mOperations[i]->preEval(*this->mCommandBuffer);
     }
@@ -133,7 +207,16 @@ Sequence::evalAsync()
 
     this->mDevice->resetFences({ this->mFence });
 
+    this->mSubmitTime = Profiler::Clock::now();
     this->mComputeQueue->submit(1, &submitInfo, this->mFence);
+    this->mImageLayoutTracker->submit();
+
+    if (this->mProfiler) {
+        this->mProfiler->addCpuSpan(this->mProfilerLabel,
+                                    "submit",
+                                    submitStart,
+                                    Profiler::Clock::now());
+    }
 
     return shared_from_this();
 }
@@ -155,6 +238,8 @@ Sequence::evalAwait(uint64_t waitFor)
         return shared_from_this();
     }
 
+    Profiler::Clock::time_point awaitStart = Profiler::Clock::now();
+
     vk::Result result =
       this->mDevice->waitForFences(1, &this->mFence, VK_TRUE, waitFor);
 
@@ -167,12 +252,44 @@ Sequence::evalAwait(uint64_t waitFor)
     }
 
     for (size_t i = 0; i < this->mOperations.size(); i++) {
+        // Any operation may have written the device memory of its memory
+        // objects, which the sync operations reset in their postEval
+        if (this->mMemoryBudget) {
+            for (const std::shared_ptr<Memory>& mem :
+                 this->mOperations[i]->getMemObjects()) {
+                if (mem) {
+                    mem->setDeviceDataNewer(true);
+                }
+            }
+        }
         this->mOperations[i]->postEval(*this->mCommandBuffer);
     }
 
+    if (this->mProfiler) {
+        this->mProfiler->addCpuSpan(this->mProfilerLabel,
+                                    "await",
+                                    awaitStart,
+                                    Profiler::Clock::now());
+        if (this->timestampQueryPool) {
+            this->profileTimestamps();
+        }
+    }
+
     return shared_from_this();
 }
 
+std::shared_ptr<ImageLayoutTracker>
+Sequence::getImageLayoutTracker()
+{
+    return this->mImageLayoutTracker;
+}
+
+std::shared_ptr<MemoryPlanner>
+Sequence::getMemoryPlanner()
+{
+    return this->mMemoryPlanner;
+}
+
 bool
 Sequence::isRunning() const
 {
@@ -195,7 +312,9 @@ Sequence::isInit() const
 void
 Sequence::rerecord()
 {
-    this->end();
+    if (this->isRecording()) {
+        this->end();
+    }
     std::vector<std::shared_ptr<OpBase>> ops = this->mOperations;
     this->mOperations.clear();
     for (const std::shared_ptr<kp::OpBase>& op : ops) {
@@ -219,6 +338,11 @@ Sequence::destroy()
           this->mFence, (vk::Optional<const vk::AllocationCallbacks>)nullptr);
     }
 
+    // Unregisters the command buffer before it is freed and reused
+    this->mImageLayoutTracker = nullptr;
+    this->mMemoryPlanner = nullptr;
+    this->mMemoryBudget = nullptr;
+
     if (this->mFreeCommandBuffer) {
         KP_LOG_INFO("Freeing CommandBuffer");
         if (!this->mCommandBuffer) {
@@ -264,9 +388,22 @@ Sequence::destroy()
           (vk::Optional<const vk::AllocationCallbacks>)nullptr);
 
         this->timestampQueryPool = nullptr;
+        this->mTotalTimestamps = 0;
         KP_LOG_DEBUG("Kompute Sequence Destroyed QueryPool");
     }
 
+    if (this->mPipelineStatisticsQueryPool) {
+        KP_LOG_INFO("Destroying pipeline statistics QueryPool");
+        this->mDevice->destroy(
+          *this->mPipelineStatisticsQueryPool,
+          (vk::Optional<const vk::AllocationCallbacks>)nullptr);
+
+        this->mPipelineStatisticsQueryPool = nullptr;
+        this->mTotalPipelineStatistics = 0;
+        KP_LOG_DEBUG("Kompute Sequence Destroyed pipeline statistics "
+                     "QueryPool");
+    }
+
     if (this->mDevice) {
         this->mDevice = nullptr;
     }
@@ -285,18 +422,83 @@ Sequence::record(std::shared_ptr<OpBase> op)
 
     this->begin();
 
+    if (this->mMemoryBudget) {
+        // Only the tensors reported by the operation are restored, so the
+        // buffers of the others could be recorded while freed
+        if (!op->reportsMemObjects() &&
+            this->mMemoryBudget->hasEvictedTensors()) {
+            throw std::runtime_error(
+              "Kompute Sequence cannot record an operation that does not "
+              "override getMemObjects() while tensors are evicted by the "
+              "memory budget");
+        }
+
+        std::vector<std::shared_ptr<Memory>> memObjects = op->getMemObjects();
+        this->mMemoryBudget->use(memObjects);
+
+        for (const std::shared_ptr<Memory>& memory : memObjects) {
+            if (memory->type() == Memory::Type::eTensor &&
+                std::static_pointer_cast<Tensor>(memory)->isEvicted()) {
+                throw std::runtime_error(
+                  "Kompute Sequence cannot record an operation using an "
+                  "evicted tensor not tracked by the memory budget");
+            }
+        }
+    }
+
+    // Operations are kept in order until the transient tensors are placed
+    if (this->mPlanPending || MemoryPlanner::needsPlan(*op)) {
+        KP_LOG_DEBUG("Kompute Sequence deferring record until memory planned");
+        this->mPlanPending = true;
+        this->mOperations.push_back(op);
+        return shared_from_this();
+    }
+
     KP_LOG_DEBUG(
       "Kompute Sequence running record on OpBase derived class instance");
 
+    Profiler::Clock::time_point recordStart = Profiler::Clock::now();
+
+    uint32_t opIndex = this->mOperations.size();
+    bool captureStatistics = this->mPipelineStatisticsQueryPool &&
+                             opIndex < this->mTotalPipelineStatistics;
+
+    if (captureStatistics) {
+        this->mCommandBuffer->beginQuery(
+          *this->mPipelineStatisticsQueryPool, opIndex, {});
+    }
+
+    this->mMemoryPlanner->recordAliasBarrier(*this->mCommandBuffer, *op);
     op->record(*this->mCommandBuffer);
 
+    if (captureStatistics) {
+        this->mCommandBuffer->endQuery(*this->mPipelineStatisticsQueryPool,
+                                       opIndex);
+    } else if (this->mPipelineStatisticsQueryPool) {
+        KP_LOG_WARN("Kompute Sequence recorded more operations than "
+                    "pipeline statistics allocated, skipping statistics");
+    }
+
     this->mOperations.push_back(op);
 
-    if (this->timestampQueryPool)
-        this->mCommandBuffer->writeTimestamp(
-          vk::PipelineStageFlagBits::eAllCommands,
-          *this->timestampQueryPool,
-          this->mOperations.size());
+    if (this->mProfiler) {
+        this->mProfiler->addCpuSpan(this->mProfilerLabel,
+                                    "record " + op->name(),
+                                    recordStart,
+                                    Profiler::Clock::now());
+    }
+
+    if (this->timestampQueryPool) {
+        if (this->mOperations.size() < this->mTotalTimestamps) {
+            this->mCommandBuffer->writeTimestamp(
+              vk::PipelineStageFlagBits::eAllCommands,
+              *this->timestampQueryPool,
+              this->mOperations.size());
+        } else {
+            KP_LOG_WARN("Kompute Sequence recorded more operations than "
+                        "timestamps allocated, skipping timestamp");
+        }
+    }
 
     return shared_from_this();
 }
@@ -363,6 +565,7 @@ Sequence::createTimestampQueryPool(uint32_t totalTimestamps)
         queryPoolInfo.setQueryType(vk::QueryType::eTimestamp);
         this->timestampQueryPool = std::make_shared<vk::QueryPool>(
           this->mDevice->createQueryPool(queryPoolInfo));
+        this->mTotalTimestamps = totalTimestamps;
 
         KP_LOG_DEBUG("Query pool for timestamps created");
     } else {
@@ -370,13 +573,72 @@ Sequence::createTimestampQueryPool(uint32_t totalTimestamps)
     }
 }
 
+void
+Sequence::createPipelineStatisticsQueryPool(uint32_t totalPipelineStatistics)
+{
+    KP_LOG_DEBUG("Kompute Sequence creating pipeline statistics query pool");
+    if (!this->isInit()) {
+        throw std::runtime_error("createPipelineStatisticsQueryPool() called "
+                                 "on uninitialized Sequence");
+    }
+    if (!this->mPhysicalDevice) {
+        throw std::runtime_error("Kompute Sequence physical device is null");
+    }
+
+    if (this->mPhysicalDevice->getFeatures().pipelineStatisticsQuery) {
+        vk::QueryPoolCreateInfo queryPoolInfo;
+        queryPoolInfo.setQueryCount(totalPipelineStatistics);
+        queryPoolInfo.setQueryType(vk::QueryType::ePipelineStatistics);
+        queryPoolInfo.setPipelineStatistics(
+          vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations);
+        this->mPipelineStatisticsQueryPool = std::make_shared<vk::QueryPool>(
+          this->mDevice->createQueryPool(queryPoolInfo));
+        this->mTotalPipelineStatistics = totalPipelineStatistics;
+
+        KP_LOG_DEBUG("Query pool for pipeline statistics created");
+    } else {
+        throw std::runtime_error(
+          "Device does not support pipeline statistics queries");
+    }
+}
+
+std::vector<Sequence::OpStatistics>
+Sequence::getPipelineStatistics()
+{
+    if (!this->mPipelineStatisticsQueryPool)
+        throw std::runtime_error("Pipeline statistics not enabled");
+
+    const auto n = std::min<size_t>(this->mOperations.size(),
+                                    this->mTotalPipelineStatistics);
+    std::vector<std::uint64_t> invocations(n, 0);
+    if (n > 0) {
+        this->mDevice->getQueryPoolResults(
+          *this->mPipelineStatisticsQueryPool,
+          0,
+          n,
+          invocations.size() * sizeof(std::uint64_t),
+          invocations.data(),
+          sizeof(uint64_t),
+          vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait);
+    }
+
+    std::vector<OpStatistics> statistics(n);
+    for (size_t i = 0; i < n; i++) {
+        statistics[i].name = this->mOperations[i]->name();
+        statistics[i].computeShaderInvocations = invocations[i];
+    }
+
+    return statistics;
+}
+
 std::vector<std::uint64_t>
 Sequence::getTimestamps()
 {
     if (!this->timestampQueryPool)
         throw std::runtime_error("Timestamp latching not enabled");
 
-    const auto n = this->mOperations.size() + 1;
+    const auto n = std::min<size_t>(this->mOperations.size() + 1,
+                                    this->mTotalTimestamps);
     std::vector<std::uint64_t> timestamps(n, 0);
     this->mDevice->getQueryPoolResults(
       *this->timestampQueryPool,
@@ -390,4 +652,43 @@ Sequence::getTimestamps()
     return timestamps;
 }
 
+void
+Sequence::setProfiler(std::shared_ptr<Profiler> profiler,
+                      const std::string& label)
+{
+    this->mProfiler = profiler;
+    this->mProfilerLabel = label;
+}
+
+void
+Sequence::setMemoryBudget(std::shared_ptr<MemoryBudget> memoryBudget)
+{
+    this->mMemoryBudget = memoryBudget;
+}
+
+void
+Sequence::profileTimestamps()
+{
+    const std::vector<std::uint64_t> timestamps = this->getTimestamps();
+
+    std::vector<std::string> opNames;
+    opNames.reserve(this->mOperations.size());
+    for (const std::shared_ptr<OpBase>& op : this->mOperations) {
+        opNames.push_back(op->name());
+    }
+
+    float timestampPeriod =
+      this->mPhysicalDevice->getProperties().limits.timestampPeriod;
+    uint32_t timestampValidBits =
+      this->mPhysicalDevice->getQueueFamilyProperties()[this->mQueueIndex]
+        .timestampValidBits;
+
+    this->mProfiler->addGpuTimestamps(this->mProfilerLabel,
+                                      opNames,
+                                      timestamps,
+                                      timestampPeriod,
+                                      timestampValidBits,
+                                      this->mSubmitTime);
+}
+
 }
@@ -0,0 +1,254 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/ShaderCompiler.hpp"
+#include "kompute/logger/Logger.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <shaderc/shaderc.hpp>
+
+namespace kp {
+
+// Changes whenever the compile options change so stale caches are not used
+static const char* CACHE_VERSION = "kp-shaderc-1";
+
+ShaderCompiler::ShaderCompiler(const std::string& cacheDirectory,
+                               uint32_t totalThreads)
+{
+    KP_LOG_DEBUG("Kompute ShaderCompiler constructor with cache directory: {}",
+                 cacheDirectory);
+
+    this->mCacheDirectory = cacheDirectory;
+    this->mTotalThreads = totalThreads;
+}
+
+std::vector<uint32_t>
+ShaderCompiler::compile(const std::string& source,
+                        const std::map<std::string, std::string>& defines,
+                        Language language,
+                        const std::string& entryPoint)
+{
+    uint64_t key = hashInputs(source, defines, language, entryPoint);
+
+    std::vector<uint32_t> spirv;
+    if (this->loadCached(key, spirv)) {
+        return spirv;
+    }
+
+    spirv = this->compileSource(source, defines, language, entryPoint);
+    this->storeCached(key, spirv);
+    return spirv;
+}
+
+std::shared_future<std::vector<uint32_t>>
+ShaderCompiler::compileAsync(const std::string& source,
+                             const std::map<std::string, std::string>& defines,
+                             Language language,
+                             const std::string& entryPoint)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mMutex);
+        if (!this->mThreadPool) {
+            this->mThreadPool.reset(new ThreadPool(this->mTotalThreads));
+        }
+    }
+
+    std::shared_ptr<std::promise<std::vector<uint32_t>>> promise =
+      std::make_shared<std::promise<std::vector<uint32_t>>>();
+    std::shared_future<std::vector<uint32_t>> result =
+      promise->get_future().share();
+
+    this->mThreadPool->submit(
+      [this, promise, source, defines, language, entryPoint]() {
+          try {
+              promise->set_value(
+                this->compile(source, defines, language, entryPoint));
+          } catch (...) {
+              promise->set_exception(std::current_exception());
+          }
+      });
+
+    return result;
+}
+
+void
+ShaderCompiler::clearCache()
+{
+    std::lock_guard<std::mutex> lock(this->mMutex);
+
+    if (!this->mCacheDirectory.empty()) {
+        for (const auto& entry : this->mCache) {
+            std::remove(this->cachePath(entry.first).c_str());
+        }
+    }
+    this->mCache.clear();
+}
+
+uint64_t
+ShaderCompiler::getCacheHits() const
+{
+    std::lock_guard<std::mutex> lock(this->mMutex);
+    return this->mCacheHits;
+}
+
+std::vector<uint32_t>
+ShaderCompiler::compileSource(const std::string& source,
+                              const std::map<std::string, std::string>& defines,
+                              Language language,
+                              const std::string& entryPoint)
+{
+    KP_LOG_DEBUG("Kompute ShaderCompiler compiling shader with {} defines",
+                 defines.size());
+
+    shaderc::CompileOptions options;
+    options.SetSourceLanguage(language == Language::eHlsl
+                                ? shaderc_source_language_hlsl
+                                : shaderc_source_language_glsl);
+    options.SetOptimizationLevel(shaderc_optimization_level_performance);
+    for (const auto& define : defines) {
+        options.AddMacroDefinition(define.first, define.second);
+    }
+
+    // A compiler per compilation keeps concurrent compilations independent
+    shaderc::Compiler compiler;
+    shaderc::SpvCompilationResult result =
+      compiler.CompileGlslToSpv(source,
+                                shaderc_glsl_compute_shader,
+                                "kp_shader",
+                                entryPoint.c_str(),
+                                options);
+
+    if (result.GetCompilationStatus() != shaderc_compilation_status_success) {
+        throw std::runtime_error("Kompute ShaderCompiler failed to compile "
+                                 "shader: " +
+                                 result.GetErrorMessage());
+    }
+
+    return { result.cbegin(), result.cend() };
+}
+
+bool
+ShaderCompiler::loadCached(uint64_t key, std::vector<uint32_t>& spirv)
+{
+    std::lock_guard<std::mutex> lock(this->mMutex);
+
+    auto cached = this->mCache.find(key);
+    if (cached != this->mCache.end()) {
+        spirv = cached->second;
+        this->mCacheHits++;
+        return true;
+    }
+
+    if (this->mCacheDirectory.empty()) {
+        return false;
+    }
+
+    std::ifstream file(this->cachePath(key), std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::vector<char> buffer((std::istreambuf_iterator<char>(file)),
+                             std::istreambuf_iterator<char>());
+
+    // Partially written or corrupted files are ignored and recompiled
+    if (buffer.size() < sizeof(uint32_t) ||
+        buffer.size() % sizeof(uint32_t) != 0) {
+        KP_LOG_WARN("Kompute ShaderCompiler ignoring invalid cache file {}",
+                    this->cachePath(key));
+        return false;
+    }
+    spirv.resize(buffer.size() / sizeof(uint32_t));
+    memcpy(spirv.data(), buffer.data(), buffer.size());
+    if (spirv[0] != 0x07230203) {
+        KP_LOG_WARN("Kompute ShaderCompiler ignoring invalid cache file {}",
+                    this->cachePath(key));
+        return false;
+    }
+
+    this->mCache[key] = spirv;
+    this->mCacheHits++;
+    return true;
+}
+
+void
+ShaderCompiler::storeCached(uint64_t key, const std::vector<uint32_t>& spirv)
+{
+    std::lock_guard<std::mutex> lock(this->mMutex);
+
+    this->mCache[key] = spirv;
+
+    if (this->mCacheDirectory.empty()) {
+        return;
+    }
+
+    // Written to a temporary file first so concurrent processes never read a
+    // partially written shader, with a random suffix as thread ids are only
+    // unique within a process
+    std::string path = this->cachePath(key);
+    std::random_device randomDevice;
+    std::ostringstream tmpPath;
+    tmpPath << path << ".tmp" << std::this_thread::get_id() << "-" << std::hex
+            << randomDevice();
+    {
+        std::ofstream file(tmpPath.str(), std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            KP_LOG_WARN("Kompute ShaderCompiler could not write cache file {}",
+                        path);
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(spirv.data()),
+                   spirv.size() * sizeof(uint32_t));
+    }
+    if (std::rename(tmpPath.str().c_str(), path.c_str())) {
+        std::remove(tmpPath.str().c_str());
+        KP_LOG_WARN("Kompute ShaderCompiler could not write cache file {}",
+                    path);
+    }
+}
+
+std::string
+ShaderCompiler::cachePath(uint64_t key) const
+{
+    std::ostringstream path;
+    path << this->mCacheDirectory << "/" << std::hex << std::setfill('0')
+         << std::setw(16) << key << ".spv";
+    return path.str();
+}
+
+uint64_t
+ShaderCompiler::hashInputs(const std::string& source,
+                           const std::map<std::string, std::string>& defines,
+                           Language language,
+                           const std::string& entryPoint)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    auto hashString = [&hash](const std::string& value) {
+        for (char c : value) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ULL;
+        }
+        // Separator so consecutive strings can't be confused
+        hash ^= 0xFF;
+        hash *= 1099511628211ULL;
+    };
+
+    hashString(CACHE_VERSION);
+    hashString(std::to_string(static_cast<uint32_t>(language)));
+    hashString(entryPoint);
+    for (const auto& define : defines) {
+        hashString(define.first);
+        hashString(define.second);
+    }
+    hashString(source);
+    return hash;
+}
+
+}
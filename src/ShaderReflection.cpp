@@ -0,0 +1,447 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/ShaderReflection.hpp"
+
+#include <algorithm>
+#include <set>
+
+namespace kp {
+
+namespace {
+
+// Subset of the SPIR-V specification used by the reflection
+const uint32_t SPIRV_MAGIC = 0x07230203;
+const uint32_t SPIRV_HEADER_WORDS = 5;
+
+enum SpirvOp : uint32_t
+{
+    OpName = 5,
+    OpExecutionMode = 16,
+    OpTypeBool = 20,
+    OpTypeInt = 21,
+    OpTypeFloat = 22,
+    OpTypeVector = 23,
+    OpTypeMatrix = 24,
+    OpTypeImage = 25,
+    OpTypeSampler = 26,
+    OpTypeSampledImage = 27,
+    OpTypeArray = 28,
+    OpTypeRuntimeArray = 29,
+    OpTypeStruct = 30,
+    OpTypePointer = 32,
+    OpConstant = 43,
+    OpConstantComposite = 44,
+    OpSpecConstant = 50,
+    OpSpecConstantComposite = 51,
+    OpVariable = 59,
+    OpDecorate = 71,
+    OpMemberDecorate = 72,
+    OpExecutionModeId = 331
+};
+
+enum SpirvDecoration : uint32_t
+{
+    DecorationSpecId = 1,
+    DecorationBufferBlock = 3,
+    DecorationArrayStride = 6,
+    DecorationMatrixStride = 7,
+    DecorationBuiltIn = 11,
+    DecorationBinding = 33,
+    DecorationDescriptorSet = 34,
+    DecorationOffset = 35
+};
+
+enum SpirvStorageClass : uint32_t
+{
+    StorageClassUniformConstant = 0,
+    StorageClassUniform = 2,
+    StorageClassPushConstant = 9,
+    StorageClassStorageBuffer = 12
+};
+
+const uint32_t EXECUTION_MODE_LOCAL_SIZE = 17;
+const uint32_t EXECUTION_MODE_LOCAL_SIZE_ID = 38;
+const uint32_t BUILT_IN_WORKGROUP_SIZE = 25;
+const uint32_t DIM_BUFFER = 5;
+
+// Declarations collected from the module, which are resolved once all the
+// instructions have been read as SPIR-V allows forward references
+struct SpirvModule
+{
+    struct Variable
+    {
+        uint32_t id;
+        uint32_t pointerType;
+        uint32_t storageClass;
+    };
+
+    std::map<uint32_t, std::string> names;
+    std::map<uint32_t, std::map<uint32_t, uint32_t>> decorations;
+    std::map<uint32_t, std::map<uint32_t, std::map<uint32_t, uint32_t>>>
+      memberDecorations;
+    std::map<uint32_t, std::vector<uint32_t>> types;
+    std::map<uint32_t, uint32_t> constants;
+    std::map<uint32_t, std::vector<uint32_t>> composites;
+    std::vector<Variable> variables;
+
+    bool hasDecoration(uint32_t id, uint32_t decoration) const
+    {
+        auto found = this->decorations.find(id);
+        return found != this->decorations.end() &&
+               found->second.count(decoration);
+    }
+
+    uint32_t decoration(uint32_t id, uint32_t decoration) const
+    {
+        return this->hasDecoration(id, decoration)
+                 ? this->decorations.at(id).at(decoration)
+                 : 0;
+    }
+
+    const std::vector<uint32_t>& type(uint32_t id) const
+    {
+        auto found = this->types.find(id);
+        if (found == this->types.end()) {
+            throw std::runtime_error(
+              "Kompute ShaderReflection reference to unknown type " +
+              std::to_string(id));
+        }
+        return found->second;
+    }
+
+    // Memory size of a type following the explicit layout decorations of the
+    // module, where runtime arrays take no space
+    uint32_t typeSize(uint32_t id) const
+    {
+        const std::vector<uint32_t>& type = this->type(id);
+        switch (type[0]) {
+            case OpTypeBool:
+                return 4;
+            case OpTypeInt:
+            case OpTypeFloat:
+                return type[1] / 8;
+            case OpTypeVector:
+            case OpTypeMatrix:
+                return type[2] * this->typeSize(type[1]);
+            case OpTypeArray: {
+                uint32_t length = this->constants.count(type[2])
+                                    ? this->constants.at(type[2])
+                                    : 0;
+                uint32_t stride =
+                  this->hasDecoration(id, DecorationArrayStride)
+                    ? this->decoration(id, DecorationArrayStride)
+                    : this->typeSize(type[1]);
+                return length * stride;
+            }
+            case OpTypeRuntimeArray:
+                return 0;
+            case OpTypeStruct: {
+                uint32_t size = 0;
+                uint32_t offset = 0;
+                for (uint32_t i = 1; i < type.size(); i++) {
+                    uint32_t member = i - 1;
+                    const std::map<uint32_t, uint32_t>& memberDecorations =
+                      this->memberDecoration(id, member);
+                    if (memberDecorations.count(DecorationOffset)) {
+                        offset = memberDecorations.at(DecorationOffset);
+                    }
+                    uint32_t memberSize = this->typeSize(type[i]);
+                    const std::vector<uint32_t>& memberType =
+                      this->type(type[i]);
+                    if (memberType[0] == OpTypeMatrix &&
+                        memberDecorations.count(DecorationMatrixStride)) {
+                        memberSize =
+                          memberType[2] *
+                          memberDecorations.at(DecorationMatrixStride);
+                    }
+                    offset += memberSize;
+                    size = std::max(size, offset);
+                }
+                return size;
+            }
+            default:
+                return 0;
+        }
+    }
+
+    const std::map<uint32_t, uint32_t>& memberDecoration(uint32_t id,
+                                                         uint32_t member) const
+    {
+        static const std::map<uint32_t, uint32_t> empty;
+        auto found = this->memberDecorations.find(id);
+        if (found == this->memberDecorations.end() ||
+            !found->second.count(member)) {
+            return empty;
+        }
+        return found->second.at(member);
+    }
+};
+
+std::string
+readString(const std::vector<uint32_t>& spirv, size_t start, size_t end)
+{
+    std::string value;
+    for (size_t i = start; i < end; i++) {
+        for (uint32_t shift = 0; shift < 32; shift += 8) {
+            char c = static_cast<char>((spirv[i] >> shift) & 0xFF);
+            if (!c) {
+                return value;
+            }
+            value += c;
+        }
+    }
+    return value;
+}
+
+}
+
+ShaderReflection::ShaderReflection(const std::vector<uint32_t>& spirv)
+{
+    this->parse(spirv);
+}
+
+const std::vector<ShaderReflection::Binding>&
+ShaderReflection::getBindings() const
+{
+    return this->mBindings;
+}
+
+uint32_t
+ShaderReflection::getPushConstantsSize() const
+{
+    return this->mPushConstantsSize;
+}
+
+std::vector<uint32_t>
+ShaderReflection::getSpecializationConstantIds() const
+{
+    std::set<uint32_t> ids;
+    for (const auto& specId : this->mSpecIds) {
+        ids.insert(specId.second);
+    }
+    return { ids.begin(), ids.end() };
+}
+
+std::array<uint32_t, 3>
+ShaderReflection::getLocalSize(
+  const std::map<uint32_t, uint32_t>& specializationConstants) const
+{
+    std::array<uint32_t, 3> localSize = this->mLocalSize;
+    for (uint32_t i = 0; i < 3; i++) {
+        uint32_t id = this->mLocalSizeIds[i];
+        if (!id) {
+            continue;
+        }
+        auto specId = this->mSpecIds.find(id);
+        if (specId != this->mSpecIds.end() &&
+            specializationConstants.count(specId->second)) {
+            localSize[i] = specializationConstants.at(specId->second);
+        } else if (this->mConstants.count(id)) {
+            localSize[i] = this->mConstants.at(id);
+        }
+    }
+    return localSize;
+}
+
+void
+ShaderReflection::parse(const std::vector<uint32_t>& spirv)
+{
+    if (spirv.size() < SPIRV_HEADER_WORDS || spirv[0] != SPIRV_MAGIC) {
+        throw std::runtime_error(
+          "Kompute ShaderReflection invalid SPIR-V magic number");
+    }
+
+    SpirvModule module;
+    uint32_t workgroupSizeId = 0;
+
+    size_t offset = SPIRV_HEADER_WORDS;
+    while (offset < spirv.size()) {
+        uint32_t wordCount = spirv[offset] >> 16;
+        uint32_t opcode = spirv[offset] & 0xFFFF;
+        if (!wordCount || offset + wordCount > spirv.size()) {
+            throw std::runtime_error(
+              "Kompute ShaderReflection malformed SPIR-V instruction at word " +
+              std::to_string(offset));
+        }
+        const uint32_t* ops = spirv.data() + offset + 1;
+        uint32_t opsCount = wordCount - 1;
+
+        switch (opcode) {
+            case OpName:
+                module.names[ops[0]] =
+                  readString(spirv, offset + 2, offset + wordCount);
+                break;
+            case OpExecutionMode:
+            case OpExecutionModeId:
+                if (opsCount >= 5 && (ops[1] == EXECUTION_MODE_LOCAL_SIZE ||
+                                      ops[1] == EXECUTION_MODE_LOCAL_SIZE_ID)) {
+                    for (uint32_t i = 0; i < 3; i++) {
+                        if (ops[1] == EXECUTION_MODE_LOCAL_SIZE) {
+                            this->mLocalSize[i] = ops[2 + i];
+                        } else {
+                            this->mLocalSizeIds[i] = ops[2 + i];
+                        }
+                    }
+                }
+                break;
+            case OpTypeBool:
+            case OpTypeInt:
+            case OpTypeFloat:
+            case OpTypeVector:
+            case OpTypeMatrix:
+            case OpTypeImage:
+            case OpTypeSampler:
+            case OpTypeSampledImage:
+            case OpTypeArray:
+            case OpTypeRuntimeArray:
+            case OpTypeStruct:
+            case OpTypePointer: {
+                // Stored as the opcode followed by the operands after the id
+                std::vector<uint32_t> type = { opcode };
+                type.insert(type.end(), ops + 1, ops + opsCount);
+                module.types[ops[0]] = type;
+                break;
+            }
+            case OpConstant:
+            case OpSpecConstant:
+                if (opsCount >= 3) {
+                    module.constants[ops[1]] = ops[2];
+                }
+                break;
+            case OpConstantComposite:
+            case OpSpecConstantComposite:
+                module.composites[ops[1]] =
+                  std::vector<uint32_t>(ops + 2, ops + opsCount);
+                break;
+            case OpVariable:
+                if (opsCount >= 3) {
+                    module.variables.push_back({ ops[1], ops[0], ops[2] });
+                }
+                break;
+            case OpDecorate:
+                if (opsCount >= 2) {
+                    module.decorations[ops[0]][ops[1]] =
+                      opsCount >= 3 ? ops[2] : 0;
+                    if (ops[1] == DecorationBuiltIn && opsCount >= 3 &&
+                        ops[2] == BUILT_IN_WORKGROUP_SIZE) {
+                        workgroupSizeId = ops[0];
+                    }
+                }
+                break;
+            case OpMemberDecorate:
+                if (opsCount >= 3) {
+                    module.memberDecorations[ops[0]][ops[1]][ops[2]] =
+                      opsCount >= 4 ? ops[3] : 0;
+                }
+                break;
+            default:
+                break;
+        }
+
+        offset += wordCount;
+    }
+
+    for (const auto& decorations : module.decorations) {
+        if (decorations.second.count(DecorationSpecId)) {
+            this->mSpecIds[decorations.first] =
+              decorations.second.at(DecorationSpecId);
+        }
+    }
+    this->mConstants = module.constants;
+
+    // The WorkgroupSize built-in takes precedence over the execution mode
+    if (workgroupSizeId && module.composites.count(workgroupSizeId) &&
+        module.composites.at(workgroupSizeId).size() == 3) {
+        for (uint32_t i = 0; i < 3; i++) {
+            this->mLocalSizeIds[i] = module.composites.at(workgroupSizeId)[i];
+        }
+    }
+    for (uint32_t i = 0; i < 3; i++) {
+        if (this->mLocalSizeIds[i] &&
+            module.constants.count(this->mLocalSizeIds[i])) {
+            this->mLocalSize[i] = module.constants.at(this->mLocalSizeIds[i]);
+        }
+    }
+
+    for (const SpirvModule::Variable& variable : module.variables) {
+        const std::vector<uint32_t>& pointer =
+          module.type(variable.pointerType);
+        if (pointer[0] != OpTypePointer) {
+            continue;
+        }
+        uint32_t typeId = pointer[2];
+
+        if (variable.storageClass == StorageClassPushConstant) {
+            this->mPushConstantsSize = module.typeSize(typeId);
+            continue;
+        }
+
+        if (!module.hasDecoration(variable.id, DecorationBinding)) {
+            continue;
+        }
+
+        // Arrays of descriptors share the binding
+        uint32_t descriptorCount = 1;
+        std::vector<uint32_t> type = module.type(typeId);
+        while (type[0] == OpTypeArray || type[0] == OpTypeRuntimeArray) {
+            if (type[0] == OpTypeArray && module.constants.count(type[2])) {
+                descriptorCount *= module.constants.at(type[2]);
+            }
+            typeId = type[1];
+            type = module.type(typeId);
+        }
+
+        vk::DescriptorType descriptorType;
+        if (variable.storageClass == StorageClassStorageBuffer) {
+            descriptorType = vk::DescriptorType::eStorageBuffer;
+        } else if (variable.storageClass == StorageClassUniform) {
+            descriptorType =
+              module.hasDecoration(typeId, DecorationBufferBlock)
+                ? vk::DescriptorType::eStorageBuffer
+                : vk::DescriptorType::eUniformBuffer;
+        } else if (variable.storageClass == StorageClassUniformConstant &&
+                   type[0] == OpTypeImage) {
+            // Operands are the sampled type, dim, depth, arrayed, ms, sampled
+            bool storage = type[6] == 2;
+            if (type[2] == DIM_BUFFER) {
+                descriptorType = storage
+                                   ? vk::DescriptorType::eStorageTexelBuffer
+                                   : vk::DescriptorType::eUniformTexelBuffer;
+            } else {
+                descriptorType = storage ? vk::DescriptorType::eStorageImage
+                                         : vk::DescriptorType::eSampledImage;
+            }
+        } else if (variable.storageClass == StorageClassUniformConstant &&
+                   type[0] == OpTypeSampledImage) {
+            descriptorType = vk::DescriptorType::eCombinedImageSampler;
+        } else if (variable.storageClass == StorageClassUniformConstant &&
+                   type[0] == OpTypeSampler) {
+            descriptorType = vk::DescriptorType::eSampler;
+        } else {
+            continue;
+        }
+
+        std::string name = module.names.count(variable.id)
+                             ? module.names.at(variable.id)
+                             : "";
+        if (name.empty() && module.names.count(typeId)) {
+            name = module.names.at(typeId);
+        }
+
+        this->mBindings.push_back(
+          { module.decoration(variable.id, DecorationDescriptorSet),
+            module.decoration(variable.id, DecorationBinding),
+            descriptorType,
+            descriptorCount,
+            name });
+    }
+
+    std::sort(this->mBindings.begin(),
+              this->mBindings.end(),
+              [](const Binding& a, const Binding& b) {
+                  return a.set != b.set ? a.set < b.set
+                                        : a.binding < b.binding;
+              });
+}
+
+}
@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/ShardedTensor.hpp"
+
+namespace kp {
+
+ShardedTensor::ShardedTensor(const std::vector<std::shared_ptr<Tensor>>& shards,
+                             const std::vector<uint32_t>& firstRows,
+                             uint32_t rows,
+                             uint32_t rowSize,
+                             bool replicated)
+{
+    KP_LOG_DEBUG("Kompute ShardedTensor constructor with {} shards of {} "
+                 "rows",
+                 shards.size(),
+                 rows);
+
+    if (shards.empty() || shards.size() != firstRows.size()) {
+        throw std::runtime_error(
+          "Kompute ShardedTensor requires a first row for each shard");
+    }
+
+    this->mShards = shards;
+    this->mFirstRows = firstRows;
+    this->mRows = rows;
+    this->mRowSize = rowSize;
+    this->mReplicated = replicated;
+}
+
+const std::vector<std::shared_ptr<Tensor>>&
+ShardedTensor::getShards() const
+{
+    return this->mShards;
+}
+
+std::shared_ptr<Tensor>
+ShardedTensor::getShard(uint32_t index) const
+{
+    return this->mShards.at(index);
+}
+
+uint32_t
+ShardedTensor::shardCount() const
+{
+    return this->mShards.size();
+}
+
+uint32_t
+ShardedTensor::getShardFirstRow(uint32_t index) const
+{
+    return this->mFirstRows.at(index);
+}
+
+uint32_t
+ShardedTensor::getShardRows(uint32_t index) const
+{
+    if (this->mReplicated) {
+        return this->mRows;
+    }
+    uint32_t nextRow = index + 1 < this->mFirstRows.size()
+                         ? this->mFirstRows[index + 1]
+                         : this->mRows;
+    return nextRow - this->mFirstRows.at(index);
+}
+
+uint32_t
+ShardedTensor::getRows() const
+{
+    return this->mRows;
+}
+
+uint32_t
+ShardedTensor::getRowSize() const
+{
+    return this->mRowSize;
+}
+
+bool
+ShardedTensor::isReplicated() const
+{
+    return this->mReplicated;
+}
+
+}
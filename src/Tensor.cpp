@@ -2,6 +2,7 @@
 
 #include "kompute/Tensor.hpp"
 #include "kompute/Image.hpp"
+#include "kompute/ImageLayoutTracker.hpp"
 
 namespace kp {
 
@@ -34,7 +35,8 @@ Tensor::Tensor(std::shared_ptr<vk::PhysicalDevice> physicalDevice,
                uint32_t elementTotalCount,
                uint32_t elementMemorySize,
                const DataTypes& dataType,
-               const MemoryTypes& memoryType)
+               const MemoryTypes& memoryType,
+               bool transient)
   : Memory(physicalDevice, device, dataType, memoryType, elementTotalCount, 1)
 {
     this->mSize = elementTotalCount;
@@ -46,6 +48,13 @@ Tensor::Tensor(std::shared_ptr<vk::PhysicalDevice> physicalDevice,
                  elementTotalCount,
                  Memory::toString(memoryType));
 
+    // Transient tensors have no host data so they can share device memory
+    if (transient && memoryType != MemoryTypes::eStorage) {
+        throw std::runtime_error(
+          "Kompute Tensor transient tensors must be of type eStorage");
+    }
+    this->mTransient = transient;
+
     this->mDescriptorType = vk::DescriptorType::eStorageBuffer;
 
     this->reserve();
@@ -81,7 +90,13 @@ Tensor::reserve()
 bool
 Tensor::isInit()
 {
-    return this->mDevice && this->mPrimaryBuffer && this->mPrimaryMemory;
+    // Transient tensors get their memory when their sequence is planned and
+    // evicted tensors when they are used again
+    if (this->mEvicted) {
+        return this->mDevice && this->mStagingBuffer;
+    }
+    return this->mDevice && this->mPrimaryBuffer &&
+           (this->mPrimaryMemory || this->mTransient);
 }
 
 void
@@ -108,14 +123,12 @@ Tensor::recordCopyFrom(const vk::CommandBuffer& commandBuffer,
 
     vk::DeviceSize bufferSize(this->memorySize());
 
-    vk::ImageSubresourceLayers layer = {};
-    layer.aspectMask = vk::ImageAspectFlagBits::eColor;
-    layer.layerCount = 1;
     vk::Offset3D offset = { 0, 0, 0 };
 
-    vk::Extent3D size = { copyFromImage->getX(), copyFromImage->getY(), 1 };
+    vk::Extent3D size = copyFromImage->getExtent();
 
-    vk::BufferImageCopy copyRegion(0, 0, 0, layer, offset, size);
+    vk::BufferImageCopy copyRegion(
+      0, 0, 0, copyFromImage->getSubresourceLayers(), offset, size);
 
     KP_LOG_DEBUG("Kompute Tensor recordCopyFrom data size {}.", bufferSize);
 
@@ -184,8 +197,11 @@ Tensor::recordCopyBufferFromImage(const vk::CommandBuffer& commandBuffer,
                                   vk::DeviceSize /*bufferSize*/,
                                   vk::BufferImageCopy copyRegion)
 {
-    commandBuffer.copyImageToBuffer(
-      *imageFrom, fromLayout, *bufferTo, 1, &copyRegion);
+    ImageLayoutTracker::recordCommand(
+      commandBuffer, [=](const vk::CommandBuffer& deferredCommandBuffer) {
+          deferredCommandBuffer.copyImageToBuffer(
+            *imageFrom, fromLayout, *bufferTo, 1, &copyRegion);
+      });
 }
 
 void
@@ -290,16 +306,19 @@ Tensor::getPrimaryBufferUsageFlags()
         case MemoryTypes::eDevice:
         case MemoryTypes::eHost:
         case MemoryTypes::eDeviceAndHost:
+            // Any tensor can hold the parameters of an indirect dispatch
             return vk::BufferUsageFlagBits::eStorageBuffer |
                    vk::BufferUsageFlagBits::eTransferSrc |
-                   vk::BufferUsageFlagBits::eTransferDst;
+                   vk::BufferUsageFlagBits::eTransferDst |
+                   vk::BufferUsageFlagBits::eIndirectBuffer;
             break;
         case MemoryTypes::eStorage:
             return vk::BufferUsageFlagBits::eStorageBuffer |
                    // You can still copy buffers to/from storage memory
                    // so set the transfer usage flags here.
                    vk::BufferUsageFlagBits::eTransferSrc |
-                   vk::BufferUsageFlagBits::eTransferDst;
+                   vk::BufferUsageFlagBits::eTransferDst |
+                   vk::BufferUsageFlagBits::eIndirectBuffer;
             break;
         default:
             throw std::runtime_error("Kompute Tensor invalid tensor type");
@@ -325,6 +344,116 @@ Tensor::getPrimaryBuffer()
     return this->mPrimaryBuffer;
 }
 
+bool
+Tensor::isTransient()
+{
+    return this->mTransient;
+}
+
+bool
+Tensor::isMemoryBound()
+{
+    return this->mPrimaryMemory != nullptr;
+}
+
+vk::MemoryRequirements
+Tensor::getPrimaryMemoryRequirements()
+{
+    return this->mDevice->getBufferMemoryRequirements(*this->mPrimaryBuffer);
+}
+
+void
+Tensor::bindTransientMemory(std::shared_ptr<vk::DeviceMemory> memory,
+                            vk::DeviceSize offset)
+{
+    KP_LOG_DEBUG("Kompute Tensor binding transient memory at offset {}",
+                 offset);
+
+    if (!this->mTransient) {
+        throw std::runtime_error(
+          "Kompute Tensor only transient tensors can be bound to memory");
+    }
+    if (this->isMemoryBound()) {
+        throw std::runtime_error(
+          "Kompute Tensor transient memory can only be bound once");
+    }
+
+    this->mDevice->bindBufferMemory(*this->mPrimaryBuffer, *memory, offset);
+
+    // The memory block is freed by its owner
+    this->mPrimaryMemory = memory;
+    this->mFreePrimaryMemory = false;
+}
+
+void
+Tensor::evict()
+{
+    KP_LOG_DEBUG("Kompute Tensor evicting device memory");
+
+    if (this->mMemoryType != MemoryTypes::eDevice) {
+        throw std::runtime_error(
+          "Kompute Tensor only eDevice tensors can be evicted, as their data "
+          "is kept in the staging memory");
+    }
+    if (this->mEvicted) {
+        return;
+    }
+
+    if (this->mFreePrimaryBuffer) {
+        this->mDevice->destroy(
+          *this->mPrimaryBuffer,
+          (vk::Optional<const vk::AllocationCallbacks>)nullptr);
+        this->mFreePrimaryBuffer = false;
+    }
+    this->mPrimaryBuffer = nullptr;
+
+    if (this->mFreePrimaryMemory) {
+        this->mDevice->freeMemory(
+          *this->mPrimaryMemory,
+          (vk::Optional<const vk::AllocationCallbacks>)nullptr);
+        this->mFreePrimaryMemory = false;
+    }
+    this->mPrimaryMemory = nullptr;
+
+    this->mEvicted = true;
+}
+
+void
+Tensor::restore()
+{
+    if (!this->mEvicted) {
+        return;
+    }
+
+    KP_LOG_DEBUG("Kompute Tensor restoring evicted device memory");
+
+    this->mPrimaryBuffer = std::make_shared<vk::Buffer>();
+    this->createBuffer(this->mPrimaryBuffer,
+                       this->getPrimaryBufferUsageFlags());
+    this->mFreePrimaryBuffer = true;
+
+    this->mPrimaryMemory = std::make_shared<vk::DeviceMemory>();
+    this->allocateBindMemory(this->mPrimaryBuffer,
+                             this->mPrimaryMemory,
+                             this->getPrimaryMemoryPropertyFlags());
+    this->mFreePrimaryMemory = true;
+
+    this->mEvicted = false;
+    this->mPrimaryBufferVersion++;
+}
+
+bool
+Tensor::isEvicted()
+{
+    return this->mEvicted;
+}
+
+uint32_t
+Tensor::getPrimaryBufferVersion()
+{
+    return this->mPrimaryBufferVersion;
+}
+
 void
 Tensor::allocateMemoryCreateGPUResources()
 {
@@ -343,6 +472,12 @@ Tensor::allocateMemoryCreateGPUResources()
     this->createBuffer(this->mPrimaryBuffer,
                        this->getPrimaryBufferUsageFlags());
     this->mFreePrimaryBuffer = true;
+
+    if (this->mTransient) {
+        KP_LOG_DEBUG("Kompute Tensor transient buffer created without memory");
+        return;
+    }
+
     this->mPrimaryMemory = std::make_shared<vk::DeviceMemory>();
     this->allocateBindMemory(this->mPrimaryBuffer,
                              this->mPrimaryMemory,
@@ -478,6 +613,9 @@ Tensor::destroy()
 
     Memory::destroy();
 
+    // The memory block of transient tensors is not owned by the tensor
+    this->mPrimaryMemory = nullptr;
+
     KP_LOG_DEBUG("Kompute Tensor successful destroy()");
 }
 }
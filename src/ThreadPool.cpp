@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kompute/ThreadPool.hpp"
+#include "kompute/logger/Logger.hpp"
+
+namespace kp {
+
+ThreadPool::ThreadPool(uint32_t totalThreads)
+{
+    if (totalThreads == 0) {
+        totalThreads = std::thread::hardware_concurrency();
+    }
+    if (totalThreads == 0) {
+        totalThreads = 1;
+    }
+
+    KP_LOG_DEBUG("Kompute ThreadPool starting {} worker threads",
+                 totalThreads);
+
+    for (uint32_t i = 0; i < totalThreads; i++) {
+        this->mWorkers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    KP_LOG_DEBUG("Kompute ThreadPool destructor started");
+
+    {
+        std::lock_guard<std::mutex> lock(this->mMutex);
+        this->mStopping = true;
+    }
+    this->mCondition.notify_all();
+
+    for (std::thread& worker : this->mWorkers) {
+        worker.join();
+    }
+}
+
+std::shared_future<void>
+ThreadPool::submit(std::function<void()> task)
+{
+    std::packaged_task<void()> packagedTask(std::move(task));
+    std::shared_future<void> future = packagedTask.get_future().share();
+
+    {
+        std::lock_guard<std::mutex> lock(this->mMutex);
+        if (this->mStopping) {
+            throw std::runtime_error(
+              "Kompute ThreadPool submit called when pool is stopping");
+        }
+        this->mTasks.push(std::move(packagedTask));
+    }
+    this->mCondition.notify_one();
+
+    return future;
+}
+
+uint32_t
+ThreadPool::size() const
+{
+    return this->mWorkers.size();
+}
+
+void
+ThreadPool::work()
+{
+    while (true) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(this->mMutex);
+            this->mCondition.wait(lock, [this]() {
+                return this->mStopping || !this->mTasks.empty();
+            });
+            // Remaining tasks are drained before stopping so all the futures
+            // handed out become ready
+            if (this->mTasks.empty()) {
+                return;
+            }
+            task = std::move(this->mTasks.front());
+            this->mTasks.pop();
+        }
+        task();
+    }
+}
+
+}
@@ -9,7 +9,10 @@
 #include <fmt/format.h>
 #endif
 
+#include "kompute/ConstantBlock.hpp"
+#include "kompute/ShaderReflection.hpp"
 #include "kompute/Tensor.hpp"
+#include "kompute/ThreadPool.hpp"
 #include "logger/Logger.hpp"
 
 namespace kp {
@@ -30,7 +33,8 @@ class Algorithm
      * resources
      *  @param spirv (optional) The spirv code to use to create the algorithm
      *  @param workgroup (optional) The kp::Workgroup to use for the dispatch
-     * which defaults to kp::Workgroup(tensor[0].size(), 1, 1) if not set.
+     * which defaults to kp::Workgroup(tensor[0].size() / localSizeX, 1, 1) if
+     * not set, where localSizeX is the local size of the shader.
      *  @param specializationConstants (optional) The templatable param is to be
      * used to initialize the specialization constants which cannot be changed
      * once set.
@@ -45,7 +49,7 @@ class Algorithm
               const std::vector<uint32_t>& spirv = {},
               const Workgroup& workgroup = {},
               const std::vector<S>& specializationConstants = {},
-              const std::vector<P>& pushConstants = {}) noexcept
+              const std::vector<P>& pushConstants = {})
     {
         KP_LOG_DEBUG("Kompute Algorithm Constructor with device");
 
@@ -76,7 +80,8 @@ class Algorithm
      *  @param tensors The tensors to use to create the descriptor resources
      *  @param spirv The spirv code to use to create the algorithm
      *  @param workgroup (optional) The kp::Workgroup to use for the dispatch
-     * which defaults to kp::Workgroup(tensor[0].size(), 1, 1) if not set.
+     * which defaults to kp::Workgroup(tensor[0].size() / localSizeX, 1, 1) if
+     * not set, where localSizeX is the local size of the shader.
      *  @param specializationConstants (optional) The std::vector<float> to use
      * to initialize the specialization constants which cannot be changed once
      * set.
@@ -94,53 +99,55 @@ class Algorithm
     {
         KP_LOG_DEBUG("Kompute Algorithm rebuild started");
 
-        this->mMemObjects = memObjects;
-        this->mSpirv = spirv;
-
-        if (specializationConstants.size()) {
-            if (this->mSpecializationConstantsData) {
-                free(this->mSpecializationConstantsData);
-            }
-            uint32_t memorySize =
-              sizeof(decltype(specializationConstants.back()));
-            uint32_t size = specializationConstants.size();
-            uint32_t totalSize = size * memorySize;
-            this->mSpecializationConstantsData = malloc(totalSize);
-            memcpy(this->mSpecializationConstantsData,
-                   specializationConstants.data(),
-                   totalSize);
-            this->mSpecializationConstantsDataTypeMemorySize = memorySize;
-            this->mSpecializationConstantsSize = size;
-        }
-
-        if (pushConstants.size()) {
-            if (this->mPushConstantsData) {
-                free(this->mPushConstantsData);
-            }
-            uint32_t memorySize = sizeof(decltype(pushConstants.back()));
-            uint32_t size = pushConstants.size();
-            uint32_t totalSize = size * memorySize;
-            this->mPushConstantsData = malloc(totalSize);
-            memcpy(this->mPushConstantsData, pushConstants.data(), totalSize);
-            this->mPushConstantsDataTypeMemorySize = memorySize;
-            this->mPushConstantsSize = size;
-        }
+        this->prepareRebuild(memObjects,
+                             spirv,
+                             workgroup,
+                             specializationConstants,
+                             pushConstants);
 
-        this->setWorkgroup(
-          workgroup,
-          this->mMemObjects.size() ? this->mMemObjects[0]->size() : 1);
-
-        // Descriptor pool is created first so if available then destroy all
-        // before rebuild
-        if (this->isInit()) {
-            this->destroy();
-        }
-
-        this->createParameters();
         this->createShaderModule();
         this->createPipeline();
     }
 
+    /**
+     *  Rebuild function which creates the descriptor resources synchronously
+     * but compiles the shader module and pipeline in the thread pool provided.
+     * The algorithm can be recorded straight away, as recording waits for the
+     * pipeline to be ready if it is still being compiled.
+     *
+     *  @param threadPool The thread pool used to compile the pipeline
+     *  @param tensors The tensors to use to create the descriptor resources
+     *  @param spirv The spirv code to use to create the algorithm
+     *  @param workgroup (optional) The kp::Workgroup to use for the dispatch
+     * which defaults to kp::Workgroup(tensor[0].size() / localSizeX, 1, 1) if
+     * not set, where localSizeX is the local size of the shader.
+     *  @param specializationConstants (optional) The templatable param to use
+     * to initialize the specialization constants.
+     *  @param pushConstants (optional) The templatable param to use when
+     * initializing the pipeline, which sets the size of the push constants.
+     */
+    template<typename S = float, typename P = float>
+    void rebuildAsync(ThreadPool& threadPool,
+                      const std::vector<std::shared_ptr<Memory>>& memObjects,
+                      const std::vector<uint32_t>& spirv,
+                      const Workgroup& workgroup = {},
+                      const std::vector<S>& specializationConstants = {},
+                      const std::vector<P>& pushConstants = {})
+    {
+        KP_LOG_DEBUG("Kompute Algorithm async rebuild started");
+
+        this->prepareRebuild(memObjects,
+                             spirv,
+                             workgroup,
+                             specializationConstants,
+                             pushConstants);
+
+        this->mPipelineReady = threadPool.submit([this]() {
+            this->createShaderModule();
+            this->createPipeline();
+        });
+    }
+
     /**
      * @brief Make Algorithm uncopyable
      *
@@ -157,6 +164,20 @@ class Algorithm
      */
     ~Algorithm() noexcept;
 
+    /**
+     * Returns whether the pipeline has finished compiling, which is always
+     * the case unless the algorithm was built with rebuildAsync.
+     *
+     * @returns true if the pipeline is not being compiled in the background
+     */
+    bool isPipelineReady() const;
+
+    /**
+     * Blocks until the pipeline being compiled in the background is ready,
+     * rethrowing any error raised while compiling it.
+     */
+    void waitForPipeline();
+
     /**
      * Records the dispatch function with the provided template parameters or
      * alternatively using the size of the tensor by default.
@@ -165,6 +186,22 @@ class Algorithm
      */
     void recordDispatch(const vk::CommandBuffer& commandBuffer);
 
+    /**
+     * Records an indirect dispatch function, where the workgroup count is read
+     * by the GPU from a VkDispatchIndirectCommand (ie. three uint32_t values
+     * x, y and z) stored in the buffer provided instead of the workgroup set
+     * in the algorithm.
+     *
+     * @param commandBuffer Command buffer to record the algorithm resources to
+     * @param buffer Buffer containing the VkDispatchIndirectCommand, which
+     * must have been created with the indirect buffer usage flag
+     * @param offset Byte offset of the command in the buffer, which must be a
+     * multiple of 4
+     */
+    void recordDispatchIndirect(const vk::CommandBuffer& commandBuffer,
+                                const vk::Buffer& buffer,
+                                vk::DeviceSize offset = 0);
+
     /**
      * Records command that binds the "core" algorithm components which consist
      * of binding the pipeline and binding the descriptorsets.
@@ -211,6 +248,9 @@ class Algorithm
     template<typename T>
     void setPushConstants(const std::vector<T>& pushConstants)
     {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Kompute push constants must be trivially copyable");
+
         uint32_t memorySize = sizeof(decltype(pushConstants.back()));
         uint32_t size = pushConstants.size();
 
@@ -226,7 +266,7 @@ class Algorithm
      * @param size The number of data elements provided in the data
      * @param memorySize The memory size of each of the data elements in bytes.
      */
-    void setPushConstants(void* data, uint32_t size, uint32_t memorySize)
+    void setPushConstants(const void* data, uint32_t size, uint32_t memorySize)
     {
 
         uint32_t totalSize = memorySize * size;
@@ -289,6 +329,32 @@ class Algorithm
      */
     const std::vector<std::shared_ptr<Memory>>& getMemObjects();
 
+    /**
+     * Gets a 64-bit FNV-1a hash of the SPIR-V of the current algorithm, which
+     * can be used to identify the shader across runs.
+     *
+     * @returns The hash of the SPIR-V words
+     */
+    uint64_t getSpirvHash() const;
+
+    /**
+     * Computes the 64-bit FNV-1a hash of the SPIR-V words provided, which is
+     * the same hash returned by getSpirvHash().
+     *
+     * @param spirv The SPIR-V words to hash
+     * @returns The hash of the SPIR-V words
+     */
+    static uint64_t hashSpirv(const std::vector<uint32_t>& spirv);
+
+    /**
+     * Gets the reflection of the SPIR-V of the current algorithm, with the
+     * bindings, push constant size and local size declared by the shader.
+     *
+     * @returns The reflection of the shader, or nullptr if the algorithm has
+     * not been built yet
+     */
+    std::shared_ptr<ShaderReflection> getReflection();
+
     void destroy();
 
   private:
@@ -317,15 +383,121 @@ class Algorithm
     void* mSpecializationConstantsData = nullptr;
     uint32_t mSpecializationConstantsDataTypeMemorySize = 0;
     uint32_t mSpecializationConstantsSize = 0;
+    std::vector<vk::SpecializationMapEntry> mSpecializationEntries;
     void* mPushConstantsData = nullptr;
     uint32_t mPushConstantsDataTypeMemorySize = 0;
     uint32_t mPushConstantsSize = 0;
     Workgroup mWorkgroup;
+    std::shared_future<void> mPipelineReady;
+    std::shared_ptr<ShaderReflection> mReflection;
+    bool mDescriptorSetsPending = false;
+    std::vector<uint32_t> mDescriptorVersions;
 
     // Create util functions
     void createShaderModule();
     void createPipeline();
 
+    // Writes the descriptors of the memory objects, which is deferred to the
+    // first record when transient or evicted tensors do not have memory yet,
+    // and done again when evicted tensors are restored with a new buffer
+    void updateDescriptorSets();
+
+    // Reflects the SPIR-V and validates it against the memory objects, which
+    // is done before any member changes so a failed rebuild has no effect
+    std::shared_ptr<ShaderReflection> reflectSpirv(
+      const std::vector<uint32_t>& spirv,
+      const std::vector<std::shared_ptr<Memory>>& memObjects,
+      uint32_t pushConstantsSize) const;
+    // Number of workgroups covering the first memory object with the local
+    // size of the shader, used when no workgroup is provided
+    uint32_t defaultWorkgroupSize();
+
+    // Shared setup of rebuild and rebuildAsync which stores the parameters
+    // and creates the descriptor resources
+    template<typename S, typename P>
+    void prepareRebuild(const std::vector<std::shared_ptr<Memory>>& memObjects,
+                        const std::vector<uint32_t>& spirv,
+                        const Workgroup& workgroup,
+                        const std::vector<S>& specializationConstants,
+                        const std::vector<P>& pushConstants)
+    {
+        static_assert(std::is_trivially_copyable<P>::value,
+                      "Kompute push constants must be trivially copyable");
+
+        // Push constants keep their previous values when none are provided
+        uint32_t pushConstantsSize =
+          pushConstants.size()
+            ? (uint32_t)(sizeof(P) * pushConstants.size())
+            : this->mPushConstantsDataTypeMemorySize * this->mPushConstantsSize;
+        std::shared_ptr<ShaderReflection> reflection =
+          this->reflectSpirv(spirv, memObjects, pushConstantsSize);
+
+        // A pipeline still compiling reads the current parameters, and any
+        // error it raised is discarded as the pipeline is being rebuilt
+        if (this->mPipelineReady.valid()) {
+            this->mPipelineReady.wait();
+            this->mPipelineReady = std::shared_future<void>();
+        }
+
+        this->mMemObjects = memObjects;
+        this->mSpirv = spirv;
+        this->mReflection = reflection;
+
+        if (specializationConstants.size()) {
+            if (this->mSpecializationConstantsData) {
+                free(this->mSpecializationConstantsData);
+            }
+            uint32_t memorySize =
+              sizeof(decltype(specializationConstants.back()));
+            uint32_t size = specializationConstants.size();
+            uint32_t totalSize = size * memorySize;
+            this->mSpecializationConstantsData = malloc(totalSize);
+            memcpy(this->mSpecializationConstantsData,
+                   specializationConstants.data(),
+                   totalSize);
+            this->mSpecializationConstantsDataTypeMemorySize = memorySize;
+            this->mSpecializationConstantsSize = size;
+
+            // Each element can hold several constants of different types,
+            // which are mapped to consecutive constant ids
+            std::vector<std::pair<uint32_t, uint32_t>> layout =
+              ConstantsLayout<S>::entries();
+            this->mSpecializationEntries.clear();
+            for (uint32_t i = 0; i < size; i++) {
+                for (const std::pair<uint32_t, uint32_t>& entry : layout) {
+                    this->mSpecializationEntries.push_back(
+                      vk::SpecializationMapEntry(
+                        (uint32_t)this->mSpecializationEntries.size(),
+                        i * memorySize + entry.first,
+                        entry.second));
+                }
+            }
+        }
+
+        if (pushConstants.size()) {
+            if (this->mPushConstantsData) {
+                free(this->mPushConstantsData);
+            }
+            uint32_t memorySize = sizeof(decltype(pushConstants.back()));
+            uint32_t size = pushConstants.size();
+            uint32_t totalSize = size * memorySize;
+            this->mPushConstantsData = malloc(totalSize);
+            memcpy(this->mPushConstantsData, pushConstants.data(), totalSize);
+            this->mPushConstantsDataTypeMemorySize = memorySize;
+            this->mPushConstantsSize = size;
+        }
+
+        this->setWorkgroup(workgroup, this->defaultWorkgroupSize());
+
+        // Descriptor pool is created first so if available then destroy all
+        // before rebuild
+        if (this->isInit()) {
+            this->destroy();
+        }
+
+        this->createParameters();
+    }
+
     // Parameters
     void createParameters();
 };
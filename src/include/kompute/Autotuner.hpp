@@ -0,0 +1,221 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <chrono>
+#include <limits>
+#include <map>
+#include <string>
+
+#include "kompute/Core.hpp"
+
+#include "kompute/Manager.hpp"
+#include "kompute/operations/OpAlgoDispatch.hpp"
+
+namespace kp {
+
+/**
+ * Chooses the fastest local workgroup size of a compute shader on the current
+ * device. The shader is expected to declare its local size through a
+ * specialization constant (ie. `layout(local_size_x_id = 0) in;`), which is
+ * set to each candidate size in turn while the dispatch is timed with the
+ * sequence timestamp queries. The results are cached per device UUID and
+ * SPIR-V hash, optionally in a file so they persist across runs.
+ *
+ * Tuning dispatches the shader on the memory objects provided, so these
+ * should contain scratch data as their content will be modified.
+ */
+class Autotuner
+{
+  public:
+    /**
+     * Outcome of tuning a shader.
+     */
+    struct Result
+    {
+        uint32_t localSizeX = 0;
+        Workgroup workgroup = { 0, 0, 0 };
+        double timeUs = 0;
+        bool cached = false;
+    };
+
+    /**
+     * Constructor for the autotuner, which loads the results previously
+     * cached in the file provided.
+     *
+     * @param manager The manager used to create the algorithms and sequences
+     * @param cachePath (optional) Path of the file used to persist results,
+     * results are only cached in memory if empty
+     * @param candidates (optional) Local sizes to evaluate, which are filtered
+     * by the limits of the device
+     * @param iterations (optional) Number of timed dispatches per candidate
+     */
+    Autotuner(Manager& manager,
+              const std::string& cachePath = "",
+              const std::vector<uint32_t>& candidates = { 32,
+                                                          64,
+                                                          128,
+                                                          256,
+                                                          512,
+                                                          1024 },
+              uint32_t iterations = 5);
+
+    /**
+     * Finds the fastest local size for the shader provided, or returns the
+     * cached result for this device and shader if available.
+     *
+     * @param memObjects The memory objects to dispatch the shader with
+     * @param spirv The SPIR-V of the shader to tune
+     * @param totalInvocations (optional) Number of invocations required along
+     * the x axis, defaults to the size of the first memory object
+     * @param specializationConstants (optional) Specialization constants of
+     * the shader, where the one at localSizeSpecId is overwritten
+     * @param pushConstants (optional) Push constants of the shader
+     * @param localSizeSpecId (optional) Constant id of local_size_x_id
+     * @returns The fastest local size with its matching dispatch workgroup
+     */
+    template<typename P = float>
+    Result tune(const std::vector<std::shared_ptr<Memory>>& memObjects,
+                const std::vector<uint32_t>& spirv,
+                uint32_t totalInvocations = 0,
+                const std::vector<uint32_t>& specializationConstants = {},
+                const std::vector<P>& pushConstants = {},
+                uint32_t localSizeSpecId = 0)
+    {
+        if (!totalInvocations) {
+            totalInvocations = memObjects.size() ? memObjects[0]->size() : 1;
+        }
+
+        std::string key = this->cacheKey(Algorithm::hashSpirv(spirv));
+
+        Result result;
+        auto cached = this->mCache.find(key);
+        if (cached != this->mCache.end()) {
+            KP_LOG_DEBUG("Kompute Autotuner using cached local size {} for {}",
+                         cached->second,
+                         key);
+            result.localSizeX = cached->second;
+            result.workgroup = workgroupFor(totalInvocations, cached->second);
+            result.cached = true;
+            return result;
+        }
+
+        std::vector<uint32_t> candidates = this->validCandidates();
+        if (candidates.empty()) {
+            throw std::runtime_error("Kompute Autotuner none of the candidate "
+                                     "local sizes are supported by the device");
+        }
+
+        result.timeUs = std::numeric_limits<double>::max();
+
+        std::shared_ptr<Algorithm> algorithm =
+          this->mManager.algorithm<uint32_t, P>(
+            memObjects,
+            spirv,
+            workgroupFor(totalInvocations, candidates[0]),
+            withLocalSize(
+              specializationConstants, localSizeSpecId, candidates[0]),
+            pushConstants);
+
+        for (uint32_t localSize : candidates) {
+            Workgroup workgroup = workgroupFor(totalInvocations, localSize);
+            if (localSize != candidates[0]) {
+                algorithm->rebuild<uint32_t, P>(
+                  memObjects,
+                  spirv,
+                  workgroup,
+                  withLocalSize(
+                    specializationConstants, localSizeSpecId, localSize),
+                  pushConstants);
+            }
+
+            double timeUs = this->timeDispatch(algorithm);
+
+            KP_LOG_DEBUG("Kompute Autotuner local size {} took {} us",
+                         localSize,
+                         timeUs);
+
+            if (timeUs < result.timeUs) {
+                result.localSizeX = localSize;
+                result.workgroup = workgroup;
+                result.timeUs = timeUs;
+            }
+        }
+
+        KP_LOG_INFO("Kompute Autotuner selected local size {} for {}",
+                    result.localSizeX,
+                    key);
+
+        algorithm->destroy();
+
+        this->mCache[key] = result.localSizeX;
+        this->saveCache();
+
+        return result;
+    }
+
+    /**
+     * Tunes the shader provided and creates a managed algorithm with the
+     * fastest local size and its matching dispatch workgroup.
+     *
+     * @param memObjects The memory objects to dispatch the shader with
+     * @param spirv The SPIR-V of the shader to tune
+     * @param totalInvocations (optional) Number of invocations required along
+     * the x axis, defaults to the size of the first memory object
+     * @param specializationConstants (optional) Specialization constants of
+     * the shader, where the one at localSizeSpecId is overwritten
+     * @param pushConstants (optional) Push constants of the shader
+     * @param localSizeSpecId (optional) Constant id of local_size_x_id
+     * @returns Shared pointer with the tuned algorithm
+     */
+    template<typename P = float>
+    std::shared_ptr<Algorithm> algorithm(
+      const std::vector<std::shared_ptr<Memory>>& memObjects,
+      const std::vector<uint32_t>& spirv,
+      uint32_t totalInvocations = 0,
+      const std::vector<uint32_t>& specializationConstants = {},
+      const std::vector<P>& pushConstants = {},
+      uint32_t localSizeSpecId = 0)
+    {
+        Result result = this->tune<P>(memObjects,
+                                      spirv,
+                                      totalInvocations,
+                                      specializationConstants,
+                                      pushConstants,
+                                      localSizeSpecId);
+
+        return this->mManager.algorithm<uint32_t, P>(
+          memObjects,
+          spirv,
+          result.workgroup,
+          withLocalSize(
+            specializationConstants, localSizeSpecId, result.localSizeX),
+          pushConstants);
+    }
+
+    /**
+     * Removes all the cached results, including the ones in the cache file.
+     */
+    void clearCache();
+
+  private:
+    Manager& mManager;
+    std::string mCachePath;
+    std::vector<uint32_t> mCandidates;
+    uint32_t mIterations;
+    std::map<std::string, uint32_t> mCache;
+
+    std::vector<uint32_t> validCandidates();
+    std::string cacheKey(uint64_t spirvHash);
+    double timeDispatch(std::shared_ptr<Algorithm> algorithm);
+    void loadCache();
+    void saveCache();
+
+    static Workgroup workgroupFor(uint32_t totalInvocations,
+                                  uint32_t localSize);
+    static std::vector<uint32_t> withLocalSize(
+      const std::vector<uint32_t>& specializationConstants,
+      uint32_t localSizeSpecId,
+      uint32_t localSize);
+};
+
+} // End namespace kp
@@ -0,0 +1,249 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace kp {
+
+namespace detail {
+
+constexpr uint32_t
+alignConstantOffset(uint32_t offset, uint32_t alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+// Scalar types that can be used as specialization or push constants, which
+// are the 32 and 64 bit types of GLSL (ie. int, uint, float, int64_t,
+// uint64_t and double).
+template<typename T>
+struct IsConstantScalar
+  : std::integral_constant<bool,
+                           std::is_arithmetic<T>::value &&
+                             !std::is_same<T, bool>::value &&
+                             (sizeof(T) == 4 || sizeof(T) == 8)>
+{};
+
+template<typename... Ts>
+struct AllConstantScalars : std::true_type
+{};
+
+template<typename T, typename... Ts>
+struct AllConstantScalars<T, Ts...>
+  : std::integral_constant<bool,
+                           IsConstantScalar<T>::value &&
+                             AllConstantScalars<Ts...>::value>
+{};
+
+// Offset of the member I following the scalar (and std430) layout rules,
+// where each member is aligned to its own size
+template<size_t I, typename Tuple>
+struct ConstantOffset
+{
+    typedef typename std::tuple_element<I - 1, Tuple>::type Previous;
+    typedef typename std::tuple_element<I, Tuple>::type Current;
+
+    static constexpr uint32_t value =
+      alignConstantOffset(ConstantOffset<I - 1, Tuple>::value +
+                            sizeof(Previous),
+                          sizeof(Current));
+};
+
+template<typename Tuple>
+struct ConstantOffset<0, Tuple>
+{
+    static constexpr uint32_t value = 0;
+};
+
+template<typename... Ts>
+struct ConstantMaxSize
+{
+    static constexpr uint32_t value = 4;
+};
+
+template<typename T, typename... Ts>
+struct ConstantMaxSize<T, Ts...>
+{
+    static constexpr uint32_t value = sizeof(T) > ConstantMaxSize<Ts...>::value
+                                        ? sizeof(T)
+                                        : ConstantMaxSize<Ts...>::value;
+};
+
+// Total size rounded up to the largest member so arrays of the block keep
+// every member aligned
+template<typename... Ts>
+struct ConstantsMemorySize
+{
+    typedef std::tuple<Ts...> Tuple;
+    static constexpr size_t last = sizeof...(Ts) - 1;
+
+    static constexpr uint32_t value = alignConstantOffset(
+      ConstantOffset<last, Tuple>::value +
+        sizeof(typename std::tuple_element<last, Tuple>::type),
+      ConstantMaxSize<Ts...>::value);
+};
+
+} // End namespace detail
+
+/**
+ * Block of heterogeneous constants, such as a uint count followed by a float
+ * scale, which can be used as the specialization constants or push constants
+ * of an algorithm (ie. Algorithm::rebuild<ConstantBlock<uint32_t, float>>).
+ *
+ * The members are laid out with the scalar layout rules, which for scalars
+ * match the std430 layout of push constant blocks, and the offsets are
+ * computed at compile time. Only 32 and 64 bit arithmetic types are accepted.
+ * When used as specialization constants, each member is mapped to the next
+ * constant_id starting from 0.
+ */
+template<typename... Ts>
+class ConstantBlock
+{
+    static_assert(sizeof...(Ts) > 0,
+                  "Kompute ConstantBlock requires at least one member");
+    static_assert(detail::AllConstantScalars<Ts...>::value,
+                  "Kompute ConstantBlock members must be 32 or 64 bit "
+                  "arithmetic types");
+
+  public:
+    typedef std::tuple<Ts...> Tuple;
+
+    /**
+     * Number of members in the block.
+     */
+    static constexpr uint32_t count = sizeof...(Ts);
+
+    /**
+     * Total memory size of the block in bytes.
+     */
+    static constexpr uint32_t memorySize =
+      detail::ConstantsMemorySize<Ts...>::value;
+
+    /**
+     * Byte offset of the member I within the block.
+     */
+    template<size_t I>
+    static constexpr uint32_t offset()
+    {
+        return detail::ConstantOffset<I, Tuple>::value;
+    }
+
+    /**
+     * Default constructor which sets all members to zero.
+     */
+    ConstantBlock() { this->mData.fill(0); }
+
+    /**
+     * Constructor with the value of each of the members.
+     *
+     * @param values The values of the members in order
+     */
+    ConstantBlock(const Ts&... values)
+    {
+        this->mData.fill(0);
+        this->setAll(std::index_sequence_for<Ts...>(), values...);
+    }
+
+    /**
+     * Gets the value of the member I.
+     *
+     * @returns The value of the member
+     */
+    template<size_t I>
+    typename std::tuple_element<I, Tuple>::type get() const
+    {
+        typename std::tuple_element<I, Tuple>::type value;
+        memcpy(&value, this->mData.data() + offset<I>(), sizeof(value));
+        return value;
+    }
+
+    /**
+     * Sets the value of the member I.
+     *
+     * @param value The value of the member
+     */
+    template<size_t I>
+    void set(const typename std::tuple_element<I, Tuple>::type& value)
+    {
+        memcpy(this->mData.data() + offset<I>(), &value, sizeof(value));
+    }
+
+    /**
+     * Returns the offset and size of each of the members, which is used to
+     * create the specialization map entries.
+     *
+     * @returns Vector of offset and size pairs in bytes
+     */
+    static std::vector<std::pair<uint32_t, uint32_t>> entries()
+    {
+        return entries(std::index_sequence_for<Ts...>());
+    }
+
+  private:
+    std::array<uint8_t, memorySize> mData;
+
+    template<size_t... Is>
+    void setAll(std::index_sequence<Is...>, const Ts&... values)
+    {
+        int expand[] = { (this->set<Is>(values), 0)... };
+        (void)expand;
+    }
+
+    template<size_t... Is>
+    static std::vector<std::pair<uint32_t, uint32_t>> entries(
+      std::index_sequence<Is...>)
+    {
+        return { { offset<Is>(),
+                   (uint32_t)sizeof(
+                     typename std::tuple_element<Is, Tuple>::type) }... };
+    }
+};
+
+template<typename... Ts>
+constexpr uint32_t ConstantBlock<Ts...>::count;
+
+template<typename... Ts>
+constexpr uint32_t ConstantBlock<Ts...>::memorySize;
+
+/**
+ * Describes how a type used for specialization constants maps to constant
+ * ids, as the offset and size of each of its members. Any other type maps to
+ * a single constant of its size, as before kp::ConstantBlock was added, and
+ * kp::ConstantBlock maps to one constant per member. It can be specialised
+ * for user defined structs, for instance:
+ *
+ *     template<>
+ *     struct kp::ConstantsLayout<Params>
+ *     {
+ *         static std::vector<std::pair<uint32_t, uint32_t>> entries()
+ *         {
+ *             return { { offsetof(Params, count), sizeof(uint32_t) },
+ *                      { offsetof(Params, scale), sizeof(float) } };
+ *         }
+ *     };
+ */
+template<typename T>
+struct ConstantsLayout
+{
+    static std::vector<std::pair<uint32_t, uint32_t>> entries()
+    {
+        return { { 0, (uint32_t)sizeof(T) } };
+    }
+};
+
+template<typename... Ts>
+struct ConstantsLayout<ConstantBlock<Ts...>>
+{
+    static std::vector<std::pair<uint32_t, uint32_t>> entries()
+    {
+        return ConstantBlock<Ts...>::entries();
+    }
+};
+
+} // End namespace kp
@@ -0,0 +1,272 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "kompute/Core.hpp"
+#include "kompute/Manager.hpp"
+#include "kompute/ShardedTensor.hpp"
+#include "kompute/operations/OpSyncDevice.hpp"
+#include "kompute/operations/OpSyncLocal.hpp"
+#include "logger/Logger.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace kp {
+
+/**
+ * Group of devices with a kp::Manager each, which splits the work of
+ * kp::ShardedTensor objects across them. The operations of the group are
+ * submitted to every device before waiting on any of them, so the devices
+ * run concurrently and the throughput scales with their number. The data
+ * is gathered through the host, as each device has its own logical device
+ * and memory cannot be shared between them.
+ */
+class DeviceGroup
+{
+  public:
+    /**
+     * Constructor which uses the devices suitable for compute ordered by
+     * their score against the default kp::DevicePolicy, see
+     * kp::DeviceSelector::scoreDevice. CPU devices are only used if there are
+     * no GPUs, as the rows are spread evenly and the slowest device bounds
+     * the throughput.
+     *
+     * @param maxDevices (optional) The maximum number of devices to use, all
+     * the suitable devices by default
+     * @param desiredExtensions (optional) The extensions to load on each device
+     */
+    DeviceGroup(uint32_t maxDevices = 0,
+                const std::vector<std::string>& desiredExtensions = {});
+
+    /**
+     * Constructor with the physical devices to use, in order.
+     *
+     * @param physicalDeviceIndices The indices of the physical devices
+     * @param desiredExtensions (optional) The extensions to load on each device
+     */
+    DeviceGroup(const std::vector<uint32_t>& physicalDeviceIndices,
+                const std::vector<std::string>& desiredExtensions = {});
+
+    /**
+     * @brief Make DeviceGroup uncopyable
+     *
+     */
+    DeviceGroup(const DeviceGroup&) = delete;
+    DeviceGroup(const DeviceGroup&&) = delete;
+    DeviceGroup& operator=(const DeviceGroup&) = delete;
+    DeviceGroup& operator=(const DeviceGroup&&) = delete;
+
+    /**
+     * The number of devices in the group.
+     *
+     * @return The number of devices
+     */
+    uint32_t size() const;
+
+    /**
+     * The manager of a device, to create the resources specific to it.
+     *
+     * @param index The index of the device in the group
+     * @return Shared pointer to the manager of the device
+     */
+    std::shared_ptr<Manager> getManager(uint32_t index) const;
+
+    /**
+     * Create a tensor split along its first dimension across the devices.
+     *
+     * @param data The data of the tensor, made of rows of rowSize elements
+     * @param rowSize (optional) The number of elements of each row
+     * @param tensorType (optional) The type of the tensors of the shards
+     * @returns Shared pointer with the sharded tensor
+     */
+    template<typename T>
+    std::shared_ptr<ShardedTensor> tensor(
+      const std::vector<T>& data,
+      uint32_t rowSize = 1,
+      Memory::MemoryTypes tensorType = Memory::MemoryTypes::eDevice)
+    {
+        if (rowSize == 0 || data.size() % rowSize != 0) {
+            throw std::runtime_error(
+              "Kompute DeviceGroup data size is not a multiple of row size");
+        }
+
+        uint32_t rows = data.size() / rowSize;
+        std::vector<uint32_t> firstRows = this->splitRows(rows);
+
+        std::vector<std::shared_ptr<Tensor>> shards;
+        for (uint32_t i = 0; i < firstRows.size(); i++) {
+            uint32_t end =
+              i + 1 < firstRows.size() ? firstRows[i + 1] : rows;
+            std::vector<T> shardData(data.begin() + firstRows[i] * rowSize,
+                                     data.begin() + end * rowSize);
+            shards.push_back(
+              this->mManagers[i]->tensorT<T>(shardData, tensorType));
+        }
+
+        return std::make_shared<ShardedTensor>(
+          shards, firstRows, rows, rowSize, false);
+    }
+
+    /**
+     * Create a tensor split along its first dimension across the devices,
+     * without initial data.
+     *
+     * @param rows The number of rows
+     * @param rowSize (optional) The number of elements of each row
+     * @param tensorType (optional) The type of the tensors of the shards
+     * @returns Shared pointer with the sharded tensor
+     */
+    template<typename T>
+    std::shared_ptr<ShardedTensor> tensorT(
+      uint32_t rows,
+      uint32_t rowSize = 1,
+      Memory::MemoryTypes tensorType = Memory::MemoryTypes::eDevice)
+    {
+        if (rowSize == 0) {
+            throw std::runtime_error(
+              "Kompute DeviceGroup row size cannot be zero");
+        }
+
+        std::vector<uint32_t> firstRows = this->splitRows(rows);
+
+        std::vector<std::shared_ptr<Tensor>> shards;
+        for (uint32_t i = 0; i < firstRows.size(); i++) {
+            uint32_t end =
+              i + 1 < firstRows.size() ? firstRows[i + 1] : rows;
+            shards.push_back(this->mManagers[i]->tensorT<T>(
+              (end - firstRows[i]) * rowSize, tensorType));
+        }
+
+        return std::make_shared<ShardedTensor>(
+          shards, firstRows, rows, rowSize, false);
+    }
+
+    /**
+     * Create a tensor with all its data on every device, which can be used
+     * alongside sharded tensors by the algorithms of the group.
+     *
+     * @param data The data of the tensor
+     * @param tensorType (optional) The type of the tensors of the shards
+     * @returns Shared pointer with the replicated tensor
+     */
+    template<typename T>
+    std::shared_ptr<ShardedTensor> replicate(
+      const std::vector<T>& data,
+      Memory::MemoryTypes tensorType = Memory::MemoryTypes::eDevice)
+    {
+        std::vector<std::shared_ptr<Tensor>> shards;
+        for (const std::shared_ptr<Manager>& manager : this->mManagers) {
+            shards.push_back(manager->tensorT<T>(data, tensorType));
+        }
+
+        return std::make_shared<ShardedTensor>(
+          shards,
+          std::vector<uint32_t>(shards.size(), 0),
+          data.size(),
+          1,
+          true);
+    }
+
+    /**
+     * Create an algorithm on each device running a shader on the shards of
+     * the tensors. The sharded tensors must have the same number of rows so
+     * their shards match, while replicated tensors can be mixed with them
+     * after the first tensor. The pipeline of each algorithm is compiled in
+     * the background.
+     *
+     * @param tensors The sharded tensors bound in order, the first of which
+     * cannot be replicated
+     * @param spirv The SPIRV bytes of the shader
+     * @param workgroups (optional) The workgroup of each shard, which by
+     * default is derived from the size of the shard of the first tensor as
+     * for kp::Manager::algorithm
+     * @param specializationConstants (optional) The specialization constants
+     * @param pushConstants (optional) The push constants, which can be set
+     * per shard on the returned algorithms
+     * @returns Vector with the algorithm of each shard
+     */
+    std::vector<std::shared_ptr<Algorithm>> algorithm(
+      const std::vector<std::shared_ptr<ShardedTensor>>& tensors,
+      const std::vector<uint32_t>& spirv,
+      const std::vector<Workgroup>& workgroups = {},
+      const std::vector<float>& specializationConstants = {},
+      const std::vector<float>& pushConstants = {});
+
+    /**
+     * Copies the host data of the shards to their devices, on all the
+     * devices at once.
+     *
+     * @param tensors The sharded tensors to sync
+     */
+    void syncDevice(const std::vector<std::shared_ptr<ShardedTensor>>& tensors);
+
+    /**
+     * Copies the device data of the shards to their host data, on all the
+     * devices at once.
+     *
+     * @param tensors The sharded tensors to sync
+     */
+    void syncLocal(const std::vector<std::shared_ptr<ShardedTensor>>& tensors);
+
+    /**
+     * Dispatches the algorithm of each shard on its device, submitting to
+     * all the devices before waiting for any of them.
+     *
+     * @param algorithms The algorithms created with algorithm()
+     */
+    void eval(const std::vector<std::shared_ptr<Algorithm>>& algorithms);
+
+    /**
+     * Gathers the rows of a sharded tensor on the host.
+     *
+     * @param tensor The sharded tensor to gather
+     * @returns Vector with the elements of all the rows
+     */
+    template<typename T>
+    std::vector<T> gather(std::shared_ptr<ShardedTensor> tensor)
+    {
+        this->syncLocal({ tensor });
+        return tensor->vector<T>();
+    }
+
+    /**
+     * Gathers the rows of a sharded tensor in a tensor of one device, staged
+     * through the host.
+     *
+     * @param tensor The sharded tensor to gather
+     * @param index The index of the device in the group
+     * @returns Shared pointer with the tensor holding all the rows
+     */
+    template<typename T>
+    std::shared_ptr<TensorT<T>> gather(std::shared_ptr<ShardedTensor> tensor,
+                                       uint32_t index)
+    {
+        std::shared_ptr<TensorT<T>> gathered =
+          this->getManager(index)->tensorT<T>(this->gather<T>(tensor));
+        this->mSequences[index]->eval<OpSyncDevice>({ gathered });
+        return gathered;
+    }
+
+  private:
+    // -------------- ALWAYS OWNED RESOURCES
+    std::vector<std::shared_ptr<Manager>> mManagers;
+    std::vector<std::shared_ptr<Sequence>> mSequences;
+
+    // Index of the first row of each shard, for as many shards as devices
+    // unless there are less rows
+    std::vector<uint32_t> splitRows(uint32_t rows) const;
+
+    // Submits the sequences recorded on each device before awaiting them
+    void evalSequences(const std::vector<bool>& recorded);
+
+    // The shards of the tensors held by a device
+    static std::vector<std::shared_ptr<Memory>> getShards(
+      const std::vector<std::shared_ptr<ShardedTensor>>& tensors,
+      uint32_t index);
+
+    void createManagers(const std::vector<uint32_t>& physicalDeviceIndices,
+                        const std::vector<std::string>& desiredExtensions,
+                        std::shared_ptr<Manager> firstManager = nullptr);
+};
+
+} // End namespace kp
@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "kompute/Core.hpp"
+#include <string>
+#include <vector>
+
+namespace kp {
+
+/**
+ * Requirements and preferences used to select the physical device and the
+ * compute queue family of a kp::Manager.
+ */
+struct DevicePolicy
+{
+    /**
+     * The type of device ranked above the others, which otherwise rank
+     * discrete GPUs, integrated GPUs, virtual GPUs and then CPUs, such as
+     * software rasterisers.
+     */
+    vk::PhysicalDeviceType preferredType = vk::PhysicalDeviceType::eDiscreteGpu;
+
+    /**
+     * Minimum size in bytes of the largest device local memory heap.
+     */
+    vk::DeviceSize minDeviceMemory = 0;
+
+    /**
+     * Core features the device must support, which are enabled on it.
+     */
+    vk::PhysicalDeviceFeatures requiredFeatures;
+
+    /**
+     * Extensions the device must support, which are enabled on it.
+     */
+    std::vector<std::string> requiredExtensions;
+
+    /**
+     * Capabilities the compute queue family must have, such as eGraphics
+     * for the blits of kp::OpGenerateMipmaps.
+     */
+    vk::QueueFlags requiredQueueFlags = vk::QueueFlagBits::eCompute;
+
+    /**
+     * Whether a queue family with compute but without graphics is preferred,
+     * as its queues run asynchronously to the graphics work of the device.
+     */
+    bool preferAsyncCompute = true;
+};
+
+/**
+ * Scores the physical devices and their queue families against a
+ * kp::DevicePolicy, so the best device is used rather than the first one
+ * enumerated, which is often an integrated GPU or a software rasteriser.
+ */
+class DeviceSelector
+{
+  public:
+    /**
+     * Score of a physical device, which ranks its type first, then whether
+     * it has dedicated compute and transfer queue families.
+     *
+     * @param physicalDevice The physical device to score
+     * @param policy The requirements and preferences of the selection
+     * @return The score, which is negative if the device does not meet the
+     * requirements of the policy
+     */
+    static int64_t scoreDevice(const vk::PhysicalDevice& physicalDevice,
+                               const DevicePolicy& policy);
+
+    /**
+     * Selects the physical device with the highest score, and the largest
+     * device local memory among equal scores.
+     *
+     * @param physicalDevices The physical devices of the instance
+     * @param policy The requirements and preferences of the selection
+     * @return The index of the selected physical device
+     */
+    static uint32_t selectDevice(
+      const std::vector<vk::PhysicalDevice>& physicalDevices,
+      const DevicePolicy& policy);
+
+    /**
+     * Selects the compute queue family of a physical device, which is an
+     * async compute family without graphics when the policy prefers it and
+     * does not require graphics.
+     *
+     * @param physicalDevice The physical device to select the family of
+     * @param policy The requirements and preferences of the selection
+     * @return The index of the selected queue family
+     */
+    static uint32_t selectQueueFamily(const vk::PhysicalDevice& physicalDevice,
+                                      const DevicePolicy& policy);
+
+    /**
+     * Finds a queue family dedicated to transfers, without compute or
+     * graphics, which usually maps to the copy engines of discrete GPUs.
+     *
+     * @param physicalDevice The physical device to search
+     * @return The index of the queue family, or -1 if there is none
+     */
+    static int64_t findTransferQueueFamily(
+      const vk::PhysicalDevice& physicalDevice);
+
+    /**
+     * The size of the largest device local memory heap.
+     *
+     * @param physicalDevice The physical device to query
+     * @return The size of the heap in bytes
+     */
+    static vk::DeviceSize getDeviceMemorySize(
+      const vk::PhysicalDevice& physicalDevice);
+
+    /**
+     * Whether all the required features are supported.
+     *
+     * @param supported The features supported by a device
+     * @param required The features required
+     * @return Boolean stating whether the required features are supported
+     */
+    static bool supportsFeatures(const vk::PhysicalDeviceFeatures& supported,
+                                 const vk::PhysicalDeviceFeatures& required);
+};
+
+} // End namespace kp
@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "kompute/Core.hpp"
+
+#include "kompute/Algorithm.hpp"
+#include "kompute/Manager.hpp"
+#include "kompute/Tensor.hpp"
+
+namespace kp {
+
+/**
+ * Builder of fused elementwise kernels over float tensors. Expressions such as
+ * `expr::relu(a * b + c) * 0.5f` form a DAG of operations, which is turned into
+ * a single generated compute shader that reads each input once per element,
+ * keeps the intermediate values in registers and writes the output once. The
+ * result is a regular kp::Algorithm to be dispatched with kp::OpAlgoDispatch.
+ *
+ * The generated source only depends on the structure of the expression: the
+ * tensors are bindings and the constants are push constants, so expressions
+ * of the same shape over other tensors or constants reuse the SPIR-V compiled
+ * previously.
+ */
+namespace expr {
+
+/**
+ * Node of an elementwise expression, which is cheap to copy as the nodes are
+ * shared between the expressions built from them.
+ */
+class Expr
+{
+  public:
+    /**
+     * The operations supported in expressions.
+     */
+    enum class Operation
+    {
+        eTensor = 0,
+        eConstant = 1,
+        eAdd = 2,
+        eSub = 3,
+        eMul = 4,
+        eDiv = 5,
+        eNeg = 6,
+        eMin = 7,
+        eMax = 8,
+        eAbs = 9,
+        eExp = 10,
+        eLog = 11,
+        eSqrt = 12,
+        eTanh = 13,
+        eRelu = 14,
+        eSigmoid = 15,
+    };
+
+    /**
+     * Data of a node, where the tensor is only set for eTensor and the value
+     * only used for eConstant.
+     */
+    struct Node
+    {
+        Operation operation;
+        std::shared_ptr<Tensor> tensor;
+        float value = 0;
+        std::vector<std::shared_ptr<const Node>> operands;
+    };
+
+    /**
+     * Expression reading the elements of a float tensor.
+     *
+     * @param tensor The tensor to read, with the same size as the output
+     */
+    explicit Expr(const std::shared_ptr<Tensor>& tensor);
+
+    /**
+     * Expression of a constant broadcast to every element.
+     *
+     * @param value The value of the constant
+     */
+    Expr(float value);
+
+    /**
+     * Expression applying an operation to other expressions.
+     *
+     * @param operation The operation, which is neither eTensor nor eConstant
+     * @param operands The operands, one for unary and two for binary
+     * operations
+     */
+    Expr(Operation operation, const std::vector<Expr>& operands);
+
+    /**
+     * The root node of the expression.
+     *
+     * @return Shared pointer to the node
+     */
+    const std::shared_ptr<const Node>& node() const;
+
+  private:
+    std::shared_ptr<const Node> mNode;
+};
+
+// Arithmetic on expressions, where floats are promoted to constants
+Expr
+operator+(const Expr& a, const Expr& b);
+Expr
+operator-(const Expr& a, const Expr& b);
+Expr
+operator*(const Expr& a, const Expr& b);
+Expr
+operator/(const Expr& a, const Expr& b);
+Expr
+operator-(const Expr& a);
+
+// Elementwise functions, matching their GLSL counterparts
+Expr
+min(const Expr& a, const Expr& b);
+Expr
+max(const Expr& a, const Expr& b);
+Expr
+abs(const Expr& a);
+Expr
+exp(const Expr& a);
+Expr
+log(const Expr& a);
+Expr
+sqrt(const Expr& a);
+Expr
+tanh(const Expr& a);
+Expr
+relu(const Expr& a);
+Expr
+sigmoid(const Expr& a);
+
+/**
+ * Function compiling GLSL compute shader sources into SPIR-V.
+ */
+typedef std::function<std::vector<uint32_t>(const std::string& source)>
+  Compiler;
+
+/**
+ * Generates the GLSL compute shader evaluating an expression into an output
+ * tensor, which can also be one of the inputs of the expression.
+ *
+ * @param output The float tensor the expression is written to
+ * @param expression The expression to evaluate for each element
+ * @return The source of the compute shader
+ */
+std::string
+source(const std::shared_ptr<Tensor>& output, const Expr& expression);
+
+/**
+ * Creates a managed algorithm evaluating an expression into an output tensor
+ * with a single dispatch. The SPIR-V of each generated source is cached for
+ * the lifetime of the process.
+ *
+ * @param manager The manager used to create the algorithm
+ * @param output The float tensor the expression is written to
+ * @param expression The expression to evaluate for each element
+ * @param compiler (optional) Function compiling the generated source, which
+ * defaults to kp::ShaderCompiler when built with KOMPUTE_OPT_USE_SHADERC and
+ * is required otherwise
+ * @return Shared pointer to the algorithm, with the tensors of the expression
+ * as its memory objects
+ */
+std::shared_ptr<Algorithm>
+algorithm(Manager& manager,
+          const std::shared_ptr<Tensor>& output,
+          const Expr& expression,
+          const Compiler& compiler = nullptr);
+
+/**
+ * Removes the SPIR-V cached by algorithm, so the following expressions are
+ * compiled again.
+ */
+void
+clearCache();
+
+} // End namespace expr
+
+} // End namespace kp
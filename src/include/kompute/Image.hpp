@@ -3,6 +3,7 @@
 
 #include "kompute/Core.hpp"
 #include "kompute/Memory.hpp"
+#include "kompute/Sampler.hpp"
 #include "kompute/Tensor.hpp"
 #include "logger/Logger.hpp"
 #include <memory>
@@ -10,6 +11,8 @@
 
 namespace kp {
 
+class ImageLayoutTracker;
+
 /**
  * Image data used in GPU operations.
  *
@@ -20,6 +23,17 @@ namespace kp {
 class Image : public Memory
 {
   public:
+    /**
+     * Dimensions of an image beyond its width, height and number of channels,
+     * which are used for 3D volumes, layered 2D arrays and mip chains.
+     */
+    struct Dimensions
+    {
+        uint32_t depth = 1;     ///< Depth of 3D images
+        uint32_t layers = 1;    ///< Number of layers of 2D image arrays
+        uint32_t mipLevels = 1; ///< Number of mip levels, 0 for a full chain
+    };
+
     /**
      *  Constructor with data provided which would be used to create the
      *  respective vulkan image and memory.
@@ -165,6 +179,49 @@ class Image : public Memory
     }
 
 
+    /**
+     *  Constructor of 3D images, image arrays or images with mip levels, which
+     *  use optimal tiling and must be of type eDevice or eStorage. The data
+     *  covers the first mip level of every layer and depth slice, with the
+     *  layers being the outermost dimension, followed by the depth, the rows
+     *  and the texels.
+     *
+     *  @param physicalDevice The physical device to use to fetch properties
+     *  @param device The device to use to create the image and memory from
+     *  @param data Pointer to data that will be used to initialise the image,
+     *  which can be null
+     *  @param dataSize Size in elements of the data pointed to by \p data
+     *  @param x Width of the image in pixels
+     *  @param y Height of the image in pixels
+     *  @param numChannels The number of channels in the image
+     *  @param dataType Data type for the image which is of type DataTypes
+     *  @param dimensions The depth, layers and mip levels of the image
+     *  @param memoryType Type for the image which is of type MemoryTypes
+     */
+    Image(std::shared_ptr<vk::PhysicalDevice> physicalDevice,
+          std::shared_ptr<vk::Device> device,
+          void* data,
+          size_t dataSize,
+          uint32_t x,
+          uint32_t y,
+          uint32_t numChannels,
+          const DataTypes& dataType,
+          const Dimensions& dimensions,
+          const MemoryTypes& memoryType = MemoryTypes::eDevice)
+      : Memory(physicalDevice, device, dataType, memoryType, x, y)
+    {
+        if (dataType == DataTypes::eCustom) {
+            throw std::runtime_error(
+              "Custom data types are not supported for Kompute Images");
+        }
+
+        init(data,
+             dataSize,
+             numChannels,
+             vk::ImageTiling::eOptimal,
+             dimensions);
+    }
+
     /**
      * @brief Make Image uncopyable
      *
@@ -272,7 +329,9 @@ class Image : public Memory
     /**
      * Records the image memory barrier into the primary image and command
      * buffer which ensures that relevant data transfers are carried out
-     * correctly.
+     * correctly. When the command buffer belongs to a kp::Sequence, the
+     * transition goes through its kp::ImageLayoutTracker, which skips it if
+     * the image is already in the layout.
      *
      * @param commandBuffer Vulkan Command Buffer to record the commands into
      * @param srcAccessMask Access flags for source access mask
@@ -299,6 +358,54 @@ class Image : public Memory
       vk::DescriptorSet descriptorSet,
       uint32_t binding) override;
 
+    /**
+     * Sets how the image is bound to the algorithms created afterwards, which
+     * is as a storage image by default. Sampled images are read with
+     * texelFetch, and combined image samplers with texture() so the filtering
+     * and addressing of the sampler are done by the texture units.
+     *
+     * @param descriptorType One of eStorageImage, eSampledImage or
+     * eCombinedImageSampler
+     * @param sampler The sampler of eCombinedImageSampler bindings, which
+     * must be null otherwise
+     */
+    void setDescriptorType(vk::DescriptorType descriptorType,
+                           std::shared_ptr<Sampler> sampler = nullptr);
+
+    /**
+     * The sampler the image is bound with, see setDescriptorType.
+     *
+     * @return Shared pointer to the sampler, or null if the image is not a
+     * combined image sampler
+     */
+    std::shared_ptr<Sampler> getSampler();
+
+    /**
+     * Records the generation of the mip levels from the first one, where each
+     * level is blitted from the previous one with a linear filter when the
+     * format supports it. The image is left in the general layout.
+     *
+     * @param commandBuffer Vulkan Command Buffer to record the commands into
+     */
+    void recordGenerateMipmaps(const vk::CommandBuffer& commandBuffer);
+
+    /**
+     * The layers of a mip level of the image, which is used to address the
+     * image in copy commands.
+     *
+     * @param mipLevel The mip level
+     * @return Subresource layers with all the layers of the mip level
+     */
+    vk::ImageSubresourceLayers getSubresourceLayers(uint32_t mipLevel = 0);
+
+    /**
+     * The size of a mip level of the image.
+     *
+     * @param mipLevel The mip level
+     * @return Extent of the mip level, whose depth is 1 for 2D images
+     */
+    vk::Extent3D getExtent(uint32_t mipLevel = 0);
+
     std::shared_ptr<vk::Image> getPrimaryImage();
     vk::ImageLayout getPrimaryImageLayout();
 
@@ -309,6 +416,27 @@ class Image : public Memory
      */
     uint32_t getNumChannels();
 
+    /***
+     * Retreive the depth of the image, which is 1 unless it is a 3D image
+     *
+     * @return Depth of the image
+     */
+    uint32_t getDepth();
+
+    /***
+     * Retreive the number of layers of the image array
+     *
+     * @return Number of layers, which is 1 for images that are not arrays
+     */
+    uint32_t getLayers();
+
+    /***
+     * Retreive the number of mip levels of the image
+     *
+     * @return Number of mip levels
+     */
+    uint32_t getMipLevels();
+
     Type type() override { return Type::eImage; }
 
   protected:
@@ -317,23 +445,45 @@ class Image : public Memory
     vk::DescriptorImageInfo mDescriptorImageInfo;
     vk::ImageLayout mPrimaryImageLayout = vk::ImageLayout::eUndefined;
     vk::ImageLayout mStagingImageLayout = vk::ImageLayout::eUndefined;
+    // Layout of the primary image once the submitted commands have executed,
+    // whereas mPrimaryImageLayout follows the commands being recorded
+    vk::ImageLayout mSubmittedPrimaryImageLayout = vk::ImageLayout::eUndefined;
     std::shared_ptr<vk::ImageView> mImageView = nullptr;
+    // View with all the mip levels, used by sampled descriptors
+    std::shared_ptr<vk::ImageView> mSampledImageView = nullptr;
     vk::ImageTiling mTiling = vk::ImageTiling::eOptimal;
+    uint32_t mDepth = 1;
+    uint32_t mLayers = 1;
+    uint32_t mMipLevels = 1;
+
+    // -------------- NEVER OWNED RESOURCES
+    std::shared_ptr<Sampler> mSampler;
 
   private:
+    friend class ImageLayoutTracker;
+
     // -------------- OPTIONALLY OWNED RESOURCES
     std::shared_ptr<vk::Image> mPrimaryImage;
     bool mFreePrimaryImage = false;
     std::shared_ptr<vk::Image> mStagingImage;
     bool mFreeStagingImage = false;
+    // Used instead of the staging image by 3D images and image arrays, as
+    // linear images are only guaranteed to support a single 2D layer
+    std::shared_ptr<vk::Buffer> mStagingBuffer;
+    bool mFreeStagingBuffer = false;
 
     void allocateMemoryCreateGPUResources(); // Creates the vulkan image
     void createImage(std::shared_ptr<vk::Image> image,
                      vk::ImageUsageFlags imageUsageFlags,
-                     vk::ImageTiling imageTiling);
+                     vk::ImageTiling imageTiling,
+                     uint32_t mipLevels);
+    void createStagingBuffer();
     void allocateBindMemory(std::shared_ptr<vk::Image> image,
                             std::shared_ptr<vk::DeviceMemory> memory,
                             vk::MemoryPropertyFlags memoryPropertyFlags);
+    void allocateMemory(vk::MemoryRequirements memoryRequirements,
+                        std::shared_ptr<vk::DeviceMemory> memory,
+                        vk::MemoryPropertyFlags memoryPropertyFlags);
     void recordCopyImage(const vk::CommandBuffer& commandBuffer,
                          std::shared_ptr<vk::Image> srcImage,
                          std::shared_ptr<vk::Image> dstImage,
@@ -367,25 +517,31 @@ class Image : public Memory
 
     void recordImageMemoryBarrier(const vk::CommandBuffer& commandBuffer,
                                   const vk::Image& image,
-                                  vk::AccessFlagBits srcAccessMask,
-                                  vk::AccessFlagBits dstAccessMask,
-                                  vk::PipelineStageFlagBits srcStageMask,
-                                  vk::PipelineStageFlagBits dstStageMask,
+                                  vk::AccessFlags srcAccessMask,
+                                  vk::AccessFlags dstAccessMask,
+                                  vk::PipelineStageFlags srcStageMask,
+                                  vk::PipelineStageFlags dstStageMask,
                                   vk::ImageLayout oldLayout,
-                                  vk::ImageLayout newLayout);
+                                  vk::ImageLayout newLayout,
+                                  vk::ImageSubresourceRange subresourceRange);
 
     // Private util functions
     vk::ImageUsageFlags getPrimaryImageUsageFlags();
     vk::ImageUsageFlags getStagingImageUsageFlags();
 
     vk::Format getFormat();
+    vk::FormatFeatureFlags getFormatFeatures();
+    vk::ImageSubresourceRange getSubresourceRange(uint32_t baseMipLevel = 0,
+                                                  uint32_t levelCount = 1);
+    bool usesStagingBuffer();
 
     vk::DescriptorImageInfo constructDescriptorImageInfo();
 
     void init(void* data,
               size_t dataSize,
               uint32_t numChannels,
-              vk::ImageTiling tiling);
+              vk::ImageTiling tiling,
+              const Dimensions& dimensions = Dimensions());
     /**
      * Function to reserve memory on the image. This does not copy any data, it
      * just reserves memory, similarly to std::vector reserve() method.
@@ -510,6 +666,39 @@ class ImageT : public Image
                      numChannels);
     }
 
+    ImageT(std::shared_ptr<vk::PhysicalDevice> physicalDevice,
+           std::shared_ptr<vk::Device> device,
+           const std::vector<T>& data,
+           uint32_t x,
+           uint32_t y,
+           uint32_t numChannels,
+           const Dimensions& dimensions,
+           const MemoryTypes& imageType = MemoryTypes::eDevice)
+      : Image(physicalDevice,
+              device,
+              data.empty() ? nullptr : (void*)data.data(),
+              data.size(),
+              x,
+              y,
+              numChannels,
+              Memory::dataType<T>(),
+              dimensions,
+              imageType)
+    {
+        // Images cannot be created with custom types
+        static_assert(Memory::dataType<T>() != DataTypes::eCustom,
+                      "Custom data types are not supported for Kompute Images");
+
+        KP_LOG_DEBUG("Kompute imageT constructor with data size {}, x {}, "
+                     "y {}, depth {}, layers {} and num channels {}",
+                     data.size(),
+                     x,
+                     y,
+                     dimensions.depth,
+                     dimensions.layers,
+                     numChannels);
+    }
+
     ~ImageT() { KP_LOG_DEBUG("Kompute imageT destructor"); }
 
     std::vector<T> vector() { return Memory::vector<T>(); }
@@ -0,0 +1,218 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "kompute/Core.hpp"
+#include "kompute/Image.hpp"
+#include "logger/Logger.hpp"
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace kp {
+
+/**
+ * Tracks the layouts of the primary images used by the command buffer of a
+ * kp::Sequence. The transitions requested by the operations are queued and
+ * recorded together in a single pipeline barrier when flushed, where the
+ * transitions to the layout an image is already in only keep their memory
+ * dependency. The layouts the recording expects the images to be in are kept
+ * so a sequence can detect when it is replayed, or submitted after another
+ * recording of the same images, with images in a different layout, and
+ * record its commands again.
+ */
+class ImageLayoutTracker
+{
+  public:
+    /**
+     * Constructor that registers the tracker for the command buffer, which
+     * is where kp::Image looks it up when recording barriers.
+     *
+     * @param commandBuffer The command buffer whose image layouts are tracked
+     * @param queueFlags (optional) The capabilities of the queue family the
+     * command buffer is submitted to
+     */
+    ImageLayoutTracker(
+      const vk::CommandBuffer& commandBuffer,
+      vk::QueueFlags queueFlags = vk::QueueFlagBits::eCompute);
+
+    /**
+     * @brief Make ImageLayoutTracker uncopyable
+     *
+     */
+    ImageLayoutTracker(const ImageLayoutTracker&) = delete;
+    ImageLayoutTracker(const ImageLayoutTracker&&) = delete;
+    ImageLayoutTracker& operator=(const ImageLayoutTracker&) = delete;
+    ImageLayoutTracker& operator=(const ImageLayoutTracker&&) = delete;
+
+    /**
+     * Destructor which unregisters the tracker from its command buffer.
+     */
+    ~ImageLayoutTracker();
+
+    /**
+     * Finds the tracker registered for a command buffer.
+     *
+     * @param commandBuffer The command buffer being recorded
+     * @return Pointer to the tracker, or nullptr if the command buffer is not
+     * tracked
+     */
+    static ImageLayoutTracker* find(const vk::CommandBuffer& commandBuffer);
+
+    /**
+     * Queues the transition of all the subresources of the primary image to
+     * a layout, which is recorded by the next flush(). Transitions to the
+     * current layout are skipped and only keep their memory dependency.
+     *
+     * @param image The image to transition
+     * @param dstLayout Image layout for the image after the barrier completes
+     * @param srcAccessMask Access flags for source access mask
+     * @param dstAccessMask Access flags for destination access mask
+     * @param srcStageMask Pipeline stage flags for source stage mask
+     * @param dstStageMask Pipeline stage flags for destination stage mask
+     */
+    void transition(Image& image,
+                    vk::ImageLayout dstLayout,
+                    vk::AccessFlags srcAccessMask,
+                    vk::AccessFlags dstAccessMask,
+                    vk::PipelineStageFlags srcStageMask,
+                    vk::PipelineStageFlags dstStageMask);
+
+    /**
+     * Records the queued transitions and memory dependencies into a single
+     * pipeline barrier.
+     *
+     * @param commandBuffer Vulkan Command Buffer to record the barrier into
+     */
+    void flush(const vk::CommandBuffer& commandBuffer);
+
+    /**
+     * Starts batching the transitions of an operation over several images.
+     * Until endBatch, kp::Image::recordPrimaryImageBarrier only queues the
+     * transitions and the commands passed to recordCommand are deferred, so
+     * a single pipeline barrier precedes the commands of the operation.
+     */
+    void beginBatch();
+
+    /**
+     * Records the transitions queued since beginBatch into a single pipeline
+     * barrier, followed by the commands deferred in the meantime.
+     *
+     * @param commandBuffer Vulkan Command Buffer to record into
+     */
+    void endBatch(const vk::CommandBuffer& commandBuffer);
+
+    /**
+     * Whether the transitions are being batched by an operation.
+     *
+     * @return Boolean stating whether a batch is being recorded
+     */
+    bool isBatching();
+
+    /**
+     * Records a command accessing images, which is deferred until the end of
+     * the batch when the tracker of the command buffer is batching, as its
+     * transitions are only recorded then.
+     *
+     * @param commandBuffer The command buffer being recorded
+     * @param command Function recording the command into the command buffer
+     */
+    static void recordCommand(
+      const vk::CommandBuffer& commandBuffer,
+      const std::function<void(const vk::CommandBuffer&)>& command);
+
+    /**
+     * Records the layout of an image after commands that transitioned it
+     * without going through the tracker.
+     *
+     * @param image The image that was transitioned
+     * @param layout The layout of the image after the commands
+     */
+    void track(Image& image, vk::ImageLayout layout);
+
+    /**
+     * Whether an image will not be in the layout the recording expects when
+     * submitted, in which case the commands have to be recorded again.
+     *
+     * @return Boolean stating whether the recording is stale
+     */
+    bool isStale();
+
+    /**
+     * Resets the recording layout of the images the stale recording expected
+     * in another layout to the layout they will be in when submitted, so the
+     * commands can be recorded again.
+     */
+    void restoreLayouts();
+
+    /**
+     * Marks the layouts of the images at the end of the recording as the ones
+     * they will be in once the submitted command buffer executes.
+     */
+    void submit();
+
+    /**
+     * Forgets the images and queued transitions when a new recording starts.
+     */
+    void reset();
+
+    /**
+     * The number of layout transitions recorded since the last reset.
+     *
+     * @return Number of image barriers recorded
+     */
+    uint32_t getTransitionCount();
+
+    /**
+     * The number of transitions skipped since the last reset because the
+     * images were already in the requested layout.
+     *
+     * @return Number of skipped transitions
+     */
+    uint32_t getSkippedTransitionCount();
+
+    /**
+     * The number of pipeline barriers recorded by the flushes since the last
+     * reset.
+     *
+     * @return Number of pipeline barriers
+     */
+    uint32_t getBarrierCount();
+
+    /**
+     * The capabilities of the queue family the command buffer is submitted
+     * to, which image operations such as kp::OpGenerateMipmaps check as blits
+     * are only supported by families with eGraphics.
+     *
+     * @return The flags of the queue family
+     */
+    vk::QueueFlags getQueueFlags();
+
+  private:
+    struct ImageState
+    {
+        vk::ImageLayout initialLayout;
+        vk::ImageLayout layout;
+    };
+
+    ImageState& getState(Image& image);
+
+    // -------------- NEVER OWNED RESOURCES
+    vk::CommandBuffer mCommandBuffer;
+    vk::QueueFlags mQueueFlags;
+
+    // -------------- ALWAYS OWNED RESOURCES
+    std::map<Image*, ImageState> mImages;
+    std::vector<vk::ImageMemoryBarrier> mPendingImageBarriers;
+    vk::AccessFlags mPendingSrcAccessMask;
+    vk::AccessFlags mPendingDstAccessMask;
+    vk::PipelineStageFlags mPendingSrcStageMask;
+    vk::PipelineStageFlags mPendingDstStageMask;
+    bool mBatching = false;
+    std::vector<std::function<void(const vk::CommandBuffer&)>>
+      mDeferredCommands;
+    uint32_t mTransitionCount = 0;
+    uint32_t mSkippedTransitionCount = 0;
+    uint32_t mBarrierCount = 0;
+};
+
+} // End namespace kp
@@ -1,20 +1,56 @@
 #pragma once
 
 #include "Algorithm.hpp"
+#include "Autotuner.hpp"
+#include "ConstantBlock.hpp"
 #include "Core.hpp"
+#include "DeviceGroup.hpp"
+#include "DeviceSelector.hpp"
+#include "Expr.hpp"
 #include "Image.hpp"
+#include "ImageLayoutTracker.hpp"
 #include "Manager.hpp"
+#include "MemoryBudget.hpp"
+#include "MemoryPlanner.hpp"
+#include "NumericTypes.hpp"
+#include "Profiler.hpp"
+#include "Sampler.hpp"
 #include "Sequence.hpp"
+#include "ShardedTensor.hpp"
+#include "ShaderReflection.hpp"
 #include "Tensor.hpp"
+#include "ThreadPool.hpp"
+
+#if KOMPUTE_OPT_USE_SHADERC
+#include "ShaderCompiler.hpp"
+#endif
 
 #include "operations/OpAlgoDispatch.hpp"
+#include "operations/OpAlgoDispatchIndirect.hpp"
 #include "operations/OpBase.hpp"
+#include "operations/OpCompact.hpp"
 #include "operations/OpCopy.hpp"
+#include "operations/OpCopyRegions.hpp"
+#include "operations/OpFill.hpp"
+#include "operations/OpFillRandom.hpp"
+#include "operations/OpGenerateMipmaps.hpp"
+#include "operations/OpMatMul.hpp"
 #include "operations/OpMemoryBarrier.hpp"
 #include "operations/OpMult.hpp"
+#include "operations/OpReduce.hpp"
+#include "operations/OpScan.hpp"
+#include "operations/OpSort.hpp"
 #include "operations/OpSyncDevice.hpp"
 #include "operations/OpSyncLocal.hpp"
 
 // Will be build by CMake and placed inside the build directory
 #include "ShaderLogisticRegression.hpp"
+#include "ShaderOpCompact.hpp"
+#include "ShaderOpFillRandom.hpp"
+#include "ShaderOpMatMul.hpp"
+#include "ShaderOpMatMulCoopMat.hpp"
 #include "ShaderOpMult.hpp"
+#include "ShaderOpReduce.hpp"
+#include "ShaderOpReduceSubgroup.hpp"
+#include "ShaderOpScan.hpp"
+#include "ShaderOpSort.hpp"
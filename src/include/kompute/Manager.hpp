@@ -2,8 +2,10 @@
 #pragma once
 
 #include "kompute/Core.hpp"
+#include "kompute/DeviceSelector.hpp"
 
 #include "kompute/Image.hpp"
+#include "kompute/MemoryBudget.hpp"
 #include "kompute/Sequence.hpp"
 #include "logger/Logger.hpp"
 
@@ -19,17 +21,29 @@ class Manager
   public:
     /**
         Base constructor and default used which creates the base resources
-       including choosing the device 0 by default.
+       including choosing the device with the default kp::DevicePolicy, which
+       prefers discrete GPUs with an async compute queue family.
     */
     Manager();
 
+    /**
+     * Constructor which selects the physical device and the compute queue
+     * family with the highest score against a policy, see kp::DeviceSelector.
+     *
+     * @param policy The requirements and preferences of the selection
+     * @param desiredExtensions (Optional) The desired extensions to load from
+     * physicalDevice, in addition to the ones required by the policy
+     */
+    Manager(const DevicePolicy& policy,
+            const std::vector<std::string>& desiredExtensions = {});
+
     /**
      * Similar to base constructor but allows for further configuration to use
      * when creating the Vulkan resources.
      *
      * @param physicalDeviceIndex The index of the physical device to use
      * @param familyQueueIndices (Optional) List of queue indices to add for
-     * explicit allocation
+     * explicit allocation, which defaults to the first compute queue family
      * @param desiredExtensions The desired extensions to load from
      * physicalDevice
      */
@@ -73,10 +87,14 @@ class Manager
      * @param queueIndex The queue to use from the available queues
      * @param nrOfTimestamps The maximum number of timestamps to allocate.
      * If zero (default), disables latching of timestamps.
+     * @param totalPipelineStatistics The maximum number of operations to
+     * capture pipeline statistics for. If zero (default), disables pipeline
+     * statistics queries.
      * @returns Shared pointer with initialised sequence
      */
     std::shared_ptr<Sequence> sequence(uint32_t queueIndex = 0,
-                                       uint32_t totalTimestamps = 0);
+                                       uint32_t totalTimestamps = 0,
+                                       uint32_t totalPipelineStatistics = 0);
 
     /**
      * Create a managed tensor that will be destroyed by this manager
@@ -96,9 +114,7 @@ class Manager
         std::shared_ptr<TensorT<T>> tensor{ new kp::TensorT<T>(
           this->mPhysicalDevice, this->mDevice, data, tensorType) };
 
-        if (this->mManageResources) {
-            this->mManagedMemObjects.push_back(tensor);
-        }
+        this->manageMemory(tensor);
 
         return tensor;
     }
@@ -121,12 +137,87 @@ class Manager
         std::shared_ptr<TensorT<T>> tensor{ new kp::TensorT<T>(
           this->mPhysicalDevice, this->mDevice, size, tensorType) };
 
-        if (this->mManageResources) {
-            this->mManagedMemObjects.push_back(tensor);
-        }
+        this->manageMemory(tensor);
 
         return tensor;
     }
+
+    /**
+     * Create a managed tensor whose elements are set to a value on the GPU
+     * with kp::OpFill, so no host data is built or uploaded. Tensors of type
+     * eStorage, which is the default, have no host memory at all, which suits
+     * large scratch tensors. The host data of other tensor types is only
+     * valid after an OpSyncLocal.
+     *
+     * @param size The number of element in this tensor
+     * @param value (optional) The value of the elements, zero by default
+     * @param tensorType The type of tensor to initialize
+     * @returns Shared pointer with initialised tensor
+     */
+    template<typename T>
+    std::shared_ptr<TensorT<T>> tensorFilledT(
+      size_t size,
+      double value = 0,
+      Memory::MemoryTypes tensorType = Memory::MemoryTypes::eStorage)
+    {
+        std::shared_ptr<TensorT<T>> tensor =
+          this->tensorT<T>(size, tensorType);
+        this->fill(tensor, value);
+        return tensor;
+    }
+
+    /**
+     * Create a managed float tensor whose elements are set to a value on the
+     * GPU with kp::OpFill, as in tensorFilledT.
+     *
+     * @param size The number of element in this tensor
+     * @param value (optional) The value of the elements, zero by default
+     * @param tensorType The type of tensor to initialize
+     * @returns Shared pointer with initialised tensor
+     */
+    std::shared_ptr<TensorT<float>> tensorFilled(
+      size_t size,
+      double value = 0,
+      Memory::MemoryTypes tensorType = Memory::MemoryTypes::eStorage)
+    {
+        return this->tensorFilledT<float>(size, value, tensorType);
+    }
+
+    /**
+     * Create a managed transient tensor, which is an intermediate tensor that
+     * only lives on the GPU. Its memory is not allocated on creation but by
+     * the first kp::Sequence evaluated with it, which places the transient
+     * tensors whose uses do not overlap in the recorded operations in the
+     * same memory. The memory belongs to that sequence, so the tensor can
+     * only be used while the sequence exists. Only tensors of type eStorage
+     * can be transient.
+     *
+     * @param size The number of element in this tensor
+     * @param tensorType The type of tensor to initialize
+     * @returns Shared pointer with initialised tensor
+     */
+    template<typename T>
+    std::shared_ptr<TensorT<T>> transientTensorT(
+      size_t size,
+      Memory::MemoryTypes tensorType = Memory::MemoryTypes::eStorage)
+    {
+        KP_LOG_DEBUG("Kompute Manager transient tensor creation triggered");
+
+        std::shared_ptr<TensorT<T>> tensor{ new kp::TensorT<T>(
+          this->mPhysicalDevice, this->mDevice, size, tensorType, true) };
+
+        this->manageMemory(tensor);
+
+        return tensor;
+    }
+
+    std::shared_ptr<TensorT<float>> transientTensor(
+      size_t size,
+      Memory::MemoryTypes tensorType = Memory::MemoryTypes::eStorage)
+    {
+        return this->transientTensorT<float>(size, tensorType);
+    }
+
     std::shared_ptr<TensorT<float>> tensor(
       const std::vector<float>& data,
       Memory::MemoryTypes tensorType = Memory::MemoryTypes::eDevice)
@@ -149,9 +240,7 @@ class Manager
                                                        dataType,
                                                        tensorType) };
 
-        if (this->mManageResources) {
-            this->mManagedMemObjects.push_back(tensor);
-        }
+        this->manageMemory(tensor);
 
         return tensor;
     }
@@ -169,10 +258,39 @@ class Manager
                                                        dataType,
                                                        tensorType) };
 
-        if (this->mManageResources) {
-            this->mManagedMemObjects.push_back(tensor);
-        }
+        this->manageMemory(tensor);
+
+        return tensor;
+    }
 
+    /**
+     * Create a managed tensor of a reduced precision type from floats, which
+     * are converted on upload with kp::Memory::setFloatData and can be read
+     * back with kp::Memory::floatVector.
+     *
+     * @param data The values to initialize the tensor with
+     * @param dataType The type of the tensor, such as eHalf, eBFloat16 or
+     * eQInt8
+     * @param tensorType The type of tensor to initialize
+     * @param scale (optional) The quantization scale of eQInt8 tensors
+     * @param zeroPoint (optional) The quantization zero point of eQInt8
+     * tensors
+     * @returns Shared pointer with initialised tensor
+     */
+    std::shared_ptr<Tensor> tensor(
+      const std::vector<float>& data,
+      const Memory::DataTypes& dataType,
+      Memory::MemoryTypes tensorType = Memory::MemoryTypes::eDevice,
+      float scale = 1.0f,
+      int32_t zeroPoint = 0)
+    {
+        std::shared_ptr<Tensor> tensor =
+          this->tensor(data.size(),
+                       Memory::dataTypeMemorySize(dataType),
+                       dataType,
+                       tensorType);
+        tensor->setQuantization(scale, zeroPoint);
+        tensor->setFloatData(data);
         return tensor;
     }
 
@@ -205,9 +323,7 @@ class Manager
           tiling,
           imageType) };
 
-        if (this->mManageResources) {
-            this->mManagedMemObjects.push_back(image);
-        }
+        this->manageMemory(image);
 
         return image;
     }
@@ -231,9 +347,7 @@ class Manager
           numChannels,
           imageType) };
 
-        if (this->mManageResources) {
-            this->mManagedMemObjects.push_back(image);
-        }
+        this->manageMemory(image);
 
         return image;
     }
@@ -257,9 +371,7 @@ class Manager
           tiling,
           imageType) };
 
-        if (this->mManageResources) {
-            this->mManagedMemObjects.push_back(image);
-        }
+        this->manageMemory(image);
 
         return image;
     }
@@ -281,12 +393,78 @@ class Manager
           numChannels,
           imageType) };
 
-        if (this->mManageResources) {
-            this->mManagedMemObjects.push_back(image);
-        }
+        this->manageMemory(image);
+
+        return image;
+    }
+    /**
+     * Create a managed 3D image, image array or image with mip levels that
+     * will be destroyed by this manager if it hasn't been destroyed by its
+     * reference count going to zero.
+     *
+     * @param data The data to initialize the first mip level with, which can
+     * be empty
+     * @param width The width of the image
+     * @param height The height of the image
+     * @param numChannels The number of channels of the image
+     * @param dimensions The depth, layers and mip levels of the image
+     * @param imageType The memory type of the image, eDevice or eStorage
+     * @returns Shared pointer with initialised image
+     */
+    template<typename T>
+    std::shared_ptr<ImageT<T>> imageT(
+      const std::vector<T>& data,
+      uint32_t width,
+      uint32_t height,
+      uint32_t numChannels,
+      const Image::Dimensions& dimensions,
+      Memory::MemoryTypes imageType = Memory::MemoryTypes::eDevice)
+    {
+        KP_LOG_DEBUG("Kompute Manager image creation triggered");
+
+        std::shared_ptr<ImageT<T>> image{ new kp::ImageT<T>(
+          this->mPhysicalDevice,
+          this->mDevice,
+          data,
+          width,
+          height,
+          numChannels,
+          dimensions,
+          imageType) };
+
+        this->manageMemory(image);
 
         return image;
     }
+
+    template<typename T>
+    std::shared_ptr<ImageT<T>> imageT(
+      uint32_t width,
+      uint32_t height,
+      uint32_t numChannels,
+      const Image::Dimensions& dimensions,
+      Memory::MemoryTypes imageType = Memory::MemoryTypes::eDevice)
+    {
+        return this->imageT<T>(std::vector<T>(),
+                               width,
+                               height,
+                               numChannels,
+                               dimensions,
+                               imageType);
+    }
+
+    std::shared_ptr<ImageT<float>> image(
+      const std::vector<float>& data,
+      uint32_t width,
+      uint32_t height,
+      uint32_t numChannels,
+      const Image::Dimensions& dimensions,
+      Memory::MemoryTypes imageType = Memory::MemoryTypes::eDevice)
+    {
+        return this->imageT<float>(
+          data, width, height, numChannels, dimensions, imageType);
+    }
+
     std::shared_ptr<ImageT<float>> image(
       const std::vector<float>& data,
       uint32_t width,
@@ -350,9 +528,7 @@ class Manager
                                                     tiling,
                                                     imageType) };
 
-        if (this->mManageResources) {
-            this->mManagedMemObjects.push_back(image);
-        }
+        this->manageMemory(image);
 
         return image;
     }
@@ -376,9 +552,7 @@ class Manager
                                                     dataType,
                                                     imageType) };
 
-        if (this->mManageResources) {
-            this->mManagedMemObjects.push_back(image);
-        }
+        this->manageMemory(image);
 
         return image;
     }
@@ -400,9 +574,7 @@ class Manager
                                                     tiling,
                                                     imageType) };
 
-        if (this->mManageResources) {
-            this->mManagedMemObjects.push_back(image);
-        }
+        this->manageMemory(image);
 
         return image;
     }
@@ -422,11 +594,43 @@ class Manager
                                                     dataType,
                                                     imageType) };
 
+        this->manageMemory(image);
+
+        return image;
+    }
+
+    /**
+     * Create a managed sampler that will be destroyed by this manager if it
+     * hasn't been destroyed by its reference count going to zero. Samplers are
+     * bound with images through Image::setDescriptorType.
+     *
+     * @param filter Filter used for both magnification and minification
+     * @param addressMode Addressing of the coordinates outside of the image
+     * @param normalizedCoordinates Whether the coordinates are in [0, 1]
+     * rather than in texels
+     * @param borderColor Color returned outside of the image with the
+     * eClampToBorder address mode
+     * @returns Shared pointer with initialised sampler
+     */
+    std::shared_ptr<Sampler> sampler(
+      vk::Filter filter = vk::Filter::eLinear,
+      vk::SamplerAddressMode addressMode = vk::SamplerAddressMode::eClampToEdge,
+      bool normalizedCoordinates = true,
+      vk::BorderColor borderColor = vk::BorderColor::eFloatTransparentBlack)
+    {
+        KP_LOG_DEBUG("Kompute Manager sampler creation triggered");
+
+        std::shared_ptr<Sampler> sampler{ new kp::Sampler(this->mDevice,
+                                                          filter,
+                                                          addressMode,
+                                                          normalizedCoordinates,
+                                                          borderColor) };
+
         if (this->mManageResources) {
-            this->mManagedMemObjects.push_back(image);
+            this->mManagedSamplers.push_back(sampler);
         }
 
-        return image;
+        return sampler;
     }
 
     /**
@@ -438,7 +642,7 @@ class Manager
      * with
      * @param spirv (optional) The SPIRV bytes for the algorithm to dispatch
      * @param workgroup (optional) kp::Workgroup for algorithm to use, and
-     * defaults to (tensor[0].size(), 1, 1)
+     * defaults to (tensor[0].size() / localSizeX, 1, 1)
      * @param specializationConstants (optional) float vector to use for
      * specialization constants, and defaults to an empty constant
      * @param pushConstants (optional) float vector to use for push constants,
@@ -464,7 +668,7 @@ class Manager
      * with
      * @param spirv (optional) The SPIRV bytes for the algorithm to dispatch
      * @param workgroup (optional) kp::Workgroup for algorithm to use, and
-     * defaults to (tensor[0].size(), 1, 1)
+     * defaults to (tensor[0].size() / localSizeX, 1, 1)
      * @param specializationConstants (optional) templatable vector parameter to
      * use for specialization constants, and defaults to an empty constant
      * @param pushConstants (optional) templatable vector parameter to use for
@@ -497,6 +701,50 @@ class Manager
         return algorithm;
     }
 
+    /**
+     * Create a managed algorithm that returns straight away, while its
+     * pipeline is compiled in the background on the thread pool of the
+     * manager. Recording the algorithm waits for the pipeline if it is not
+     * ready yet, so creating many algorithms upfront scales with the number
+     * of cores available.
+     *
+     * @param memObjects The mem objects to initialise the algorithm with
+     * @param spirv The SPIRV bytes for the algorithm to dispatch
+     * @param workgroup (optional) kp::Workgroup for algorithm to use, and
+     * defaults to (tensor[0].size() / localSizeX, 1, 1)
+     * @param specializationConstants (optional) templatable vector parameter to
+     * use for specialization constants, and defaults to an empty constant
+     * @param pushConstants (optional) templatable vector parameter to use for
+     * push constants, and defaults to an empty constant
+     * @returns Shared pointer with the algorithm being initialised
+     */
+    template<typename S = float, typename P = float>
+    std::shared_ptr<Algorithm> algorithmAsync(
+      const std::vector<std::shared_ptr<Memory>>& memObjects,
+      const std::vector<uint32_t>& spirv,
+      const Workgroup& workgroup = {},
+      const std::vector<S>& specializationConstants = {},
+      const std::vector<P>& pushConstants = {})
+    {
+        KP_LOG_DEBUG("Kompute Manager async algorithm creation triggered");
+
+        std::shared_ptr<Algorithm> algorithm{ new kp::Algorithm(
+          this->mDevice) };
+
+        algorithm->rebuildAsync(this->getThreadPool(),
+                                memObjects,
+                                spirv,
+                                workgroup,
+                                specializationConstants,
+                                pushConstants);
+
+        if (this->mManageResources) {
+            this->mManagedAlgorithms.push_back(algorithm);
+        }
+
+        return algorithm;
+    }
+
     /**
      * Destroy the GPU resources and all managed resources by manager.
      **/
@@ -515,6 +763,59 @@ class Manager
      **/
     vk::PhysicalDeviceProperties getDeviceProperties() const;
 
+    /**
+     * Universally unique identifier of the current device, which stays the
+     * same across instances and processes.
+     *
+     * @return array with the UUID bytes of the device
+     **/
+    std::array<uint8_t, VK_UUID_SIZE> getDeviceUUID() const;
+
+    /**
+     * Support for 16-bit and 8-bit types in shaders, which is enabled when
+     * the manager is created with the VK_KHR_shader_float16_int8,
+     * VK_KHR_16bit_storage and VK_KHR_8bit_storage extensions.
+     */
+    struct ShaderTypeFeatures
+    {
+        bool shaderFloat16 = false;
+        bool shaderInt8 = false;
+        bool storageBuffer16BitAccess = false;
+        bool storageBuffer8BitAccess = false;
+    };
+
+    /**
+     * The 16-bit and 8-bit type features enabled on the device, which shaders
+     * reading kp::Half, kp::BFloat16 or kp::QInt8 tensors as their native
+     * types rely on.
+     *
+     * @return ShaderTypeFeatures with the features enabled
+     **/
+    ShaderTypeFeatures getShaderTypeFeatures() const;
+
+    /**
+     * Subgroup capabilities of the current device, which are used to select
+     * the subgroup variants of the built-in operations.
+     *
+     * @return vk::PhysicalDeviceSubgroupProperties with the subgroup size and
+     * the supported stages and operations
+     **/
+    vk::PhysicalDeviceSubgroupProperties getSubgroupProperties() const;
+
+#ifdef VK_KHR_cooperative_matrix
+    /**
+     * Matrix sizes and component types supported by cooperative matrices,
+     * which are only enabled when the manager is created with the
+     * VK_KHR_cooperative_matrix, VK_KHR_vulkan_memory_model,
+     * VK_KHR_shader_float16_int8 and VK_KHR_16bit_storage extensions.
+     *
+     * @return vector of supported configurations, which is empty when
+     * cooperative matrices are not enabled on the device
+     **/
+    std::vector<vk::CooperativeMatrixPropertiesKHR>
+    getCooperativeMatrixProperties() const;
+#endif // VK_KHR_cooperative_matrix
+
     /**
      * List the devices available in the current vulkan instance.
      *
@@ -530,6 +831,28 @@ class Manager
      **/
     std::shared_ptr<vk::Instance> getVkInstance() const;
 
+    /**
+     * List the hardware performance counters exposed through
+     * VK_KHR_performance_query for the queue family of the given queue.
+     *
+     * @param queueIndex The queue to list the counters for
+     * @return pair of vectors with the counters and their descriptions, which
+     * are empty if the extension is not supported by the device
+     **/
+    std::pair<std::vector<vk::PerformanceCounterKHR>,
+              std::vector<vk::PerformanceCounterDescriptionKHR>>
+    listPerformanceCounters(uint32_t queueIndex = 0) const;
+
+    /**
+     * The memory budget of the device, which tracks the usage of its memory
+     * heaps against the budget reported by VK_EXT_memory_budget, enabled
+     * when the device supports it. Soft limits and the eviction of the least
+     * recently used eDevice tensors are configured through it.
+     *
+     * @return Shared pointer to the memory budget
+     **/
+    std::shared_ptr<MemoryBudget> getMemoryBudget() const;
+
   private:
     // -------------- OPTIONALLY OWNED RESOURCES
     std::shared_ptr<vk::Instance> mInstance = nullptr;
@@ -542,11 +865,17 @@ class Manager
     std::vector<std::weak_ptr<Memory>> mManagedMemObjects;
     std::vector<std::weak_ptr<Sequence>> mManagedSequences;
     std::vector<std::weak_ptr<Algorithm>> mManagedAlgorithms;
+    std::vector<std::weak_ptr<Sampler>> mManagedSamplers;
+    std::unique_ptr<ThreadPool> mThreadPool = nullptr;
+    std::shared_ptr<MemoryBudget> mMemoryBudget = nullptr;
 
     std::vector<uint32_t> mComputeQueueFamilyIndices;
     std::vector<std::shared_ptr<vk::Queue>> mComputeQueues;
 
     bool mManageResources = false;
+    ShaderTypeFeatures mShaderTypeFeatures;
+    bool mCooperativeMatrixEnabled = false;
+    bool mMemoryBudgetEnabled = false;
 
 #ifndef KOMPUTE_DISABLE_VK_DEBUG_LAYERS
     vk::DebugReportCallbackEXT mDebugReportCallback;
@@ -557,11 +886,23 @@ class Manager
 #endif // VK_VERSION_1_4
 #endif // KOMPUTE_DISABLE_VK_DEBUG_LAYERS
 
+    // Lazily creates the pool used to compile pipelines asynchronously
+    ThreadPool& getThreadPool();
+
+    // Sets the elements of a memory object on the GPU and waits for it
+    void fill(std::shared_ptr<Memory> memory, double value);
+
+    // Registers a created memory object to be destroyed with the manager and
+    // tracked by the memory budget, which checks the soft limit
+    void manageMemory(std::shared_ptr<Memory> memory);
+
     // Create functions
     void createInstance();
     void createDevice(const std::vector<uint32_t>& familyQueueIndices = {},
                       uint32_t hysicalDeviceIndex = 0,
-                      const std::vector<std::string>& desiredExtensions = {});
+                      const std::vector<std::string>& desiredExtensions = {},
+                      const DevicePolicy& policy = DevicePolicy());
+    void createMemoryBudget();
 };
 
 } // End namespace kp
@@ -2,9 +2,11 @@
 #pragma once
 
 #include "kompute/Core.hpp"
+#include "kompute/NumericTypes.hpp"
 #include "logger/Logger.hpp"
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace kp {
 
@@ -44,7 +46,10 @@ class Memory
         eShort = 6,
         eUnsignedShort = 7,
         eChar = 8,
-        eUnsignedChar = 9
+        eUnsignedChar = 9,
+        eHalf = 10,     ///< kp::Half, IEEE 754 half precision float
+        eBFloat16 = 11, ///< kp::BFloat16, upper 16 bits of a float
+        eQInt8 = 12     ///< kp::QInt8, int8 with a scale and zero point
     };
 
     enum class Type
@@ -264,6 +269,10 @@ class Memory
     template<typename T>
     T* data()
     {
+        // The data can be modified through the pointer
+        this->resolveHostDataDependents();
+        this->resolveHostData();
+
         if (this->mRawData == nullptr) {
             this->mapRawData();
         }
@@ -281,6 +290,8 @@ class Memory
     template<typename T>
     std::vector<T> vector()
     {
+        this->resolveHostData();
+
         if (this->mRawData == nullptr) {
             this->mapRawData();
         }
@@ -288,6 +299,107 @@ class Memory
         return { (T*)this->mRawData, ((T*)this->mRawData) + this->size() };
     }
 
+    /**
+     * Defers the copy of the host data of another memory object into the host
+     * data of this one, such as after a copy on the GPU, so the host memcpy
+     * only happens if the data is accessed with data(), vector() or rawData().
+     * The host data of the source is the one it has when this function is
+     * called, as any later change to it first resolves the deferred copies.
+     *
+     * @param source Memory object of the same size whose host data is copied
+     */
+    void deferHostDataCopy(std::shared_ptr<Memory> source);
+
+    /**
+     * Whether the host data is stale and is copied from another memory object
+     * on access, see deferHostDataCopy.
+     *
+     * @return Boolean stating whether a host data copy is pending
+     */
+    bool hasDeferredHostData();
+
+    /**
+     * Performs the pending host data copy into this memory object, if any.
+     * This is done by the accessors of the data, and by kp::OpSyncDevice
+     * before uploading the host data.
+     */
+    void resolveHostData();
+
+    /**
+     * Performs the pending host data copies from this memory object into
+     * others, which is required before its host data is modified, such as by
+     * kp::OpSyncLocal.
+     */
+    void resolveHostDataDependents();
+
+    /**
+     * Drops the pending host data copy into this memory object, if any,
+     * which is used when the host data is about to be overwritten.
+     */
+    void discardDeferredHostData();
+
+    /**
+     * Whether the device memory may hold data newer than the staging memory,
+     * which is the case once an operation other than kp::OpSyncDevice and
+     * kp::OpSyncLocal used the memory object, until it is synced or its data
+     * is set from the host. kp::MemoryBudget only copies the device data of a
+     * tensor to its staging memory before evicting it in that case.
+     *
+     * @return Boolean stating whether the device data may be newer
+     */
+    bool isDeviceDataNewer();
+
+    /**
+     * Sets whether the device memory may hold data newer than the staging
+     * memory, which kp::Sequence does for the memory objects of the
+     * operations it evaluates, and the sync operations reset.
+     *
+     * @param newer Whether the device data may be newer
+     */
+    void setDeviceDataNewer(bool newer);
+
+    /**
+     * Sets the affine mapping of quantized values to floats, where
+     * value = scale * (quantized - zeroPoint), which is used to convert the
+     * data of kp::Memory::DataTypes::eQInt8 memory objects.
+     *
+     * @param scale The step between consecutive quantized values
+     * @param zeroPoint The quantized value representing zero
+     */
+    void setQuantization(float scale, int32_t zeroPoint);
+
+    /**
+     * The scale of the quantized values, see setQuantization.
+     *
+     * @return The scale, which is 1 unless set
+     */
+    float quantizationScale();
+
+    /**
+     * The zero point of the quantized values, see setQuantization.
+     *
+     * @return The zero point, which is 0 unless set
+     */
+    int32_t quantizationZeroPoint();
+
+    /**
+     * Sets the data from floats, which are converted to the data type of the
+     * memory object: rounded for eHalf and eBFloat16, and quantized with the
+     * scale and zero point for eQInt8. This is mainly used to upload data
+     * in a reduced precision so shaders read less memory.
+     *
+     * @param data The values, one per element of the memory object
+     */
+    void setFloatData(const std::vector<float>& data);
+
+    /**
+     * Gets the data converted to floats, which is the reverse of
+     * setFloatData and is supported for eFloat, eHalf, eBFloat16 and eQInt8.
+     *
+     * @return Vector with one float per element
+     */
+    std::vector<float> floatVector();
+
     /***
      * Retreive the size of the x-dimension of the memory
      *
@@ -318,12 +430,20 @@ class Memory
     void* mRawData = nullptr;
     vk::DescriptorType mDescriptorType;
     bool mUnmapMemory = false;
+    bool mDeviceDataNewer = false;
     uint32_t mX;
     uint32_t mY;
+    float mQuantizationScale = 1.0f;
+    int32_t mQuantizationZeroPoint = 0;
 
     // -------------- NEVER OWNED RESOURCES
     std::shared_ptr<vk::PhysicalDevice> mPhysicalDevice;
     std::shared_ptr<vk::Device> mDevice;
+    // Memory object whose host data is copied on access, see
+    // deferHostDataCopy, and the memory objects doing so from this one, which
+    // remove themselves when the copy is resolved or discarded
+    std::shared_ptr<Memory> mHostDataSource;
+    std::vector<Memory*> mHostDataDependents;
 
     // -------------- OPTIONALLY OWNED RESOURCES
     std::shared_ptr<vk::DeviceMemory> mPrimaryMemory;
@@ -332,6 +452,7 @@ class Memory
     bool mFreeStagingMemory = false;
 
     // Private util functions
+    bool hasHostVisibleMemory();
     void mapRawData();
     void unmapRawData();
     void updateRawData(void* data);
@@ -407,4 +528,25 @@ Memory::dataType<double>()
     return DataTypes::eDouble;
 }
 
+template<>
+constexpr Memory::DataTypes
+Memory::dataType<Half>()
+{
+    return DataTypes::eHalf;
+}
+
+template<>
+constexpr Memory::DataTypes
+Memory::dataType<BFloat16>()
+{
+    return DataTypes::eBFloat16;
+}
+
+template<>
+constexpr Memory::DataTypes
+Memory::dataType<QInt8>()
+{
+    return DataTypes::eQInt8;
+}
+
 } // End namespace kp
@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "kompute/Core.hpp"
+#include "kompute/Memory.hpp"
+#include "kompute/Sequence.hpp"
+#include "kompute/Tensor.hpp"
+#include "logger/Logger.hpp"
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace kp {
+
+/**
+ * Tracks the usage of the memory heaps of the device against the budget
+ * reported by VK_EXT_memory_budget, which the kp::Manager enables when the
+ * device supports it. The budget accounts for the memory used by the other
+ * processes on the GPU, so a soft limit below it lets a process stay within
+ * its share. When a heap goes over the soft limit a callback is invoked and,
+ * if eviction is enabled, the device memory of the least recently used
+ * eDevice tensors is freed, keeping their data in their staging memory until
+ * a kp::Sequence uses them again.
+ */
+class MemoryBudget
+{
+  public:
+    /**
+     * Usage and budget of a memory heap of the device, in bytes.
+     */
+    struct Heap
+    {
+        uint32_t index = 0;
+        vk::MemoryHeapFlags flags;
+        vk::DeviceSize size = 0;
+        vk::DeviceSize budget = 0;
+        vk::DeviceSize usage = 0;
+    };
+
+    typedef std::function<void(const Heap&)> Callback;
+
+    /**
+     * Constructor with the device whose heaps are tracked.
+     *
+     * @param physicalDevice The physical device to query the heaps from
+     * @param device The device the memory objects are allocated from
+     * @param extensionEnabled Whether VK_EXT_memory_budget is enabled on the
+     * device, without which the budget of a heap is its size and the usage
+     * of the largest device local heap is the memory tracked by this object
+     * @param sequence The sequence to copy the data of the evicted tensors
+     * with, without which eviction is not available
+     */
+    MemoryBudget(std::shared_ptr<vk::PhysicalDevice> physicalDevice,
+                 std::shared_ptr<vk::Device> device,
+                 bool extensionEnabled,
+                 std::shared_ptr<Sequence> sequence = nullptr);
+
+    /**
+     * @brief Make MemoryBudget uncopyable
+     *
+     */
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget(const MemoryBudget&&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&&) = delete;
+
+    /**
+     * The usage and budget of each memory heap of the device.
+     *
+     * @return Vector with the heaps in the order of their index
+     */
+    std::vector<Heap> getHeaps() const;
+
+    /**
+     * Whether the usage and budget are reported by VK_EXT_memory_budget.
+     *
+     * @return Boolean stating whether the extension is enabled
+     */
+    bool isExtensionEnabled() const;
+
+    /**
+     * Sets the soft limit of the device local heaps as a fraction of their
+     * budget. The limit is checked when memory objects are created and when
+     * sequences are evaluated.
+     *
+     * @param fraction The fraction of the budget, 1 by default
+     * @param callback (optional) Function called with each heap over the
+     * limit when it is checked
+     */
+    void setSoftLimit(double fraction, const Callback& callback = nullptr);
+
+    /**
+     * Enables the eviction of the least recently used eDevice tensors when a
+     * device local heap is over the soft limit. The device data of an evicted
+     * tensor replaces its host data, and it is uploaded again when a sequence
+     * records an operation using the tensor. Evicting waits for the device to
+     * be idle, so sequences running asynchronously are never affected.
+     *
+     * @param enabled Whether eviction is enabled, which it is not by default
+     */
+    void setEvictionEnabled(bool enabled);
+
+    /**
+     * Tracks a memory object created by the kp::Manager, whose device memory
+     * counts as used and which can be evicted if it is an eDevice tensor.
+     *
+     * @param memory The memory object to track
+     */
+    void track(std::shared_ptr<Memory> memory);
+
+    /**
+     * Marks memory objects as used, restoring the evicted tensors among them
+     * so they can be recorded.
+     *
+     * @param memObjects The memory objects used
+     */
+    void use(const std::vector<std::shared_ptr<Memory>>& memObjects);
+
+    /**
+     * Checks the soft limit of the device local heaps, invoking the callback
+     * for the heaps over it and evicting tensors until they are under it.
+     *
+     * @param memObjects The memory objects in use, which are not evicted
+     */
+    void enforce(const std::vector<std::shared_ptr<Memory>>& memObjects = {});
+
+    /**
+     * The device memory of the tracked memory objects, in bytes.
+     *
+     * @return The size of the device memory allocated by Kompute
+     */
+    vk::DeviceSize getAllocatedSize() const;
+
+    /**
+     * The number of tensors evicted, which sequences use to know their
+     * recordings reference freed buffers.
+     *
+     * @return The number of evictions
+     */
+    uint64_t getEvictionCount() const;
+
+    /**
+     * The number of evicted tensors restored.
+     *
+     * @return The number of restorations
+     */
+    uint64_t getRestoreCount() const;
+
+    /**
+     * Whether any of the tracked tensors is currently evicted.
+     *
+     * @return Boolean stating whether a tensor is evicted
+     */
+    bool hasEvictedTensors() const;
+
+  private:
+    struct Entry
+    {
+        std::weak_ptr<Memory> memory;
+        uint64_t lastUse = 0;
+    };
+
+    // -------------- NEVER OWNED RESOURCES
+    std::shared_ptr<vk::PhysicalDevice> mPhysicalDevice;
+    std::shared_ptr<vk::Device> mDevice;
+    std::shared_ptr<Sequence> mSequence;
+
+    // -------------- ALWAYS OWNED RESOURCES
+    std::map<const Memory*, Entry> mEntries;
+    bool mExtensionEnabled = false;
+    double mSoftLimit = 1.0;
+    Callback mCallback;
+    bool mEvictionEnabled = false;
+    uint64_t mTick = 0;
+    uint64_t mEvictionCount = 0;
+    uint64_t mRestoreCount = 0;
+
+    // Evicts the least recently used tensor not in use, if any
+    bool evictLeastRecentlyUsed(
+      const std::vector<std::shared_ptr<Memory>>& memObjects);
+};
+
+} // End namespace kp
@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "kompute/Core.hpp"
+#include "kompute/Tensor.hpp"
+#include "kompute/operations/OpBase.hpp"
+#include "logger/Logger.hpp"
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace kp {
+
+/**
+ * Places the transient tensors used by the operations of a kp::Sequence in
+ * shared memory blocks. The lifetime of each tensor spans from the first to
+ * the last operation using it, and tensors whose lifetimes do not overlap
+ * are placed at overlapping offsets of the same block, largest first, as
+ * done by the memory planners of graph compilers. When an operation uses a
+ * tensor whose memory was last used by another tensor, a memory barrier is
+ * recorded so the accesses to the memory are ordered.
+ */
+class MemoryPlanner
+{
+  public:
+    /**
+     * Constructor with the device the memory blocks are allocated from.
+     *
+     * @param physicalDevice The physical device to find the memory type with
+     * @param device The device to allocate the memory blocks from
+     */
+    MemoryPlanner(std::shared_ptr<vk::PhysicalDevice> physicalDevice,
+                  std::shared_ptr<vk::Device> device);
+
+    /**
+     * @brief Make MemoryPlanner uncopyable
+     *
+     */
+    MemoryPlanner(const MemoryPlanner&) = delete;
+    MemoryPlanner(const MemoryPlanner&&) = delete;
+    MemoryPlanner& operator=(const MemoryPlanner&) = delete;
+    MemoryPlanner& operator=(const MemoryPlanner&&) = delete;
+
+    /**
+     * Destructor which frees the memory blocks, after which the transient
+     * tensors placed in them cannot be used.
+     */
+    ~MemoryPlanner();
+
+    /**
+     * Whether an operation uses transient tensors without memory, in which
+     * case it can only be recorded after plan().
+     *
+     * @param op The operation to check
+     * @return Boolean stating whether the operation needs a plan
+     */
+    static bool needsPlan(const OpBase& op);
+
+    /**
+     * Computes the lifetimes of the transient tensors without memory used by
+     * the operations, in the order they are given, and binds them to a new
+     * memory block. Throws if there are such tensors and one of the
+     * operations does not report its memory objects.
+     *
+     * @param operations The operations of the sequence in recording order
+     */
+    void plan(const std::vector<std::shared_ptr<OpBase>>& operations);
+
+    /**
+     * Records a memory barrier before an operation when it uses a transient
+     * tensor whose memory was used by another tensor since the last reset().
+     * Throws if tensors were placed and the operation does not report its
+     * memory objects.
+     *
+     * @param commandBuffer The command buffer being recorded
+     * @param op The operation about to be recorded
+     */
+    void recordAliasBarrier(const vk::CommandBuffer& commandBuffer,
+                            const OpBase& op);
+
+    /**
+     * Forgets the tensors used by the recording, which is called when the
+     * command buffer starts recording.
+     */
+    void reset();
+
+    /**
+     * Size of the memory blocks allocated for the transient tensors.
+     *
+     * @return The size in bytes
+     */
+    vk::DeviceSize getMemorySize() const;
+
+    /**
+     * Size the transient tensors would take without sharing memory, which
+     * can be compared with getMemorySize().
+     *
+     * @return The size in bytes
+     */
+    vk::DeviceSize getTensorsMemorySize() const;
+
+    /**
+     * Number of transient tensors placed by the planner.
+     *
+     * @return The number of tensors
+     */
+    uint32_t getTensorCount() const;
+
+    /**
+     * Frees the memory blocks.
+     */
+    void destroy();
+
+  private:
+    struct Placement
+    {
+        std::weak_ptr<Tensor> tensor;
+        vk::DeviceMemory memory;
+        vk::DeviceSize offset;
+        vk::DeviceSize size;
+    };
+
+    // -------------- NEVER OWNED RESOURCES
+    std::shared_ptr<vk::PhysicalDevice> mPhysicalDevice;
+    std::shared_ptr<vk::Device> mDevice;
+
+    // -------------- ALWAYS OWNED RESOURCES
+    std::vector<std::shared_ptr<vk::DeviceMemory>> mMemoryBlocks;
+    std::map<const Tensor*, Placement> mPlacements;
+    // Tensors whose contents are live in the current recording
+    std::vector<const Tensor*> mLiveTensors;
+    vk::DeviceSize mMemorySize = 0;
+    vk::DeviceSize mTensorsMemorySize = 0;
+
+    std::shared_ptr<vk::DeviceMemory> allocateMemory(vk::DeviceSize size,
+                                                     uint32_t memoryTypeBits);
+};
+
+} // End namespace kp
@@ -0,0 +1,207 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace kp {
+
+/**
+ * Converts a float to the bits of an IEEE 754 half, rounding to the nearest
+ * even value. Values too large for a half become infinities and NaNs are
+ * kept as quiet NaNs.
+ *
+ * @param value The float to convert
+ * @return The bits of the half
+ */
+inline uint16_t
+floatToHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t exponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (exponent == 0xFF) {
+        return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+    }
+
+    int32_t halfExponent = int32_t(exponent) - 127 + 15;
+    if (halfExponent >= 0x1F) {
+        return sign | 0x7C00;
+    }
+
+    uint32_t half;
+    uint32_t remainder;
+    uint32_t halfway;
+    if (halfExponent <= 0) {
+        // Subnormal halves, where the implicit bit becomes explicit
+        if (halfExponent < -10) {
+            return sign;
+        }
+        mantissa |= 0x800000;
+        uint32_t shift = 14 - halfExponent;
+        half = mantissa >> shift;
+        remainder = mantissa & ((1u << shift) - 1);
+        halfway = 1u << (shift - 1);
+    } else {
+        half = (uint32_t(halfExponent) << 10) | (mantissa >> 13);
+        remainder = mantissa & 0x1FFF;
+        halfway = 0x1000;
+    }
+
+    // A carry out of the mantissa correctly increments the exponent
+    if (remainder > halfway || (remainder == halfway && (half & 1))) {
+        half++;
+    }
+    return sign | half;
+}
+
+/**
+ * Converts the bits of an IEEE 754 half to a float, which is exact.
+ *
+ * @param half The bits of the half
+ * @return The float value
+ */
+inline float
+halfToFloat(uint16_t half)
+{
+    uint32_t sign = uint32_t(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1F;
+    uint32_t mantissa = half & 0x3FF;
+
+    uint32_t bits;
+    if (exponent == 0x1F) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        bits = sign;
+    } else {
+        // Subnormal halves are normal floats
+        exponent = 127 - 15 + 1;
+        while (!(mantissa & 0x400)) {
+            mantissa <<= 1;
+            exponent--;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+    }
+
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * Converts a float to the bits of a bfloat16, which keeps the exponent range
+ * of floats with 8 bits of precision, rounding to the nearest even value.
+ *
+ * @param value The float to convert
+ * @return The bits of the bfloat16
+ */
+inline uint16_t
+floatToBFloat16(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    if ((bits & 0x7FFFFFFF) > 0x7F800000) {
+        return uint16_t((bits >> 16) | 0x40);
+    }
+    bits += 0x7FFF + ((bits >> 16) & 1);
+    return uint16_t(bits >> 16);
+}
+
+/**
+ * Converts the bits of a bfloat16 to a float, which is exact.
+ *
+ * @param bfloat16 The bits of the bfloat16
+ * @return The float value
+ */
+inline float
+bfloat16ToFloat(uint16_t bfloat16)
+{
+    uint32_t bits = uint32_t(bfloat16) << 16;
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * Quantizes a float to an int8 with an affine mapping, where
+ * value = scale * (quantized - zeroPoint), saturating to the int8 range.
+ *
+ * @param value The float to quantize
+ * @param scale The step between consecutive quantized values
+ * @param zeroPoint The quantized value representing zero
+ * @return The quantized value
+ */
+inline int8_t
+quantizeInt8(float value, float scale, int32_t zeroPoint)
+{
+    float quantized = std::nearbyint(value / scale) + float(zeroPoint);
+    quantized = std::fmax(-128.0f, std::fmin(127.0f, quantized));
+    return int8_t(quantized);
+}
+
+/**
+ * Dequantizes an int8 with an affine mapping, see kp::quantizeInt8.
+ *
+ * @param quantized The quantized value
+ * @param scale The step between consecutive quantized values
+ * @param zeroPoint The quantized value representing zero
+ * @return The float value
+ */
+inline float
+dequantizeInt8(int8_t quantized, float scale, int32_t zeroPoint)
+{
+    return scale * float(int32_t(quantized) - zeroPoint);
+}
+
+/**
+ * Half precision float stored as its IEEE 754 bits, which is the element type
+ * of tensors of kp::Memory::DataTypes::eHalf. It converts to and from float
+ * so vectors of halves can be built from float values.
+ */
+struct Half
+{
+    uint16_t bits = 0;
+
+    Half() = default;
+    Half(float value)
+      : bits(floatToHalf(value))
+    {
+    }
+    operator float() const { return halfToFloat(this->bits); }
+};
+
+/**
+ * Brain float stored as the upper 16 bits of a float, which is the element
+ * type of tensors of kp::Memory::DataTypes::eBFloat16.
+ */
+struct BFloat16
+{
+    uint16_t bits = 0;
+
+    BFloat16() = default;
+    BFloat16(float value)
+      : bits(floatToBFloat16(value))
+    {
+    }
+    operator float() const { return bfloat16ToFloat(this->bits); }
+};
+
+/**
+ * Quantized int8 value, which is the element type of tensors of
+ * kp::Memory::DataTypes::eQInt8. The scale and zero point mapping it to a
+ * float are stored on the tensor, see kp::Memory::setQuantization.
+ */
+struct QInt8
+{
+    int8_t value = 0;
+};
+
+} // End namespace kp
@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace kp {
+
+/**
+ * Collects the CPU and GPU timings of the sequences it is attached to through
+ * Sequence::setProfiler. CPU spans are captured for record, submit and await
+ * calls, and if the sequence was created with timestamps enabled the latched
+ * GPU timestamps are mapped to the name of each recorded operation.
+ *
+ * Timings are aggregated per operation name across evals, and can be exported
+ * as a Chrome trace_event JSON document which can be opened in
+ * chrome://tracing or https://ui.perfetto.dev.
+ */
+class Profiler
+{
+  public:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * Single span of time captured by the profiler. Start times are relative
+     * to the creation of the profiler.
+     */
+    struct Event
+    {
+        std::string name;
+        std::string track;
+        bool gpu;
+        double startUs;
+        double durationUs;
+    };
+
+    /**
+     * Aggregated timings of all the events that share the same name.
+     */
+    struct Stats
+    {
+        uint64_t count = 0;
+        double totalUs = 0;
+        double minUs = 0;
+        double maxUs = 0;
+
+        double meanUs() const { return count ? totalUs / count : 0; }
+    };
+
+    /**
+     * Constructor which sets the time origin of all the events captured.
+     */
+    Profiler();
+
+    /**
+     * Adds a CPU span to the given track, which is usually the label of the
+     * sequence that produced it.
+     *
+     * @param track Name of the track (ie sequence) the span belongs to
+     * @param name Name of the span
+     * @param begin Time point at which the span started
+     * @param end Time point at which the span finished
+     */
+    void addCpuSpan(const std::string& track,
+                    const std::string& name,
+                    Clock::time_point begin,
+                    Clock::time_point end);
+
+    /**
+     * Adds the GPU spans of a single submission given the timestamps latched
+     * at the beginning of the command buffer and after each operation. The
+     * spans are placed relative to the time the command buffer was submitted
+     * as the GPU and CPU clocks are not calibrated against each other.
+     *
+     * @param track Name of the track (ie sequence) the spans belong to
+     * @param opNames Name of each of the operations recorded
+     * @param timestamps Raw timestamps, one more than the number of operations
+     * @param timestampPeriod Nanoseconds per timestamp tick of the device
+     * @param timestampValidBits Number of valid bits in the timestamps
+     * @param submitTime Time point at which the command buffer was submitted
+     */
+    void addGpuTimestamps(const std::string& track,
+                          const std::vector<std::string>& opNames,
+                          const std::vector<uint64_t>& timestamps,
+                          float timestampPeriod,
+                          uint32_t timestampValidBits,
+                          Clock::time_point submitTime);
+
+    /**
+     * Returns a copy of all the events captured since creation or the last
+     * clear() call.
+     *
+     * @return Vector of events in the order they were captured
+     */
+    std::vector<Event> getEvents() const;
+
+    /**
+     * Returns the timings aggregated by event name.
+     *
+     * @param gpu Whether to return the GPU operation timings or the CPU spans
+     * @return Map of event name to the aggregated timings
+     */
+    std::map<std::string, Stats> getStats(bool gpu = true) const;
+
+    /**
+     * Serialises all the events captured into a Chrome trace_event JSON
+     * document, with one process for the CPU and one for the GPU, and one
+     * thread per track.
+     *
+     * @return String containing the JSON document
+     */
+    std::string toChromeTrace() const;
+
+    /**
+     * Writes the Chrome trace_event JSON document into the given path.
+     *
+     * @param path Path of the file to create or overwrite
+     */
+    void writeChromeTrace(const std::string& path) const;
+
+    /**
+     * Removes all captured events and aggregated timings.
+     */
+    void clear();
+
+  private:
+    Clock::time_point mStart;
+    mutable std::mutex mMutex;
+    std::vector<Event> mEvents;
+    std::map<std::string, Stats> mCpuStats;
+    std::map<std::string, Stats> mGpuStats;
+
+    void addEvent(Event event);
+    double toUs(Clock::time_point timePoint) const;
+};
+
+} // End namespace kp
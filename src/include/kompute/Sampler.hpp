@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "kompute/Core.hpp"
+#include "logger/Logger.hpp"
+#include <memory>
+
+namespace kp {
+
+/**
+ * Sampler used by images bound as combined image samplers, which lets shaders
+ * read them with texture() so the filtering, such as bilinear interpolation,
+ * and the addressing outside of the image are done by the texture units.
+ */
+class Sampler
+{
+  public:
+    /**
+     * Constructor that creates the Vulkan sampler.
+     *
+     * @param device The device to use to create the sampler
+     * @param filter Filter used for both magnification and minification, and
+     * between mip levels when the coordinates are normalized
+     * @param addressMode Addressing of the coordinates outside of the image,
+     * used for all the dimensions
+     * @param normalizedCoordinates Whether the coordinates are in [0, 1]
+     * rather than in texels, which requires a nearest or linear filter with
+     * the same value for both directions and a clamping address mode
+     * @param borderColor Color returned outside of the image with the
+     * eClampToBorder address mode
+     */
+    Sampler(std::shared_ptr<vk::Device> device,
+            vk::Filter filter = vk::Filter::eLinear,
+            vk::SamplerAddressMode addressMode =
+              vk::SamplerAddressMode::eClampToEdge,
+            bool normalizedCoordinates = true,
+            vk::BorderColor borderColor =
+              vk::BorderColor::eFloatTransparentBlack);
+
+    /**
+     * @brief Make Sampler uncopyable
+     *
+     */
+    Sampler(const Sampler&) = delete;
+    Sampler(const Sampler&&) = delete;
+    Sampler& operator=(const Sampler&) = delete;
+    Sampler& operator=(const Sampler&&) = delete;
+
+    /**
+     * Destructor which is in charge of freeing the vulkan sampler.
+     */
+    ~Sampler();
+
+    /**
+     * Destroys the vulkan sampler, images bound with it must not be used in
+     * new descriptor sets afterwards.
+     */
+    void destroy();
+
+    /**
+     * Check whether the sampler is initialized.
+     *
+     * @returns Boolean stating whether the sampler is initialized
+     */
+    bool isInit();
+
+    /**
+     * The vulkan sampler, which is used to construct the descriptor sets.
+     *
+     * @return Shared pointer to the vulkan sampler
+     */
+    std::shared_ptr<vk::Sampler> getSampler();
+
+    /**
+     * The filter used for both magnification and minification.
+     *
+     * @return The filter of the sampler
+     */
+    vk::Filter getFilter();
+
+    /**
+     * The addressing of the coordinates outside of the image.
+     *
+     * @return The address mode of the sampler
+     */
+    vk::SamplerAddressMode getAddressMode();
+
+    /**
+     * Whether the coordinates are normalized to [0, 1].
+     *
+     * @return Boolean stating whether the coordinates are normalized
+     */
+    bool getNormalizedCoordinates();
+
+  private:
+    // -------------- NEVER OWNED RESOURCES
+    std::shared_ptr<vk::Device> mDevice;
+
+    // -------------- ALWAYS OWNED RESOURCES
+    std::shared_ptr<vk::Sampler> mSampler;
+    vk::Filter mFilter;
+    vk::SamplerAddressMode mAddressMode;
+    bool mNormalizedCoordinates;
+};
+
+} // End namespace kp
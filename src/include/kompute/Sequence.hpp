@@ -3,17 +3,31 @@
 
 #include "kompute/Core.hpp"
 
+#include "kompute/ImageLayoutTracker.hpp"
+#include "kompute/MemoryPlanner.hpp"
+#include "kompute/Profiler.hpp"
 #include "kompute/operations/OpAlgoDispatch.hpp"
 #include "kompute/operations/OpBase.hpp"
 
 namespace kp {
 
+class MemoryBudget;
+
 /**
  *  Container of operations that can be sent to GPU as batch
  */
 class Sequence : public std::enable_shared_from_this<Sequence>
 {
   public:
+    /**
+     * Pipeline statistics captured around a single recorded operation.
+     */
+    struct OpStatistics
+    {
+        std::string name;
+        uint64_t computeShaderInvocations = 0;
+    };
+
     /**
      * Main constructor for sequence which requires core vulkan components to
      * generate all dependent resources.
@@ -23,12 +37,16 @@ class Sequence : public std::enable_shared_from_this<Sequence>
      * @param computeQueue Vulkan compute queue
      * @param queueIndex Vulkan compute queue index in device
      * @param totalTimestamps Maximum number of timestamps to allocate
+     * @param totalPipelineStatistics Maximum number of operations to capture
+     * pipeline statistics for, which requires the pipelineStatisticsQuery
+     * device feature to be enabled
      */
     Sequence(std::shared_ptr<vk::PhysicalDevice> physicalDevice,
              std::shared_ptr<vk::Device> device,
              std::shared_ptr<vk::Queue> computeQueue,
              uint32_t queueIndex,
-             uint32_t totalTimestamps = 0) noexcept;
+             uint32_t totalTimestamps = 0,
+             uint32_t totalPipelineStatistics = 0) noexcept;
 
     /**
      * @brief Make Sequence uncopyable
@@ -228,6 +246,37 @@ class Sequence : public std::enable_shared_from_this<Sequence>
      */
     std::vector<std::uint64_t> getTimestamps();
 
+    /**
+     * Return the pipeline statistics captured around each of the recorded
+     * operations during the last eval() call. Operations that do not dispatch
+     * any shader report zero invocations.
+     *
+     * @return Vector with the statistics of each recorded operation
+     */
+    std::vector<OpStatistics> getPipelineStatistics();
+
+    /**
+     * Attaches a profiler which captures the CPU spans of the record, submit
+     * and await calls of this sequence. If the sequence was created with
+     * timestamps enabled, the GPU time of each recorded operation is also
+     * captured after every evalAwait() call.
+     *
+     * @param profiler The profiler to attach, or nullptr to detach it
+     * @param label Name of the track used for this sequence in the profiler
+     */
+    void setProfiler(std::shared_ptr<Profiler> profiler,
+                     const std::string& label = "Sequence");
+
+    /**
+     * Attaches the memory budget of the manager, which restores the evicted
+     * tensors used by the operations when they are recorded and checks the
+     * soft limit when the sequence is evaluated. The sequence is recorded
+     * again when tensors were evicted since it was recorded.
+     *
+     * @param memoryBudget The memory budget to attach, or nullptr to detach it
+     */
+    void setMemoryBudget(std::shared_ptr<MemoryBudget> memoryBudget);
+
     /**
      * Begins recording commands for commands to be submitted into the command
      * buffer.
@@ -270,6 +319,25 @@ class Sequence : public std::enable_shared_from_this<Sequence>
      */
     bool isRunning() const;
 
+    /**
+     * The tracker of the image layouts used by the command buffer of this
+     * sequence, which batches the image transitions of each operation and
+     * re-records the sequence when its images are not in the layouts the
+     * recording expects once submitted.
+     *
+     * @return Shared pointer to the image layout tracker
+     */
+    std::shared_ptr<ImageLayoutTracker> getImageLayoutTracker();
+
+    /**
+     * The planner of the memory of the transient tensors used by this
+     * sequence, which places the tensors whose lifetimes do not overlap in
+     * the same memory.
+     *
+     * @return Shared pointer to the memory planner
+     */
+    std::shared_ptr<MemoryPlanner> getMemoryPlanner();
+
     /**
      * Destroys and frees the GPU resources which include the buffer and memory
      * and sets the sequence as init=False.
@@ -293,15 +361,30 @@ class Sequence : public std::enable_shared_from_this<Sequence>
     vk::Fence mFence;
     std::vector<std::shared_ptr<OpBase>> mOperations{};
     std::shared_ptr<vk::QueryPool> timestampQueryPool = nullptr;
+    uint32_t mTotalTimestamps = 0;
+    std::shared_ptr<vk::QueryPool> mPipelineStatisticsQueryPool = nullptr;
+    uint32_t mTotalPipelineStatistics = 0;
+    std::shared_ptr<ImageLayoutTracker> mImageLayoutTracker = nullptr;
+    std::shared_ptr<MemoryPlanner> mMemoryPlanner = nullptr;
+    std::shared_ptr<MemoryBudget> mMemoryBudget = nullptr;
+    uint64_t mRecordedEvictionCount = 0;
+    std::shared_ptr<Profiler> mProfiler = nullptr;
+    std::string mProfilerLabel;
+    Profiler::Clock::time_point mSubmitTime;
 
     // State
     bool mRecording = false;
     bool mIsRunning = false;
+    bool mPlanPending = false;
 
     // Create functions
     void createCommandPool();
     void createCommandBuffer();
     void createTimestampQueryPool(uint32_t totalTimestamps);
+    void createPipelineStatisticsQueryPool(uint32_t totalPipelineStatistics);
+
+    // Profiling functions
+    void profileTimestamps();
 };
 
 } // End namespace kp
@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "kompute/ThreadPool.hpp"
+
+namespace kp {
+
+/**
+ * In-process compiler of GLSL and HLSL compute shaders into SPIR-V, backed by
+ * shaderc. It is only available when Kompute is built with the
+ * KOMPUTE_OPT_USE_SHADERC option.
+ *
+ * Compiled shaders are cached in memory and optionally in a directory on
+ * disk, keyed by a hash of the source, the language, the entry point and the
+ * macro definitions, so kernel variants built from the same source are cached
+ * separately. Nothing is written to the working directory, and shaders can be
+ * compiled in parallel on a thread pool.
+ */
+class ShaderCompiler
+{
+  public:
+    /**
+     * Source languages supported by the compiler.
+     */
+    enum class Language
+    {
+        eGlsl = 0,
+        eHlsl = 1,
+    };
+
+    /**
+     * Constructor for the compiler.
+     *
+     * @param cacheDirectory (optional) Existing directory in which the
+     * compiled SPIR-V is cached across runs, results are only cached in memory
+     * if empty
+     * @param totalThreads (optional) Number of threads used by compileAsync,
+     * which defaults to the number of hardware threads available
+     */
+    ShaderCompiler(const std::string& cacheDirectory = "",
+                   uint32_t totalThreads = 0);
+
+    /**
+     * @brief Make ShaderCompiler non-copyable
+     *
+     */
+    ShaderCompiler(const ShaderCompiler&) = delete;
+    ShaderCompiler(const ShaderCompiler&&) = delete;
+    ShaderCompiler& operator=(const ShaderCompiler&) = delete;
+    ShaderCompiler& operator=(const ShaderCompiler&&) = delete;
+
+    /**
+     * Compiles the compute shader source provided into SPIR-V, or returns
+     * the cached result of a previous compilation. This function is thread
+     * safe.
+     *
+     * @param source The source of the compute shader
+     * @param defines (optional) Macro definitions of the variant to compile,
+     * which are set with an empty value if their value is empty
+     * @param language (optional) The language of the source
+     * @param entryPoint (optional) The name of the entry point function
+     * @return The compiled SPIR-V words
+     */
+    std::vector<uint32_t> compile(
+      const std::string& source,
+      const std::map<std::string, std::string>& defines = {},
+      Language language = Language::eGlsl,
+      const std::string& entryPoint = "main");
+
+    /**
+     * Compiles the compute shader source provided on the thread pool of the
+     * compiler.
+     *
+     * @param source The source of the compute shader
+     * @param defines (optional) Macro definitions of the variant to compile
+     * @param language (optional) The language of the source
+     * @param entryPoint (optional) The name of the entry point function
+     * @return Shared future with the compiled SPIR-V words, which rethrows any
+     * compilation error when accessed
+     */
+    std::shared_future<std::vector<uint32_t>> compileAsync(
+      const std::string& source,
+      const std::map<std::string, std::string>& defines = {},
+      Language language = Language::eGlsl,
+      const std::string& entryPoint = "main");
+
+    /**
+     * Removes all the cached results, including the files created in the
+     * cache directory.
+     */
+    void clearCache();
+
+    /**
+     * Number of compilations served from the cache since the creation of the
+     * compiler, which is mainly useful for testing.
+     *
+     * @return The number of cache hits
+     */
+    uint64_t getCacheHits() const;
+
+  private:
+    std::string mCacheDirectory;
+    uint32_t mTotalThreads;
+    std::map<uint64_t, std::vector<uint32_t>> mCache;
+    mutable std::mutex mMutex;
+    uint64_t mCacheHits = 0;
+    // Declared last so it is destroyed first, as its queued compilations
+    // still access the cache when the pool joins them
+    std::unique_ptr<ThreadPool> mThreadPool;
+
+    std::vector<uint32_t> compileSource(
+      const std::string& source,
+      const std::map<std::string, std::string>& defines,
+      Language language,
+      const std::string& entryPoint);
+    bool loadCached(uint64_t key, std::vector<uint32_t>& spirv);
+    void storeCached(uint64_t key, const std::vector<uint32_t>& spirv);
+    std::string cachePath(uint64_t key) const;
+
+    static uint64_t hashInputs(
+      const std::string& source,
+      const std::map<std::string, std::string>& defines,
+      Language language,
+      const std::string& entryPoint);
+};
+
+} // End namespace kp
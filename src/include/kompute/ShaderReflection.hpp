@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "kompute/Core.hpp"
+
+namespace kp {
+
+/**
+ * Minimal SPIR-V reflection of the interface of a compute shader, which
+ * extracts the descriptor bindings, the size of the push constant block, the
+ * specialization constant ids and the local workgroup size by parsing the
+ * SPIR-V words directly, without external dependencies.
+ *
+ * This is used by kp::Algorithm to validate the memory objects provided
+ * against the bindings of the shader, and to derive the default dispatch size
+ * from the local size of the shader.
+ */
+class ShaderReflection
+{
+  public:
+    /**
+     * Descriptor binding declared by the shader.
+     */
+    struct Binding
+    {
+        uint32_t set;
+        uint32_t binding;
+        vk::DescriptorType descriptorType;
+        uint32_t descriptorCount;
+        std::string name;
+    };
+
+    /**
+     * Parses the SPIR-V provided, throwing if it is not a valid SPIR-V module.
+     *
+     * @param spirv The SPIR-V words of the shader
+     */
+    explicit ShaderReflection(const std::vector<uint32_t>& spirv);
+
+    /**
+     * Gets the descriptor bindings declared by the shader, sorted by set and
+     * binding.
+     *
+     * @returns The bindings of the shader
+     */
+    const std::vector<Binding>& getBindings() const;
+
+    /**
+     * Gets the size in bytes of the push constant block of the shader, which
+     * is 0 if the shader does not declare one.
+     *
+     * @returns The size of the push constant block
+     */
+    uint32_t getPushConstantsSize() const;
+
+    /**
+     * Gets the ids of the specialization constants declared by the shader,
+     * including the ones used for the local size.
+     *
+     * @returns The sorted specialization constant ids
+     */
+    std::vector<uint32_t> getSpecializationConstantIds() const;
+
+    /**
+     * Gets the local workgroup size of the shader. For sizes set through
+     * specialization constants (ie. local_size_x_id) the value provided for
+     * the constant id is used, or otherwise its default value.
+     *
+     * @param specializationConstants (optional) Values of the specialization
+     * constants by constant id
+     * @returns The local size in the x, y and z dimensions
+     */
+    std::array<uint32_t, 3> getLocalSize(
+      const std::map<uint32_t, uint32_t>& specializationConstants = {}) const;
+
+  private:
+    std::vector<Binding> mBindings;
+    uint32_t mPushConstantsSize = 0;
+    std::map<uint32_t, uint32_t> mSpecIds;
+    std::map<uint32_t, uint32_t> mConstants;
+    std::array<uint32_t, 3> mLocalSize = { { 1, 1, 1 } };
+    std::array<uint32_t, 3> mLocalSizeIds = { { 0, 0, 0 } };
+
+    void parse(const std::vector<uint32_t>& spirv);
+};
+
+} // End namespace kp
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "kompute/Core.hpp"
+#include "kompute/Tensor.hpp"
+#include <memory>
+#include <vector>
+
+namespace kp {
+
+/**
+ * Tensor split along its first dimension across the devices of a
+ * kp::DeviceGroup. The tensor is made of rows of the same number of
+ * elements, and shard i holds a contiguous range of rows on device i, with
+ * the rows spread as evenly as possible. A replicated tensor instead holds
+ * all the rows on each device, such as the weights used by every shard.
+ */
+class ShardedTensor
+{
+  public:
+    /**
+     * Constructor with the shards created by a kp::DeviceGroup.
+     *
+     * @param shards The tensor of each shard, in the order of the devices
+     * @param firstRows The index of the first row of each shard
+     * @param rows The total number of rows
+     * @param rowSize The number of elements of each row
+     * @param replicated Whether each shard holds all the rows
+     */
+    ShardedTensor(const std::vector<std::shared_ptr<Tensor>>& shards,
+                  const std::vector<uint32_t>& firstRows,
+                  uint32_t rows,
+                  uint32_t rowSize,
+                  bool replicated);
+
+    /**
+     * The tensors of the shards, in the order of the devices.
+     *
+     * @return Vector with the tensor of each shard
+     */
+    const std::vector<std::shared_ptr<Tensor>>& getShards() const;
+
+    /**
+     * The tensor of a shard.
+     *
+     * @param index The index of the shard, which is that of its device
+     * @return Shared pointer to the tensor of the shard
+     */
+    std::shared_ptr<Tensor> getShard(uint32_t index) const;
+
+    /**
+     * The number of shards, which is the number of devices used, or fewer
+     * when the tensor has less rows than there are devices.
+     *
+     * @return The number of shards
+     */
+    uint32_t shardCount() const;
+
+    /**
+     * The index of the first row of a shard in the whole tensor, which
+     * shaders computing on global indices add to their invocation index.
+     *
+     * @param index The index of the shard
+     * @return The index of the first row of the shard
+     */
+    uint32_t getShardFirstRow(uint32_t index) const;
+
+    /**
+     * The number of rows of a shard.
+     *
+     * @param index The index of the shard
+     * @return The number of rows held by the shard
+     */
+    uint32_t getShardRows(uint32_t index) const;
+
+    /**
+     * The total number of rows.
+     *
+     * @return The size of the first dimension
+     */
+    uint32_t getRows() const;
+
+    /**
+     * The number of elements of each row.
+     *
+     * @return The product of the dimensions after the first one
+     */
+    uint32_t getRowSize() const;
+
+    /**
+     * Whether each shard holds all the rows.
+     *
+     * @return Boolean stating whether the tensor is replicated
+     */
+    bool isReplicated() const;
+
+    /**
+     * The host data of the whole tensor, which concatenates the host data of
+     * the shards, or is that of the first shard for replicated tensors. The
+     * shards have to be synced with kp::DeviceGroup::syncLocal beforehand.
+     *
+     * @return Vector with the elements of all the rows
+     */
+    template<typename T>
+    std::vector<T> vector()
+    {
+        if (this->mReplicated) {
+            return this->mShards[0]->vector<T>();
+        }
+
+        std::vector<T> data;
+        data.reserve(this->mRows * this->mRowSize);
+        for (const std::shared_ptr<Tensor>& shard : this->mShards) {
+            std::vector<T> shardData = shard->vector<T>();
+            data.insert(data.end(), shardData.begin(), shardData.end());
+        }
+        return data;
+    }
+
+  private:
+    // -------------- ALWAYS OWNED RESOURCES
+    std::vector<std::shared_ptr<Tensor>> mShards;
+    std::vector<uint32_t> mFirstRows;
+    uint32_t mRows;
+    uint32_t mRowSize;
+    bool mReplicated;
+};
+
+} // End namespace kp
@@ -49,13 +49,16 @@ class Tensor : public Memory
      *  @param elmentTotalCount the number of elements of the array
      *  @param elementMemorySize the size of the element
      *  @param tensorTypes Type for the tensor which is of type TensorTypes
+     *  @param transient Whether the buffer is created without memory, which
+     * is bound by the kp::Sequence using the tensor, see isTransient
      */
     Tensor(std::shared_ptr<vk::PhysicalDevice> physicalDevice,
            std::shared_ptr<vk::Device> device,
            uint32_t elementTotalCount,
            uint32_t elementMemorySize,
            const DataTypes& dataType,
-           const MemoryTypes& memoryType = MemoryTypes::eDevice);
+           const MemoryTypes& memoryType = MemoryTypes::eDevice,
+           bool transient = false);
 
     /**
      * @brief Make Tensor uncopyable
@@ -174,6 +177,76 @@ class Tensor : public Memory
 
     std::shared_ptr<vk::Buffer> getPrimaryBuffer();
 
+    /**
+     * Whether the tensor is transient. Transient tensors are eStorage tensors
+     * whose buffer is created without memory. The first kp::Sequence
+     * evaluating operations on them binds them to a memory block that they
+     * share with the other transient tensors of the sequence whose lifetimes
+     * do not overlap, so their contents are undefined before their first use
+     * in the sequence and they cannot be used after it is destroyed.
+     *
+     * @return Boolean stating whether the tensor is transient
+     */
+    bool isTransient();
+
+    /**
+     * Whether memory is bound to the buffer of the tensor, which is only
+     * false for transient tensors that have not been planned yet.
+     *
+     * @return Boolean stating whether the buffer has memory
+     */
+    bool isMemoryBound();
+
+    /**
+     * The memory requirements of the buffer of the tensor, which are used to
+     * place transient tensors in a shared memory block.
+     *
+     * @return The memory requirements of the primary buffer
+     */
+    vk::MemoryRequirements getPrimaryMemoryRequirements();
+
+    /**
+     * Binds the buffer of a transient tensor to a range of a memory block
+     * that is owned by the caller, which is done once by kp::MemoryPlanner.
+     *
+     * @param memory The memory block
+     * @param offset The offset of the buffer in the memory block, aligned
+     * to the memory requirements of the buffer
+     */
+    void bindTransientMemory(std::shared_ptr<vk::DeviceMemory> memory,
+                             vk::DeviceSize offset);
+
+    /**
+     * Frees the buffer and device memory of an eDevice tensor, whose data is
+     * then only kept in its staging memory. The device data has to be copied
+     * to the staging memory beforehand if it is newer, as kp::MemoryBudget
+     * does with a kp::OpSyncLocal when it evicts the least recently used
+     * tensors.
+     */
+    void evict();
+
+    /**
+     * Creates the buffer and device memory of an evicted tensor again. The
+     * buffer is new, so the data has to be copied from the staging memory,
+     * and the descriptors and recordings using the previous one are outdated.
+     */
+    void restore();
+
+    /**
+     * Whether the device memory of the tensor was evicted.
+     *
+     * @return Boolean stating whether the tensor is evicted
+     */
+    bool isEvicted();
+
+    /**
+     * The number of times the buffer of the tensor was created again after
+     * an eviction, which lets algorithms update their descriptors.
+     *
+     * @return The version of the primary buffer
+     */
+    uint32_t getPrimaryBufferVersion();
+
     Type type() override { return Type::eTensor; }
 
   protected:
@@ -187,6 +260,11 @@ class Tensor : public Memory
     std::shared_ptr<vk::Buffer> mStagingBuffer;
     bool mFreeStagingBuffer = false;
 
+    // -------------- ALWAYS OWNED RESOURCES
+    bool mTransient = false;
+    bool mEvicted = false;
+    uint32_t mPrimaryBufferVersion = 0;
+
     void allocateMemoryCreateGPUResources(); // Creates the vulkan buffer
     void createBuffer(std::shared_ptr<vk::Buffer> buffer,
                       vk::BufferUsageFlags bufferUsageFlags);
@@ -231,13 +309,15 @@ class TensorT : public Tensor
     TensorT(std::shared_ptr<vk::PhysicalDevice> physicalDevice,
             std::shared_ptr<vk::Device> device,
             const size_t size,
-            const MemoryTypes& tensorType = MemoryTypes::eDevice)
+            const MemoryTypes& tensorType = MemoryTypes::eDevice,
+            bool transient = false)
       : Tensor(physicalDevice,
                device,
                size,
                sizeof(T),
                Memory::dataType<T>(),
-               tensorType)
+               tensorType,
+               transient)
     {
         KP_LOG_DEBUG("Kompute TensorT constructor with data size {}", size);
     }
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace kp {
+
+/**
+ * Fixed size pool of worker threads used to run tasks in the background, such
+ * as compiling the pipelines of algorithms created asynchronously.
+ */
+class ThreadPool
+{
+  public:
+    /**
+     * Constructor which starts the worker threads.
+     *
+     * @param totalThreads (optional) Number of worker threads to start, which
+     * defaults to the number of hardware threads available
+     */
+    explicit ThreadPool(uint32_t totalThreads = 0);
+
+    /**
+     * @brief Make ThreadPool uncopyable
+     *
+     */
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(const ThreadPool&&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&&) = delete;
+
+    /**
+     * Destructor which finishes all the tasks already submitted and then
+     * joins the worker threads.
+     */
+    ~ThreadPool();
+
+    /**
+     * Submits a task to be run by one of the worker threads.
+     *
+     * @param task The function to run
+     * @return Shared future that becomes ready when the task finishes, and
+     * which rethrows any exception thrown by the task when waited on
+     */
+    std::shared_future<void> submit(std::function<void()> task);
+
+    /**
+     * Number of worker threads of the pool.
+     *
+     * @return The number of worker threads
+     */
+    uint32_t size() const;
+
+  private:
+    std::vector<std::thread> mWorkers;
+    std::queue<std::packaged_task<void()>> mTasks;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    bool mStopping = false;
+
+    void work();
+};
+
+} // End namespace kp
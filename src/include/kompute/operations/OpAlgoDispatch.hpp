@@ -43,6 +43,52 @@ class OpAlgoDispatch : public OpBase
         }
     }
 
+    /**
+     * Constructor that stores the algorithm to use together with a tensor
+     * holding constants that can be updated with setConstants between evals
+     * without re-recording the sequence. The tensor has to be one of the
+     * memory objects of the algorithm, which the shader reads as a storage
+     * buffer instead of a push constant block. For tensors of type eDevice
+     * the staging to device copy is recorded before the dispatch.
+     *
+     * @param algorithm The algorithm object to use for dispatch
+     * @param constantsTensor Tensor of type eDevice, eHost or eDeviceAndHost
+     * holding the constants of the dispatch
+     * @param pushConstants The push constants to use for override
+     */
+    template<typename T = float>
+    OpAlgoDispatch(const std::shared_ptr<kp::Algorithm>& algorithm,
+                   const std::shared_ptr<kp::Tensor>& constantsTensor,
+                   const std::vector<T>& pushConstants = {})
+      : OpAlgoDispatch(algorithm, pushConstants)
+    {
+        if (!constantsTensor) {
+            throw std::runtime_error(
+              "Kompute OpAlgoDispatch constants tensor is null");
+        }
+        if (constantsTensor->memoryType() == Memory::MemoryTypes::eStorage) {
+            throw std::runtime_error(
+              "Kompute OpAlgoDispatch constants tensor cannot be of type "
+              "eStorage as it is not accessible from the host");
+        }
+
+        bool isBound = false;
+        for (const std::shared_ptr<Memory>& memObject :
+             algorithm->getMemObjects()) {
+            if (memObject == constantsTensor) {
+                isBound = true;
+                break;
+            }
+        }
+        if (!isBound) {
+            throw std::runtime_error(
+              "Kompute OpAlgoDispatch constants tensor is not one of the "
+              "memory objects of the algorithm");
+        }
+
+        this->mConstantsTensor = constantsTensor;
+    }
+
     /**
      * @brief Make OpAlgoDispatch non-copyable
      *
@@ -59,6 +105,36 @@ class OpAlgoDispatch : public OpBase
      */
     virtual ~OpAlgoDispatch() noexcept override;
 
+    /**
+     * Stages new values for the constants tensor, which are written into its
+     * host visible memory right before the next eval or evalAsync, so the
+     * command buffer previously recorded can be replayed with new parameters.
+     *
+     * @param constants The values to write, which must have the same memory
+     * size as the constants tensor
+     */
+    template<typename T>
+    void setConstants(const std::vector<T>& constants)
+    {
+        if (!this->mConstantsTensor) {
+            throw std::runtime_error(
+              "Kompute OpAlgoDispatch setConstants called without a "
+              "constants tensor");
+        }
+
+        size_t memorySize = constants.size() * sizeof(T);
+        if (memorySize != this->mConstantsTensor->memorySize()) {
+            throw std::runtime_error(
+              "Kompute OpAlgoDispatch constants size " +
+              std::to_string(memorySize) +
+              " does not match the constants tensor size " +
+              std::to_string(this->mConstantsTensor->memorySize()));
+        }
+
+        this->mPendingConstants.resize(memorySize);
+        memcpy(this->mPendingConstants.data(), constants.data(), memorySize);
+    }
+
     /**
      * This records the commands that are to be sent to the GPU. This includes
      * the barriers that ensure the memory has been copied before going in and
@@ -72,7 +148,8 @@ class OpAlgoDispatch : public OpBase
     virtual void record(const vk::CommandBuffer& commandBuffer) override;
 
     /**
-     * Does not perform any preEval commands.
+     * Writes the constants staged with setConstants, if any, into the host
+     * visible memory of the constants tensor.
      *
      * @param commandBuffer The command buffer to record the command into.
      */
@@ -85,12 +162,38 @@ class OpAlgoDispatch : public OpBase
      */
     virtual void postEval(const vk::CommandBuffer& commandBuffer) override;
 
-  private:
+    std::vector<std::shared_ptr<Memory>> getMemObjects() const override;
+
+    bool reportsMemObjects() const override { return true; }
+
+    /**
+     * Returns the name of the operation including the SPIR-V hash and
+     * workgroup of the algorithm it dispatches, which is used by kp::Profiler
+     * to label the timings of this operation.
+     *
+     * @return The name of the operation
+     */
+    virtual std::string name() const override;
+
+  protected:
     // -------------- ALWAYS OWNED RESOURCES
     std::shared_ptr<Algorithm> mAlgorithm;
     void* mPushConstantsData = nullptr;
     uint32_t mPushConstantsDataTypeMemorySize = 0;
     uint32_t mPushConstantsSize = 0;
+    std::vector<uint8_t> mPendingConstants;
+
+    // -------------- NEVER OWNED RESOURCES
+    std::shared_ptr<Tensor> mConstantsTensor;
+
+    /**
+     * Records the dispatch command of the algorithm once the barriers and
+     * bindings have been recorded, which can be overridden by operations that
+     * dispatch the algorithm differently.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void recordDispatch(const vk::CommandBuffer& commandBuffer);
 };
 
 } // End namespace kp
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "kompute/Algorithm.hpp"
+#include "kompute/Core.hpp"
+#include "kompute/Tensor.hpp"
+#include "kompute/operations/OpAlgoDispatch.hpp"
+
+namespace kp {
+
+/**
+ * Operation that dispatches an algorithm with a workgroup count read by the
+ * GPU from a tensor, which holds a VkDispatchIndirectCommand (ie. three
+ * uint32_t values x, y and z). This allows the size of a dispatch to be
+ * computed by a previous shader in the same sequence without reading it back
+ * to the host, such as the number of elements left after a stream compaction.
+ */
+class OpAlgoDispatchIndirect : public OpAlgoDispatch
+{
+  public:
+    /**
+     * Constructor that stores the algorithm to use, the tensor holding the
+     * dispatch parameters as well as the relevant push constants to override
+     * when recording.
+     *
+     * @param algorithm The algorithm object to use for dispatch
+     * @param indirectTensor The tensor holding the VkDispatchIndirectCommand
+     * @param offset Byte offset of the command in the tensor, which must be a
+     * multiple of 4
+     * @param pushConstants The push constants to use for override
+     */
+    template<typename T = float>
+    OpAlgoDispatchIndirect(const std::shared_ptr<kp::Algorithm>& algorithm,
+                           const std::shared_ptr<kp::Tensor>& indirectTensor,
+                           uint32_t offset = 0,
+                           const std::vector<T>& pushConstants = {})
+      : OpAlgoDispatch(algorithm, pushConstants)
+    {
+        KP_LOG_DEBUG("Kompute OpAlgoDispatchIndirect constructor");
+
+        if (!indirectTensor) {
+            throw std::runtime_error(
+              "Kompute OpAlgoDispatchIndirect indirect tensor is null");
+        }
+        if (offset % 4 != 0) {
+            throw std::runtime_error(
+              "Kompute OpAlgoDispatchIndirect offset must be a multiple of 4");
+        }
+        if (indirectTensor->memorySize() < offset + 3 * sizeof(uint32_t)) {
+            throw std::runtime_error(
+              "Kompute OpAlgoDispatchIndirect indirect tensor of " +
+              std::to_string(indirectTensor->memorySize()) +
+              " bytes is too small for a dispatch command at offset " +
+              std::to_string(offset));
+        }
+
+        this->mIndirectTensor = indirectTensor;
+        this->mOffset = offset;
+    }
+
+    /**
+     * @brief Make OpAlgoDispatchIndirect non-copyable
+     *
+     */
+    OpAlgoDispatchIndirect(const OpAlgoDispatchIndirect&) = delete;
+    OpAlgoDispatchIndirect(const OpAlgoDispatchIndirect&&) = delete;
+    OpAlgoDispatchIndirect& operator=(const OpAlgoDispatchIndirect&) = delete;
+    OpAlgoDispatchIndirect& operator=(const OpAlgoDispatchIndirect&&) = delete;
+
+    /**
+     * Default destructor, which does not destroy the underlying algorithm or
+     * tensors
+     */
+    virtual ~OpAlgoDispatchIndirect() noexcept override;
+
+    /**
+     * Records the barriers that make the writes to the indirect tensor, either
+     * from a shader or from a transfer, visible to the indirect command read,
+     * followed by the same commands as kp::OpAlgoDispatch with an indirect
+     * dispatch.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void record(const vk::CommandBuffer& commandBuffer) override;
+
+    std::vector<std::shared_ptr<Memory>> getMemObjects() const override;
+
+    /**
+     * Returns the name of the operation including the SPIR-V hash of the
+     * algorithm it dispatches, which is used by kp::Profiler to label the
+     * timings of this operation.
+     *
+     * @return The name of the operation
+     */
+    virtual std::string name() const override;
+
+  protected:
+    /**
+     * Records the indirect dispatch with the command in the indirect tensor.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void recordDispatch(
+      const vk::CommandBuffer& commandBuffer) override;
+
+  private:
+    // -------------- NEVER OWNED RESOURCES
+    std::shared_ptr<Tensor> mIndirectTensor;
+
+    // -------------- ALWAYS OWNED RESOURCES
+    uint32_t mOffset = 0;
+};
+
+} // End namespace kp
@@ -73,6 +73,40 @@ class OpBase
      * @param commandBuffer The command buffer to record the command into.
      */
     virtual void postEval(const vk::CommandBuffer& commandBuffer) = 0;
+
+    /**
+     * Returns the name of the operation, which is used by kp::Profiler to
+     * label the timings of each of the recorded operations. Custom operations
+     * can override it to provide a more descriptive name.
+     *
+     * @return The name of the operation
+     */
+    virtual std::string name() const { return "OpBase"; }
+
+    /**
+     * Returns the memory objects accessed by the operation, which kp::Sequence
+     * uses to compute the lifetimes of transient tensors and kp::MemoryBudget
+     * uses to know which tensors are in use. Operations that override it must
+     * also override reportsMemObjects() to return true.
+     *
+     * @return The memory objects accessed by the operation
+     */
+    virtual std::vector<std::shared_ptr<Memory>> getMemObjects() const
+    {
+        return {};
+    }
+
+    /**
+     * Whether the operation overrides getMemObjects(). The memory objects of
+     * operations that do not are unknown, so kp::Sequence throws when they
+     * are recorded in a sequence that uses transient tensors, as the memory
+     * of those tensors could be shared with tensors the operation accesses,
+     * and when tensors are evicted by kp::MemoryBudget, as only the tensors
+     * reported are restored.
+     *
+     * @return Boolean stating whether getMemObjects() is overridden
+     */
+    virtual bool reportsMemObjects() const { return false; }
 };
 
 } // End namespace kp
@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "kompute/Core.hpp"
+
+#include "ShaderOpCompact.hpp"
+
+#include "kompute/Algorithm.hpp"
+#include "kompute/Manager.hpp"
+#include "kompute/Tensor.hpp"
+
+#include "kompute/operations/OpBase.hpp"
+#include "kompute/operations/OpScan.hpp"
+
+namespace kp {
+
+/**
+ * Operation that performs a stream compaction, which copies the values of a
+ * tensor whose predicate is non zero to the start of an output tensor while
+ * preserving their order. The output positions are computed with an exclusive
+ * kp::OpScan of the predicates, and the number of values kept is written to a
+ * count tensor so it can be read by later shaders without going back to the
+ * host. The count is a single uint, so it is not a dispatch command by itself
+ * and has to be converted into the { x, 1, 1 } workgroup count expected by
+ * kp::OpAlgoDispatchIndirect first.
+ */
+class OpCompact : public OpBase
+{
+  public:
+    /**
+     * Constructor that creates the scan of the predicates and the algorithm
+     * scattering the values.
+     *
+     * @param memObjects The tensors with the values, the predicates, the
+     * output values and the count, where the values are 32-bit, the predicates
+     * and the count are uint, and the output has the type of the values and at
+     * least the same size
+     * @param manager The manager used to create the algorithms and the scratch
+     * tensors
+     * @param localSize (optional) Number of invocations per workgroup, which
+     * defaults to 256 and is rounded down to a power of two supported by the
+     * device
+     */
+    OpCompact(std::vector<std::shared_ptr<Memory>> memObjects,
+              Manager& manager,
+              uint32_t localSize = 0);
+
+    /**
+     * @brief Make OpCompact non-copyable
+     *
+     */
+    OpCompact(const OpCompact&) = delete;
+    OpCompact(const OpCompact&&) = delete;
+    OpCompact& operator=(const OpCompact&) = delete;
+    OpCompact& operator=(const OpCompact&&) = delete;
+
+    /**
+     * Default destructor, the algorithms and scratch tensors are owned by the
+     * manager that created them
+     */
+    ~OpCompact() noexcept override;
+
+    /**
+     * Records the scan of the predicates followed by the scatter of the
+     * values, with a barrier so the positions are visible to the scatter.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    void record(const vk::CommandBuffer& commandBuffer) override;
+
+    /**
+     * Does not perform any preEval commands.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void preEval(const vk::CommandBuffer& commandBuffer) override;
+
+    /**
+     * Does not perform any postEval commands.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void postEval(const vk::CommandBuffer& commandBuffer) override;
+
+    std::vector<std::shared_ptr<Memory>> getMemObjects() const override
+    {
+        return this->mMemObjects;
+    }
+
+    bool reportsMemObjects() const override { return true; }
+
+    /**
+     * Returns the name of the operation, which is used by kp::Profiler to
+     * label the timings of this operation.
+     *
+     * @return The name of the operation
+     */
+    std::string name() const override { return "OpCompact"; }
+
+  private:
+    // -------------- NEVER OWNED RESOURCES
+    std::vector<std::shared_ptr<Memory>> mMemObjects;
+    std::shared_ptr<Tensor> mPositions;
+    std::shared_ptr<Algorithm> mAlgorithm;
+
+    // -------------- ALWAYS OWNED RESOURCES
+    std::unique_ptr<OpScan> mScan;
+};
+
+} // End namespace kp
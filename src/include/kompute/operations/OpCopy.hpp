@@ -57,13 +57,30 @@ class OpCopy : public OpBase
     virtual void preEval(const vk::CommandBuffer& commandBuffer) override;
 
     /**
-     * Copies the local vectors for all the memory objects to sync the data with
-     * the gpu.
+     * Syncs the host data of the destinations with the source. eDevice
+     * destinations of an eDevice source defer the copy of its staging data
+     * until they are accessed (see Memory::deferHostDataCopy), so memory
+     * objects that are never read on the host are not copied.
      *
      * @param commandBuffer The command buffer to record the command into.
      */
     virtual void postEval(const vk::CommandBuffer& commandBuffer) override;
 
+    std::vector<std::shared_ptr<Memory>> getMemObjects() const override
+    {
+        return this->mMemObjects;
+    }
+
+    bool reportsMemObjects() const override { return true; }
+
+    /**
+     * Returns the name of the operation, which is used by kp::Profiler to
+     * label the timings of this operation.
+     *
+     * @return The name of the operation
+     */
+    virtual std::string name() const override { return "OpCopy"; }
+
   private:
     // -------------- ALWAYS OWNED RESOURCES
     std::vector<std::shared_ptr<Memory>> mMemObjects;
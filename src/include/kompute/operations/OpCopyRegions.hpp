@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "kompute/Core.hpp"
+
+#include "kompute/Image.hpp"
+#include "kompute/Memory.hpp"
+#include "kompute/Tensor.hpp"
+
+#include "kompute/operations/OpBase.hpp"
+
+namespace kp {
+
+/**
+ * Operation that copies regions of a memory object into another one, which
+ * can be tensors or images of the same data type, with all the regions being
+ * recorded in a single copy command. This allows tiling images into patches,
+ * or scattering and gathering rows of tensors, on the GPU. Unlike OpCopy, the
+ * host data of the destination is not updated, so an OpSyncLocal is needed
+ * to read the result of the copy on the host.
+ */
+class OpCopyRegions : public OpBase
+{
+  public:
+    /**
+     * Region copied from the source to the destination. Copies between
+     * tensors use the element ranges, copies between images use the texel
+     * boxes, and copies between a tensor and an image use the element offset
+     * of the tensor and the texel box of the image.
+     */
+    struct Region
+    {
+        uint64_t srcOffset = 0; ///< First element copied from a tensor
+        uint64_t dstOffset = 0; ///< First element copied into a tensor
+        uint64_t size = 0;      ///< Elements copied between tensors
+
+        vk::Offset3D srcImageOffset = { 0, 0, 0 }; ///< Texel in the source
+        vk::Offset3D dstImageOffset = { 0, 0, 0 }; ///< Texel in the dest
+        vk::Extent3D imageExtent = { 0, 0, 0 };    ///< Texels copied
+        uint32_t srcMipLevel = 0;
+        uint32_t dstMipLevel = 0;
+        uint32_t srcBaseLayer = 0;
+        uint32_t dstBaseLayer = 0;
+        uint32_t layerCount = 1;
+
+        /// Texels per row of the tensor in copies between a tensor and an
+        /// image, or 0 when the rows are as wide as the image extent
+        uint32_t rowLength = 0;
+    };
+
+    /**
+     * Constructor that validates the regions against the sizes of the memory
+     * objects.
+     *
+     * @param memObjects The source and destination memory objects, which
+     * must be different and of the same data type
+     * @param regions The regions copied from the source to the destination
+     */
+    OpCopyRegions(const std::vector<std::shared_ptr<Memory>>& memObjects,
+                  const std::vector<Region>& regions);
+
+    /**
+     * @brief Make OpCopyRegions non-copyable
+     *
+     */
+    OpCopyRegions(const OpCopyRegions&) = delete;
+    OpCopyRegions(const OpCopyRegions&&) = delete;
+    OpCopyRegions& operator=(const OpCopyRegions&) = delete;
+    OpCopyRegions& operator=(const OpCopyRegions&&) = delete;
+
+    /**
+     * Default destructor. This class does not manage memory so it won't be
+     * expecting the parent to perform a release.
+     */
+    ~OpCopyRegions() noexcept override;
+
+    /**
+     * Records the transitions of the images to the transfer layouts and the
+     * copy command with all the regions.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    void record(const vk::CommandBuffer& commandBuffer) override;
+
+    /**
+     * Does not perform any preEval commands.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void preEval(const vk::CommandBuffer& commandBuffer) override;
+
+    /**
+     * Does not perform any postEval commands.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void postEval(const vk::CommandBuffer& commandBuffer) override;
+
+    std::vector<std::shared_ptr<Memory>> getMemObjects() const override
+    {
+        return { this->mSource, this->mDestination };
+    }
+
+    bool reportsMemObjects() const override { return true; }
+
+    /**
+     * Returns the name of the operation, which is used by kp::Profiler to
+     * label the timings of this operation.
+     *
+     * @return The name of the operation
+     */
+    virtual std::string name() const override { return "OpCopyRegions"; }
+
+  private:
+    void validateTensorRange(const std::shared_ptr<Memory>& mem,
+                             uint64_t offset,
+                             uint64_t size);
+    void validateImageBox(const std::shared_ptr<Memory>& mem,
+                          const vk::Offset3D& offset,
+                          const vk::Extent3D& extent,
+                          uint32_t mipLevel,
+                          uint32_t baseLayer,
+                          uint32_t layerCount);
+    uint64_t getTensorRangeSize(const std::shared_ptr<Memory>& image,
+                                const Region& region);
+    vk::ImageSubresourceLayers getSubresourceLayers(uint32_t mipLevel,
+                                                    uint32_t baseLayer,
+                                                    uint32_t layerCount);
+
+    // -------------- ALWAYS OWNED RESOURCES
+    std::shared_ptr<Memory> mSource;
+    std::shared_ptr<Memory> mDestination;
+    std::vector<Region> mRegions;
+};
+
+} // End namespace kp
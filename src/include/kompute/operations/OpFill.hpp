@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "kompute/Core.hpp"
+
+#include "kompute/Image.hpp"
+#include "kompute/Memory.hpp"
+#include "kompute/Tensor.hpp"
+
+#include "kompute/operations/OpBase.hpp"
+
+namespace kp {
+
+/**
+ * Operation that sets every element of tensors, and every texel of all the
+ * mip levels and layers of images, to a value directly on the GPU with
+ * vkCmdFillBuffer and vkCmdClearColorImage. This avoids building the values
+ * on the host and uploading them with an OpSyncDevice. The host data is not
+ * updated, so an OpSyncLocal is needed to read the values on the host.
+ */
+class OpFill : public OpBase
+{
+  public:
+    /**
+     * Constructor that converts the value to the data type of each memory
+     * object.
+     *
+     * @param memObjects The tensors and images to fill. The byte size of
+     * tensors must be a multiple of 4, and tensors of 8-byte or custom types
+     * can only be filled with zeros
+     * @param value (optional) The value of the elements, which is quantized
+     * for eQInt8 memory objects and defaults to zero
+     */
+    OpFill(const std::vector<std::shared_ptr<Memory>>& memObjects,
+           double value = 0);
+
+    /**
+     * @brief Make OpFill non-copyable
+     *
+     */
+    OpFill(const OpFill&) = delete;
+    OpFill(const OpFill&&) = delete;
+    OpFill& operator=(const OpFill&) = delete;
+    OpFill& operator=(const OpFill&&) = delete;
+
+    /**
+     * Default destructor. This class does not manage memory so it won't be
+     * expecting the parent to perform a release.
+     */
+    ~OpFill() noexcept override;
+
+    /**
+     * Records the fill of each tensor and the clear of each image, which is
+     * transitioned to the transfer destination layout first.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    void record(const vk::CommandBuffer& commandBuffer) override;
+
+    /**
+     * Does not perform any preEval commands.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void preEval(const vk::CommandBuffer& commandBuffer) override;
+
+    /**
+     * Does not perform any postEval commands.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void postEval(const vk::CommandBuffer& commandBuffer) override;
+
+    std::vector<std::shared_ptr<Memory>> getMemObjects() const override
+    {
+        return this->mMemObjects;
+    }
+
+    bool reportsMemObjects() const override { return true; }
+
+    /**
+     * Returns the name of the operation, which is used by kp::Profiler to
+     * label the timings of this operation.
+     *
+     * @return The name of the operation
+     */
+    std::string name() const override { return "OpFill"; }
+
+  private:
+    // -------------- NEVER OWNED RESOURCES
+    std::vector<std::shared_ptr<Memory>> mMemObjects;
+
+    // -------------- ALWAYS OWNED RESOURCES
+    double mValue;
+
+    uint32_t getFillPattern(const std::shared_ptr<Memory>& mem);
+    vk::ClearColorValue getClearColor(const std::shared_ptr<Memory>& mem);
+};
+
+} // End namespace kp
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "kompute/Core.hpp"
+
+#include "ShaderOpFillRandom.hpp"
+
+#include "kompute/Algorithm.hpp"
+#include "kompute/Manager.hpp"
+#include "kompute/Tensor.hpp"
+
+#include "kompute/operations/OpBase.hpp"
+
+namespace kp {
+
+/**
+ * Operation that fills a tensor with random values generated on the GPU with
+ * the counter-based Philox4x32-10 generator, which avoids generating the
+ * values on the host and uploading them. The values only depend on the seed,
+ * the stream and their index, so the same values are generated on any device
+ * and an initialization can be reproduced. As with OpFill, the host data is
+ * not updated.
+ */
+class OpFillRandom : public OpBase
+{
+  public:
+    /**
+     * The distributions supported by the operation.
+     */
+    enum class Distribution
+    {
+        eUniform = 0, ///< Floats in [a, b)
+        eNormal = 1,  ///< Floats with mean a and standard deviation b
+        eBits = 2,    ///< Raw 32-bit words, for int and uint tensors
+    };
+
+    /**
+     * Constructor that creates the algorithm generating the values.
+     *
+     * @param memObjects The tensor to fill, which is a float tensor for the
+     * uniform and normal distributions and an int or uint tensor for eBits
+     * @param manager The manager used to create the algorithm
+     * @param seed The key of the generator
+     * @param distribution (optional) The distribution of the values
+     * @param a (optional) The lower bound of eUniform or the mean of eNormal
+     * @param b (optional) The upper bound of eUniform or the standard
+     * deviation of eNormal
+     * @param stream (optional) Selects an independent sequence of values for
+     * the same seed, such as one per training step
+     * @param localSize (optional) Number of invocations per workgroup, which
+     * defaults to 256 and is limited to the size supported by the device
+     */
+    OpFillRandom(std::vector<std::shared_ptr<Memory>> memObjects,
+                 Manager& manager,
+                 uint64_t seed,
+                 Distribution distribution = Distribution::eUniform,
+                 float a = 0.0f,
+                 float b = 1.0f,
+                 uint64_t stream = 0,
+                 uint32_t localSize = 0);
+
+    /**
+     * @brief Make OpFillRandom non-copyable
+     *
+     */
+    OpFillRandom(const OpFillRandom&) = delete;
+    OpFillRandom(const OpFillRandom&&) = delete;
+    OpFillRandom& operator=(const OpFillRandom&) = delete;
+    OpFillRandom& operator=(const OpFillRandom&&) = delete;
+
+    /**
+     * Default destructor, the algorithm is owned by the manager that created
+     * it
+     */
+    ~OpFillRandom() noexcept override;
+
+    /**
+     * Records the dispatch generating the values, after a barrier ordering
+     * it with the previous writes of the tensor.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    void record(const vk::CommandBuffer& commandBuffer) override;
+
+    /**
+     * Does not perform any preEval commands.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void preEval(const vk::CommandBuffer& commandBuffer) override;
+
+    /**
+     * Does not perform any postEval commands.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void postEval(const vk::CommandBuffer& commandBuffer) override;
+
+    std::vector<std::shared_ptr<Memory>> getMemObjects() const override
+    {
+        return { this->mOutput };
+    }
+
+    bool reportsMemObjects() const override { return true; }
+
+    /**
+     * Returns the name of the operation, which is used by kp::Profiler to
+     * label the timings of this operation.
+     *
+     * @return The name of the operation with the distribution
+     */
+    std::string name() const override;
+
+  private:
+    // -------------- NEVER OWNED RESOURCES
+    std::shared_ptr<Tensor> mOutput;
+    std::shared_ptr<Algorithm> mAlgorithm;
+
+    // -------------- ALWAYS OWNED RESOURCES
+    Distribution mDistribution;
+};
+
+} // End namespace kp
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "kompute/Core.hpp"
+#include "kompute/Image.hpp"
+#include "kompute/operations/OpBase.hpp"
+
+namespace kp {
+
+/**
+ * Operation that generates the mip levels of images from their first level,
+ * halving the size at each level with blits so the whole pyramid is built on
+ * the GPU within the command buffer. The images are left in the general
+ * layout so they can be read by the following operations. Blits require a
+ * queue family with graphics, which has to be requested through
+ * kp::DevicePolicy::requiredQueueFlags as async compute families are
+ * preferred by default.
+ */
+class OpGenerateMipmaps : public OpBase
+{
+  public:
+    /**
+     * Constructor that stores the images whose mip levels are generated.
+     *
+     * @param memObjects The images to generate the mip levels of, which must
+     * have more than one mip level
+     */
+    OpGenerateMipmaps(const std::vector<std::shared_ptr<Memory>>& memObjects);
+
+    /**
+     * @brief Make OpGenerateMipmaps non-copyable
+     *
+     */
+    OpGenerateMipmaps(const OpGenerateMipmaps&) = delete;
+    OpGenerateMipmaps(const OpGenerateMipmaps&&) = delete;
+    OpGenerateMipmaps& operator=(const OpGenerateMipmaps&) = delete;
+    OpGenerateMipmaps& operator=(const OpGenerateMipmaps&&) = delete;
+
+    /**
+     * Default destructor, which is in charge of destroying the references to
+     * the images.
+     */
+    virtual ~OpGenerateMipmaps() noexcept override;
+
+    /**
+     * Records the blits of every mip level from the previous one, with the
+     * barriers between the levels, for all the images.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void record(const vk::CommandBuffer& commandBuffer) override;
+
+    /**
+     * Does not perform any preEval commands.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void preEval(const vk::CommandBuffer& commandBuffer) override;
+
+    /**
+     * Does not perform any postEval commands.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void postEval(const vk::CommandBuffer& commandBuffer) override;
+
+    std::vector<std::shared_ptr<Memory>> getMemObjects() const override
+    {
+        return { this->mImages.begin(), this->mImages.end() };
+    }
+
+    bool reportsMemObjects() const override { return true; }
+
+    /**
+     * Returns the name of the operation, which is used by kp::Profiler to
+     * label the timings of this operation.
+     *
+     * @return The name of the operation
+     */
+    virtual std::string name() const override { return "OpGenerateMipmaps"; }
+
+  private:
+    std::vector<std::shared_ptr<Image>> mImages;
+};
+
+} // End namespace kp
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "kompute/Core.hpp"
+
+#include "ShaderOpMatMul.hpp"
+#include "ShaderOpMatMulCoopMat.hpp"
+
+#include "kompute/Algorithm.hpp"
+#include "kompute/Manager.hpp"
+#include "kompute/Tensor.hpp"
+
+#include "kompute/operations/OpBase.hpp"
+
+namespace kp {
+
+/**
+ * Operation that performs a batched matrix multiplication
+ * C = alpha * op(A) * op(B) + beta * C of row-major matrices, where op(A) is
+ * M x K, op(B) is K x N and op() optionally transposes its matrix. The inputs
+ * are either float tensors or kp::Memory::DataTypes::eHalf tensors, and C is
+ * a float tensor in both cases. The multiplication
+ * uses a shared memory tiled kernel whose tile sizes are specialization
+ * constants, or cooperative matrices for fp16 inputs when they are enabled on
+ * the device (see Manager::getCooperativeMatrixProperties) and the matrix
+ * sizes are multiples of a supported configuration.
+ */
+class OpMatMul : public OpBase
+{
+  public:
+    /**
+     * Constructor that validates the tensors and creates the algorithm of the
+     * multiplication.
+     *
+     * @param memObjects The tensors of A, B and C, where the matrices of each
+     * batch are stored one after the other
+     * @param manager The manager used to create the algorithm
+     * @param m The number of rows of op(A) and C
+     * @param n The number of columns of op(B) and C
+     * @param k The number of columns of op(A) and rows of op(B)
+     * @param batch (optional) The number of matrix multiplications
+     * @param transposeA (optional) Whether A is stored as a K x M matrix
+     * @param transposeB (optional) Whether B is stored as a N x K matrix
+     * @param alpha (optional) The scale of the product
+     * @param beta (optional) The scale of the previous values of C, which are
+     * not read when it is zero
+     */
+    OpMatMul(std::vector<std::shared_ptr<Memory>> memObjects,
+             Manager& manager,
+             uint32_t m,
+             uint32_t n,
+             uint32_t k,
+             uint32_t batch = 1,
+             bool transposeA = false,
+             bool transposeB = false,
+             float alpha = 1.0f,
+             float beta = 0.0f);
+
+    /**
+     * @brief Make OpMatMul non-copyable
+     *
+     */
+    OpMatMul(const OpMatMul&) = delete;
+    OpMatMul(const OpMatMul&&) = delete;
+    OpMatMul& operator=(const OpMatMul&) = delete;
+    OpMatMul& operator=(const OpMatMul&&) = delete;
+
+    /**
+     * Default destructor, the algorithm is owned by the manager that created
+     * it
+     */
+    ~OpMatMul() noexcept override;
+
+    /**
+     * Records the dispatch of the multiplication, with a barrier so the
+     * matrices copied to the device are visible to the shader.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    void record(const vk::CommandBuffer& commandBuffer) override;
+
+    /**
+     * Does not perform any preEval commands.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void preEval(const vk::CommandBuffer& commandBuffer) override;
+
+    /**
+     * Does not perform any postEval commands.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void postEval(const vk::CommandBuffer& commandBuffer) override;
+
+    std::vector<std::shared_ptr<Memory>> getMemObjects() const override
+    {
+        return this->mMemObjects;
+    }
+
+    bool reportsMemObjects() const override { return true; }
+
+    /**
+     * Returns the name of the operation, which is used by kp::Profiler to
+     * label the timings of this operation.
+     *
+     * @return The name of the operation with the matrix sizes and the kernel
+     */
+    std::string name() const override;
+
+    /**
+     * Whether the multiplication uses cooperative matrices instead of the
+     * shared memory tiled kernel.
+     *
+     * @return True if the cooperative matrix kernel is used
+     */
+    bool usesCooperativeMatrix() const;
+
+  private:
+    // -------------- NEVER OWNED RESOURCES
+    std::vector<std::shared_ptr<Memory>> mMemObjects;
+    std::shared_ptr<Algorithm> mAlgorithm;
+
+    // -------------- ALWAYS OWNED RESOURCES
+    uint32_t mM;
+    uint32_t mN;
+    uint32_t mK;
+    uint32_t mBatch;
+    bool mUseCooperativeMatrix = false;
+};
+
+} // End namespace kp
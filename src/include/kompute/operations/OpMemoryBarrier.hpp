@@ -78,6 +78,21 @@ class OpMemoryBarrier : public OpBase
      */
     virtual void postEval(const vk::CommandBuffer& commandBuffer) override;
 
+    std::vector<std::shared_ptr<Memory>> getMemObjects() const override
+    {
+        return this->mMemObjects;
+    }
+
+    bool reportsMemObjects() const override { return true; }
+
+    /**
+     * Returns the name of the operation, which is used by kp::Profiler to
+     * label the timings of this operation.
+     *
+     * @return The name of the operation
+     */
+    virtual std::string name() const override { return "OpMemoryBarrier"; }
+
   private:
     const vk::AccessFlagBits mSrcAccessMask;
     const vk::AccessFlagBits mDstAccessMask;
@@ -62,6 +62,14 @@ class OpMult : public OpAlgoDispatch
      * components but does not destroy the underlying tensors
      */
     ~OpMult() noexcept override { KP_LOG_DEBUG("Kompute OpMult destructor started"); }
+
+    /**
+     * Returns the name of the operation, which is used by kp::Profiler to
+     * label the timings of this operation.
+     *
+     * @return The name of the operation
+     */
+    virtual std::string name() const override { return "OpMult"; }
 };
 
 } // End namespace kp
@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "kompute/Core.hpp"
+
+#include "ShaderOpReduce.hpp"
+#include "ShaderOpReduceSubgroup.hpp"
+
+#include "kompute/Algorithm.hpp"
+#include "kompute/Manager.hpp"
+#include "kompute/Tensor.hpp"
+
+#include "kompute/operations/OpBase.hpp"
+
+namespace kp {
+
+/**
+ * Operation that reduces all the values of an int, uint or float tensor into
+ * the first element of an output tensor. Each workgroup reduces its share of
+ * the values with a shared memory tree reduction, or with subgroup arithmetic
+ * when the device supports it, and further passes reduce the partial results
+ * of the workgroups until a single value is left.
+ */
+class OpReduce : public OpBase
+{
+  public:
+    /**
+     * The reductions supported by the operation.
+     */
+    enum class Operation
+    {
+        eSum = 0,
+        eMin = 1,
+        eMax = 2,
+        eArgMax = 3, ///< Index of the first maximum value
+    };
+
+    /**
+     * Constructor that creates the algorithms of each pass, as well as the
+     * scratch tensors holding the partial results between passes.
+     *
+     * @param memObjects The input tensor followed by the output tensor, which
+     * has the type of the input tensor, or uint for eArgMax
+     * @param manager The manager used to create the algorithms and the scratch
+     * tensors
+     * @param operation (optional) The reduction to perform
+     * @param localSize (optional) Number of invocations per workgroup, which
+     * defaults to 256 and is rounded down to a power of two supported by the
+     * device
+     */
+    OpReduce(std::vector<std::shared_ptr<Memory>> memObjects,
+             Manager& manager,
+             Operation operation = Operation::eSum,
+             uint32_t localSize = 0);
+
+    /**
+     * @brief Make OpReduce non-copyable
+     *
+     */
+    OpReduce(const OpReduce&) = delete;
+    OpReduce(const OpReduce&&) = delete;
+    OpReduce& operator=(const OpReduce&) = delete;
+    OpReduce& operator=(const OpReduce&&) = delete;
+
+    /**
+     * Default destructor, the algorithms and scratch tensors are owned by the
+     * manager that created them
+     */
+    ~OpReduce() noexcept override;
+
+    /**
+     * Records the dispatch of each pass, with a barrier between passes so the
+     * partial results are visible to the next one.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    void record(const vk::CommandBuffer& commandBuffer) override;
+
+    /**
+     * Does not perform any preEval commands.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void preEval(const vk::CommandBuffer& commandBuffer) override;
+
+    /**
+     * Does not perform any postEval commands.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void postEval(const vk::CommandBuffer& commandBuffer) override;
+
+    std::vector<std::shared_ptr<Memory>> getMemObjects() const override
+    {
+        return { this->mInput, this->mOutput };
+    }
+
+    bool reportsMemObjects() const override { return true; }
+
+    /**
+     * Returns the name of the operation, which is used by kp::Profiler to
+     * label the timings of this operation.
+     *
+     * @return The name of the operation with the reduction and passes
+     */
+    std::string name() const override;
+
+    /**
+     * Number of dispatches recorded by the operation, which depends on the
+     * size of the input tensor.
+     *
+     * @return The number of passes
+     */
+    uint32_t passes() const;
+
+    /**
+     * Whether the operation uses the subgroup arithmetic variant of the
+     * reduction.
+     *
+     * @return True if subgroup operations are used
+     */
+    bool usesSubgroups() const;
+
+  private:
+    // -------------- NEVER OWNED RESOURCES
+    std::shared_ptr<Tensor> mInput;
+    std::shared_ptr<Tensor> mOutput;
+    std::vector<std::shared_ptr<Algorithm>> mAlgorithms;
+    std::vector<std::shared_ptr<Tensor>> mScratchTensors;
+
+    // -------------- ALWAYS OWNED RESOURCES
+    Operation mOperation;
+    bool mUseSubgroups;
+};
+
+} // End namespace kp
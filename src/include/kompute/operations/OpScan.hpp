@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "kompute/Core.hpp"
+
+#include "ShaderOpScan.hpp"
+
+#include "kompute/Algorithm.hpp"
+#include "kompute/Manager.hpp"
+#include "kompute/Tensor.hpp"
+
+#include "kompute/operations/OpBase.hpp"
+
+namespace kp {
+
+/**
+ * Operation that computes the inclusive or exclusive prefix sum of an int,
+ * uint or float tensor into an output tensor of the same type. It follows a
+ * reduce-then-scan design: the sums of the blocks of values handled by each
+ * workgroup are computed first, these sums are scanned recursively into the
+ * offsets of the blocks, and each block is then scanned from its offset.
+ */
+class OpScan : public OpBase
+{
+  public:
+    /**
+     * Constructor that creates the algorithms of each pass, as well as the
+     * scratch tensors holding the sums and offsets of the blocks.
+     *
+     * @param memObjects The input tensor followed by the output tensor, which
+     * has the same type and at least the same size as the input
+     * @param manager The manager used to create the algorithms and the scratch
+     * tensors
+     * @param exclusive (optional) Whether each output excludes its own value
+     * @param countNonZero (optional) Scans 1 for each non zero input instead
+     * of the input values, which gives the output positions of a stream
+     * compaction and requires a uint output tensor
+     * @param localSize (optional) Number of invocations per workgroup, which
+     * defaults to 256 and is rounded down to a power of two supported by the
+     * device
+     */
+    OpScan(std::vector<std::shared_ptr<Memory>> memObjects,
+           Manager& manager,
+           bool exclusive = false,
+           bool countNonZero = false,
+           uint32_t localSize = 0);
+
+    /**
+     * @brief Make OpScan non-copyable
+     *
+     */
+    OpScan(const OpScan&) = delete;
+    OpScan(const OpScan&&) = delete;
+    OpScan& operator=(const OpScan&) = delete;
+    OpScan& operator=(const OpScan&&) = delete;
+
+    /**
+     * Default destructor, the algorithms and scratch tensors are owned by the
+     * manager that created them
+     */
+    ~OpScan() noexcept override;
+
+    /**
+     * Records the dispatch of each pass, with a barrier between passes so the
+     * results of a pass are visible to the next one.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    void record(const vk::CommandBuffer& commandBuffer) override;
+
+    /**
+     * Does not perform any preEval commands.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void preEval(const vk::CommandBuffer& commandBuffer) override;
+
+    /**
+     * Does not perform any postEval commands.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void postEval(const vk::CommandBuffer& commandBuffer) override;
+
+    std::vector<std::shared_ptr<Memory>> getMemObjects() const override
+    {
+        return { this->mInput, this->mOutput };
+    }
+
+    bool reportsMemObjects() const override { return true; }
+
+    /**
+     * Returns the name of the operation, which is used by kp::Profiler to
+     * label the timings of this operation.
+     *
+     * @return The name of the operation with the scan type and passes
+     */
+    std::string name() const override;
+
+    /**
+     * Number of dispatches recorded by the operation, which depends on the
+     * size of the input tensor.
+     *
+     * @return The number of passes
+     */
+    uint32_t passes() const;
+
+  private:
+    // -------------- NEVER OWNED RESOURCES
+    std::shared_ptr<Tensor> mInput;
+    std::shared_ptr<Tensor> mOutput;
+    std::vector<std::shared_ptr<Algorithm>> mAlgorithms;
+    std::vector<std::shared_ptr<Tensor>> mScratchTensors;
+
+    // -------------- ALWAYS OWNED RESOURCES
+    bool mExclusive;
+
+    void createPasses(Manager& manager,
+                      const std::vector<uint32_t>& spirv,
+                      const std::shared_ptr<Tensor>& input,
+                      const std::shared_ptr<Tensor>& output,
+                      uint32_t count,
+                      uint32_t localSize,
+                      uint32_t maxWorkgroups,
+                      Memory::DataTypes dataType,
+                      bool exclusive,
+                      bool countNonZero);
+};
+
+} // End namespace kp
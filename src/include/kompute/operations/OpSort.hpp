@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "kompute/Core.hpp"
+
+#include "ShaderOpSort.hpp"
+
+#include "kompute/Algorithm.hpp"
+#include "kompute/Manager.hpp"
+#include "kompute/Tensor.hpp"
+
+#include "kompute/operations/OpBase.hpp"
+#include "kompute/operations/OpScan.hpp"
+
+namespace kp {
+
+/**
+ * Operation that sorts an int, uint or float tensor of keys in place, with an
+ * optional tensor of 32-bit values that is reordered along with the keys. It
+ * performs a stable least significant digit radix sort over 4 bits of the keys
+ * per pass: the digits of each block of keys are counted, the digit-major
+ * histograms are scanned with a kp::OpScan into the output offsets of each
+ * block, and the keys are then scattered to these offsets. The passes alternate
+ * between the user tensors and scratch tensors that are allocated once, so the
+ * operation can be evaluated repeatedly without further allocations.
+ */
+class OpSort : public OpBase
+{
+  public:
+    /**
+     * Constructor that creates the algorithms of the histogram and scatter
+     * passes, the scan of the histograms, and the scratch tensors.
+     *
+     * @param memObjects The tensor of keys, optionally followed by a tensor of
+     * values with the same size, where the keys are int, uint or float and the
+     * values are 32-bit
+     * @param manager The manager used to create the algorithms and the scratch
+     * tensors
+     * @param descending (optional) Whether the keys are sorted from the largest
+     * to the smallest, equal keys keep their order in both cases
+     * @param localSize (optional) Number of invocations per workgroup, which
+     * defaults to 128 and is rounded down to a power of two supported by the
+     * device
+     */
+    OpSort(std::vector<std::shared_ptr<Memory>> memObjects,
+           Manager& manager,
+           bool descending = false,
+           uint32_t localSize = 0);
+
+    /**
+     * @brief Make OpSort non-copyable
+     *
+     */
+    OpSort(const OpSort&) = delete;
+    OpSort(const OpSort&&) = delete;
+    OpSort& operator=(const OpSort&) = delete;
+    OpSort& operator=(const OpSort&&) = delete;
+
+    /**
+     * Default destructor, the algorithms and scratch tensors are owned by the
+     * manager that created them
+     */
+    ~OpSort() noexcept override;
+
+    /**
+     * Records the histogram, scan and scatter dispatches of each pass, with
+     * barriers so the results of each dispatch are visible to the next one.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    void record(const vk::CommandBuffer& commandBuffer) override;
+
+    /**
+     * Does not perform any preEval commands.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void preEval(const vk::CommandBuffer& commandBuffer) override;
+
+    /**
+     * Does not perform any postEval commands.
+     *
+     * @param commandBuffer The command buffer to record the command into.
+     */
+    virtual void postEval(const vk::CommandBuffer& commandBuffer) override;
+
+    std::vector<std::shared_ptr<Memory>> getMemObjects() const override
+    {
+        return this->mMemObjects;
+    }
+
+    bool reportsMemObjects() const override { return true; }
+
+    /**
+     * Returns the name of the operation, which is used by kp::Profiler to
+     * label the timings of this operation.
+     *
+     * @return The name of the operation with the sort order
+     */
+    std::string name() const override;
+
+    /**
+     * Number of radix passes recorded by the operation, each of which
+     * consists of a histogram, a scan and a scatter.
+     *
+     * @return The number of passes
+     */
+    uint32_t passes() const;
+
+  private:
+    // -------------- NEVER OWNED RESOURCES
+    std::vector<std::shared_ptr<Memory>> mMemObjects;
+    std::shared_ptr<Tensor> mHistograms;
+    std::shared_ptr<Tensor> mOffsets;
+    std::vector<std::shared_ptr<Tensor>> mScratchTensors;
+    // Histogram and scatter algorithms reading the user tensors, followed by
+    // the ones reading the scratch tensors
+    std::vector<std::shared_ptr<Algorithm>> mHistogramAlgorithms;
+    std::vector<std::shared_ptr<Algorithm>> mScatterAlgorithms;
+
+    // -------------- ALWAYS OWNED RESOURCES
+    std::unique_ptr<OpScan> mScan;
+    uint32_t mCount;
+    bool mDescending;
+};
+
+} // End namespace kp
@@ -53,7 +53,8 @@ class OpSyncDevice : public OpBase
     void record(const vk::CommandBuffer& commandBuffer) override;
 
     /**
-     * Does not perform any preEval commands.
+     * Resolves the deferred host data copies into the device memory objects,
+     * so the staging memory uploaded holds their current host data.
      *
      * @param commandBuffer The command buffer to record the command into.
      */
@@ -66,6 +67,21 @@ class OpSyncDevice : public OpBase
      */
     virtual void postEval(const vk::CommandBuffer& commandBuffer) override;
 
+    std::vector<std::shared_ptr<Memory>> getMemObjects() const override
+    {
+        return this->mMemObjects;
+    }
+
+    bool reportsMemObjects() const override { return true; }
+
+    /**
+     * Returns the name of the operation, which is used by kp::Profiler to
+     * label the timings of this operation.
+     *
+     * @return The name of the operation
+     */
+    virtual std::string name() const override { return "OpSyncDevice"; }
+
   private:
     // -------------- ALWAYS OWNED RESOURCES
     std::vector<std::shared_ptr<Memory>> mMemObjects;
@@ -54,7 +54,8 @@ class OpSyncLocal : public OpBase
     void record(const vk::CommandBuffer& commandBuffer) override;
 
     /**
-     * Does not perform any preEval commands.
+     * Resolves the deferred host data copies from the device memory objects
+     * and drops those into them, as their staging memory is overwritten.
      *
      * @param commandBuffer The command buffer to record the command into.
      */
@@ -68,6 +69,21 @@ class OpSyncLocal : public OpBase
      */
     virtual void postEval(const vk::CommandBuffer& commandBuffer) override;
 
+    std::vector<std::shared_ptr<Memory>> getMemObjects() const override
+    {
+        return this->mMemObjects;
+    }
+
+    bool reportsMemObjects() const override { return true; }
+
+    /**
+     * Returns the name of the operation, which is used by kp::Profiler to
+     * label the timings of this operation.
+     *
+     * @return The name of the operation
+     */
+    virtual std::string name() const override { return "OpSyncLocal"; }
+
   private:
     // -------------- ALWAYS OWNED RESOURCES
     std::vector<std::shared_ptr<Memory>> mMemObjects;
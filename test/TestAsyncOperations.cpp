@@ -290,3 +290,60 @@ TEST(TestAsyncOperations, TestManagerAsyncExecutionTimeout)
     EXPECT_EQ(tensorA->vector(), resultAsync);
     EXPECT_EQ(tensorB->vector(), resultAsync);
 }
+
+TEST(TestAsyncOperations, TestAsyncAlgorithmCreation)
+{
+    uint32_t numAlgorithms = 32;
+
+    std::string shader(R"(
+        #version 450
+
+        layout (constant_id = 0) const float cValue = 0;
+        layout (local_size_x = 1) in;
+
+        layout(set = 0, binding = 0) buffer a { float pa[]; };
+
+        void main() {
+            uint index = gl_GlobalInvocationID.x;
+            pa[index] = pa[index] + cValue;
+        }
+    )");
+
+    std::vector<uint32_t> spirv = compileSource(shader);
+
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensor({ 0, 0, 0 });
+
+    // Each algorithm has a different specialization constant so every
+    // pipeline is compiled separately on the thread pool
+    std::vector<std::shared_ptr<kp::Algorithm>> algorithms;
+    for (uint32_t i = 0; i < numAlgorithms; i++) {
+        algorithms.push_back(mgr.algorithmAsync(
+          { tensorA }, spirv, {}, std::vector<float>({ (float)i + 1 })));
+    }
+
+    std::shared_ptr<kp::Sequence> sq = mgr.sequence();
+    sq->record<kp::OpSyncDevice>({ tensorA });
+    for (const std::shared_ptr<kp::Algorithm>& algorithm : algorithms) {
+        // Recording waits for each pipeline that is not ready yet
+        sq->record<kp::OpAlgoDispatch>(algorithm);
+        sq->record<kp::OpMemoryBarrier>(
+          { tensorA },
+          vk::AccessFlagBits::eShaderWrite,
+          vk::AccessFlagBits::eShaderRead,
+          vk::PipelineStageFlagBits::eComputeShader,
+          vk::PipelineStageFlagBits::eComputeShader);
+    }
+    sq->record<kp::OpSyncLocal>({ tensorA });
+    sq->eval();
+
+    for (const std::shared_ptr<kp::Algorithm>& algorithm : algorithms) {
+        EXPECT_TRUE(algorithm->isPipelineReady());
+        EXPECT_TRUE(algorithm->isInit());
+    }
+
+    float expected = numAlgorithms * (numAlgorithms + 1) / 2;
+    EXPECT_EQ(tensorA->vector(),
+              std::vector<float>({ expected, expected, expected }));
+}
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+#include "shaders/Utils.hpp"
+
+static const std::string sAutotunerShader(R"(
+  #version 450
+  layout (local_size_x_id = 0) in;
+  layout(set = 0, binding = 0) buffer a { float pa[]; };
+  void main() {
+      uint index = gl_GlobalInvocationID.x;
+      if (index < pa.length()) {
+          pa[index] = pa[index] + 1;
+      }
+  })");
+
+TEST(TestAutotuner, TuneAndCacheLocalSize)
+{
+    const std::string cachePath = "kompute_autotuner_test.cache";
+    std::remove(cachePath.c_str());
+
+    kp::Manager mgr;
+
+    std::vector<uint32_t> spirv = compileSource(sAutotunerShader);
+
+    std::shared_ptr<kp::TensorT<float>> tensorA =
+      mgr.tensor(std::vector<float>(1000, 0));
+
+    kp::Autotuner::Result result;
+    {
+        kp::Autotuner autotuner(mgr, cachePath, { 16, 32, 64 }, 2);
+        result = autotuner.tune({ tensorA }, spirv);
+
+        EXPECT_FALSE(result.cached);
+        EXPECT_TRUE(result.localSizeX == 16 || result.localSizeX == 32 ||
+                    result.localSizeX == 64);
+        EXPECT_GE(result.workgroup[0] * result.localSizeX, 1000);
+        EXPECT_LT((result.workgroup[0] - 1) * result.localSizeX, 1000);
+    }
+
+    {
+        kp::Autotuner autotuner(mgr, cachePath, { 16, 32, 64 }, 2);
+
+        mgr.sequence()->eval<kp::OpSyncDevice>({ tensorA });
+
+        std::shared_ptr<kp::Algorithm> algo =
+          autotuner.algorithm({ tensorA }, spirv);
+
+        EXPECT_EQ(algo->getWorkgroup(), result.workgroup);
+        EXPECT_EQ(algo->getSpecializationConstants<uint32_t>(),
+                  std::vector<uint32_t>({ result.localSizeX }));
+
+        // Tuning with a cached result does not dispatch the shader, so the
+        // device values are only incremented by the dispatch below
+        mgr.sequence()
+          ->record<kp::OpAlgoDispatch>(algo)
+          ->record<kp::OpSyncLocal>({ tensorA })
+          ->eval();
+
+        EXPECT_EQ(tensorA->vector(), std::vector<float>(1000, 1));
+
+        autotuner.clearCache();
+    }
+
+    std::remove(cachePath.c_str());
+}
+
+TEST(TestAutotuner, NoValidCandidates)
+{
+    kp::Manager mgr;
+
+    std::vector<uint32_t> spirv = compileSource(sAutotunerShader);
+
+    std::shared_ptr<kp::TensorT<float>> tensorA =
+      mgr.tensor(std::vector<float>(10, 0));
+
+    kp::Autotuner autotuner(mgr, "", { 0, UINT32_MAX });
+    EXPECT_ANY_THROW(autotuner.tune({ tensorA }, spirv));
+}
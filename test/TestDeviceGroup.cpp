@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+#include "shaders/Utils.hpp"
+
+static const std::string SCALE_SHADER(R"(
+    #version 450
+
+    layout (local_size_x = 1) in;
+
+    layout(set = 0, binding = 0) buffer buf_in { float in_a[]; };
+    layout(set = 0, binding = 1) buffer buf_out { float out_a[]; };
+    layout(set = 0, binding = 2) buffer buf_w { float w[]; };
+
+    void main() {
+        uint index = gl_GlobalInvocationID.x;
+        out_a[index] = in_a[index] * w[0] + w[1];
+    }
+)");
+
+// Sums the two elements of each row
+static const std::string ROW_SUM_SHADER(R"(
+    #version 450
+
+    layout (local_size_x = 1) in;
+
+    layout(set = 0, binding = 0) buffer buf_in { float in_a[]; };
+    layout(set = 0, binding = 1) buffer buf_out { float out_a[]; };
+
+    void main() {
+        uint row = gl_GlobalInvocationID.x;
+        out_a[row] = in_a[row * 2] + in_a[row * 2 + 1];
+    }
+)");
+
+TEST(TestDeviceGroup, SelectsDevicesByScore)
+{
+    kp::DeviceGroup group;
+
+    ASSERT_GE(group.size(), 1u);
+
+    std::vector<vk::PhysicalDevice> devices =
+      group.getManager(0)->listDevices();
+    int64_t bestScore = -1;
+    for (const vk::PhysicalDevice& device : devices) {
+        bestScore = std::max(
+          bestScore,
+          kp::DeviceSelector::scoreDevice(device, kp::DevicePolicy()));
+    }
+
+    // The first device of the group is the best one available
+    vk::PhysicalDeviceProperties properties =
+      group.getManager(0)->getDeviceProperties();
+    for (const vk::PhysicalDevice& device : devices) {
+        if (device.getProperties().deviceID == properties.deviceID) {
+            EXPECT_EQ(
+              kp::DeviceSelector::scoreDevice(device, kp::DevicePolicy()),
+              bestScore);
+        }
+    }
+
+    kp::DeviceGroup single(1);
+    EXPECT_EQ(single.size(), 1u);
+}
+
+TEST(TestDeviceGroup, ShardedAlgorithm)
+{
+    // Two managers of the same device exercise the sharding on any machine
+    kp::DeviceGroup group(std::vector<uint32_t>({ 0, 0 }));
+    ASSERT_EQ(group.size(), 2u);
+
+    std::vector<float> data{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    std::shared_ptr<kp::ShardedTensor> tensorIn = group.tensor(data, 2);
+    std::shared_ptr<kp::ShardedTensor> tensorOut =
+      group.tensorT<float>(5, 2);
+    std::shared_ptr<kp::ShardedTensor> weights =
+      group.replicate(std::vector<float>({ 2, 1 }));
+
+    // The first shard takes the extra row
+    EXPECT_EQ(tensorIn->shardCount(), 2u);
+    EXPECT_EQ(tensorIn->getShardRows(0), 3u);
+    EXPECT_EQ(tensorIn->getShardRows(1), 2u);
+    EXPECT_EQ(tensorIn->getShardFirstRow(1), 3u);
+    EXPECT_EQ(tensorIn->getShard(1)->size(), 4u);
+    EXPECT_TRUE(weights->isReplicated());
+
+    std::vector<std::shared_ptr<kp::Algorithm>> algorithms =
+      group.algorithm({ tensorIn, tensorOut, weights },
+                      compileSource(SCALE_SHADER));
+    EXPECT_EQ(algorithms.size(), 2u);
+
+    group.syncDevice({ tensorIn, weights });
+    group.eval(algorithms);
+
+    std::vector<float> expected{ 1, 3, 5, 7, 9, 11, 13, 15, 17, 19 };
+    EXPECT_EQ(group.gather<float>(tensorOut), expected);
+
+    // Host staged gather into a tensor of the second device
+    std::shared_ptr<kp::TensorT<float>> gathered =
+      group.gather<float>(tensorOut, 1);
+    group.getManager(1)->sequence()->eval<kp::OpSyncLocal>({ gathered });
+    EXPECT_EQ(gathered->vector(), expected);
+}
+
+TEST(TestDeviceGroup, PerShardWorkgroups)
+{
+    kp::DeviceGroup group(std::vector<uint32_t>({ 0, 0 }));
+    ASSERT_EQ(group.size(), 2u);
+
+    std::shared_ptr<kp::ShardedTensor> tensorIn =
+      group.tensor(std::vector<float>({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }), 2);
+    std::shared_ptr<kp::ShardedTensor> tensorOut = group.tensorT<float>(5);
+
+    // One invocation per row of each shard
+    std::vector<kp::Workgroup> workgroups;
+    for (uint32_t i = 0; i < tensorIn->shardCount(); i++) {
+        workgroups.push_back({ tensorIn->getShardRows(i), 1, 1 });
+    }
+
+    std::vector<std::shared_ptr<kp::Algorithm>> algorithms = group.algorithm(
+      { tensorIn, tensorOut }, compileSource(ROW_SUM_SHADER), workgroups);
+    ASSERT_EQ(algorithms.size(), 2u);
+
+    group.syncDevice({ tensorIn });
+    group.eval(algorithms);
+
+    EXPECT_EQ(algorithms[0]->getWorkgroup(), kp::Workgroup({ 3, 1, 1 }));
+    EXPECT_EQ(algorithms[1]->getWorkgroup(), kp::Workgroup({ 2, 1, 1 }));
+
+    EXPECT_EQ(group.gather<float>(tensorOut),
+              std::vector<float>({ 1, 5, 9, 13, 17 }));
+
+    // The workgroups must match the shards
+    EXPECT_ANY_THROW(group.algorithm({ tensorIn, tensorOut },
+                                     compileSource(ROW_SUM_SHADER),
+                                     { kp::Workgroup({ 5, 1, 1 }) }));
+
+    // The default workgroup would cover the whole replicated tensor
+    std::shared_ptr<kp::ShardedTensor> replicated =
+      group.replicate(std::vector<float>({ 1, 2 }));
+    EXPECT_ANY_THROW(group.algorithm({ replicated, tensorOut },
+                                     compileSource(ROW_SUM_SHADER)));
+}
+
+TEST(TestDeviceGroup, FewerRowsThanDevices)
+{
+    kp::DeviceGroup group(std::vector<uint32_t>({ 0, 0, 0 }));
+
+    std::shared_ptr<kp::ShardedTensor> tensor =
+      group.tensor(std::vector<float>({ 1, 2 }));
+    EXPECT_EQ(tensor->shardCount(), 2u);
+
+    std::shared_ptr<kp::ShardedTensor> other =
+      group.tensor(std::vector<float>({ 1, 2, 3 }));
+    EXPECT_ANY_THROW(group.algorithm({ tensor, other },
+                                     compileSource(SCALE_SHADER)));
+    EXPECT_ANY_THROW(group.tensor(std::vector<float>({ 1, 2, 3 }), 2));
+}
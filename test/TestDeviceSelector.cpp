@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+#include <limits>
+
+TEST(TestDeviceSelector, ManagerSelectsBestDevice)
+{
+    kp::Manager mgr;
+
+    std::vector<vk::PhysicalDevice> devices = mgr.listDevices();
+    uint32_t index =
+      kp::DeviceSelector::selectDevice(devices, kp::DevicePolicy());
+
+    // No other device has a higher score than the one used by the manager
+    int64_t score =
+      kp::DeviceSelector::scoreDevice(devices[index], kp::DevicePolicy());
+    for (const vk::PhysicalDevice& device : devices) {
+        EXPECT_LE(kp::DeviceSelector::scoreDevice(device, kp::DevicePolicy()),
+                  score);
+    }
+
+    EXPECT_EQ(mgr.getDeviceProperties().deviceID,
+              devices[index].getProperties().deviceID);
+}
+
+TEST(TestDeviceSelector, PrefersAsyncComputeQueueFamily)
+{
+    kp::Manager mgr;
+
+    std::vector<vk::PhysicalDevice> devices = mgr.listDevices();
+    vk::PhysicalDevice device = devices[kp::DeviceSelector::selectDevice(
+      devices, kp::DevicePolicy())];
+    std::vector<vk::QueueFamilyProperties> families =
+      device.getQueueFamilyProperties();
+
+    bool hasAsyncCompute = false;
+    for (const vk::QueueFamilyProperties& family : families) {
+        if ((family.queueFlags & vk::QueueFlagBits::eCompute) &&
+            !(family.queueFlags & vk::QueueFlagBits::eGraphics)) {
+            hasAsyncCompute = true;
+        }
+    }
+
+    uint32_t asyncIndex =
+      kp::DeviceSelector::selectQueueFamily(device, kp::DevicePolicy());
+    EXPECT_TRUE(families[asyncIndex].queueFlags & vk::QueueFlagBits::eCompute);
+    EXPECT_EQ(
+      bool(families[asyncIndex].queueFlags & vk::QueueFlagBits::eGraphics),
+      !hasAsyncCompute);
+
+    kp::DevicePolicy graphicsPolicy;
+    graphicsPolicy.requiredQueueFlags =
+      vk::QueueFlagBits::eCompute | vk::QueueFlagBits::eGraphics;
+
+    bool hasGraphics = false;
+    for (const vk::QueueFamilyProperties& family : families) {
+        if ((family.queueFlags & graphicsPolicy.requiredQueueFlags) ==
+            graphicsPolicy.requiredQueueFlags) {
+            hasGraphics = true;
+        }
+    }
+    if (!hasGraphics) {
+        GTEST_SKIP() << "GPU does not have a graphics queue family";
+    }
+
+    uint32_t graphicsIndex =
+      kp::DeviceSelector::selectQueueFamily(device, graphicsPolicy);
+    EXPECT_TRUE(families[graphicsIndex].queueFlags &
+                vk::QueueFlagBits::eGraphics);
+}
+
+TEST(TestDeviceSelector, IndexConstructorUsesFirstComputeFamily)
+{
+    kp::Manager mgr(0);
+
+    std::vector<vk::QueueFamilyProperties> families =
+      mgr.listDevices()[0].getQueueFamilyProperties();
+    uint32_t first = 0;
+    while (!(families[first].queueFlags & vk::QueueFlagBits::eCompute)) {
+        first++;
+    }
+
+    // The sequences record for the queue family used by the manager
+    EXPECT_EQ(mgr.sequence()->getImageLayoutTracker()->getQueueFlags(),
+              families[first].queueFlags);
+}
+
+TEST(TestDeviceSelector, UnsatisfiablePolicyThrows)
+{
+    kp::DevicePolicy policy;
+    policy.minDeviceMemory = std::numeric_limits<vk::DeviceSize>::max();
+
+    kp::Manager mgr;
+    std::vector<vk::PhysicalDevice> devices = mgr.listDevices();
+
+    for (const vk::PhysicalDevice& device : devices) {
+        EXPECT_LT(kp::DeviceSelector::scoreDevice(device, policy), 0);
+    }
+    EXPECT_ANY_THROW(kp::DeviceSelector::selectDevice(devices, policy));
+    EXPECT_ANY_THROW(kp::Manager failingMgr(policy));
+}
+
+TEST(TestDeviceSelector, RequiredFeaturesAreEnabled)
+{
+    kp::Manager mgr;
+
+    std::vector<vk::PhysicalDevice> devices = mgr.listDevices();
+    vk::PhysicalDevice device = devices[kp::DeviceSelector::selectDevice(
+      devices, kp::DevicePolicy())];
+    vk::PhysicalDeviceFeatures supported = device.getFeatures();
+
+    kp::DevicePolicy policy;
+    policy.requiredFeatures.shaderInt64 = supported.shaderInt64;
+    policy.requiredFeatures.shaderFloat64 = supported.shaderFloat64;
+
+    EXPECT_TRUE(kp::DeviceSelector::supportsFeatures(supported,
+                                                     policy.requiredFeatures));
+    EXPECT_GE(kp::DeviceSelector::scoreDevice(device, policy), 0);
+
+    kp::Manager featureMgr(policy);
+    std::shared_ptr<kp::TensorT<float>> tensor = featureMgr.tensor({ 1, 2 });
+    featureMgr.sequence()->eval<kp::OpSyncDevice>({ tensor });
+    EXPECT_EQ(tensor->vector(), std::vector<float>({ 1, 2 }));
+}
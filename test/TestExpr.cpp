@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+#include "shaders/Utils.hpp"
+
+TEST(TestExpr, FusedMultiplyAddRelu)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensor({ 1, 2, -3, 4 });
+    std::shared_ptr<kp::TensorT<float>> tensorB = mgr.tensor({ 2, 2, 2, -2 });
+    std::shared_ptr<kp::TensorT<float>> tensorC = mgr.tensor({ 1, -5, 1, 1 });
+    std::shared_ptr<kp::TensorT<float>> tensorOut = mgr.tensor({ 0, 0, 0, 0 });
+
+    kp::expr::Expr a(tensorA);
+    kp::expr::Expr b(tensorB);
+    kp::expr::Expr c(tensorC);
+
+    std::shared_ptr<kp::Algorithm> algorithm = kp::expr::algorithm(
+      mgr, tensorOut, kp::expr::relu(a * b + c) * 0.5f, compileSource);
+
+    // The three inputs and the output are bound to a single dispatch
+    EXPECT_EQ(algorithm->getMemObjects().size(), 4u);
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorA, tensorB, tensorC })
+      ->record<kp::OpAlgoDispatch>(algorithm)
+      ->record<kp::OpSyncLocal>({ tensorOut })
+      ->eval();
+
+    EXPECT_EQ(tensorOut->vector(), std::vector<float>({ 1.5, 0, 0, 0 }));
+}
+
+TEST(TestExpr, SharedNodesAndInPlaceOutput)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensor({ 1, 2, 3 });
+    std::shared_ptr<kp::TensorT<float>> tensorB = mgr.tensor({ 4, 5, 6 });
+
+    kp::expr::Expr a(tensorA);
+    kp::expr::Expr b(tensorB);
+    kp::expr::Expr sum = a + b;
+
+    // The sum is computed once and the output overwrites the first input
+    std::string source = kp::expr::source(tensorA, sum * sum - a);
+    EXPECT_EQ(source.find("v0 + v1"), source.rfind("v0 + v1"));
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorA, tensorB })
+      ->record<kp::OpAlgoDispatch>(
+        kp::expr::algorithm(mgr, tensorA, sum * sum - a, compileSource))
+      ->record<kp::OpSyncLocal>({ tensorA })
+      ->eval();
+
+    EXPECT_EQ(tensorA->vector(), std::vector<float>({ 24, 47, 78 }));
+}
+
+TEST(TestExpr, KernelsCachedBySignature)
+{
+    kp::Manager mgr;
+
+    // Kernels cached by previous tests would not be compiled again
+    kp::expr::clearCache();
+
+    uint32_t compilations = 0;
+    kp::expr::Compiler compiler = [&](const std::string& source) {
+        compilations++;
+        return compileSource(source);
+    };
+
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensor({ 1, 2 });
+    std::shared_ptr<kp::TensorT<float>> tensorB = mgr.tensor({ 3, 4 });
+    std::shared_ptr<kp::TensorT<float>> tensorOut = mgr.tensor({ 0, 0 });
+
+    kp::expr::Expr a(tensorA);
+    kp::expr::Expr b(tensorB);
+
+    // Expressions of the same shape over other tensors and constants share
+    // their kernel
+    kp::expr::algorithm(mgr, tensorOut, kp::expr::exp(a) * 123.0f, compiler);
+    kp::expr::algorithm(mgr, tensorOut, kp::expr::exp(b) * 456.0f, compiler);
+    EXPECT_EQ(compilations, 1u);
+
+    std::shared_ptr<kp::Algorithm> algorithm = kp::expr::algorithm(
+      mgr, tensorOut, kp::expr::max(a, b) / 2.0f, compiler);
+    EXPECT_EQ(compilations, 2u);
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorA, tensorB })
+      ->record<kp::OpAlgoDispatch>(algorithm)
+      ->record<kp::OpSyncLocal>({ tensorOut })
+      ->eval();
+
+    EXPECT_EQ(tensorOut->vector(), std::vector<float>({ 1.5, 2 }));
+}
+
+TEST(TestExpr, InvalidTensorsThrow)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensor({ 1, 2 });
+    std::shared_ptr<kp::TensorT<float>> tensorShort = mgr.tensor({ 1 });
+    std::shared_ptr<kp::TensorT<int32_t>> tensorInt =
+      mgr.tensorT<int32_t>({ 1, 2 });
+
+    kp::expr::Expr a(tensorA);
+
+    EXPECT_THROW(kp::expr::Expr{ tensorInt }, std::runtime_error);
+    EXPECT_THROW(kp::expr::source(tensorShort, a + 1.0f), std::runtime_error);
+    EXPECT_THROW(kp::expr::source(tensorInt, a), std::runtime_error);
+}
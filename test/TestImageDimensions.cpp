@@ -0,0 +1,237 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+#include "shaders/Utils.hpp"
+
+TEST(TestImageDimensions, ImageArraySync)
+{
+    kp::Manager mgr;
+
+    kp::Image::Dimensions dimensions;
+    dimensions.layers = 3;
+
+    std::vector<float> data{ 0, 1, 2, 3, 10, 11, 12, 13, 20, 21, 22, 23 };
+    std::shared_ptr<kp::ImageT<float>> image =
+      mgr.image(data, 2, 2, 1, dimensions);
+    std::shared_ptr<kp::TensorT<float>> tensor =
+      mgr.tensorT<float>(data.size());
+
+    EXPECT_EQ(image->getLayers(), 3u);
+    EXPECT_EQ(image->getDepth(), 1u);
+    EXPECT_EQ(image->getMipLevels(), 1u);
+    EXPECT_EQ(image->size(), data.size());
+
+    mgr.sequence()->eval<kp::OpSyncDevice>({ image });
+    image->setData(std::vector<float>(data.size()));
+
+    mgr.sequence()
+      ->record<kp::OpCopy>({ image, tensor })
+      ->record<kp::OpSyncLocal>({ image, tensor })
+      ->eval();
+
+    EXPECT_EQ(image->vector(), data);
+    EXPECT_EQ(tensor->vector(), data);
+}
+
+TEST(TestImageDimensions, ImageArrayShader)
+{
+    kp::Manager mgr;
+
+    kp::Image::Dimensions dimensions;
+    dimensions.layers = 2;
+
+    std::shared_ptr<kp::ImageT<float>> image =
+      mgr.image({ 1, 2, 3, 4 }, 2, 1, 1, dimensions);
+    std::shared_ptr<kp::TensorT<float>> tensorOut = mgr.tensorT<float>(4);
+
+    std::string shader(R"(
+        #version 450
+
+        layout (local_size_x = 2, local_size_y = 2) in;
+
+        layout(set = 0, binding = 0, r32f) uniform image2DArray imageIn;
+        layout(set = 0, binding = 1) buffer buf_out { float out_a[]; };
+
+        void main() {
+            ivec3 texel = ivec3(gl_LocalInvocationID.x, 0,
+                                gl_LocalInvocationID.y);
+            out_a[texel.z * 2 + texel.x] = imageLoad(imageIn, texel).r * 10;
+        }
+    )");
+
+    std::shared_ptr<kp::Algorithm> algorithm =
+      mgr.algorithm({ image, tensorOut }, compileSource(shader));
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ image })
+      ->record<kp::OpAlgoDispatch>(algorithm)
+      ->record<kp::OpSyncLocal>({ tensorOut })
+      ->eval();
+
+    EXPECT_EQ(tensorOut->vector(), std::vector<float>({ 10, 20, 30, 40 }));
+}
+
+TEST(TestImageDimensions, VolumeShader)
+{
+    kp::Manager mgr;
+
+    kp::Image::Dimensions dimensions;
+    dimensions.depth = 2;
+
+    std::vector<float> data{ 0, 1, 2, 3, 4, 5, 6, 7 };
+    std::shared_ptr<kp::ImageT<float>> image =
+      mgr.image(data, 2, 2, 1, dimensions);
+    std::shared_ptr<kp::TensorT<float>> tensorOut =
+      mgr.tensorT<float>(data.size());
+
+    EXPECT_EQ(image->getDepth(), 2u);
+    EXPECT_EQ(image->getExtent().depth, 2u);
+
+    std::string shader(R"(
+        #version 450
+
+        layout (local_size_x = 2, local_size_y = 2, local_size_z = 2) in;
+
+        layout(set = 0, binding = 0, r32f) uniform image3D imageIn;
+        layout(set = 0, binding = 1) buffer buf_out { float out_a[]; };
+
+        void main() {
+            ivec3 texel = ivec3(gl_LocalInvocationID);
+            uint index = texel.z * 4 + texel.y * 2 + texel.x;
+            out_a[index] = imageLoad(imageIn, texel).r;
+        }
+    )");
+
+    std::shared_ptr<kp::Algorithm> algorithm =
+      mgr.algorithm({ image, tensorOut }, compileSource(shader));
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ image })
+      ->record<kp::OpAlgoDispatch>(algorithm)
+      ->record<kp::OpSyncLocal>({ tensorOut, image })
+      ->eval();
+
+    EXPECT_EQ(tensorOut->vector(), data);
+    EXPECT_EQ(image->vector(), data);
+}
+
+TEST(TestImageDimensions, GenerateMipmaps)
+{
+    // Blits are only supported by queue families with graphics
+    kp::DevicePolicy policy;
+    policy.requiredQueueFlags =
+      vk::QueueFlagBits::eCompute | vk::QueueFlagBits::eGraphics;
+    kp::Manager mgr(policy);
+
+    // Linear filtering averages each 2x2 block into the next level
+    std::vector<vk::PhysicalDevice> devices = mgr.listDevices();
+    vk::FormatProperties properties =
+      devices[kp::DeviceSelector::selectDevice(devices, policy)]
+        .getFormatProperties(vk::Format::eR32Sfloat);
+    if (!(properties.optimalTilingFeatures &
+          vk::FormatFeatureFlagBits::eSampledImageFilterLinear)) {
+        GTEST_SKIP() << "GPU does not support linear filtering of floats";
+    }
+
+    kp::Image::Dimensions dimensions;
+    dimensions.mipLevels = 0;
+
+    std::vector<float> data{ 0, 1, 2,  3,  4,  5,  6,  7,
+                             8, 9, 10, 11, 12, 13, 14, 15 };
+    std::shared_ptr<kp::ImageT<float>> image =
+      mgr.image(data, 4, 4, 1, dimensions);
+    std::shared_ptr<kp::TensorT<float>> tensorOut = mgr.tensorT<float>(5);
+
+    EXPECT_EQ(image->getMipLevels(), 3u);
+    EXPECT_EQ(image->getExtent(1).width, 2u);
+    EXPECT_EQ(image->getExtent(2).height, 1u);
+
+    image->setDescriptorType(vk::DescriptorType::eSampledImage);
+
+    std::string shader(R"(
+        #version 450
+        #extension GL_EXT_samplerless_texture_functions : require
+
+        layout (local_size_x = 1) in;
+
+        layout(set = 0, binding = 0) uniform texture2D imageIn;
+        layout(set = 0, binding = 1) buffer buf_out { float out_a[]; };
+
+        void main() {
+            out_a[0] = texelFetch(imageIn, ivec2(0, 0), 1).r;
+            out_a[1] = texelFetch(imageIn, ivec2(1, 0), 1).r;
+            out_a[2] = texelFetch(imageIn, ivec2(0, 1), 1).r;
+            out_a[3] = texelFetch(imageIn, ivec2(1, 1), 1).r;
+            out_a[4] = texelFetch(imageIn, ivec2(0, 0), 2).r;
+        }
+    )");
+
+    std::shared_ptr<kp::Algorithm> algorithm =
+      mgr.algorithm({ image, tensorOut }, compileSource(shader));
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ image })
+      ->record<kp::OpGenerateMipmaps>({ image })
+      ->record<kp::OpAlgoDispatch>(algorithm)
+      ->record<kp::OpSyncLocal>({ tensorOut, image })
+      ->eval();
+
+    std::vector<float> output = tensorOut->vector();
+    std::vector<float> expected{ 2.5f, 4.5f, 10.5f, 12.5f, 7.5f };
+    for (size_t i = 0; i < expected.size(); i++) {
+        EXPECT_NEAR(output[i], expected[i], 0.01f);
+    }
+
+    // The first level is synced with the host and kept by the generation
+    EXPECT_EQ(image->vector(), data);
+}
+
+TEST(TestImageDimensions, GenerateMipmapsRequiresGraphicsQueue)
+{
+    // The default policy prefers a queue family without graphics
+    kp::Manager mgr;
+
+    std::vector<vk::PhysicalDevice> devices = mgr.listDevices();
+    vk::PhysicalDevice device = devices[kp::DeviceSelector::selectDevice(
+      devices, kp::DevicePolicy())];
+    uint32_t family =
+      kp::DeviceSelector::selectQueueFamily(device, kp::DevicePolicy());
+    if (device.getQueueFamilyProperties()[family].queueFlags &
+        vk::QueueFlagBits::eGraphics) {
+        GTEST_SKIP() << "GPU does not have an async compute queue family";
+    }
+
+    kp::Image::Dimensions dimensions;
+    dimensions.mipLevels = 0;
+    std::shared_ptr<kp::ImageT<float>> image =
+      mgr.imageT<float>(4, 4, 1, dimensions);
+
+    EXPECT_ANY_THROW(mgr.sequence()->record<kp::OpGenerateMipmaps>({ image }));
+}
+
+TEST(TestImageDimensions, InvalidDimensions)
+{
+    kp::Manager mgr;
+
+    kp::Image::Dimensions layers;
+    layers.layers = 2;
+    kp::Image::Dimensions volumeArray;
+    volumeArray.depth = 2;
+    volumeArray.layers = 2;
+    kp::Image::Dimensions tooManyLevels;
+    tooManyLevels.mipLevels = 4;
+
+    // Only optimal tiling supports more than a single 2D level
+    EXPECT_ANY_THROW(mgr.imageT<float>(
+      4, 4, 1, layers, kp::Memory::MemoryTypes::eDeviceAndHost));
+    EXPECT_ANY_THROW(mgr.imageT<float>(4, 4, 1, volumeArray));
+    EXPECT_ANY_THROW(mgr.imageT<float>(4, 4, 1, tooManyLevels));
+    EXPECT_ANY_THROW(mgr.image({ 1, 2, 3 }, 2, 2, 1, layers));
+
+    std::shared_ptr<kp::ImageT<float>> image = mgr.image({ 1, 2, 3 }, 3, 1, 1);
+    EXPECT_ANY_THROW(mgr.sequence()->record<kp::OpGenerateMipmaps>({ image }));
+}
@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+#include "shaders/Utils.hpp"
+
+static const std::string INCREMENT_SHADER(R"(
+    #version 450
+
+    layout (local_size_x = 1) in;
+
+    layout(set = 0, binding = 0, r32f) uniform image2D imageA;
+    layout(set = 0, binding = 1, r32f) uniform image2D imageB;
+
+    void main() {
+        ivec2 texel = ivec2(gl_GlobalInvocationID.x, 0);
+        imageStore(imageA, texel, imageLoad(imageA, texel) + 1);
+        imageStore(imageB, texel, imageLoad(imageB, texel) + 10);
+    }
+)");
+
+TEST(TestImageLayoutTracker, BatchesTransitionsOfDispatch)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::ImageT<float>> imageA = mgr.image({ 0, 1, 2 }, 3, 1, 1);
+    std::shared_ptr<kp::ImageT<float>> imageB = mgr.image({ 0, 0, 0 }, 3, 1, 1);
+
+    std::shared_ptr<kp::Algorithm> algorithm =
+      mgr.algorithm({ imageA, imageB },
+                    compileSource(INCREMENT_SHADER),
+                    kp::Workgroup({ 3, 1, 1 }));
+
+    mgr.sequence()->eval<kp::OpSyncDevice>({ imageA, imageB });
+
+    std::shared_ptr<kp::Sequence> sq = mgr.sequence();
+    std::shared_ptr<kp::ImageLayoutTracker> tracker =
+      sq->getImageLayoutTracker();
+
+    sq->record<kp::OpAlgoDispatch>(algorithm);
+
+    // Both images are transitioned to eGeneral by a single barrier
+    EXPECT_EQ(tracker->getTransitionCount(), 2u);
+    EXPECT_EQ(tracker->getBarrierCount(), 1u);
+    EXPECT_EQ(imageA->getPrimaryImageLayout(), vk::ImageLayout::eGeneral);
+
+    // The images are already in eGeneral so only the memory dependency stays
+    sq->record<kp::OpAlgoDispatch>(algorithm);
+
+    EXPECT_EQ(tracker->getTransitionCount(), 2u);
+    EXPECT_EQ(tracker->getSkippedTransitionCount(), 2u);
+    EXPECT_EQ(tracker->getBarrierCount(), 2u);
+
+    sq->eval();
+    mgr.sequence()->eval<kp::OpSyncLocal>({ imageA, imageB });
+
+    EXPECT_EQ(imageA->vector(), std::vector<float>({ 2, 3, 4 }));
+    EXPECT_EQ(imageB->vector(), std::vector<float>({ 20, 20, 20 }));
+}
+
+TEST(TestImageLayoutTracker, BatchesTransitionsOfSyncAndCopy)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::ImageT<float>> imageA = mgr.image({ 0, 1, 2 }, 3, 1, 1);
+    std::shared_ptr<kp::ImageT<float>> imageB = mgr.image({ 0, 0, 0 }, 3, 1, 1);
+    std::shared_ptr<kp::ImageT<float>> imageC = mgr.image({ 0, 0, 0 }, 3, 1, 1);
+
+    std::shared_ptr<kp::Sequence> sq = mgr.sequence();
+    std::shared_ptr<kp::ImageLayoutTracker> tracker =
+      sq->getImageLayoutTracker();
+
+    // The three images are transitioned for the copies by a single barrier
+    sq->record<kp::OpSyncDevice>({ imageA, imageB, imageC });
+
+    EXPECT_EQ(tracker->getTransitionCount(), 3u);
+    EXPECT_EQ(tracker->getBarrierCount(), 1u);
+
+    // The source and both destinations share one barrier as well
+    sq->record<kp::OpCopy>({ imageA, imageB, imageC });
+
+    EXPECT_EQ(tracker->getBarrierCount(), 2u);
+
+    sq->record<kp::OpSyncLocal>({ imageB, imageC });
+
+    // One barrier before the copies to staging and one after them
+    EXPECT_EQ(tracker->getBarrierCount(), 4u);
+
+    sq->eval();
+
+    EXPECT_EQ(imageB->vector(), std::vector<float>({ 0, 1, 2 }));
+    EXPECT_EQ(imageC->vector(), std::vector<float>({ 0, 1, 2 }));
+}
+
+TEST(TestImageLayoutTracker, ReplayKeepsImageContents)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::ImageT<float>> imageA = mgr.image({ 0, 1, 2 }, 3, 1, 1);
+    std::shared_ptr<kp::ImageT<float>> imageB = mgr.image({ 0, 0, 0 }, 3, 1, 1);
+
+    std::shared_ptr<kp::Algorithm> algorithm =
+      mgr.algorithm({ imageA, imageB },
+                    compileSource(INCREMENT_SHADER),
+                    kp::Workgroup({ 3, 1, 1 }));
+
+    mgr.sequence()->eval<kp::OpSyncDevice>({ imageA, imageB });
+
+    std::shared_ptr<kp::Sequence> sq =
+      mgr.sequence()->record<kp::OpAlgoDispatch>(algorithm);
+
+    // The first replay is recorded again without the transitions, which
+    // would otherwise discard the contents of the images
+    sq->eval();
+    sq->eval();
+    EXPECT_EQ(sq->getImageLayoutTracker()->getTransitionCount(), 0u);
+    sq->eval();
+
+    mgr.sequence()->eval<kp::OpSyncLocal>({ imageA, imageB });
+
+    EXPECT_EQ(imageA->vector(), std::vector<float>({ 3, 4, 5 }));
+    EXPECT_EQ(imageB->vector(), std::vector<float>({ 30, 30, 30 }));
+}
+
+TEST(TestImageLayoutTracker, SequencesSubmittedOutOfOrder)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::ImageT<float>> imageA = mgr.image({ 0, 1, 2 }, 3, 1, 1);
+    std::shared_ptr<kp::ImageT<float>> imageB = mgr.image({ 0, 0, 0 }, 3, 1, 1);
+
+    std::shared_ptr<kp::Algorithm> algorithm =
+      mgr.algorithm({ imageA, imageB },
+                    compileSource(INCREMENT_SHADER),
+                    kp::Workgroup({ 3, 1, 1 }));
+
+    // The second sequence is recorded expecting the layouts left by the
+    // first one, but it is submitted first
+    std::shared_ptr<kp::Sequence> sqUpload =
+      mgr.sequence()->record<kp::OpSyncDevice>({ imageA, imageB });
+    std::shared_ptr<kp::Sequence> sqDispatch =
+      mgr.sequence()->record<kp::OpAlgoDispatch>(algorithm);
+
+    sqDispatch->eval();
+    sqUpload->eval();
+    sqDispatch->eval();
+
+    mgr.sequence()->eval<kp::OpSyncLocal>({ imageA, imageB });
+
+    EXPECT_EQ(imageA->vector(), std::vector<float>({ 1, 2, 3 }));
+    EXPECT_EQ(imageB->vector(), std::vector<float>({ 10, 10, 10 }));
+}
@@ -0,0 +1,189 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+#include "shaders/Utils.hpp"
+
+static const std::string ADD_SHADER(R"(
+    #version 450
+
+    layout (local_size_x = 1) in;
+
+    layout(set = 0, binding = 0) buffer buf_a { float a[]; };
+    layout(set = 0, binding = 1) buffer buf_b { float b[]; };
+    layout(set = 0, binding = 2) buffer buf_out { float out_a[]; };
+
+    void main() {
+        uint index = gl_GlobalInvocationID.x;
+        out_a[index] = a[index] + b[index];
+    }
+)");
+
+// Operation that does not report the memory objects it accesses
+class OpUnreported : public kp::OpBase
+{
+  public:
+    void record(const vk::CommandBuffer& /*commandBuffer*/) override {}
+    void preEval(const vk::CommandBuffer& /*commandBuffer*/) override {}
+    void postEval(const vk::CommandBuffer& /*commandBuffer*/) override {}
+};
+
+TEST(TestMemoryBudget, ReportsHeaps)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::MemoryBudget> budget = mgr.getMemoryBudget();
+    std::vector<kp::MemoryBudget::Heap> heaps = budget->getHeaps();
+    ASSERT_FALSE(heaps.empty());
+
+    bool deviceLocal = false;
+    for (const kp::MemoryBudget::Heap& heap : heaps) {
+        deviceLocal |= bool(heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal);
+        EXPECT_LE(heap.budget, heap.size);
+    }
+    EXPECT_TRUE(deviceLocal);
+
+    // Only the memory of the device is accounted
+    vk::DeviceSize allocatedSize = budget->getAllocatedSize();
+    std::shared_ptr<kp::TensorT<float>> tensor = mgr.tensorT<float>(1024);
+    EXPECT_EQ(budget->getAllocatedSize(),
+              allocatedSize + tensor->memorySize());
+    mgr.tensorT<float>(1024, kp::Memory::MemoryTypes::eHost);
+    EXPECT_EQ(budget->getAllocatedSize(),
+              allocatedSize + tensor->memorySize());
+}
+
+TEST(TestMemoryBudget, EvictsLeastRecentlyUsedTensors)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::MemoryBudget> budget = mgr.getMemoryBudget();
+
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensor({ 1, 2, 3 });
+    std::shared_ptr<kp::TensorT<float>> tensorB = mgr.tensor({ 4, 5, 6 });
+    mgr.sequence()->eval<kp::OpSyncDevice>({ tensorA, tensorB });
+
+    // A soft limit of zero evicts every tensor that is not in use
+    std::vector<uint32_t> heapsOverLimit;
+    budget->setSoftLimit(0, [&](const kp::MemoryBudget::Heap& heap) {
+        heapsOverLimit.push_back(heap.index);
+    });
+    budget->setEvictionEnabled(true);
+
+    std::shared_ptr<kp::TensorT<float>> tensorOut = mgr.tensor({ 0, 0, 0 });
+
+    EXPECT_FALSE(heapsOverLimit.empty());
+    EXPECT_TRUE(tensorA->isEvicted());
+    EXPECT_TRUE(tensorB->isEvicted());
+    EXPECT_FALSE(tensorOut->isEvicted());
+    EXPECT_EQ(budget->getEvictionCount(), 2u);
+    EXPECT_EQ(tensorA->vector(), std::vector<float>({ 1, 2, 3 }));
+
+    std::shared_ptr<kp::Algorithm> algorithm =
+      mgr.algorithm({ tensorA, tensorB, tensorOut }, compileSource(ADD_SHADER));
+
+    // The evicted tensors are uploaded again when recorded
+    std::shared_ptr<kp::Sequence> sq =
+      mgr.sequence()
+        ->record<kp::OpAlgoDispatch>(algorithm)
+        ->record<kp::OpSyncLocal>({ tensorOut });
+
+    EXPECT_FALSE(tensorA->isEvicted());
+    EXPECT_EQ(budget->getRestoreCount(), 2u);
+
+    sq->eval();
+    EXPECT_EQ(tensorOut->vector(), std::vector<float>({ 5, 7, 9 }));
+
+    // Creating a tensor evicts the ones recorded in the sequence, which is
+    // recorded again with their new buffers when evaluated
+    mgr.tensor({ 0, 0, 0 });
+    EXPECT_TRUE(tensorOut->isEvicted());
+
+    tensorA->setData({ 10, 20, 30 });
+    sq->eval();
+
+    EXPECT_FALSE(tensorOut->isEvicted());
+    EXPECT_EQ(tensorOut->vector(), std::vector<float>({ 14, 25, 36 }));
+}
+
+TEST(TestMemoryBudget, EvictionKeepsNewerStagingData)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::MemoryBudget> budget = mgr.getMemoryBudget();
+
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensor({ 1, 2, 3 });
+    std::shared_ptr<kp::TensorT<float>> tensorB = mgr.tensor({ 4, 5, 6 });
+    std::shared_ptr<kp::TensorT<float>> tensorOut = mgr.tensor({ 0, 0, 0 });
+    std::shared_ptr<kp::TensorT<float>> tensorSet = mgr.tensor({ 0, 0, 0 });
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorA, tensorB })
+      ->record<kp::OpAlgoDispatch>(mgr.algorithm(
+        { tensorA, tensorB, tensorOut }, compileSource(ADD_SHADER)))
+      ->record<kp::OpAlgoDispatch>(mgr.algorithm(
+        { tensorA, tensorB, tensorSet }, compileSource(ADD_SHADER)))
+      ->eval();
+
+    EXPECT_TRUE(tensorOut->isDeviceDataNewer());
+
+    // The data set from the host is newer than the one on the device
+    tensorSet->setData({ 1, 1, 1 });
+    EXPECT_FALSE(tensorSet->isDeviceDataNewer());
+
+    // The data of a tensor never synced to the device is in staging memory
+    std::shared_ptr<kp::TensorT<float>> tensorFresh = mgr.tensor({ 7, 8, 9 });
+    EXPECT_FALSE(tensorFresh->isDeviceDataNewer());
+
+    budget->setSoftLimit(0);
+    budget->setEvictionEnabled(true);
+    mgr.tensor({ 0, 0, 0 });
+
+    EXPECT_TRUE(tensorOut->isEvicted());
+    EXPECT_TRUE(tensorSet->isEvicted());
+    EXPECT_TRUE(tensorFresh->isEvicted());
+
+    // Only the tensor written on the device was copied to its staging memory
+    EXPECT_EQ(tensorOut->vector(), std::vector<float>({ 5, 7, 9 }));
+    EXPECT_EQ(tensorSet->vector(), std::vector<float>({ 1, 1, 1 }));
+    EXPECT_EQ(tensorFresh->vector(), std::vector<float>({ 7, 8, 9 }));
+}
+
+TEST(TestMemoryBudget, UnreportedOperationWithEvictedTensorsThrows)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::MemoryBudget> budget = mgr.getMemoryBudget();
+
+    std::shared_ptr<kp::TensorT<float>> tensor = mgr.tensor({ 1, 2, 3 });
+    std::shared_ptr<OpUnreported> op = std::make_shared<OpUnreported>();
+
+    // Without evicted tensors the memory objects are not needed
+    mgr.sequence()->record(op)->eval();
+
+    budget->setSoftLimit(0);
+    budget->setEvictionEnabled(true);
+    mgr.tensor({ 0, 0, 0 });
+    EXPECT_TRUE(budget->hasEvictedTensors());
+
+    // The operation could use the evicted tensor, which is not restored
+    EXPECT_ANY_THROW(mgr.sequence()->record(op));
+    EXPECT_TRUE(tensor->isEvicted());
+}
+
+TEST(TestMemoryBudget, InvalidEviction)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::MemoryBudget> budget = mgr.getMemoryBudget();
+    EXPECT_ANY_THROW(budget->setSoftLimit(-1));
+
+    // Only eDevice tensors keep their data in staging memory
+    std::shared_ptr<kp::TensorT<float>> tensor =
+      mgr.tensorT<float>(3, kp::Memory::MemoryTypes::eStorage);
+    EXPECT_ANY_THROW(tensor->evict());
+    EXPECT_FALSE(tensor->isEvicted());
+}
@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+#include "shaders/Utils.hpp"
+
+static const std::string AFFINE_SHADER(R"(
+    #version 450
+
+    layout (local_size_x = 1) in;
+
+    layout(set = 0, binding = 0) buffer buf_in { float in_a[]; };
+    layout(set = 0, binding = 1) buffer buf_out { float out_a[]; };
+
+    layout(push_constant) uniform PushConstants {
+        float scale;
+        float offset;
+    };
+
+    void main() {
+        uint index = gl_GlobalInvocationID.x;
+        out_a[index] = in_a[index] * scale + offset;
+    }
+)");
+
+// Operation that does not report the memory objects it accesses
+class OpUnreported : public kp::OpBase
+{
+  public:
+    void record(const vk::CommandBuffer& /*commandBuffer*/) override {}
+    void preEval(const vk::CommandBuffer& /*commandBuffer*/) override {}
+    void postEval(const vk::CommandBuffer& /*commandBuffer*/) override {}
+};
+
+TEST(TestMemoryPlanner, AliasesChainOfTransientTensors)
+{
+    kp::Manager mgr;
+
+    std::vector<uint32_t> spirv = compileSource(AFFINE_SHADER);
+
+    std::shared_ptr<kp::TensorT<float>> tensorIn = mgr.tensor({ 1, 2, 3, 4 });
+    std::shared_ptr<kp::TensorT<float>> tensorOut = mgr.tensor({ 0, 0, 0, 0 });
+    std::shared_ptr<kp::TensorT<float>> t1 = mgr.transientTensor(4);
+    std::shared_ptr<kp::TensorT<float>> t2 = mgr.transientTensor(4);
+    std::shared_ptr<kp::TensorT<float>> t3 = mgr.transientTensor(4);
+
+    EXPECT_TRUE(t1->isTransient());
+    EXPECT_FALSE(t1->isMemoryBound());
+
+    std::vector<std::shared_ptr<kp::Algorithm>> algorithms{
+        mgr.algorithm({ tensorIn, t1 }, spirv, {}, {}, { 2.0, 0.0 }),
+        mgr.algorithm({ t1, t2 }, spirv, {}, {}, { 1.0, 1.0 }),
+        mgr.algorithm({ t2, t3 }, spirv, {}, {}, { 3.0, 0.0 }),
+        mgr.algorithm({ t3, tensorOut }, spirv, {}, {}, { 1.0, -1.0 })
+    };
+
+    std::shared_ptr<kp::Sequence> sq = mgr.sequence();
+    sq->record<kp::OpSyncDevice>({ tensorIn });
+    for (const std::shared_ptr<kp::Algorithm>& algorithm : algorithms) {
+        sq->record<kp::OpAlgoDispatch>(algorithm);
+    }
+    sq->record<kp::OpSyncLocal>({ tensorOut });
+
+    // The transient tensors are placed when the sequence is evaluated
+    EXPECT_FALSE(t1->isMemoryBound());
+    sq->eval();
+    EXPECT_TRUE(t1->isMemoryBound());
+
+    EXPECT_EQ(tensorOut->vector(), std::vector<float>({ 8, 14, 20, 26 }));
+
+    // t1 and t3 are never used at the same time so they share memory
+    std::shared_ptr<kp::MemoryPlanner> planner = sq->getMemoryPlanner();
+    EXPECT_EQ(planner->getTensorCount(), 3u);
+    EXPECT_LT(planner->getMemorySize(), planner->getTensorsMemorySize());
+
+    // Replaying keeps the placement and the results
+    tensorIn->setData({ 0, 0, 0, 0 });
+    sq->eval<kp::OpSyncDevice>({ tensorIn });
+    sq->clear();
+    for (const std::shared_ptr<kp::Algorithm>& algorithm : algorithms) {
+        sq->record<kp::OpAlgoDispatch>(algorithm);
+    }
+    sq->record<kp::OpSyncLocal>({ tensorOut })->eval()->eval();
+
+    EXPECT_EQ(planner->getTensorCount(), 3u);
+    EXPECT_EQ(tensorOut->vector(), std::vector<float>({ 2, 2, 2, 2 }));
+}
+
+TEST(TestMemoryPlanner, FillTransientTensor)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorOut = mgr.tensor({ 0, 0, 0 });
+    std::shared_ptr<kp::TensorT<float>> transient = mgr.transientTensor(3);
+
+    std::shared_ptr<kp::Algorithm> algorithm =
+      mgr.algorithm({ transient, tensorOut },
+                    compileSource(AFFINE_SHADER),
+                    {},
+                    {},
+                    { 2.0, 1.0 });
+
+    mgr.sequence()
+      ->record<kp::OpFill>({ transient }, 5.0)
+      ->record<kp::OpAlgoDispatch>(algorithm)
+      ->record<kp::OpSyncLocal>({ tensorOut })
+      ->eval();
+
+    EXPECT_EQ(tensorOut->vector(), std::vector<float>({ 11, 11, 11 }));
+}
+
+TEST(TestMemoryPlanner, InvalidTransientTensors)
+{
+    kp::Manager mgr;
+
+    // Only tensors without host memory can be transient
+    EXPECT_ANY_THROW(mgr.transientTensor(4, kp::Memory::MemoryTypes::eDevice));
+    EXPECT_ANY_THROW(mgr.transientTensor(4, kp::Memory::MemoryTypes::eHost));
+
+    std::shared_ptr<kp::TensorT<float>> tensor = mgr.tensor({ 1, 2 });
+    EXPECT_FALSE(tensor->isTransient());
+    EXPECT_ANY_THROW(tensor->bindTransientMemory(nullptr, 0));
+}
+
+TEST(TestMemoryPlanner, OperationWithoutMemObjectsThrows)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensor = mgr.tensor({ 1, 2 });
+    std::shared_ptr<kp::TensorT<float>> transient = mgr.transientTensor(2);
+
+    std::shared_ptr<OpUnreported> op = std::make_shared<OpUnreported>();
+
+    // Without transient tensors the memory objects are not needed
+    mgr.sequence()->record(op)->record<kp::OpSyncDevice>({ tensor })->eval();
+
+    std::shared_ptr<kp::Sequence> sq =
+      mgr.sequence()->record(op)->record<kp::OpCopy>({ tensor, transient });
+    EXPECT_ANY_THROW(sq->eval());
+}
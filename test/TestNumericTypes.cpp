@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+TEST(TestNumericTypes, HalfConversions)
+{
+    EXPECT_EQ(kp::floatToHalf(0.0f), 0x0000u);
+    EXPECT_EQ(kp::floatToHalf(-0.0f), 0x8000u);
+    EXPECT_EQ(kp::floatToHalf(1.0f), 0x3C00u);
+    EXPECT_EQ(kp::floatToHalf(-2.0f), 0xC000u);
+    EXPECT_EQ(kp::floatToHalf(65504.0f), 0x7BFFu);
+
+    // Overflows to infinity and underflows to subnormals
+    EXPECT_EQ(kp::floatToHalf(70000.0f), 0x7C00u);
+    EXPECT_EQ(kp::floatToHalf(std::ldexp(1.0f, -24)), 0x0001u);
+    EXPECT_TRUE(std::isnan(kp::halfToFloat(kp::floatToHalf(NAN))));
+
+    // Rounds to the nearest even half
+    EXPECT_EQ(kp::floatToHalf(1.0f + std::ldexp(1.0f, -11)), 0x3C00u);
+    EXPECT_EQ(kp::floatToHalf(1.0f + 3 * std::ldexp(1.0f, -11)), 0x3C02u);
+
+    for (uint32_t bits = 0; bits < 0x7C00; bits++) {
+        uint16_t half = static_cast<uint16_t>(bits);
+        EXPECT_EQ(kp::floatToHalf(kp::halfToFloat(half)), half);
+    }
+}
+
+TEST(TestNumericTypes, BFloat16Conversions)
+{
+    EXPECT_EQ(kp::floatToBFloat16(1.0f), 0x3F80u);
+    EXPECT_EQ(kp::floatToBFloat16(-2.0f), 0xC000u);
+    EXPECT_EQ(kp::bfloat16ToFloat(0x3F80), 1.0f);
+
+    // Keeps the range of floats with 8 bits of precision
+    EXPECT_EQ(kp::bfloat16ToFloat(kp::floatToBFloat16(1e30f)),
+              kp::bfloat16ToFloat(0x714A));
+    EXPECT_EQ(kp::bfloat16ToFloat(kp::floatToBFloat16(1.00390625f)), 1.0f);
+    EXPECT_TRUE(std::isnan(kp::bfloat16ToFloat(kp::floatToBFloat16(NAN))));
+}
+
+TEST(TestNumericTypes, QuantizedInt8Conversions)
+{
+    EXPECT_EQ(kp::quantizeInt8(0.0f, 0.5f, 10), 10);
+    EXPECT_EQ(kp::quantizeInt8(2.0f, 0.5f, 10), 14);
+    EXPECT_EQ(kp::quantizeInt8(-1000.0f, 0.5f, 10), -128);
+    EXPECT_EQ(kp::quantizeInt8(1000.0f, 0.5f, 10), 127);
+    EXPECT_EQ(kp::dequantizeInt8(14, 0.5f, 10), 2.0f);
+}
+
+TEST(TestNumericTypes, TensorDataTypes)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<kp::Half>> half =
+      mgr.tensorT(std::vector<kp::Half>{ 1.0f, 2.0f });
+    std::shared_ptr<kp::TensorT<kp::BFloat16>> bfloat16 =
+      mgr.tensorT(std::vector<kp::BFloat16>{ 1.0f, 2.0f });
+    std::shared_ptr<kp::Tensor> qint8 =
+      mgr.tensor({ 1.0f, 2.0f }, kp::Memory::DataTypes::eQInt8);
+
+    EXPECT_EQ(half->dataType(), kp::Memory::DataTypes::eHalf);
+    EXPECT_EQ(half->dataTypeMemorySize(), 2u);
+    EXPECT_EQ(bfloat16->dataType(), kp::Memory::DataTypes::eBFloat16);
+    EXPECT_EQ(bfloat16->dataTypeMemorySize(), 2u);
+    EXPECT_EQ(qint8->dataType(), kp::Memory::DataTypes::eQInt8);
+    EXPECT_EQ(qint8->dataTypeMemorySize(), 1u);
+    EXPECT_EQ(qint8->memorySize(), 2u);
+
+    EXPECT_EQ(half->vector()[1].bits, 0x4000u);
+    EXPECT_EQ(half->floatVector(), std::vector<float>({ 1.0f, 2.0f }));
+    EXPECT_EQ(bfloat16->floatVector(), std::vector<float>({ 1.0f, 2.0f }));
+
+    std::shared_ptr<kp::TensorT<uint32_t>> uints = mgr.tensorT<uint32_t>(1);
+    EXPECT_ANY_THROW(uints->floatVector());
+    EXPECT_ANY_THROW(half->setFloatData({ 1.0f }));
+}
+
+TEST(TestNumericTypes, QuantizedTensorSync)
+{
+    kp::Manager mgr;
+
+    std::vector<float> values{ -1.0f, -0.25f, 0.0f, 0.5f, 1.5f };
+    std::shared_ptr<kp::Tensor> tensor =
+      mgr.tensor(values,
+                 kp::Memory::DataTypes::eQInt8,
+                 kp::Memory::MemoryTypes::eDevice,
+                 0.25f,
+                 -3);
+
+    EXPECT_EQ(tensor->quantizationScale(), 0.25f);
+    EXPECT_EQ(tensor->quantizationZeroPoint(), -3);
+    EXPECT_EQ(tensor->vector<kp::QInt8>()[0].value, -7);
+
+    mgr.sequence()->eval<kp::OpSyncDevice>({ tensor });
+    tensor->setFloatData(std::vector<float>(values.size()));
+    mgr.sequence()->eval<kp::OpSyncLocal>({ tensor });
+
+    EXPECT_EQ(tensor->floatVector(), values);
+}
+
+TEST(TestNumericTypes, HalfTensorSync)
+{
+    kp::Manager mgr;
+
+    std::vector<float> values{ 0.5f, -3.0f, 1024.0f, 0.1f };
+    std::shared_ptr<kp::Tensor> tensorIn =
+      mgr.tensor(values, kp::Memory::DataTypes::eHalf);
+    std::shared_ptr<kp::Tensor> tensorOut = mgr.tensor(
+      std::vector<float>(values.size()), kp::Memory::DataTypes::eHalf);
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorIn })
+      ->record<kp::OpCopy>({ tensorIn, tensorOut })
+      ->record<kp::OpSyncLocal>({ tensorOut })
+      ->eval();
+
+    std::vector<float> output = tensorOut->floatVector();
+    for (size_t i = 0; i < values.size(); i++) {
+        EXPECT_NEAR(output[i], values[i], std::abs(values[i]) * 1e-3f);
+    }
+    EXPECT_NE(output[3], values[3]);
+}
+
+TEST(TestNumericTypes, ShaderTypeFeaturesRequireExtensions)
+{
+    kp::Manager mgr;
+
+    // None of the type extensions are requested by the default manager
+    kp::Manager::ShaderTypeFeatures features = mgr.getShaderTypeFeatures();
+    EXPECT_FALSE(features.shaderFloat16);
+    EXPECT_FALSE(features.shaderInt8);
+    EXPECT_FALSE(features.storageBuffer16BitAccess);
+    EXPECT_FALSE(features.storageBuffer8BitAccess);
+}
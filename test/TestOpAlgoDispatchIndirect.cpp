@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+#include "shaders/Utils.hpp"
+
+TEST(TestOpAlgoDispatchIndirect, DispatchSizeFromShader)
+{
+    // Counts the positive values and writes the number of workgroups required
+    // to process them as a VkDispatchIndirectCommand
+    std::string shaderCount(R"(
+        #version 450
+        layout (local_size_x = 1) in;
+        layout(set = 0, binding = 0) buffer a { float pa[]; };
+        layout(set = 0, binding = 1) buffer b { uint pb[]; };
+        void main() {
+            uint count = 0;
+            for (uint i = 0; i < pa.length(); i++) {
+                if (pa[i] > 0) {
+                    count++;
+                }
+            }
+            pb[0] = count;
+            pb[1] = 1;
+            pb[2] = 1;
+        })");
+
+    std::string shaderWrite(R"(
+        #version 450
+        layout (local_size_x = 1) in;
+        layout(set = 0, binding = 0) buffer a { float pa[]; };
+        void main() {
+            pa[gl_GlobalInvocationID.x] = 10;
+        })");
+
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorIn =
+      mgr.tensor({ 1, -1, 2, -2, 3 });
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorIndirect =
+      mgr.tensorT<uint32_t>({ 0, 0, 0 });
+    std::shared_ptr<kp::TensorT<float>> tensorOut =
+      mgr.tensor({ 0, 0, 0, 0, 0 });
+
+    std::shared_ptr<kp::Algorithm> algoCount =
+      mgr.algorithm({ tensorIn, tensorIndirect },
+                    compileSource(shaderCount),
+                    kp::Workgroup({ 1, 1, 1 }));
+    std::shared_ptr<kp::Algorithm> algoWrite =
+      mgr.algorithm({ tensorOut }, compileSource(shaderWrite));
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorIn, tensorIndirect, tensorOut })
+      ->record<kp::OpAlgoDispatch>(algoCount)
+      ->record<kp::OpAlgoDispatchIndirect>(algoWrite, tensorIndirect)
+      ->record<kp::OpSyncLocal>({ tensorIndirect, tensorOut })
+      ->eval();
+
+    EXPECT_EQ(tensorIndirect->vector(), std::vector<uint32_t>({ 3, 1, 1 }));
+    EXPECT_EQ(tensorOut->vector(), std::vector<float>({ 10, 10, 10, 0, 0 }));
+}
+
+TEST(TestOpAlgoDispatchIndirect, DispatchSizeFromHostWithOffset)
+{
+    std::string shader(R"(
+        #version 450
+        layout (local_size_x = 1) in;
+        layout(set = 0, binding = 0) buffer a { float pa[]; };
+        void main() {
+            pa[gl_GlobalInvocationID.x] += 1;
+        })");
+
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensor({ 0, 0, 0, 0 });
+    // The command is stored after a leading value, at a 4 byte offset
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorIndirect =
+      mgr.tensorT<uint32_t>({ 100, 2, 1, 1 });
+
+    std::shared_ptr<kp::Algorithm> algorithm =
+      mgr.algorithm({ tensorA }, compileSource(shader));
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorA, tensorIndirect })
+      ->record<kp::OpAlgoDispatchIndirect>(algorithm, tensorIndirect, 4)
+      ->record<kp::OpSyncLocal>({ tensorA })
+      ->eval();
+
+    EXPECT_EQ(tensorA->vector(), std::vector<float>({ 1, 1, 0, 0 }));
+
+    // Commands past the end of the tensor or misaligned are rejected
+    EXPECT_ANY_THROW(std::make_shared<kp::OpAlgoDispatchIndirect>(
+      algorithm, tensorIndirect, 8));
+    EXPECT_ANY_THROW(std::make_shared<kp::OpAlgoDispatchIndirect>(
+      algorithm, tensorIndirect, 2));
+}
@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+TEST(TestOpCompact, CompactFloatValues)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorValues =
+      mgr.tensor({ 1.5, 2.5, 3.5, 4.5, 5.5, 6.5 });
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorPredicates =
+      mgr.tensorT<uint32_t>({ 1, 0, 0, 1, 1, 0 });
+    std::shared_ptr<kp::TensorT<float>> tensorOut =
+      mgr.tensor({ 0, 0, 0, 0, 0, 0 });
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorCount =
+      mgr.tensorT<uint32_t>(1);
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorValues, tensorPredicates, tensorOut })
+      ->record<kp::OpCompact>(
+        { tensorValues, tensorPredicates, tensorOut, tensorCount }, mgr)
+      ->record<kp::OpSyncLocal>({ tensorOut, tensorCount })
+      ->eval();
+
+    EXPECT_EQ(tensorCount->vector(), std::vector<uint32_t>({ 3 }));
+    EXPECT_EQ(tensorOut->vector(),
+              std::vector<float>({ 1.5, 4.5, 5.5, 0, 0, 0 }));
+}
+
+TEST(TestOpCompact, CompactLargeTensor)
+{
+    kp::Manager mgr;
+
+    uint32_t size = 50000;
+    std::vector<uint32_t> values(size);
+    std::vector<uint32_t> predicates(size);
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i < size; i++) {
+        values[i] = i;
+        predicates[i] = (i % 3 == 0) ? 1 : 0;
+        if (predicates[i]) {
+            expected.push_back(i);
+        }
+    }
+
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorValues =
+      mgr.tensorT(values);
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorPredicates =
+      mgr.tensorT(predicates);
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorOut =
+      mgr.tensorT<uint32_t>(size);
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorCount =
+      mgr.tensorT<uint32_t>(1);
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorValues, tensorPredicates })
+      ->record<kp::OpCompact>(
+        { tensorValues, tensorPredicates, tensorOut, tensorCount }, mgr)
+      ->record<kp::OpSyncLocal>({ tensorOut, tensorCount })
+      ->eval();
+
+    uint32_t expectedCount = expected.size();
+    EXPECT_EQ(tensorCount->vector(), std::vector<uint32_t>({ expectedCount }));
+
+    std::vector<uint32_t> output = tensorOut->vector();
+    output.resize(expected.size());
+    EXPECT_EQ(output, expected);
+}
+
+TEST(TestOpCompact, InvalidTensorsThrow)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorValues = mgr.tensor({ 1, 2 });
+    std::shared_ptr<kp::TensorT<float>> tensorPredicatesFloat =
+      mgr.tensor({ 1, 0 });
+    std::shared_ptr<kp::TensorT<float>> tensorOut = mgr.tensor({ 0, 0 });
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorCount =
+      mgr.tensorT<uint32_t>(1);
+
+    std::vector<std::shared_ptr<kp::Memory>> memObjects = {
+        tensorValues, tensorPredicatesFloat, tensorOut, tensorCount
+    };
+
+    EXPECT_THROW(mgr.sequence()->record<kp::OpCompact>(memObjects, mgr),
+                 std::runtime_error);
+}
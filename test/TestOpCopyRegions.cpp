@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+TEST(TestOpCopyRegions, TensorScatterGather)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorA =
+      mgr.tensor({ 1, 2, 3, 4, 5, 6 });
+    std::shared_ptr<kp::TensorT<float>> tensorB =
+      mgr.tensor({ 0, 0, 0, 0, 0, 0, 0, 0 });
+
+    // Swap the two rows of three elements and leave a gap between them
+    kp::OpCopyRegions::Region first;
+    first.srcOffset = 0;
+    first.dstOffset = 5;
+    first.size = 3;
+    kp::OpCopyRegions::Region second;
+    second.srcOffset = 3;
+    second.dstOffset = 0;
+    second.size = 3;
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorA, tensorB })
+      ->record<kp::OpCopyRegions>(std::vector<std::shared_ptr<kp::Memory>>{
+                                    tensorA, tensorB },
+                                  std::vector<kp::OpCopyRegions::Region>{
+                                    first, second })
+      ->record<kp::OpSyncLocal>({ tensorB })
+      ->eval();
+
+    EXPECT_EQ(tensorB->vector(),
+              std::vector<float>({ 4, 5, 6, 0, 0, 1, 2, 3 }));
+}
+
+TEST(TestOpCopyRegions, ImageTileToTensor)
+{
+    kp::Manager mgr;
+
+    std::vector<float> data{ 0,  1,  2,  3,  4,  5,  6,  7,
+                             8,  9,  10, 11, 12, 13, 14, 15 };
+    std::shared_ptr<kp::ImageT<float>> image = mgr.image(data, 4, 4, 1);
+    std::shared_ptr<kp::TensorT<float>> tensor =
+      mgr.tensor({ 0, 0, 0, 0, 0, 0, 0, 0 });
+
+    // The bottom right 2x2 tile is written with a row length of 4 texels
+    kp::OpCopyRegions::Region region;
+    region.srcImageOffset = vk::Offset3D(2, 2, 0);
+    region.imageExtent = vk::Extent3D(2, 2, 1);
+    region.dstOffset = 2;
+    region.rowLength = 4;
+
+    mgr.sequence()->eval<kp::OpSyncDevice>({ image, tensor });
+    mgr.sequence()
+      ->record<kp::OpCopyRegions>(
+        std::vector<std::shared_ptr<kp::Memory>>{ image, tensor },
+        std::vector<kp::OpCopyRegions::Region>{ region })
+      ->record<kp::OpSyncLocal>({ tensor })
+      ->eval();
+
+    EXPECT_EQ(tensor->vector(),
+              std::vector<float>({ 0, 0, 10, 11, 0, 0, 14, 15 }));
+}
+
+TEST(TestOpCopyRegions, TensorToImageRegion)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensor = mgr.tensor({ 7, 8, 9, 10 });
+    std::shared_ptr<kp::ImageT<float>> image =
+      mgr.image({ 0, 0, 0, 0, 0, 0, 0, 0, 0 }, 3, 3, 1);
+
+    kp::OpCopyRegions::Region region;
+    region.dstImageOffset = vk::Offset3D(1, 1, 0);
+    region.imageExtent = vk::Extent3D(2, 2, 1);
+
+    mgr.sequence()->eval<kp::OpSyncDevice>({ tensor, image });
+    mgr.sequence()
+      ->record<kp::OpCopyRegions>(
+        std::vector<std::shared_ptr<kp::Memory>>{ tensor, image },
+        std::vector<kp::OpCopyRegions::Region>{ region })
+      ->record<kp::OpSyncLocal>({ image })
+      ->eval();
+
+    EXPECT_EQ(image->vector(),
+              std::vector<float>({ 0, 0, 0, 0, 7, 8, 0, 9, 10 }));
+}
+
+TEST(TestOpCopyRegions, ImageToImageRegion)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::ImageT<float>> imageA =
+      mgr.image({ 1, 2, 3, 4 }, 2, 2, 1);
+    std::shared_ptr<kp::ImageT<float>> imageB =
+      mgr.image({ 0, 0, 0, 0 }, 2, 2, 1);
+
+    // Copy the first column of the source into the second of the destination
+    kp::OpCopyRegions::Region region;
+    region.srcImageOffset = vk::Offset3D(0, 0, 0);
+    region.dstImageOffset = vk::Offset3D(1, 0, 0);
+    region.imageExtent = vk::Extent3D(1, 2, 1);
+
+    mgr.sequence()->eval<kp::OpSyncDevice>({ imageA, imageB });
+    mgr.sequence()
+      ->record<kp::OpCopyRegions>(
+        std::vector<std::shared_ptr<kp::Memory>>{ imageA, imageB },
+        std::vector<kp::OpCopyRegions::Region>{ region })
+      ->record<kp::OpSyncLocal>({ imageB })
+      ->eval();
+
+    EXPECT_EQ(imageB->vector(), std::vector<float>({ 0, 1, 0, 3 }));
+}
+
+TEST(TestOpCopyRegions, InvalidRegions)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensor({ 1, 2, 3 });
+    std::shared_ptr<kp::TensorT<float>> tensorB = mgr.tensor({ 0, 0, 0 });
+    std::shared_ptr<kp::ImageT<float>> image =
+      mgr.image({ 1, 2, 3, 4 }, 2, 2, 1);
+    std::shared_ptr<kp::ImageT<float>> imageTwoChannels =
+      mgr.image({ 1, 2, 3, 4, 5, 6, 7, 8 }, 2, 2, 2);
+    std::shared_ptr<kp::Sequence> sq = mgr.sequence();
+
+    std::vector<std::shared_ptr<kp::Memory>> tensors{ tensorA, tensorB };
+    std::vector<std::shared_ptr<kp::Memory>> toImage{ tensorA, image };
+    std::vector<std::shared_ptr<kp::Memory>> images{ image, imageTwoChannels };
+
+    kp::OpCopyRegions::Region outOfRange;
+    outOfRange.srcOffset = 2;
+    outOfRange.size = 2;
+    kp::OpCopyRegions::Region empty;
+    kp::OpCopyRegions::Region outsideImage;
+    outsideImage.dstImageOffset = vk::Offset3D(1, 0, 0);
+    outsideImage.imageExtent = vk::Extent3D(2, 1, 1);
+    kp::OpCopyRegions::Region tooLarge;
+    tooLarge.imageExtent = vk::Extent3D(2, 2, 1);
+
+    EXPECT_ANY_THROW(sq->record<kp::OpCopyRegions>(
+      tensors, std::vector<kp::OpCopyRegions::Region>{ outOfRange }));
+    EXPECT_ANY_THROW(sq->record<kp::OpCopyRegions>(
+      tensors, std::vector<kp::OpCopyRegions::Region>{ empty }));
+    EXPECT_ANY_THROW(sq->record<kp::OpCopyRegions>(
+      tensors, std::vector<kp::OpCopyRegions::Region>{}));
+    EXPECT_ANY_THROW(sq->record<kp::OpCopyRegions>(
+      toImage, std::vector<kp::OpCopyRegions::Region>{ outsideImage }));
+    // The tensor only holds 3 of the 4 texels of the image
+    EXPECT_ANY_THROW(sq->record<kp::OpCopyRegions>(
+      toImage, std::vector<kp::OpCopyRegions::Region>{ tooLarge }));
+    // The texels of the images have a different number of channels
+    kp::OpCopyRegions::Region texel;
+    texel.imageExtent = vk::Extent3D(1, 1, 1);
+    EXPECT_ANY_THROW(sq->record<kp::OpCopyRegions>(
+      images, std::vector<kp::OpCopyRegions::Region>{ texel }));
+}
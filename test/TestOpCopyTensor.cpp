@@ -382,3 +382,88 @@ TEST(TestOpTensorCopy, CopyDeviceAndHostToDeviceAndHostTensor)
     // Making sure the GPU holds the same vector
     EXPECT_EQ(tensorA->vector(), tensorB->vector());
 }
+
+TEST(TestOpCopyTensor, CopyDeviceTensorDefersHostData)
+{
+    kp::Manager mgr;
+
+    std::vector<float> testVecA{ 1, 2, 3 };
+
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensor(testVecA);
+    std::shared_ptr<kp::TensorT<float>> tensorB = mgr.tensor({ 0, 0, 0 });
+    std::shared_ptr<kp::TensorT<float>> tensorC = mgr.tensor({ 0, 0, 0 });
+
+    mgr.sequence()
+      ->eval<kp::OpSyncDevice>({ tensorA })
+      ->eval<kp::OpCopy>({ tensorA, tensorB })
+      ->eval<kp::OpCopy>({ tensorB, tensorC });
+
+    // No host copy happens until the data is accessed
+    EXPECT_TRUE(tensorB->hasDeferredHostData());
+    EXPECT_TRUE(tensorC->hasDeferredHostData());
+
+    // Changing the source first resolves the copies that depend on it
+    tensorA->setData(std::vector<float>{ 4, 5, 6 });
+    EXPECT_FALSE(tensorB->hasDeferredHostData());
+
+    EXPECT_EQ(tensorC->vector(), testVecA);
+    EXPECT_FALSE(tensorC->hasDeferredHostData());
+    EXPECT_EQ(tensorB->vector(), testVecA);
+}
+
+TEST(TestOpCopyTensor, CopyDeviceTensorSyncLocalDropsDeferredHostData)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensor({ 1, 2, 3 });
+    std::shared_ptr<kp::TensorT<float>> tensorB = mgr.tensor({ 0, 0, 0 });
+
+    mgr.sequence()
+      ->eval<kp::OpSyncDevice>({ tensorA })
+      ->eval<kp::OpCopy>({ tensorA, tensorB });
+
+    // The staging memory of the source is modified without syncing it
+    tensorA->data()[0] = 7;
+    EXPECT_EQ(tensorB->vector(), std::vector<float>({ 1, 2, 3 }));
+
+    mgr.sequence()
+      ->eval<kp::OpCopy>({ tensorA, tensorB })
+      ->eval<kp::OpSyncLocal>({ tensorB });
+
+    // The device data synced replaces the deferred host data of the source
+    EXPECT_FALSE(tensorB->hasDeferredHostData());
+    EXPECT_EQ(tensorB->vector(), std::vector<float>({ 1, 2, 3 }));
+}
+
+TEST(TestOpCopyTensor, CopyDeviceToHostTensorThenAlgorithmWrite)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensor({ 1, 2, 3 });
+    std::shared_ptr<kp::TensorT<float>> tensorB =
+      mgr.tensor({ 0, 0, 0 }, kp::Memory::MemoryTypes::eHost);
+
+    std::string shader = (R"(
+        #version 450
+
+        layout (local_size_x = 1) in;
+
+        layout(set = 0, binding = 0) buffer buf_out { float t_out[]; };
+
+        void main() {
+            uint index = gl_GlobalInvocationID.x;
+            t_out[index] = 10.0;
+        }
+    )");
+
+    auto algo = mgr.algorithm({ tensorB }, compileSource(shader));
+
+    mgr.sequence()
+      ->eval<kp::OpSyncDevice>({ tensorA })
+      ->eval<kp::OpCopy>({ tensorA, tensorB })
+      ->eval<kp::OpAlgoDispatch>(algo);
+
+    // The copy must not overwrite what the algorithm wrote afterwards
+    EXPECT_FALSE(tensorB->hasDeferredHostData());
+    EXPECT_EQ(tensorB->vector(), std::vector<float>({ 10, 10, 10 }));
+}
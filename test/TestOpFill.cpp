@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+TEST(TestOpFill, FillTensors)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorFloat = mgr.tensor({ 1, 2, 3 });
+    std::shared_ptr<kp::TensorT<int32_t>> tensorInt =
+      mgr.tensorT<int32_t>({ 1, 2, 3 });
+    std::shared_ptr<kp::TensorT<uint8_t>> tensorByte =
+      mgr.tensorT<uint8_t>({ 1, 2, 3, 4 });
+    std::shared_ptr<kp::TensorT<kp::Half>> tensorHalf =
+      mgr.tensorT<kp::Half>(2);
+
+    mgr.sequence()
+      ->record<kp::OpFill>({ tensorFloat }, 2.5)
+      ->record<kp::OpFill>({ tensorInt }, -7)
+      ->record<kp::OpFill>({ tensorByte, tensorHalf }, 200)
+      ->record<kp::OpSyncLocal>(
+        { tensorFloat, tensorInt, tensorByte, tensorHalf })
+      ->eval();
+
+    EXPECT_EQ(tensorFloat->vector(), std::vector<float>({ 2.5, 2.5, 2.5 }));
+    EXPECT_EQ(tensorInt->vector(), std::vector<int32_t>({ -7, -7, -7 }));
+    EXPECT_EQ(tensorByte->vector(),
+              std::vector<uint8_t>({ 200, 200, 200, 200 }));
+    EXPECT_EQ(tensorHalf->floatVector(), std::vector<float>({ 200, 200 }));
+}
+
+TEST(TestOpFill, ClearImage)
+{
+    kp::Manager mgr;
+
+    kp::Image::Dimensions dimensions;
+    dimensions.layers = 2;
+
+    std::shared_ptr<kp::ImageT<float>> image =
+      mgr.image({ 1, 2, 3, 4, 5, 6, 7, 8 }, 2, 2, 1, dimensions);
+    std::shared_ptr<kp::ImageT<uint32_t>> imageUint =
+      mgr.imageT<uint32_t>({ 1, 2, 3, 4 }, 2, 2, 1);
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ image, imageUint })
+      ->record<kp::OpFill>({ image, imageUint }, 3)
+      ->record<kp::OpSyncLocal>({ image, imageUint })
+      ->eval();
+
+    EXPECT_EQ(image->vector(), std::vector<float>(8, 3));
+    EXPECT_EQ(imageUint->vector(), std::vector<uint32_t>(4, 3));
+}
+
+TEST(TestOpFill, TensorFilledWithoutHostData)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorScratch =
+      mgr.tensorFilled(1000, 1.5);
+    std::shared_ptr<kp::TensorT<float>> tensorZeros =
+      mgr.tensorFilled(1000, 0, kp::Memory::MemoryTypes::eDevice);
+    std::shared_ptr<kp::TensorT<float>> tensorOut =
+      mgr.tensorT<float>(1000);
+
+    EXPECT_EQ(tensorScratch->memoryType(), kp::Memory::MemoryTypes::eStorage);
+
+    mgr.sequence()
+      ->record<kp::OpCopy>({ tensorScratch, tensorOut })
+      ->record<kp::OpSyncLocal>({ tensorOut, tensorZeros })
+      ->eval();
+
+    EXPECT_EQ(tensorOut->vector(), std::vector<float>(1000, 1.5));
+    EXPECT_EQ(tensorZeros->vector(), std::vector<float>(1000, 0));
+}
+
+TEST(TestOpFill, InvalidFills)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<uint8_t>> tensorOdd =
+      mgr.tensorT<uint8_t>({ 1, 2, 3 });
+    std::shared_ptr<kp::TensorT<double>> tensorDouble =
+      mgr.tensorT<double>({ 1, 2 });
+    std::shared_ptr<kp::Sequence> sq = mgr.sequence();
+
+    EXPECT_ANY_THROW(sq->record<kp::OpFill>({ tensorOdd }, 1));
+    EXPECT_ANY_THROW(sq->record<kp::OpFill>({ tensorDouble }, 1));
+    EXPECT_NO_THROW(sq->record<kp::OpFill>({ tensorDouble }, 0));
+    EXPECT_ANY_THROW(sq->record<kp::OpFill>({}));
+}
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+#include <cmath>
+
+TEST(TestOpFillRandom, PhiloxKnownAnswer)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<uint32_t>> tensor = mgr.tensorT<uint32_t>(8);
+
+    mgr.sequence()
+      ->record<kp::OpFillRandom>(
+        { tensor }, mgr, 0, kp::OpFillRandom::Distribution::eBits)
+      ->record<kp::OpSyncLocal>({ tensor })
+      ->eval();
+
+    // Philox4x32-10 of the counters 0 and 1 with a zero key
+    EXPECT_EQ(tensor->vector(),
+              std::vector<uint32_t>({ 0x6627e8d5,
+                                      0xe169c58d,
+                                      0xbc57ac4c,
+                                      0x9b00dbd8,
+                                      0xf8e4cca4,
+                                      0x5cb200db,
+                                      0xb1a574eb,
+                                      0x097eff67 }));
+}
+
+TEST(TestOpFillRandom, UniformIsReproducible)
+{
+    kp::Manager mgr;
+
+    uint32_t size = 10001;
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensorT<float>(size);
+    std::shared_ptr<kp::TensorT<float>> tensorB = mgr.tensorT<float>(size);
+    std::shared_ptr<kp::TensorT<float>> tensorC = mgr.tensorT<float>(size);
+
+    using Distribution = kp::OpFillRandom::Distribution;
+
+    // The local size does not change the values
+    mgr.sequence()
+      ->record<kp::OpFillRandom>(
+        { tensorA }, mgr, 42, Distribution::eUniform, -2.0f, 2.0f)
+      ->record<kp::OpFillRandom>(
+        { tensorB }, mgr, 42, Distribution::eUniform, -2.0f, 2.0f, 0, 32)
+      ->record<kp::OpFillRandom>(
+        { tensorC }, mgr, 42, Distribution::eUniform, -2.0f, 2.0f, 1)
+      ->record<kp::OpSyncLocal>({ tensorA, tensorB, tensorC })
+      ->eval();
+
+    std::vector<float> valuesA = tensorA->vector();
+    EXPECT_EQ(valuesA, tensorB->vector());
+    EXPECT_NE(valuesA, tensorC->vector());
+
+    double sum = 0;
+    for (float value : valuesA) {
+        EXPECT_GE(value, -2.0f);
+        EXPECT_LT(value, 2.0f);
+        sum += value;
+    }
+    EXPECT_NEAR(sum / size, 0.0, 0.1);
+}
+
+TEST(TestOpFillRandom, NormalMoments)
+{
+    kp::Manager mgr;
+
+    uint32_t size = 100000;
+    std::shared_ptr<kp::TensorT<float>> tensor = mgr.tensorT<float>(size);
+
+    mgr.sequence()
+      ->record<kp::OpFillRandom>({ tensor },
+                                 mgr,
+                                 7,
+                                 kp::OpFillRandom::Distribution::eNormal,
+                                 3.0f,
+                                 0.5f)
+      ->record<kp::OpSyncLocal>({ tensor })
+      ->eval();
+
+    double sum = 0;
+    double sumSquares = 0;
+    for (float value : tensor->vector()) {
+        EXPECT_TRUE(std::isfinite(value));
+        sum += value;
+        sumSquares += value * value;
+    }
+    double mean = sum / size;
+    double variance = sumSquares / size - mean * mean;
+
+    EXPECT_NEAR(mean, 3.0, 0.02);
+    EXPECT_NEAR(std::sqrt(variance), 0.5, 0.02);
+}
+
+TEST(TestOpFillRandom, InvalidTensors)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorFloat = mgr.tensorT<float>(4);
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorUint =
+      mgr.tensorT<uint32_t>(4);
+    std::shared_ptr<kp::ImageT<float>> image = mgr.image({ 1, 2, 3 }, 3, 1, 1);
+    std::shared_ptr<kp::Sequence> sq = mgr.sequence();
+
+    using Distribution = kp::OpFillRandom::Distribution;
+
+    EXPECT_ANY_THROW(sq->record<kp::OpFillRandom>(
+      { tensorUint }, mgr, 1, Distribution::eUniform));
+    EXPECT_ANY_THROW(sq->record<kp::OpFillRandom>(
+      { tensorFloat }, mgr, 1, Distribution::eBits));
+    EXPECT_ANY_THROW(sq->record<kp::OpFillRandom>({ image }, mgr, 1));
+    EXPECT_ANY_THROW(
+      sq->record<kp::OpFillRandom>({ tensorFloat, tensorUint }, mgr, 1));
+}
@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+// Reference C = alpha * op(A) * op(B) + beta * C of row-major matrices
+static std::vector<float>
+matMul(const std::vector<float>& a,
+       const std::vector<float>& b,
+       std::vector<float> c,
+       uint32_t m,
+       uint32_t n,
+       uint32_t k,
+       uint32_t batch,
+       bool transposeA,
+       bool transposeB,
+       float alpha,
+       float beta)
+{
+    for (uint32_t s = 0; s < batch; s++) {
+        for (uint32_t i = 0; i < m; i++) {
+            for (uint32_t j = 0; j < n; j++) {
+                float sum = 0;
+                for (uint32_t p = 0; p < k; p++) {
+                    float valueA = transposeA ? a[s * m * k + p * m + i]
+                                              : a[s * m * k + i * k + p];
+                    float valueB = transposeB ? b[s * k * n + j * k + p]
+                                              : b[s * k * n + p * n + j];
+                    sum += valueA * valueB;
+                }
+                float& value = c[s * m * n + i * n + j];
+                value = alpha * sum + beta * value;
+            }
+        }
+    }
+    return c;
+}
+
+static std::vector<float>
+sequenceValues(size_t size, uint32_t modulo)
+{
+    std::vector<float> values(size);
+    for (size_t i = 0; i < size; i++) {
+        values[i] = float(int32_t((i * 7) % modulo) - int32_t(modulo / 2));
+    }
+    return values;
+}
+
+TEST(TestOpMatMul, FloatTransposesWithAlphaBeta)
+{
+    kp::Manager mgr;
+
+    uint32_t m = 37;
+    uint32_t n = 70;
+    uint32_t k = 53;
+
+    std::vector<float> a = sequenceValues(m * k, 5);
+    std::vector<float> b = sequenceValues(k * n, 7);
+    std::vector<float> c(m * n, 1);
+
+    for (bool transposeA : { false, true }) {
+        for (bool transposeB : { false, true }) {
+            std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensor(a);
+            std::shared_ptr<kp::TensorT<float>> tensorB = mgr.tensor(b);
+            std::shared_ptr<kp::TensorT<float>> tensorC = mgr.tensor(c);
+
+            mgr.sequence()
+              ->record<kp::OpSyncDevice>({ tensorA, tensorB, tensorC })
+              ->record<kp::OpMatMul>({ tensorA, tensorB, tensorC },
+                                     mgr,
+                                     m,
+                                     n,
+                                     k,
+                                     1,
+                                     transposeA,
+                                     transposeB,
+                                     0.5f,
+                                     2.0f)
+              ->record<kp::OpSyncLocal>({ tensorC })
+              ->eval();
+
+            // Small integers are summed exactly in any order
+            EXPECT_EQ(tensorC->vector(),
+                      matMul(
+                        a, b, c, m, n, k, 1, transposeA, transposeB, 0.5f, 2));
+        }
+    }
+}
+
+TEST(TestOpMatMul, FloatBatched)
+{
+    kp::Manager mgr;
+
+    uint32_t m = 64;
+    uint32_t n = 64;
+    uint32_t k = 32;
+    uint32_t batch = 3;
+
+    std::vector<float> a = sequenceValues(batch * m * k, 9);
+    std::vector<float> b = sequenceValues(batch * k * n, 5);
+
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensor(a);
+    std::shared_ptr<kp::TensorT<float>> tensorB = mgr.tensor(b);
+    std::shared_ptr<kp::TensorT<float>> tensorC =
+      mgr.tensorT<float>(batch * m * n);
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorA, tensorB })
+      ->record<kp::OpMatMul>(
+        { tensorA, tensorB, tensorC }, mgr, m, n, k, batch)
+      ->record<kp::OpSyncLocal>({ tensorC })
+      ->eval();
+
+    EXPECT_EQ(tensorC->vector(),
+              matMul(a,
+                     b,
+                     std::vector<float>(batch * m * n),
+                     m,
+                     n,
+                     k,
+                     batch,
+                     false,
+                     false,
+                     1,
+                     0));
+}
+
+TEST(TestOpMatMul, HalfInputs)
+{
+    kp::Manager mgr;
+
+    uint32_t m = 32;
+    uint32_t n = 48;
+    uint32_t k = 64;
+
+    std::vector<float> a = sequenceValues(m * k, 5);
+    std::vector<float> b = sequenceValues(k * n, 3);
+    std::shared_ptr<kp::TensorT<kp::Half>> tensorA =
+      mgr.tensorT(std::vector<kp::Half>(a.begin(), a.end()));
+    std::shared_ptr<kp::TensorT<kp::Half>> tensorB =
+      mgr.tensorT(std::vector<kp::Half>(b.begin(), b.end()));
+    std::shared_ptr<kp::TensorT<float>> tensorC = mgr.tensorT<float>(m * n);
+
+    std::shared_ptr<kp::OpMatMul> op{ new kp::OpMatMul(
+      { tensorA, tensorB, tensorC }, mgr, m, n, k) };
+
+    // Cooperative matrices are only enabled when requested on the manager
+    EXPECT_FALSE(op->usesCooperativeMatrix());
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorA, tensorB })
+      ->record(op)
+      ->record<kp::OpSyncLocal>({ tensorC })
+      ->eval();
+
+    EXPECT_EQ(tensorC->vector(),
+              matMul(a,
+                     b,
+                     std::vector<float>(m * n),
+                     m,
+                     n,
+                     k,
+                     1,
+                     false,
+                     false,
+                     1,
+                     0));
+}
+
+TEST(TestOpMatMul, InvalidTensorsThrow)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensorT<float>(6);
+    std::shared_ptr<kp::TensorT<float>> tensorB = mgr.tensorT<float>(6);
+    std::shared_ptr<kp::TensorT<float>> tensorC = mgr.tensorT<float>(4);
+    std::shared_ptr<kp::TensorT<int32_t>> tensorInt =
+      mgr.tensorT<int32_t>(6);
+
+    EXPECT_NO_THROW(
+      kp::OpMatMul({ tensorA, tensorB, tensorC }, mgr, 2, 2, 3));
+    EXPECT_THROW(kp::OpMatMul({ tensorA, tensorB, tensorC }, mgr, 3, 2, 3),
+                 std::runtime_error);
+    EXPECT_THROW(kp::OpMatMul({ tensorInt, tensorB, tensorC }, mgr, 2, 2, 3),
+                 std::runtime_error);
+    EXPECT_THROW(kp::OpMatMul({ tensorA, tensorB, tensorInt }, mgr, 2, 2, 3),
+                 std::runtime_error);
+    EXPECT_THROW(kp::OpMatMul({ tensorA, tensorB }, mgr, 2, 2, 3),
+                 std::runtime_error);
+}
@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include <numeric>
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+TEST(TestOpReduce, SumFloat)
+{
+    kp::Manager mgr;
+
+    std::vector<float> data(1000);
+    std::iota(data.begin(), data.end(), 1.0f);
+
+    std::shared_ptr<kp::TensorT<float>> tensorIn = mgr.tensor(data);
+    std::shared_ptr<kp::TensorT<float>> tensorOut = mgr.tensor({ 0 });
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorIn })
+      ->record<kp::OpReduce>({ tensorIn, tensorOut }, mgr)
+      ->record<kp::OpSyncLocal>({ tensorOut })
+      ->eval();
+
+    EXPECT_EQ(tensorOut->vector(), std::vector<float>({ 500500 }));
+}
+
+TEST(TestOpReduce, MinMaxInt)
+{
+    kp::Manager mgr;
+
+    std::vector<int32_t> data(5000);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<int32_t>((i * 7919) % 5000) - 2500;
+    }
+
+    std::shared_ptr<kp::TensorT<int32_t>> tensorIn = mgr.tensorT(data);
+    std::shared_ptr<kp::TensorT<int32_t>> tensorMin = mgr.tensorT<int32_t>(1);
+    std::shared_ptr<kp::TensorT<int32_t>> tensorMax = mgr.tensorT<int32_t>(1);
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorIn })
+      ->record<kp::OpReduce>(
+        { tensorIn, tensorMin }, mgr, kp::OpReduce::Operation::eMin)
+      ->record<kp::OpReduce>(
+        { tensorIn, tensorMax }, mgr, kp::OpReduce::Operation::eMax)
+      ->record<kp::OpSyncLocal>({ tensorMin, tensorMax })
+      ->eval();
+
+    EXPECT_EQ(tensorMin->vector(), std::vector<int32_t>({ -2500 }));
+    EXPECT_EQ(tensorMax->vector(), std::vector<int32_t>({ 2499 }));
+}
+
+TEST(TestOpReduce, ArgMaxFirstIndex)
+{
+    kp::Manager mgr;
+
+    std::vector<float> data(3000, -1.0f);
+    data[1234] = 5.0f;
+    data[2345] = 5.0f;
+
+    std::shared_ptr<kp::TensorT<float>> tensorIn = mgr.tensor(data);
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorOut =
+      mgr.tensorT<uint32_t>(1);
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorIn })
+      ->record<kp::OpReduce>(
+        { tensorIn, tensorOut }, mgr, kp::OpReduce::Operation::eArgMax, 64)
+      ->record<kp::OpSyncLocal>({ tensorOut })
+      ->eval();
+
+    EXPECT_EQ(tensorOut->vector(), std::vector<uint32_t>({ 1234 }));
+}
+
+TEST(TestOpReduce, MultiPassSumUint)
+{
+    kp::Manager mgr;
+
+    std::vector<uint32_t> data(1 << 20);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = i % 7;
+    }
+    uint32_t expected = std::accumulate(data.begin(), data.end(), 0u);
+
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorIn = mgr.tensorT(data);
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorOut =
+      mgr.tensorT<uint32_t>(1);
+
+    std::shared_ptr<kp::OpReduce> op{ new kp::OpReduce(
+      { tensorIn, tensorOut }, mgr, kp::OpReduce::Operation::eSum, 64) };
+
+    // 2^20 values reduced by 256 per workgroup need three passes
+    EXPECT_EQ(op->passes(), 3u);
+
+    std::shared_ptr<kp::Sequence> sq = mgr.sequence();
+    sq->eval<kp::OpSyncDevice>({ tensorIn });
+
+    // The passes can be evaluated again without re-recording
+    sq->record(op)->record<kp::OpSyncLocal>({ tensorOut })->eval()->eval();
+
+    EXPECT_EQ(tensorOut->vector(), std::vector<uint32_t>({ expected }));
+}
+
+TEST(TestOpReduce, InvalidTensorsThrow)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorFloat = mgr.tensor({ 1, 2 });
+    std::shared_ptr<kp::TensorT<double>> tensorDouble =
+      mgr.tensorT<double>({ 1, 2 });
+    std::shared_ptr<kp::TensorT<float>> tensorOut = mgr.tensor({ 0 });
+
+    std::shared_ptr<kp::Sequence> sq = mgr.sequence();
+
+    EXPECT_THROW(sq->record<kp::OpReduce>({ tensorDouble, tensorOut }, mgr),
+                 std::runtime_error);
+    EXPECT_THROW(sq->record<kp::OpReduce>({ tensorFloat }, mgr),
+                 std::runtime_error);
+    // Arg max writes a uint index
+    EXPECT_THROW(sq->record<kp::OpReduce>({ tensorFloat, tensorOut },
+                                          mgr,
+                                          kp::OpReduce::Operation::eArgMax),
+                 std::runtime_error);
+}
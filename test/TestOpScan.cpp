@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include <numeric>
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+TEST(TestOpScan, InclusiveAndExclusiveSingleBlock)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorIn =
+      mgr.tensor({ 1, 2, 3, 4, 5 });
+    std::shared_ptr<kp::TensorT<float>> tensorInclusive =
+      mgr.tensor({ 0, 0, 0, 0, 0 });
+    std::shared_ptr<kp::TensorT<float>> tensorExclusive =
+      mgr.tensor({ 0, 0, 0, 0, 0 });
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorIn })
+      ->record<kp::OpScan>({ tensorIn, tensorInclusive }, mgr)
+      ->record<kp::OpScan>({ tensorIn, tensorExclusive }, mgr, true)
+      ->record<kp::OpSyncLocal>({ tensorInclusive, tensorExclusive })
+      ->eval();
+
+    EXPECT_EQ(tensorInclusive->vector(),
+              std::vector<float>({ 1, 3, 6, 10, 15 }));
+    EXPECT_EQ(tensorExclusive->vector(),
+              std::vector<float>({ 0, 1, 3, 6, 10 }));
+}
+
+TEST(TestOpScan, MultiLevelInt)
+{
+    kp::Manager mgr;
+
+    std::vector<int32_t> data(100000);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<int32_t>(i % 11) - 5;
+    }
+    std::vector<int32_t> expected(data.size());
+    std::partial_sum(data.begin(), data.end(), expected.begin());
+
+    std::shared_ptr<kp::TensorT<int32_t>> tensorIn = mgr.tensorT(data);
+    std::shared_ptr<kp::TensorT<int32_t>> tensorOut =
+      mgr.tensorT<int32_t>(data.size());
+
+    // Blocks of 128 values need two levels of block offsets
+    std::shared_ptr<kp::OpScan> op{ new kp::OpScan(
+      { tensorIn, tensorOut }, mgr, false, false, 32) };
+    EXPECT_EQ(op->passes(), 5u);
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorIn })
+      ->record(op)
+      ->record<kp::OpSyncLocal>({ tensorOut })
+      ->eval();
+
+    EXPECT_EQ(tensorOut->vector(), expected);
+}
+
+TEST(TestOpScan, CountNonZero)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorIn =
+      mgr.tensorT<uint32_t>({ 0, 7, 0, 1, 1, 0, 3 });
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorOut =
+      mgr.tensorT<uint32_t>(7);
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorIn })
+      ->record<kp::OpScan>({ tensorIn, tensorOut }, mgr, true, true)
+      ->record<kp::OpSyncLocal>({ tensorOut })
+      ->eval();
+
+    EXPECT_EQ(tensorOut->vector(),
+              std::vector<uint32_t>({ 0, 0, 1, 1, 2, 3, 3 }));
+}
+
+TEST(TestOpScan, InvalidTensorsThrow)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorIn = mgr.tensor({ 1, 2, 3 });
+    std::shared_ptr<kp::TensorT<float>> tensorSmall = mgr.tensor({ 0, 0 });
+    std::shared_ptr<kp::TensorT<int32_t>> tensorInt =
+      mgr.tensorT<int32_t>({ 0, 0, 0 });
+
+    std::shared_ptr<kp::Sequence> sq = mgr.sequence();
+
+    EXPECT_THROW(sq->record<kp::OpScan>({ tensorIn, tensorSmall }, mgr),
+                 std::runtime_error);
+    EXPECT_THROW(sq->record<kp::OpScan>({ tensorIn, tensorInt }, mgr),
+                 std::runtime_error);
+}
@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+TEST(TestOpSort, FloatKeysWithNegatives)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorKeys =
+      mgr.tensor({ 3.5, -1, 0, -7.25, 2, -0.5, 10, 1 });
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorKeys })
+      ->record<kp::OpSort>({ tensorKeys }, mgr)
+      ->record<kp::OpSyncLocal>({ tensorKeys })
+      ->eval();
+
+    EXPECT_EQ(tensorKeys->vector(),
+              std::vector<float>({ -7.25, -1, -0.5, 0, 1, 2, 3.5, 10 }));
+}
+
+TEST(TestOpSort, IntKeyValueIsStable)
+{
+    kp::Manager mgr;
+
+    std::vector<int32_t> keys(5000);
+    std::vector<uint32_t> values(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        keys[i] = static_cast<int32_t>((i * 7919) % 13) - 6;
+        values[i] = static_cast<uint32_t>(i);
+    }
+
+    std::vector<std::pair<int32_t, uint32_t>> expected;
+    for (size_t i = 0; i < keys.size(); i++) {
+        expected.push_back({ keys[i], values[i] });
+    }
+    std::stable_sort(expected.begin(),
+                     expected.end(),
+                     [](const std::pair<int32_t, uint32_t>& a,
+                        const std::pair<int32_t, uint32_t>& b) {
+                         return a.first < b.first;
+                     });
+
+    std::shared_ptr<kp::TensorT<int32_t>> tensorKeys = mgr.tensorT(keys);
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorValues = mgr.tensorT(values);
+
+    std::shared_ptr<kp::OpSort> op{ new kp::OpSort(
+      { tensorKeys, tensorValues }, mgr, false, 32) };
+    EXPECT_EQ(op->passes(), 8u);
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorKeys, tensorValues })
+      ->record(op)
+      ->record<kp::OpSyncLocal>({ tensorKeys, tensorValues })
+      ->eval();
+
+    std::vector<int32_t> outKeys = tensorKeys->vector();
+    std::vector<uint32_t> outValues = tensorValues->vector();
+    for (size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(outKeys[i], expected[i].first);
+        EXPECT_EQ(outValues[i], expected[i].second);
+    }
+}
+
+TEST(TestOpSort, UintMillionsReusedAcrossEvals)
+{
+    kp::Manager mgr;
+
+    std::mt19937 generator(42);
+    std::vector<uint32_t> data(1 << 21);
+    for (uint32_t& value : data) {
+        value = generator();
+    }
+    std::vector<uint32_t> expected = data;
+    std::sort(expected.begin(), expected.end());
+
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorKeys = mgr.tensorT(data);
+
+    std::shared_ptr<kp::Sequence> sq =
+      mgr.sequence()
+        ->record<kp::OpSyncDevice>({ tensorKeys })
+        ->record<kp::OpSort>({ tensorKeys }, mgr)
+        ->record<kp::OpSyncLocal>({ tensorKeys });
+
+    sq->eval();
+    EXPECT_EQ(tensorKeys->vector(), expected);
+
+    // The scratch tensors are reused when sorting new keys
+    std::reverse(data.begin(), data.end());
+    tensorKeys->setData(data);
+    sq->eval();
+    EXPECT_EQ(tensorKeys->vector(), expected);
+}
+
+TEST(TestOpSort, Descending)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<int32_t>> tensorKeys =
+      mgr.tensorT<int32_t>({ 4, -2, 9, 0, -2, 7 });
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorValues =
+      mgr.tensorT<uint32_t>({ 0, 1, 2, 3, 4, 5 });
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorKeys, tensorValues })
+      ->record<kp::OpSort>({ tensorKeys, tensorValues }, mgr, true)
+      ->record<kp::OpSyncLocal>({ tensorKeys, tensorValues })
+      ->eval();
+
+    EXPECT_EQ(tensorKeys->vector(),
+              std::vector<int32_t>({ 9, 7, 4, 0, -2, -2 }));
+    EXPECT_EQ(tensorValues->vector(),
+              std::vector<uint32_t>({ 2, 5, 0, 3, 1, 4 }));
+}
+
+TEST(TestOpSort, InvalidTensorsThrow)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<double>> tensorDouble =
+      mgr.tensorT<double>({ 1, 2, 3 });
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorKeys =
+      mgr.tensorT<uint32_t>({ 3, 2, 1 });
+    std::shared_ptr<kp::TensorT<uint32_t>> tensorShort =
+      mgr.tensorT<uint32_t>({ 1, 2 });
+
+    EXPECT_THROW(kp::OpSort({ tensorDouble }, mgr), std::runtime_error);
+    EXPECT_THROW(kp::OpSort({ tensorKeys, tensorShort }, mgr),
+                 std::runtime_error);
+    EXPECT_THROW(kp::OpSort({ tensorKeys, tensorDouble }, mgr),
+                 std::runtime_error);
+}
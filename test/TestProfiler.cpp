@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+#include "shaders/Utils.hpp"
+
+static const std::string sProfilerShader(R"(
+  #version 450
+  layout (local_size_x = 1) in;
+  layout(set = 0, binding = 0) buffer a { float pa[]; };
+  void main() {
+      uint index = gl_GlobalInvocationID.x;
+      pa[index] = pa[index] + 1;
+  })");
+
+TEST(TestProfiler, ProfilerCpuSpans)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::Profiler> profiler = std::make_shared<kp::Profiler>();
+
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensor({ 0, 0, 0 });
+
+    std::vector<uint32_t> spirv = compileSource(sProfilerShader);
+
+    std::shared_ptr<kp::Sequence> sq = mgr.sequence();
+    sq->setProfiler(profiler, "main");
+
+    sq->record<kp::OpSyncDevice>({ tensorA })
+      ->record<kp::OpAlgoDispatch>(mgr.algorithm({ tensorA }, spirv))
+      ->record<kp::OpSyncLocal>({ tensorA });
+
+    sq->eval();
+    sq->eval();
+
+    EXPECT_EQ(tensorA->vector(), std::vector<float>({ 2, 2, 2 }));
+
+    std::map<std::string, kp::Profiler::Stats> stats = profiler->getStats(false);
+    EXPECT_EQ(stats["record OpSyncDevice"].count, 1);
+    EXPECT_EQ(stats["record OpSyncLocal"].count, 1);
+    EXPECT_EQ(stats["submit"].count, 2);
+    EXPECT_EQ(stats["await"].count, 2);
+
+    // Without timestamps enabled no GPU spans are captured
+    EXPECT_TRUE(profiler->getStats(true).empty());
+
+    std::string trace = profiler->toChromeTrace();
+    EXPECT_NE(trace.find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"main\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"submit\""), std::string::npos);
+
+    profiler->clear();
+    EXPECT_TRUE(profiler->getEvents().empty());
+}
+
+TEST(TestProfiler, ProfilerGpuTimestamps)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::Profiler> profiler = std::make_shared<kp::Profiler>();
+
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensor({ 0, 0, 0 });
+
+    std::vector<uint32_t> spirv = compileSource(sProfilerShader);
+
+    std::shared_ptr<kp::Sequence> sq = mgr.sequence(0, 10);
+    sq->setProfiler(profiler);
+
+    sq->record<kp::OpSyncDevice>({ tensorA })
+      ->record<kp::OpAlgoDispatch>(mgr.algorithm({ tensorA }, spirv))
+      ->record<kp::OpSyncLocal>({ tensorA });
+
+    // Evaluating multiple times requires the query pool to be reset
+    sq->eval();
+    sq->eval();
+    sq->eval();
+
+    EXPECT_EQ(tensorA->vector(), std::vector<float>({ 3, 3, 3 }));
+
+    std::map<std::string, kp::Profiler::Stats> stats = profiler->getStats();
+    EXPECT_EQ(stats.size(), 3);
+    EXPECT_EQ(stats["OpSyncDevice"].count, 3);
+    EXPECT_EQ(stats["OpSyncLocal"].count, 3);
+    for (const auto& stat : stats) {
+        EXPECT_GE(stat.second.minUs, 0);
+        EXPECT_LE(stat.second.minUs, stat.second.maxUs);
+    }
+
+    std::string trace = profiler->toChromeTrace();
+    EXPECT_NE(trace.find("\"cat\":\"gpu\""), std::string::npos);
+    EXPECT_NE(trace.find("OpAlgoDispatch"), std::string::npos);
+}
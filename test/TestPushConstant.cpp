@@ -128,14 +128,20 @@ TEST(TestPushConstants, TestConstantsWrongSize)
             std::shared_ptr<kp::TensorT<float>> tensor =
               mgr.tensor({ 0, 0, 0 });
 
+            // The push constants do not cover the block of the shader
+            EXPECT_THROW(
+              mgr.algorithm(
+                { tensor }, spirv, kp::Workgroup({ 1 }), {}, { 0.0 }),
+              std::runtime_error);
+
             std::shared_ptr<kp::Algorithm> algo = mgr.algorithm(
-              { tensor }, spirv, kp::Workgroup({ 1 }), {}, { 0.0 });
+              { tensor }, spirv, kp::Workgroup({ 1 }), {}, { 0.0, 0.0, 0.0 });
 
             sq = mgr.sequence()->record<kp::OpSyncDevice>({ tensor });
 
-            EXPECT_THROW(sq->record<kp::OpAlgoDispatch>(
-                           algo, std::vector<float>{ 0.1, 0.2, 0.3 }),
-                         std::runtime_error);
+            EXPECT_THROW(
+              sq->record<kp::OpAlgoDispatch>(algo, std::vector<float>{ 0.1 }),
+              std::runtime_error);
         }
     }
 }
@@ -390,3 +396,102 @@ TEST(TestPushConstants, TestConstantsDouble)
         }
     }
 }
+
+TEST(TestPushConstants, TestConstantsTensorWithoutRerecord)
+{
+    std::string shader(R"(
+      #version 450
+      layout (local_size_x = 1) in;
+      layout(set = 0, binding = 0) buffer a { float pa[]; };
+      layout(set = 0, binding = 1) readonly buffer b { float step; };
+      void main() {
+          pa[gl_GlobalInvocationID.x] += step;
+      })");
+
+    std::vector<uint32_t> spirv = compileSource(shader);
+
+    for (kp::Memory::MemoryTypes memoryType :
+         { kp::Memory::MemoryTypes::eDevice, kp::Memory::MemoryTypes::eHost }) {
+        kp::Manager mgr;
+
+        std::shared_ptr<kp::TensorT<float>> tensor = mgr.tensor({ 0, 0 });
+        std::shared_ptr<kp::TensorT<float>> constants =
+          mgr.tensorT<float>({ 1 }, memoryType);
+
+        std::shared_ptr<kp::Algorithm> algo =
+          mgr.algorithm({ tensor, constants }, spirv);
+
+        mgr.sequence()->eval<kp::OpSyncDevice>({ tensor, constants });
+
+        std::shared_ptr<kp::OpAlgoDispatch> op =
+          std::make_shared<kp::OpAlgoDispatch>(algo, constants);
+
+        std::shared_ptr<kp::Sequence> sq = mgr.sequence()->record(op);
+
+        // The same recorded command buffer is replayed with new constants
+        sq->eval();
+        op->setConstants<float>({ 2 });
+        sq->eval();
+        op->setConstants<float>({ 0.5 });
+        sq->evalAsync();
+        sq->evalAwait();
+
+        mgr.sequence()->eval<kp::OpSyncLocal>({ tensor });
+
+        EXPECT_EQ(tensor->vector(), std::vector<float>({ 3.5, 3.5 }));
+
+        EXPECT_ANY_THROW(op->setConstants<float>({ 1, 2 }));
+    }
+
+    kp::Manager mgr;
+    std::shared_ptr<kp::TensorT<float>> tensor = mgr.tensor({ 0 });
+    std::shared_ptr<kp::TensorT<float>> constants =
+      mgr.tensorT<float>({ 1 }, kp::Memory::MemoryTypes::eStorage);
+    std::shared_ptr<kp::Algorithm> algo =
+      mgr.algorithm({ tensor, constants }, spirv);
+    EXPECT_ANY_THROW(std::make_shared<kp::OpAlgoDispatch>(algo, constants));
+
+    // The constants tensor has to be bound to the algorithm
+    std::shared_ptr<kp::TensorT<float>> unbound = mgr.tensor({ 1 });
+    EXPECT_ANY_THROW(std::make_shared<kp::OpAlgoDispatch>(algo, unbound));
+}
+
+TEST(TestPushConstants, TestConstantsBlockMixedTypes)
+{
+    std::string shader(R"(
+      #version 450
+      layout(push_constant) uniform PushConstants {
+        uint x;
+        float y;
+        int z;
+      } pcs;
+      layout (local_size_x = 1) in;
+      layout(set = 0, binding = 0) buffer a { float pa[]; };
+      void main() {
+          pa[0] += float(pcs.x);
+          pa[1] += pcs.y;
+          pa[2] += float(pcs.z);
+      })");
+
+    typedef kp::ConstantBlock<uint32_t, float, int32_t> PushConsts;
+
+    std::vector<uint32_t> spirv = compileSource(shader);
+
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensor = mgr.tensor({ 0, 0, 0 });
+
+    std::shared_ptr<kp::Algorithm> algo = mgr.algorithm<float, PushConsts>(
+      { tensor }, spirv, kp::Workgroup({ 1 }), {}, { PushConsts() });
+
+    std::shared_ptr<kp::Sequence> sq =
+      mgr.sequence()->eval<kp::OpSyncDevice>({ tensor });
+
+    sq->eval<kp::OpAlgoDispatch>(
+      algo, std::vector<PushConsts>{ PushConsts(4, 1.5, -2) });
+    sq->eval<kp::OpAlgoDispatch>(
+      algo, std::vector<PushConsts>{ PushConsts(6, 0.25, -3) });
+    sq->eval<kp::OpSyncLocal>({ tensor });
+
+    EXPECT_EQ(tensor->vector(), std::vector<float>({ 10, 1.75, -5 }));
+}
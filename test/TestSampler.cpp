@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+#include "shaders/Utils.hpp"
+
+TEST(TestSampler, BilinearCombinedImageSampler)
+{
+    kp::Manager mgr;
+
+    // Linear filtering of 32-bit floats is an optional feature
+    std::vector<vk::PhysicalDevice> devices = mgr.listDevices();
+    vk::FormatProperties properties =
+      devices[kp::DeviceSelector::selectDevice(devices, kp::DevicePolicy())]
+        .getFormatProperties(vk::Format::eR32Sfloat);
+    if (!(properties.optimalTilingFeatures &
+          vk::FormatFeatureFlagBits::eSampledImageFilterLinear)) {
+        GTEST_SKIP() << "GPU does not support linear filtering of floats";
+    }
+
+    std::shared_ptr<kp::ImageT<float>> image =
+      mgr.image({ 0, 10, 20, 30 }, 2, 2, 1);
+    std::shared_ptr<kp::TensorT<float>> tensorOut = mgr.tensorT<float>(3);
+
+    std::shared_ptr<kp::Sampler> sampler = mgr.sampler(
+      vk::Filter::eLinear, vk::SamplerAddressMode::eClampToEdge);
+    image->setDescriptorType(vk::DescriptorType::eCombinedImageSampler,
+                             sampler);
+
+    EXPECT_EQ(image->getDescriptorType(),
+              vk::DescriptorType::eCombinedImageSampler);
+    EXPECT_EQ(image->getSampler(), sampler);
+
+    std::string shader(R"(
+        #version 450
+
+        layout (local_size_x = 1) in;
+
+        layout(set = 0, binding = 0) uniform sampler2D imageIn;
+        layout(set = 0, binding = 1) buffer buf_out { float out_a[]; };
+
+        void main() {
+            // Between the texels, on a texel and clamped outside the image
+            out_a[0] = texture(imageIn, vec2(0.5, 0.25)).r;
+            out_a[1] = texture(imageIn, vec2(0.25, 0.75)).r;
+            out_a[2] = texture(imageIn, vec2(2.0, 2.0)).r;
+        }
+    )");
+
+    std::shared_ptr<kp::Algorithm> algorithm =
+      mgr.algorithm({ image, tensorOut }, compileSource(shader));
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ image })
+      ->record<kp::OpAlgoDispatch>(algorithm)
+      ->record<kp::OpSyncLocal>({ tensorOut })
+      ->eval();
+
+    std::vector<float> output = tensorOut->vector();
+    EXPECT_NEAR(output[0], 5.0f, 0.1f);
+    EXPECT_NEAR(output[1], 20.0f, 0.1f);
+    EXPECT_NEAR(output[2], 30.0f, 0.1f);
+}
+
+TEST(TestSampler, SampledImage)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::ImageT<float>> image = mgr.image({ 1, 2, 3 }, 3, 1, 1);
+    std::shared_ptr<kp::TensorT<float>> tensorOut = mgr.tensorT<float>(3);
+
+    image->setDescriptorType(vk::DescriptorType::eSampledImage);
+
+    std::string shader(R"(
+        #version 450
+        #extension GL_EXT_samplerless_texture_functions : require
+
+        layout (local_size_x = 1) in;
+
+        layout(set = 0, binding = 0) uniform texture2D imageIn;
+        layout(set = 0, binding = 1) buffer buf_out { float out_a[]; };
+
+        void main() {
+            uint index = gl_GlobalInvocationID.x;
+            out_a[index] = texelFetch(imageIn, ivec2(index, 0), 0).r;
+        }
+    )");
+
+    std::shared_ptr<kp::Algorithm> algorithm = mgr.algorithm(
+      { image, tensorOut }, compileSource(shader), kp::Workgroup({ 3, 1, 1 }));
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ image })
+      ->record<kp::OpAlgoDispatch>(algorithm)
+      ->record<kp::OpSyncLocal>({ tensorOut })
+      ->eval();
+
+    EXPECT_EQ(tensorOut->vector(), std::vector<float>({ 1, 2, 3 }));
+}
+
+TEST(TestSampler, InvalidDescriptorTypes)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::ImageT<float>> image = mgr.image({ 1, 2, 3 }, 3, 1, 1);
+    std::shared_ptr<kp::Sampler> sampler = mgr.sampler();
+
+    EXPECT_ANY_THROW(
+      image->setDescriptorType(vk::DescriptorType::eCombinedImageSampler));
+    EXPECT_ANY_THROW(
+      image->setDescriptorType(vk::DescriptorType::eStorageImage, sampler));
+    EXPECT_ANY_THROW(
+      image->setDescriptorType(vk::DescriptorType::eStorageBuffer));
+    EXPECT_EQ(image->getDescriptorType(), vk::DescriptorType::eStorageImage);
+
+    // Unnormalized coordinates only support clamping
+    EXPECT_ANY_THROW(mgr.sampler(
+      vk::Filter::eNearest, vk::SamplerAddressMode::eRepeat, false));
+}
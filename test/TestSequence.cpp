@@ -135,6 +135,43 @@ TEST(TestSequence, SequenceTimestamps)
               6); // 1 timestamp at start + 1 after each operation
 }
 
+TEST(TestSequence, SequencePipelineStatistics)
+{
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::Tensor> tensorA = mgr.tensor({ 0, 0, 0, 0 });
+
+    std::string shader(R"(
+      #version 450
+      layout (local_size_x = 2) in;
+      layout(set = 0, binding = 0) buffer a { float pa[]; };
+      void main() {
+          uint index = gl_GlobalInvocationID.x;
+          pa[index] = pa[index] + 1;
+      })");
+
+    std::vector<uint32_t> spirv = compileSource(shader);
+
+    auto seq = mgr.sequence(0, 0, 10);
+    seq->record<kp::OpSyncDevice>({ tensorA })
+      ->record<kp::OpAlgoDispatch>(
+        mgr.algorithm({ tensorA }, spirv, kp::Workgroup({ 2, 1, 1 })))
+      ->record<kp::OpAlgoDispatch>(mgr.algorithm({ tensorA }, spirv))
+      ->record<kp::OpSyncLocal>({ tensorA })
+      ->eval();
+
+    const std::vector<kp::Sequence::OpStatistics> statistics =
+      seq->getPipelineStatistics();
+
+    EXPECT_EQ(statistics.size(), 4);
+    EXPECT_EQ(statistics[0].name, "OpSyncDevice");
+    EXPECT_EQ(statistics[0].computeShaderInvocations, 0);
+    EXPECT_EQ(statistics[1].computeShaderInvocations, 4);
+    // Default workgroup is derived from the local size of the shader
+    EXPECT_EQ(statistics[2].computeShaderInvocations, 4);
+    EXPECT_EQ(statistics[3].computeShaderInvocations, 0);
+}
+
 TEST(TestSequence, UtilsClearRecordingRunning)
 {
     kp::Manager mgr;
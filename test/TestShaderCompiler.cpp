@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+#if KOMPUTE_OPT_USE_SHADERC
+
+static const std::string sScaleShader(R"(
+  #version 450
+  layout (local_size_x = 1) in;
+  layout(set = 0, binding = 0) buffer a { float pa[]; };
+  void main() {
+      uint index = gl_GlobalInvocationID.x;
+      pa[index] = pa[index] * SCALE;
+  })");
+
+TEST(TestShaderCompiler, CompileVariantsWithDefines)
+{
+    kp::ShaderCompiler compiler;
+
+    std::vector<uint32_t> spirvTwo =
+      compiler.compile(sScaleShader, { { "SCALE", "2.0" } });
+    std::vector<uint32_t> spirvThree =
+      compiler.compile(sScaleShader, { { "SCALE", "3.0" } });
+
+    EXPECT_NE(spirvTwo, spirvThree);
+    EXPECT_EQ(compiler.getCacheHits(), 0);
+
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensor({ 1, 2, 3 });
+    std::shared_ptr<kp::TensorT<float>> tensorB = mgr.tensor({ 1, 2, 3 });
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensorA, tensorB })
+      ->record<kp::OpAlgoDispatch>(mgr.algorithm({ tensorA }, spirvTwo))
+      ->record<kp::OpAlgoDispatch>(mgr.algorithm({ tensorB }, spirvThree))
+      ->record<kp::OpSyncLocal>({ tensorA, tensorB })
+      ->eval();
+
+    EXPECT_EQ(tensorA->vector(), std::vector<float>({ 2, 4, 6 }));
+    EXPECT_EQ(tensorB->vector(), std::vector<float>({ 3, 6, 9 }));
+}
+
+TEST(TestShaderCompiler, CompileErrorThrows)
+{
+    kp::ShaderCompiler compiler;
+
+    // SCALE is left undefined
+    EXPECT_THROW(compiler.compile(sScaleShader), std::runtime_error);
+    EXPECT_THROW(compiler.compileAsync(sScaleShader).get(),
+                 std::runtime_error);
+}
+
+TEST(TestShaderCompiler, CacheInMemoryAndOnDisk)
+{
+    std::map<std::string, std::string> defines = { { "SCALE", "2.0" } };
+
+    // Cached in the temporary directory rather than the working directory
+    std::string cacheDirectory = testing::TempDir();
+
+    std::vector<uint32_t> spirv;
+    {
+        kp::ShaderCompiler compiler(cacheDirectory);
+        spirv = compiler.compile(sScaleShader, defines);
+        EXPECT_EQ(compiler.compile(sScaleShader, defines), spirv);
+        EXPECT_EQ(compiler.getCacheHits(), 1);
+    }
+
+    // A new compiler loads the result cached on disk by the previous one
+    kp::ShaderCompiler compiler(cacheDirectory);
+    EXPECT_EQ(compiler.compileAsync(sScaleShader, defines).get(), spirv);
+    EXPECT_EQ(compiler.getCacheHits(), 1);
+
+    compiler.clearCache();
+    EXPECT_EQ(compiler.compile(sScaleShader, defines), spirv);
+    EXPECT_EQ(compiler.getCacheHits(), 1);
+    compiler.clearCache();
+}
+
+TEST(TestShaderCompiler, CompileAsyncInParallel)
+{
+    kp::ShaderCompiler compiler("", 4);
+
+    std::vector<std::shared_future<std::vector<uint32_t>>> futures;
+    for (uint32_t i = 0; i < 8; i++) {
+        futures.push_back(compiler.compileAsync(
+          sScaleShader, { { "SCALE", std::to_string(i) + ".0" } }));
+    }
+
+    kp::Manager mgr;
+
+    for (uint32_t i = 0; i < futures.size(); i++) {
+        std::shared_ptr<kp::TensorT<float>> tensor = mgr.tensor({ 1, 2 });
+
+        mgr.sequence()
+          ->record<kp::OpSyncDevice>({ tensor })
+          ->record<kp::OpAlgoDispatch>(
+            mgr.algorithm({ tensor }, futures[i].get()))
+          ->record<kp::OpSyncLocal>({ tensor })
+          ->eval();
+
+        EXPECT_EQ(tensor->vector(),
+                  std::vector<float>({ 1.0f * i, 2.0f * i }));
+    }
+}
+
+#endif
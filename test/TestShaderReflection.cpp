@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gtest/gtest.h"
+
+#include "kompute/Kompute.hpp"
+#include "kompute/logger/Logger.hpp"
+
+#include "shaders/Utils.hpp"
+
+TEST(TestShaderReflection, ReflectInterface)
+{
+    std::string shader(R"(
+      #version 450
+      layout (constant_id = 0) const uint cLocalSize = 64;
+      layout (constant_id = 3) const float cScale = 1;
+      layout (local_size_x_id = 0, local_size_y = 2) in;
+      layout(push_constant) uniform PushConstants {
+        float x;
+        uint y;
+        vec2 z;
+      } pcs;
+      layout(set = 0, binding = 0) buffer a { float pa[]; };
+      layout(set = 0, binding = 1) readonly buffer b { float pb[]; };
+      layout(set = 0, binding = 2, r32f) uniform image2D image;
+      void main() {
+          uint index = gl_GlobalInvocationID.x;
+          pa[index] = pb[index] * cScale + pcs.x + pcs.z.y;
+          imageStore(image, ivec2(0, 0), vec4(pcs.y));
+      })");
+
+    kp::ShaderReflection reflection(compileSource(shader));
+
+    const std::vector<kp::ShaderReflection::Binding>& bindings =
+      reflection.getBindings();
+    EXPECT_EQ(bindings.size(), 3);
+    EXPECT_EQ(bindings[0].binding, 0);
+    EXPECT_EQ(bindings[0].descriptorType, vk::DescriptorType::eStorageBuffer);
+    EXPECT_EQ(bindings[1].name, "b");
+    EXPECT_EQ(bindings[2].descriptorType, vk::DescriptorType::eStorageImage);
+
+    EXPECT_EQ(reflection.getPushConstantsSize(), 16);
+    EXPECT_EQ(reflection.getSpecializationConstantIds(),
+              std::vector<uint32_t>({ 0, 3 }));
+
+    EXPECT_EQ(reflection.getLocalSize(),
+              std::array<uint32_t, 3>({ { 64, 2, 1 } }));
+    EXPECT_EQ(reflection.getLocalSize({ { 0, 32 } }),
+              std::array<uint32_t, 3>({ { 32, 2, 1 } }));
+
+    EXPECT_ANY_THROW(kp::ShaderReflection({ 1, 2, 3, 4, 5 }));
+}
+
+TEST(TestShaderReflection, DefaultWorkgroupFromLocalSize)
+{
+    std::string shader(R"(
+      #version 450
+      layout (constant_id = 0) const uint cLocalSize = 4;
+      layout (local_size_x_id = 0) in;
+      layout(set = 0, binding = 0) buffer a { float pa[]; };
+      void main() {
+          uint index = gl_GlobalInvocationID.x;
+          if (index < pa.length()) {
+              pa[index] = pa[index] + 1;
+          }
+      })");
+
+    std::vector<uint32_t> spirv = compileSource(shader);
+
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensor =
+      mgr.tensor(std::vector<float>(10, 0));
+
+    std::shared_ptr<kp::Algorithm> algoDefault =
+      mgr.algorithm({ tensor }, spirv);
+    EXPECT_EQ(algoDefault->getWorkgroup(), kp::Workgroup({ 3, 1, 1 }));
+
+    std::shared_ptr<kp::Algorithm> algoSpec = mgr.algorithm<uint32_t, float>(
+      { tensor }, spirv, {}, std::vector<uint32_t>({ 8 }), {});
+    EXPECT_EQ(algoSpec->getWorkgroup(), kp::Workgroup({ 2, 1, 1 }));
+
+    mgr.sequence()
+      ->record<kp::OpSyncDevice>({ tensor })
+      ->record<kp::OpAlgoDispatch>(algoDefault)
+      ->record<kp::OpAlgoDispatch>(algoSpec)
+      ->record<kp::OpSyncLocal>({ tensor })
+      ->eval();
+
+    EXPECT_EQ(tensor->vector(), std::vector<float>(10, 2));
+}
+
+TEST(TestShaderReflection, MismatchedBindingsThrow)
+{
+    std::string shader(R"(
+      #version 450
+      layout (local_size_x = 1) in;
+      layout(set = 0, binding = 0) buffer a { float pa[]; };
+      layout(set = 0, binding = 1) buffer b { float pb[]; };
+      void main() {
+          uint index = gl_GlobalInvocationID.x;
+          pb[index] = pa[index];
+      })");
+
+    std::vector<uint32_t> spirv = compileSource(shader);
+
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensor = mgr.tensor({ 0, 0, 0 });
+    std::shared_ptr<kp::ImageT<float>> image =
+      mgr.image({ 0, 0, 0, 0 }, 2, 2, 1);
+
+    std::shared_ptr<kp::Algorithm> algorithm = mgr.algorithm();
+
+    // Binding 1 has no memory object
+    EXPECT_THROW(algorithm->rebuild({ tensor }, spirv), std::runtime_error);
+    // Binding 1 expects a storage buffer rather than a storage image
+    EXPECT_THROW(algorithm->rebuild({ tensor, image }, spirv),
+                 std::runtime_error);
+
+    // The manager raises the mismatch rather than terminating
+    EXPECT_THROW(mgr.algorithm({ tensor }, spirv), std::runtime_error);
+
+    algorithm->rebuild({ tensor, tensor }, spirv);
+    EXPECT_TRUE(algorithm->isInit());
+
+    // A failed rebuild leaves the previous build untouched
+    EXPECT_THROW(algorithm->rebuild({ image }, spirv), std::runtime_error);
+    EXPECT_TRUE(algorithm->isInit());
+    EXPECT_EQ(algorithm->getMemObjects().size(), 2u);
+    EXPECT_EQ(algorithm->getSpirvHash(), kp::Algorithm::hashSpirv(spirv));
+}
+
+TEST(TestShaderReflection, SmallPushConstantsThrow)
+{
+    std::string shader(R"(
+      #version 450
+      layout (local_size_x = 1) in;
+      layout(push_constant) uniform PushConstants {
+        float x;
+        float y;
+      } pcs;
+      layout(set = 0, binding = 0) buffer a { float pa[]; };
+      void main() {
+          pa[gl_GlobalInvocationID.x] = pcs.x + pcs.y;
+      })");
+
+    std::vector<uint32_t> spirv = compileSource(shader);
+
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensor = mgr.tensor({ 0, 0 });
+
+    // The pipeline layout would not cover the block used by the shader
+    EXPECT_THROW(mgr.algorithm({ tensor }, spirv), std::runtime_error);
+    EXPECT_THROW(mgr.algorithm({ tensor },
+                               spirv,
+                               kp::Workgroup({ 2, 1, 1 }),
+                               std::vector<float>(),
+                               std::vector<float>({ 1 })),
+                 std::runtime_error);
+
+    std::shared_ptr<kp::Algorithm> algorithm =
+      mgr.algorithm({ tensor },
+                    spirv,
+                    kp::Workgroup({ 2, 1, 1 }),
+                    std::vector<float>(),
+                    std::vector<float>({ 1, 2 }));
+    EXPECT_TRUE(algorithm->isInit());
+}
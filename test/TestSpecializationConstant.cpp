@@ -102,3 +102,38 @@ TEST(TestSpecializationConstants, TestConstantsInt)
         }
     }
 }
+
+TEST(TestSpecializationConstants, TestConstantsMixedTypes)
+{
+    std::string shader(R"(
+      #version 450
+      layout (constant_id = 0) const uint cCount = 0;
+      layout (constant_id = 1) const float cScale = 0;
+      layout (constant_id = 2) const int cBias = 0;
+      layout (local_size_x = 1) in;
+      layout(set = 0, binding = 0) buffer a { float pa[]; };
+      void main() {
+          uint index = gl_GlobalInvocationID.x;
+          pa[index] = float(cCount) * cScale + float(cBias);
+      })");
+
+    typedef kp::ConstantBlock<uint32_t, float, int32_t> SpecConsts;
+    static_assert(SpecConsts::offset<2>() == 8, "Unexpected offset");
+    static_assert(sizeof(SpecConsts) == 12, "Unexpected size");
+
+    std::vector<uint32_t> spirv = compileSource(shader);
+
+    kp::Manager mgr;
+
+    std::shared_ptr<kp::TensorT<float>> tensorA = mgr.tensor({ 0, 0, 0 });
+
+    std::shared_ptr<kp::Algorithm> algo = mgr.algorithm<SpecConsts, float>(
+      { tensorA }, spirv, {}, { SpecConsts(10, 2.5, -3) }, {});
+
+    mgr.sequence()
+      ->record<kp::OpAlgoDispatch>(algo)
+      ->record<kp::OpSyncLocal>({ tensorA })
+      ->eval();
+
+    EXPECT_EQ(tensorA->vector(), std::vector<float>({ 22, 22, 22 }));
+}
@@ -7,9 +7,17 @@
 #include <string>
 #include <vector>
 
+#if KOMPUTE_OPT_USE_SHADERC
+#include "kompute/ShaderCompiler.hpp"
+#endif
+
 std::vector<uint32_t>
 compileSource(const std::string& source)
 {
+#if KOMPUTE_OPT_USE_SHADERC
+    static kp::ShaderCompiler compiler;
+    return compiler.compile(source);
+#else
     std::ofstream fileOut("tmp_kp_shader.comp");
     fileOut << source;
     fileOut.close();
@@ -25,4 +33,5 @@ compileSource(const std::string& source)
       buffer.begin(), std::istreambuf_iterator<char>(fileStream), {});
     return { reinterpret_cast<uint32_t*>(buffer.data()),
              reinterpret_cast<uint32_t*>(buffer.data() + buffer.size()) };
+#endif
 }